@@ -0,0 +1,4 @@
+DELETE FROM `command` WHERE `name` IN ('server set compression','server stats compression');
+INSERT INTO `command` (`name`, `security`, `help`) VALUES
+('server set compression', 3, 'Syntax: .server set compression #level [#threshold]\r\n\r\nSet zlib level (1..9) and minimal size in bytes of compressed update packets.'),
+('server stats compression', 3, 'Syntax: .server stats compression [reset]\r\n\r\nShow bytes in/out and time spent compressing update packets, optionally reset the counters.');
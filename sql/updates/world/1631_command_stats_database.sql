@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` = 'server stats database';
+INSERT INTO `command` (`name`, `security`, `help`) VALUES
+('server stats database', 3, 'Syntax: .server stats database\r\n\r\nShow the synchronous queries of each database pool and the queue size and latency of its async threads.');
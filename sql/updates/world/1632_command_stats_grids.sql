@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` = 'server stats grids';
+INSERT INTO `command` (`name`, `security`, `help`) VALUES
+('server stats grids', 3, 'Syntax: .server stats grids\r\n\r\nShow the grid preloading counters and the grid load latency histograms of the terrain and object loading.');
@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` = 'debug terrainbench';
+INSERT INTO `command` (`name`, `security`, `help`) VALUES
+('debug terrainbench', 3, 'Syntax: .debug terrainbench [#count]\r\n\r\nTime the .map height lookups of #count (default 100000) random points in your grid, one by one and as one batch, and count the results that differ. Also times the batched liquid status lookup.');
@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` = 'debug visbench';
+INSERT INTO `command` (`name`, `security`, `help`) VALUES
+('debug visbench', 3, 'Syntax: .debug visbench #entry [#creatures [#moves]]\r\n\r\nSummon #creatures creatures of #entry (default 200) within 40 yards and time #moves moves of 2 yards (default 50) of your character through the player relocation notifier, once updating the view of your client at every move and once with Visibility.RelocationLowerLimit. The creatures react to the moves, use it in gm mode.');
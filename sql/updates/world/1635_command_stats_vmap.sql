@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` = 'server stats vmap';
+INSERT INTO `command` (`name`, `security`, `help`) VALUES
+('server stats vmap', 3, 'Syntax: .server stats vmap [reset]\r\n\r\nShow the size and the hit rates of the line of sight and height cache of the vmaps, reset clears the counters.');
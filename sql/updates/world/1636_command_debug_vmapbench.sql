@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` = 'debug vmapbench';
+INSERT INTO `command` (`name`, `security`, `help`) VALUES
+('debug vmapbench', 3, 'Syntax: .debug vmapbench [#rays]\r\n\r\nTrace the line of sight from your position to #rays random points within 40 yards (default 10000) one by one and in SIMD packets, and show both times and the number of different results.');
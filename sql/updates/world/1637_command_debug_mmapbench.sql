@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` = 'debug mmapbench';
+INSERT INTO `command` (`name`, `security`, `help`) VALUES
+('debug mmapbench', 3, 'Syntax: .debug mmapbench [#paths]\r\n\r\nFind the paths between #paths random pairs of points within 60 yards of you (default 1000) on one core, first searched and then from the path cache, and show the paths per second of both.');
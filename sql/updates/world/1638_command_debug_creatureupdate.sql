@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` = 'debug creatureupdate';
+INSERT INTO `command` (`name`, `security`, `help`) VALUES
+('debug creatureupdate', 3, 'Syntax: .debug creatureupdate\r\n\r\nShow the number of sleeping idle creatures on your map and the creatures updated, the creatures left asleep and the microseconds spent in the cell updates per map tick since the last use of the command. Set CreatureIdleSleep to 0 to compare against updating every creature.');
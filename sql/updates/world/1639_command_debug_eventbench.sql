@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` = 'debug eventbench';
+INSERT INTO `command` (`name`, `security`, `help`) VALUES
+('debug eventbench', 3, 'Syntax: .debug eventbench [#events [#units]]\r\n\r\nAdd #events events (default 100000) with delays up to 3 seconds to #units event processors (default 200) over the first 5 seconds of 50 ms ticks, every other event running twice, and show the time taken by the old std::multimap queue and by the EventProcessor heap with slab allocated events.');
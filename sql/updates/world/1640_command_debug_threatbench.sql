@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` = 'debug threatbench';
+INSERT INTO `command` (`name`, `security`, `help`) VALUES
+('debug threatbench', 3, 'Syntax: .debug threatbench [#attackers [#ticks]]\r\n\r\nSimulate a boss with #attackers on its threat list (default 40) for #ticks updates (default 10000), every attacker adding threat each tick and one going offline every tenth tick, and show the time taken by the old std::list threat list and by the ThreatTable.');
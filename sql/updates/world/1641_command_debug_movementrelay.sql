@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` = 'debug movementrelay';
+INSERT INTO `command` (`name`, `security`, `help`) VALUES
+('debug movementrelay', 3, 'Syntax: .debug movementrelay\r\n\r\nShow the movement packets the players on your map sent since the last use of the command, the heartbeats merged into a later one of the same mover, the packets sent to the observers and the heartbeats held back from far observers (MovementRelay.FarDistance).');
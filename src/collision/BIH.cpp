@@ -246,10 +246,10 @@ bool BIH::writeToFile(FILE *wf) const
     check += fwrite(&bounds.low(), sizeof(float), 3, wf);
     check += fwrite(&bounds.high(), sizeof(float), 3, wf);
     check += fwrite(&treeSize, sizeof(uint32), 1, wf);
-    check += fwrite(&tree[0], sizeof(uint32), treeSize, wf);
+    check += fwrite(tree.begin(), sizeof(uint32), treeSize, wf);
     count = objects.size();
     check += fwrite(&count, sizeof(uint32), 1, wf);
-    check += fwrite(&objects[0], sizeof(uint32), count, wf);
+    check += fwrite(objects.begin(), sizeof(uint32), count, wf);
     return check == (3 + 3 + 2 + treeSize + count);
 }
 
@@ -262,11 +262,15 @@ bool BIH::readFromFile(FILE *rf)
     check += fread(&hi, sizeof(float), 3, rf);
     bounds = AABox(lo, hi);
     check += fread(&treeSize, sizeof(uint32), 1, rf);
-    tree.resize(treeSize);
-    check += fread(&tree[0], sizeof(uint32), treeSize, rf);
+    std::vector<uint32> tempTree(treeSize);
+    if (treeSize)
+        check += fread(&tempTree[0], sizeof(uint32), treeSize, rf);
     check += fread(&count, sizeof(uint32), 1, rf);
-    objects.resize(count); // = new uint32[nObjects];
-    check += fread(&objects[0], sizeof(uint32), count, rf);
+    std::vector<uint32> tempObjects(count);
+    if (count)
+        check += fread(&tempObjects[0], sizeof(uint32), count, rf);
+    tree.swap(tempTree);
+    objects.swap(tempObjects);
     return check == (3 + 3 + 2 + treeSize + count);
 }
 
@@ -26,6 +26,9 @@
 
 #include <Platform/Define.h>
 
+#include "RayPacket.h"
+#include "FlatArray.h"
+
 #include <stdexcept>
 #include <vector>
 #include <algorithm>
@@ -82,8 +85,8 @@ class BIH
 {
     public:
         BIH() {};
-        template< class T, class BoundsFunc >
-        void build(const std::vector<T> &primitives, BoundsFunc &getBounds, uint32 leafSize = 3, bool printStats=false)
+        template< class PrimArray, class BoundsFunc >
+        void build(const PrimArray &primitives, BoundsFunc &getBounds, uint32 leafSize = 3, bool printStats=false)
         {
             if (primitives.size() == 0)
                 return;
@@ -106,11 +109,9 @@ class BIH
             if (printStats)
                 stats.printStats();
 
-            objects.resize(dat.numPrims);
-            for (uint32 i=0; i<dat.numPrims; ++i)
-                objects[i] = dat.indices[i];
-            //nObjects = dat.numPrims;
-            tree = tempTree;
+            std::vector<uint32> tempObjects(dat.indices, dat.indices + dat.numPrims);
+            objects.swap(tempObjects);
+            tree.swap(tempTree);
             delete[] dat.primBound;
             delete[] dat.indices;
         }
@@ -255,6 +256,140 @@ class BIH
             }
         }
 
+        /* Same traversal as intersectRay for the rays of mask together, the nodes
+           are clipped for all lanes at once. The callback gets the packet, the
+           entry and the lanes that reach it and returns the lanes it hit. With
+           stopAtFirst a lane that hit something is not traced any further. */
+        template<typename PacketCallback>
+        void intersectRayPacket(RayPacket &packet, PacketCallback& intersectCallback, uint32 mask, bool stopAtFirst=false) const
+        {
+            if (tree.empty())
+                return;
+
+            RayLanes org[3], invDir[3];
+            uint32 negative[3];
+            for (int i=0; i<3; ++i)
+            {
+                org[i] = RayLanes::load(packet.org[i]);
+                invDir[i] = RayLanes::load(packet.invDir[i]);
+                negative[i] = RayLanes::load(packet.dir[i]).signs();
+            }
+
+            RayLanes intervalMin(0.f);
+            RayLanes intervalMax = RayLanes::load(packet.maxDist);
+            for (int i=0; i<3; ++i)
+            {
+                RayLanes t1 = (RayLanes(bounds.low()[i]) - org[i]) * invDir[i];
+                RayLanes t2 = (RayLanes(bounds.high()[i]) - org[i]) * invDir[i];
+                intervalMin = RayLanes::max(intervalMin, RayLanes::min(t1, t2));
+                intervalMax = RayLanes::min(intervalMax, RayLanes::max(t1, t2));
+            }
+
+            uint32 live = mask;
+            mask &= RayLanes::lessEqual(intervalMin, intervalMax);
+
+            PacketStackNode stack[MAX_STACK_SIZE];
+            int stackPos = 0;
+            int node = 0;
+
+            while (true) {
+                while (mask)
+                {
+                    uint32 tn = tree[node];
+                    uint32 axis = (tn & (3 << 30)) >> 30;
+                    bool BVH2 = tn & (1 << 29);
+                    int offset = tn & ~(7 << 29);
+                    if (!BVH2)
+                    {
+                        if (axis < 3)
+                        {
+                            // "normal" interior node, the left child ends at the first
+                            // clip plane and the right one starts at the second
+                            RayLanes tl = (RayLanes(intBitsToFloat(tree[node + 1])) - org[axis]) * invDir[axis];
+                            RayLanes tr = (RayLanes(intBitsToFloat(tree[node + 2])) - org[axis]) * invDir[axis];
+                            uint32 neg = negative[axis];
+                            RayLanes leftMin = RayLanes::select(neg, RayLanes::max(intervalMin, tl), intervalMin);
+                            RayLanes leftMax = RayLanes::select(neg, intervalMax, RayLanes::min(intervalMax, tl));
+                            RayLanes rightMin = RayLanes::select(neg, intervalMin, RayLanes::max(intervalMin, tr));
+                            RayLanes rightMax = RayLanes::select(neg, RayLanes::min(intervalMax, tr), intervalMax);
+                            uint32 leftMask = mask & RayLanes::lessEqual(leftMin, leftMax);
+                            uint32 rightMask = mask & RayLanes::lessEqual(rightMin, rightMax);
+
+                            // rays pass between clip zones
+                            if (!leftMask && !rightMask)
+                                break;
+                            if (!rightMask)
+                            {
+                                node = offset;
+                                intervalMin = leftMin; intervalMax = leftMax; mask = leftMask;
+                                continue;
+                            }
+                            if (!leftMask)
+                            {
+                                node = offset + 3;
+                                intervalMin = rightMin; intervalMax = rightMax; mask = rightMask;
+                                continue;
+                            }
+
+                            // rays pass through both nodes, the first ray decides which is near
+                            bool rightFirst = (neg & mask & -mask) != 0;
+                            PacketStackNode& back = stack[stackPos++];
+                            back.node = rightFirst ? offset : offset + 3;
+                            back.tnear = rightFirst ? leftMin : rightMin;
+                            back.tfar = rightFirst ? leftMax : rightMax;
+                            back.mask = rightFirst ? leftMask : rightMask;
+
+                            node = rightFirst ? offset + 3 : offset;
+                            intervalMin = rightFirst ? rightMin : leftMin;
+                            intervalMax = rightFirst ? rightMax : leftMax;
+                            mask = rightFirst ? rightMask : leftMask;
+                            continue;
+                        }
+                        else
+                        {
+                            // leaf - test some objects
+                            int n = tree[node + 1];
+                            while (n > 0 && mask) {
+                                uint32 hit = intersectCallback(packet, objects[offset], mask, stopAtFirst);
+                                if (stopAtFirst)
+                                {
+                                    live &= ~hit;
+                                    mask &= ~hit;
+                                }
+                                --n;
+                                ++offset;
+                            }
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        if (axis>2)
+                            return; // should not happen
+                        RayLanes t1 = (RayLanes(intBitsToFloat(tree[node + 1])) - org[axis]) * invDir[axis];
+                        RayLanes t2 = (RayLanes(intBitsToFloat(tree[node + 2])) - org[axis]) * invDir[axis];
+                        node = offset;
+                        intervalMin = RayLanes::max(intervalMin, RayLanes::min(t1, t2));
+                        intervalMax = RayLanes::min(intervalMax, RayLanes::max(t1, t2));
+                        mask &= RayLanes::lessEqual(intervalMin, intervalMax);
+                        continue;
+                    }
+                } // traversal loop
+                do
+                {
+                    // stack is empty?
+                    if (stackPos == 0 || !live)
+                        return;
+                    // move back up the stack, the hits may have shortened the rays meanwhile
+                    stackPos--;
+                    intervalMin = stack[stackPos].tnear;
+                    intervalMax = RayLanes::min(stack[stackPos].tfar, RayLanes::load(packet.maxDist));
+                    mask = stack[stackPos].mask & live & RayLanes::lessEqual(intervalMin, intervalMax);
+                    node = stack[stackPos].node;
+                } while (!mask);
+            }
+        }
+
         template<typename IsectCallback>
         void intersectPoint(const Vector3 &p, IsectCallback& intersectCallback) const
         {
@@ -336,9 +471,20 @@ class BIH
         bool writeToFile(FILE *wf) const;
         bool readFromFile(FILE *rf);
 
+        // the flat model files store the arrays as they are, see WorldModel::writeFile()
+        const AABox& getBounds() const { return bounds; }
+        const FlatArray<uint32>& getTree() const { return tree; }
+        const FlatArray<uint32>& getObjects() const { return objects; }
+        void setView(const AABox &box, const uint32 *treeData, uint32 treeSize, const uint32 *objectData, uint32 count)
+        {
+            bounds = box;
+            tree.setView(treeData, treeSize);
+            objects.setView(objectData, count);
+        }
+
     protected:
-        std::vector<uint32> tree;
-        std::vector<uint32> objects;
+        FlatArray<uint32> tree;
+        FlatArray<uint32> objects;
         AABox bounds;
 
         struct buildData
@@ -354,6 +500,13 @@ class BIH
             float tnear;
             float tfar;
         };
+        struct PacketStackNode
+        {
+            RayLanes tnear;
+            RayLanes tfar;
+            uint32 node;
+            uint32 mask;
+        };
 
         class BuildStats
         {
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ * Copyright (C) 2008-2012 TrinityCore <http://www.trinitycore.org/>
+ * Copyright (C) 2005-2012 MaNGOS <http://getmangos.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _FLATARRAY_H
+#define _FLATARRAY_H
+
+#include <Platform/Define.h>
+
+#include <vector>
+
+/* Read only array that either owns its elements or views elements owned by
+   someone else, like the mapped model files. Copies of a view share the
+   viewed memory, copies of an owning array copy the elements. */
+template<class T>
+class FlatArray
+{
+    public:
+        FlatArray() : iData(NULL), iSize(0), iOwned(true) {}
+        FlatArray(const FlatArray &other) : iData(NULL), iSize(0), iOwned(true) { *this = other; }
+
+        FlatArray& operator=(const FlatArray &other)
+        {
+            if (this == &other)
+                return *this;
+            iStorage = other.iStorage;
+            iOwned = other.iOwned;
+            iData = iOwned ? (iStorage.empty() ? NULL : &iStorage[0]) : other.iData;
+            iSize = other.iSize;
+            return *this;
+        }
+
+        // takes the elements of v, which gets the old ones if they were owned
+        void swap(std::vector<T> &v)
+        {
+            if (!iOwned)
+                iStorage.clear();
+            iStorage.swap(v);
+            iOwned = true;
+            iData = iStorage.empty() ? NULL : &iStorage[0];
+            iSize = uint32(iStorage.size());
+        }
+
+        void setView(const T *data, uint32 size)
+        {
+            std::vector<T>().swap(iStorage);
+            iOwned = false;
+            iData = data;
+            iSize = size;
+        }
+
+        void clear() { std::vector<T> empty; swap(empty); }
+
+        uint32 size() const { return iSize; }
+        bool empty() const { return iSize == 0; }
+        const T* begin() const { return iData; }
+        const T& operator[](size_t i) const { return iData[i]; }
+
+    private:
+        std::vector<T> iStorage;
+        const T *iData;
+        uint32 iSize;
+        bool iOwned;
+};
+
+#endif // _FLATARRAY_H
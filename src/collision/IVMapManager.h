@@ -21,6 +21,7 @@
 #define _IVMAPMANAGER_H
 
 #include <string>
+#include <vector>
 #include <Platform/Define.h>
 
 // This is the minimum interface to the VMapMamager.
@@ -38,6 +39,18 @@ namespace VMAP
     #define VMAP_INVALID_HEIGHT       -100000.0f            // for check
     #define VMAP_INVALID_HEIGHT_VALUE -200000.0f            // real assigned value in unknown height case
 
+    struct VMapQueryCacheStats
+    {
+        VMapQueryCacheStats() : size(0), losHits(0), losMisses(0), heightHits(0), heightMisses(0), invalidations(0) {}
+
+        uint32 size;                                        // entries, 0 if disabled
+        uint64 losHits;
+        uint64 losMisses;
+        uint64 heightHits;
+        uint64 heightMisses;
+        uint64 invalidations;                               // tiles loaded or unloaded
+    };
+
     class IVMapManager
     {
         private:
@@ -59,6 +72,14 @@ namespace VMAP
             virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) = 0;
             virtual float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist) = 0;
             /*
+            line of sight from one point to count others, for the spells hitting many targets at once
+            */
+            virtual void isInLineOfSightBatch(unsigned int pMapId, float x1, float y1, float z1, float const* x2, float const* y2, float const* z2, bool* results, uint32 count)
+            {
+                for (uint32 i = 0; i < count; ++i)
+                    results[i] = isInLineOfSight(pMapId, x1, y1, z1, x2[i], y2[i], z2[i]);
+            }
+            /*
             test if we hit an object. return true if we hit one. rx,ry,rz will hold the hit position or the dest position, if no intersection was found
             return a position, that is pReduceDist closer to the origin
             */
@@ -90,6 +111,20 @@ namespace VMAP
             */
             virtual bool getAreaInfo(unsigned int pMapId, float x, float y, float &z, uint32 &flags, int32 &adtId, int32 &rootId, int32 &groupId) const=0;
             virtual bool GetLiquidLevel(uint32 pMapId, float x, float y, float z, uint8 ReqLiquidType, float &level, float &floor, uint32 &type) const=0;
+
+            /*
+            Read the models of a tile ahead of loadMap(), may be called from any thread.
+            The names of the acquired models are appended to modelNames, they stay loaded until released.
+            */
+            virtual void preloadMapTile(const char* /*pBasePath*/, unsigned int /*pMapId*/, int /*x*/, int /*y*/, std::vector<std::string>& /*modelNames*/) {}
+            virtual void releasePreloadedModels(std::vector<std::string> const& /*modelNames*/) {}
+
+            /*
+            Cache of the line of sight and height results, 0 entries disable it.
+            */
+            virtual void setQueryCacheSize(uint32 /*entries*/) {}
+            virtual VMapQueryCacheStats getQueryCacheStats() { return VMapQueryCacheStats(); }
+            virtual void resetQueryCacheStats() {}
     };
 
 }
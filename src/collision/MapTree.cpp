@@ -49,6 +49,22 @@ namespace VMAP
             bool hit;
     };
 
+    class MapPacketCallback
+    {
+        public:
+            MapPacketCallback(ModelInstance *val): prims(val), hits(0) {}
+            uint32 operator()(RayPacket& packet, uint32 entry, uint32 mask, bool pStopAtFirstHit=true)
+            {
+                uint32 result = prims[entry].intersectRayPacket(packet, mask, pStopAtFirstHit);
+                hits |= result;
+                return result;
+            }
+            uint32 getHits() { return hits; }
+        protected:
+            ModelInstance *prims;
+            uint32 hits;
+    };
+
     class AreaInfoCallback
     {
         public:
@@ -162,6 +178,39 @@ namespace VMAP
         return true;
     }
 
+    void StaticMapTree::isInLineOfSight(const Vector3& pos1, const Vector3* pos2, bool* results, uint32 count) const
+    {
+        for (uint32 first = 0; first < count; first += RAY_PACKET_SIZE)
+        {
+            RayPacket packet;
+            uint32 mask = 0;
+            for (uint32 i = 0; i < RAY_PACKET_SIZE; ++i)
+            {
+                uint32 idx = first + i;
+                float maxDist = idx < count ? (pos2[idx] - pos1).magnitude() : 0.f;
+                ASSERT(maxDist < std::numeric_limits<float>::max());
+                if (idx < count)
+                    results[idx] = true;
+                // see isInLineOfSight() for the NaN
+                if (maxDist < 1e-10f)
+                {
+                    packet.clearRay(i);
+                    continue;
+                }
+                packet.setRay(i, pos1, (pos2[idx] - pos1)/maxDist, maxDist);
+                mask |= 1 << i;
+            }
+            if (!mask)
+                continue;
+
+            MapPacketCallback intersectionCallBack(iTreeValues);
+            iTree.intersectRayPacket(packet, intersectionCallBack, mask, true);
+            for (uint32 i = 0; i < RAY_PACKET_SIZE; ++i)
+                if (intersectionCallBack.getHits() & (1 << i))
+                    results[first + i] = false;
+        }
+    }
+
     /*
     When moving from pos1 to pos2 check if we hit an object. Return true and the position if we hit one
     Return the hit pos or the original dest pos
@@ -63,6 +63,38 @@ namespace VMAP
         return hit;
     }
 
+    uint32 ModelInstance::intersectRayPacket(RayPacket& pPacket, uint32 pMask, bool pStopAtFirstHit) const
+    {
+        if (!iModel)
+            return 0;
+
+        // same per ray transform as intersectRay, only the model is traced with the packet
+        RayPacket modPacket;
+        uint32 mask = 0;
+        for (uint32 i = 0; i < RAY_PACKET_SIZE; ++i)
+        {
+            if (pMask & (1 << i))
+            {
+                G3D::Ray ray = pPacket.getRay(i);
+                if (ray.intersectionTime(iBound) != G3D::inf())
+                {
+                    modPacket.setRay(i, iInvRot * (ray.origin() - iPos) * iInvScale, iInvRot * ray.direction(), pPacket.maxDist[i] * iInvScale);
+                    mask |= 1 << i;
+                    continue;
+                }
+            }
+            modPacket.clearRay(i);
+        }
+        if (!mask)
+            return 0;
+
+        uint32 hits = iModel->IntersectRayPacket(modPacket, mask, pStopAtFirstHit);
+        for (uint32 i = 0; i < RAY_PACKET_SIZE; ++i)
+            if (hits & (1 << i))
+                pPacket.maxDist[i] = modPacket.maxDist[i] * iScale;
+        return hits;
+    }
+
     void ModelInstance::intersectPoint(const G3D::Vector3& p, AreaInfo &info) const
     {
         if (!iModel)
@@ -26,6 +26,7 @@
 #include <G3D/Ray.h>
 
 #include "Platform/Define.h"
+#include "RayPacket.h"
 
 namespace VMAP
 {
@@ -69,6 +70,7 @@ namespace VMAP
             ModelInstance(const ModelSpawn &spawn, WorldModel *model);
             void setUnloaded() { iModel = 0; }
             bool intersectRay(const G3D::Ray& pRay, float& pMaxDist, bool pStopAtFirstHit) const;
+            uint32 intersectRayPacket(RayPacket& pPacket, uint32 pMask, bool pStopAtFirstHit) const;
             void intersectPoint(const G3D::Vector3& p, AreaInfo &info) const;
             bool GetLocationInfo(const G3D::Vector3& p, LocationInfo &info) const;
             bool GetLiquidLevel(const G3D::Vector3& p, LocationInfo &info, float &liqHeight) const;
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ * Copyright (C) 2008-2012 TrinityCore <http://www.trinitycore.org/>
+ * Copyright (C) 2005-2012 MaNGOS <http://getmangos.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _RAYPACKET_H
+#define _RAYPACKET_H
+
+#include <G3D/Vector3.h>
+#include <G3D/Ray.h>
+
+#include <Platform/Define.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RAYPACKET_SSE2
+#include <emmintrin.h>
+#endif
+
+#define RAY_PACKET_SIZE 4
+#define RAY_PACKET_ALL  ((1 << RAY_PACKET_SIZE) - 1)
+
+/* One float per ray of a packet. Lane masks are bit masks, bit i for ray i.
+   min and max return the second value if either is NaN, like minps/maxps. */
+struct RayLanes
+{
+#ifdef RAYPACKET_SSE2
+    __m128 v;
+
+    RayLanes() {}
+    RayLanes(__m128 _v) : v(_v) {}
+    explicit RayLanes(float f) : v(_mm_set1_ps(f)) {}
+
+    static RayLanes load(float const* p) { return _mm_loadu_ps(p); }
+    void store(float* p) const { _mm_storeu_ps(p, v); }
+
+    RayLanes operator+(RayLanes const& o) const { return _mm_add_ps(v, o.v); }
+    RayLanes operator-(RayLanes const& o) const { return _mm_sub_ps(v, o.v); }
+    RayLanes operator*(RayLanes const& o) const { return _mm_mul_ps(v, o.v); }
+    RayLanes operator/(RayLanes const& o) const { return _mm_div_ps(v, o.v); }
+
+    static RayLanes min(RayLanes const& a, RayLanes const& b) { return _mm_min_ps(a.v, b.v); }
+    static RayLanes max(RayLanes const& a, RayLanes const& b) { return _mm_max_ps(a.v, b.v); }
+    static RayLanes abs(RayLanes const& a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+
+    static uint32 less(RayLanes const& a, RayLanes const& b) { return _mm_movemask_ps(_mm_cmplt_ps(a.v, b.v)); }
+    static uint32 lessEqual(RayLanes const& a, RayLanes const& b) { return _mm_movemask_ps(_mm_cmple_ps(a.v, b.v)); }
+    uint32 signs() const { return _mm_movemask_ps(v); }
+
+    // a in the lanes of mask, b in the others
+    static RayLanes select(uint32 mask, RayLanes const& a, RayLanes const& b)
+    {
+        __m128 m = _mm_castsi128_ps(_mm_set_epi32(-int32((mask >> 3) & 1), -int32((mask >> 2) & 1), -int32((mask >> 1) & 1), -int32(mask & 1)));
+        return _mm_or_ps(_mm_and_ps(m, a.v), _mm_andnot_ps(m, b.v));
+    }
+#else
+    float v[RAY_PACKET_SIZE];
+
+    RayLanes() {}
+    explicit RayLanes(float f) { for (int i = 0; i < RAY_PACKET_SIZE; ++i) v[i] = f; }
+
+    static RayLanes load(float const* p) { RayLanes r; for (int i = 0; i < RAY_PACKET_SIZE; ++i) r.v[i] = p[i]; return r; }
+    void store(float* p) const { for (int i = 0; i < RAY_PACKET_SIZE; ++i) p[i] = v[i]; }
+
+    RayLanes operator+(RayLanes const& o) const { RayLanes r; for (int i = 0; i < RAY_PACKET_SIZE; ++i) r.v[i] = v[i] + o.v[i]; return r; }
+    RayLanes operator-(RayLanes const& o) const { RayLanes r; for (int i = 0; i < RAY_PACKET_SIZE; ++i) r.v[i] = v[i] - o.v[i]; return r; }
+    RayLanes operator*(RayLanes const& o) const { RayLanes r; for (int i = 0; i < RAY_PACKET_SIZE; ++i) r.v[i] = v[i] * o.v[i]; return r; }
+    RayLanes operator/(RayLanes const& o) const { RayLanes r; for (int i = 0; i < RAY_PACKET_SIZE; ++i) r.v[i] = v[i] / o.v[i]; return r; }
+
+    static RayLanes min(RayLanes const& a, RayLanes const& b) { RayLanes r; for (int i = 0; i < RAY_PACKET_SIZE; ++i) r.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i]; return r; }
+    static RayLanes max(RayLanes const& a, RayLanes const& b) { RayLanes r; for (int i = 0; i < RAY_PACKET_SIZE; ++i) r.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i]; return r; }
+    static RayLanes abs(RayLanes const& a) { RayLanes r; for (int i = 0; i < RAY_PACKET_SIZE; ++i) r.v[i] = fabs(a.v[i]); return r; }
+
+    static uint32 less(RayLanes const& a, RayLanes const& b) { uint32 m = 0; for (int i = 0; i < RAY_PACKET_SIZE; ++i) if (a.v[i] < b.v[i]) m |= 1 << i; return m; }
+    static uint32 lessEqual(RayLanes const& a, RayLanes const& b) { uint32 m = 0; for (int i = 0; i < RAY_PACKET_SIZE; ++i) if (a.v[i] <= b.v[i]) m |= 1 << i; return m; }
+    uint32 signs() const { uint32 m = 0; for (int i = 0; i < RAY_PACKET_SIZE; ++i) if (v[i] < 0.0f || (v[i] == 0.0f && 1.0f / v[i] < 0.0f)) m |= 1 << i; return m; }
+
+    static RayLanes select(uint32 mask, RayLanes const& a, RayLanes const& b) { RayLanes r; for (int i = 0; i < RAY_PACKET_SIZE; ++i) r.v[i] = (mask & (1 << i)) ? a.v[i] : b.v[i]; return r; }
+#endif
+};
+
+/* Up to RAY_PACKET_SIZE rays traced together, stored lane by lane. maxDist
+   works like the maxDist of BIH::intersectRay and shrinks to the hits. */
+struct RayPacket
+{
+    float org[3][RAY_PACKET_SIZE];
+    float dir[3][RAY_PACKET_SIZE];
+    float invDir[3][RAY_PACKET_SIZE];
+    float maxDist[RAY_PACKET_SIZE];
+
+    void setRay(uint32 lane, G3D::Vector3 const& origin, G3D::Vector3 const& direction, float dist)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            org[i][lane] = origin[i];
+            dir[i][lane] = direction[i];
+            // a zero component would turn the clip distances of planes through the origin into NaN
+            invDir[i][lane] = 1.f / (direction[i] != 0.f ? direction[i] : 1e-30f);
+        }
+        maxDist[lane] = dist;
+    }
+
+    // lanes not in mask keep arbitrary but finite values, so the vector math stays quiet
+    void clearRay(uint32 lane)
+    {
+        setRay(lane, G3D::Vector3(0.f, 0.f, 0.f), G3D::Vector3(0.f, 0.f, 1.f), 0.f);
+    }
+
+    G3D::Ray getRay(uint32 lane) const
+    {
+        return G3D::Ray::fromOriginAndDirection(G3D::Vector3(org[0][lane], org[1][lane], org[2][lane]),
+            G3D::Vector3(dir[0][lane], dir[1][lane], dir[2][lane]));
+    }
+};
+
+#endif // _RAYPACKET_H
@@ -26,6 +26,8 @@
 namespace VMAP
 {
     const char VMAP_MAGIC[] = "VMAP_3.0";
+    // model files in the flat layout, see WorldModel::writeFile()
+    const char VMAP_FLAT_MAGIC[] = "VMAPF3.0";
 
     // defined in TileAssembler.cpp currently...
     bool readChunk(FILE *rf, char *dest, const char *compare, uint32 len);
@@ -27,6 +27,8 @@
 #include "WorldModel.h"
 #include "VMapDefinitions.h"
 
+#include <ace/Guard_T.h>
+
 using G3D::Vector3;
 
 namespace VMAP
@@ -45,6 +47,7 @@ namespace VMAP
         for (ModelFileMap::iterator i = iLoadedModelFiles.begin(); i != iLoadedModelFiles.end(); ++i)
         {
             delete i->second.getModel();
+            delete i->second.getFile();
         }
     }
 
@@ -88,6 +91,8 @@ namespace VMAP
                 result = VMAP_LOAD_RESULT_OK;
             else
                 result = VMAP_LOAD_RESULT_ERROR;
+            // after the tree changed, so results computed meanwhile are not kept
+            iQueryCache.invalidate(pMapId);
         }
         return result;
     }
@@ -119,6 +124,7 @@ namespace VMAP
                 iInstanceMapTrees.erase(pMapId);
             }
         }
+        iQueryCache.invalidate(pMapId);
     }
 
     void VMapManager2::unloadMap(unsigned int  pMapId, int x, int y)
@@ -133,6 +139,7 @@ namespace VMAP
                 iInstanceMapTrees.erase(pMapId);
             }
         }
+        iQueryCache.invalidate(pMapId);
     }
 
     bool VMapManager2::isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2)
@@ -146,12 +153,68 @@ namespace VMAP
             Vector3 pos2 = convertPositionToInternalRep(x2,y2,z2);
             if (pos1 != pos2)
             {
+                uint32 generation = 0;
+                bool cached = iQueryCache.isEnabled();
+                if (cached && iQueryCache.getLineOfSight(pMapId, x1, y1, z1, x2, y2, z2, result, generation))
+                    return result;
+
                 result = instanceTree->second->isInLineOfSight(pos1, pos2);
+
+                if (cached)
+                    iQueryCache.storeLineOfSight(pMapId, x1, y1, z1, x2, y2, z2, result, generation);
             }
         }
         return result;
     }
 
+    void VMapManager2::isInLineOfSightBatch(unsigned int pMapId, float x1, float y1, float z1, float const* x2, float const* y2, float const* z2, bool* results, uint32 count)
+    {
+        for (uint32 i = 0; i < count; ++i)
+            results[i] = true;
+
+        if (!isLineOfSightCalcEnabled())
+            return;
+        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
+        if (instanceTree == iInstanceMapTrees.end())
+            return;
+
+        Vector3 pos1 = convertPositionToInternalRep(x1, y1, z1);
+        bool cached = iQueryCache.isEnabled();
+
+        std::vector<uint32> traced;
+        std::vector<Vector3> targets;
+        std::vector<uint32> generations;
+        traced.reserve(count);
+        targets.reserve(count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            Vector3 pos2 = convertPositionToInternalRep(x2[i], y2[i], z2[i]);
+            if (pos1 == pos2)
+                continue;
+
+            uint32 generation = 0;
+            if (cached && iQueryCache.getLineOfSight(pMapId, x1, y1, z1, x2[i], y2[i], z2[i], results[i], generation))
+                continue;
+
+            traced.push_back(i);
+            targets.push_back(pos2);
+            generations.push_back(generation);
+        }
+        if (traced.empty())
+            return;
+
+        bool* tracedResults = new bool[traced.size()];
+        instanceTree->second->isInLineOfSight(pos1, &targets[0], tracedResults, traced.size());
+        for (size_t j = 0; j < traced.size(); ++j)
+        {
+            uint32 i = traced[j];
+            results[i] = tracedResults[j];
+            if (cached)
+                iQueryCache.storeLineOfSight(pMapId, x1, y1, z1, x2[i], y2[i], z2[i], results[i], generations[j]);
+        }
+        delete[] tracedResults;
+    }
+
     /*
     get the hit position and return true if we hit something
     otherwise the result pos will be the dest pos
@@ -189,12 +252,20 @@ namespace VMAP
             InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
             if (instanceTree != iInstanceMapTrees.end())
             {
+                uint32 generation = 0;
+                bool cached = iQueryCache.isEnabled();
+                if (cached && iQueryCache.getHeight(pMapId, x, y, z, maxSearchDist, height, generation))
+                    return height;
+
                 Vector3 pos = convertPositionToInternalRep(x,y,z);
                 height = instanceTree->second->getHeight(pos, maxSearchDist);
                 if (!(height < G3D::inf()))
                 {
                     height = VMAP_INVALID_HEIGHT_VALUE;         //no height
                 }
+
+                if (cached)
+                    iQueryCache.storeHeight(pMapId, x, y, z, maxSearchDist, height, generation);
             }
         }
         return height;
@@ -236,38 +307,126 @@ namespace VMAP
 
     WorldModel* VMapManager2::acquireModelInstance(const std::string &basepath, const std::string &filename)
     {
-        ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
-        if (model == iLoadedModelFiles.end())
         {
-            WorldModel *worldmodel = new WorldModel();
-            if (!worldmodel->readFile(basepath + filename + ".vmo"))
+            ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, iLoadedModelFilesLock, NULL);
+            ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
+            if (model != iLoadedModelFiles.end())
+            {
+                model->second.incRefCount();
+                return model->second.getModel();
+            }
+        }
+
+        // read the file unlocked, another thread may load the same model meanwhile.
+        // Files of the flat layout are mapped and used in place, so the pages are
+        // shared with the page cache and only read when a ray gets there.
+        std::string path = basepath + filename + ".vmo";
+        WorldModel *worldmodel = new WorldModel();
+        ACE_Mem_Map *file = new ACE_Mem_Map();
+        if (file->map(path.c_str(), static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_READ, ACE_MAP_SHARED) != -1 &&
+            worldmodel->readFlat(static_cast<const uint8*>(file->addr()), uint32(file->size())))
+            file->close_handle();
+        else
+        {
+            delete file;
+            file = NULL;
+            if (!worldmodel->readFile(path))
             {
-                ERROR_LOG("VMapManager2: could not load '%s%s.vmo'!", basepath.c_str(), filename.c_str());
+                ERROR_LOG("VMapManager2: could not load '%s'!", path.c_str());
                 delete worldmodel;
                 return NULL;
             }
-            DEBUG_LOG("VMapManager2: loading file '%s%s'.", basepath.c_str(), filename.c_str());
-            model = iLoadedModelFiles.insert(std::pair<std::string, ManagedModel>(filename, ManagedModel())).first;
-            model->second.setModel(worldmodel);
         }
-        model->second.incRefCount();
-        return model->second.getModel();
+        DEBUG_LOG("VMapManager2: loading file '%s%s'.", basepath.c_str(), filename.c_str());
+
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, iLoadedModelFilesLock, NULL);
+        std::pair<ModelFileMap::iterator, bool> model = iLoadedModelFiles.insert(std::pair<std::string, ManagedModel>(filename, ManagedModel()));
+        if (model.second)
+        {
+            model.first->second.setModel(worldmodel);
+            model.first->second.setFile(file);
+        }
+        else
+        {
+            delete worldmodel;
+            delete file;
+        }
+        model.first->second.incRefCount();
+        return model.first->second.getModel();
     }
 
     void VMapManager2::releaseModelInstance(const std::string &filename)
     {
-        ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
-        if (model == iLoadedModelFiles.end())
+        WorldModel *unloaded = NULL;
+        ACE_Mem_Map *file = NULL;
         {
-            ERROR_LOG("VMapManager2: trying to unload non-loaded file '%s'!", filename.c_str());
-            return;
+            ACE_GUARD(ACE_Thread_Mutex, guard, iLoadedModelFilesLock);
+            ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
+            if (model == iLoadedModelFiles.end())
+            {
+                ERROR_LOG("VMapManager2: trying to unload non-loaded file '%s'!", filename.c_str());
+                return;
+            }
+            if (model->second.decRefCount() == 0)
+            {
+                unloaded = model->second.getModel();
+                file = model->second.getFile();
+                iLoadedModelFiles.erase(model);
+            }
         }
-        if (model->second.decRefCount() == 0)
+        if (unloaded)
         {
             DEBUG_LOG("VMapManager2: unloading file '%s'", filename.c_str());
-            delete model->second.getModel();
-            iLoadedModelFiles.erase(model);
+            delete unloaded;
+            delete file;
+        }
+    }
+
+    // Only the model references of the tile are taken, the tree itself is
+    // built later by loadMap() on the thread of the map which then finds the
+    // models already in memory.
+    void VMapManager2::preloadMapTile(const char* pBasePath, unsigned int pMapId, int x, int y, std::vector<std::string>& modelNames)
+    {
+        if (!isMapLoadingEnabled())
+            return;
+
+        std::string basePath = pBasePath;
+        if (basePath.length() > 0 && basePath[basePath.length()-1] != '/')
+            basePath.append("/");
+
+        FILE* tf = fopen((basePath + StaticMapTree::getTileFileName(pMapId, x, y)).c_str(), "rb");
+        if (!tf)
+            return;                                         // not tiled or no models here
+
+        char chunk[8];
+        uint32 numSpawns;
+        if (readChunk(tf, chunk, VMAP_MAGIC, 8) && fread(&numSpawns, sizeof(uint32), 1, tf) == 1)
+        {
+            for (uint32 i = 0; i < numSpawns; ++i)
+            {
+                ModelSpawn spawn;
+                uint32 referencedVal;
+                if (!ModelSpawn::readFromFile(tf, spawn) || fread(&referencedVal, sizeof(uint32), 1, tf) != 1)
+                    break;
+
+                if (acquireModelInstance(basePath, spawn.name))
+                    modelNames.push_back(spawn.name);
+            }
         }
+        fclose(tf);
+    }
+
+    void VMapManager2::releasePreloadedModels(std::vector<std::string> const& modelNames)
+    {
+        for (std::vector<std::string>::const_iterator itr = modelNames.begin(); itr != modelNames.end(); ++itr)
+            releaseModelInstance(*itr);
+    }
+
+    VMapQueryCacheStats VMapManager2::getQueryCacheStats()
+    {
+        VMapQueryCacheStats stats;
+        iQueryCache.getStats(stats);
+        return stats;
     }
 
     bool VMapManager2::existsMap(const char* pBasePath, unsigned int pMapId, int x, int y)
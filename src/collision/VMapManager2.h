@@ -21,9 +21,12 @@
 #define _VMAPMANAGER2_H
 
 #include "IVMapManager.h"
+#include "VMapQueryCache.h"
 #include "Utilities/UnorderedMap.h"
 #include "Platform/Define.h"
 #include <G3D/Vector3.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Mem_Map.h>
 
 #define MAP_FILENAME_EXTENSION2 ".vmtree"
 
@@ -45,13 +48,17 @@ namespace VMAP
     class ManagedModel
     {
         public:
-            ManagedModel(): iModel(0), iRefCount(0) {}
+            ManagedModel(): iModel(0), iFile(0), iRefCount(0) {}
             void setModel(WorldModel *model) { iModel = model; }
             WorldModel *getModel() { return iModel; }
+            // the mapped file a flat model uses in place, must be deleted after the model
+            void setFile(ACE_Mem_Map *file) { iFile = file; }
+            ACE_Mem_Map *getFile() { return iFile; }
             void incRefCount() { ++iRefCount; }
             int decRefCount() { return --iRefCount; }
         protected:
             WorldModel *iModel;
+            ACE_Mem_Map *iFile;
             int iRefCount;
     };
 
@@ -63,7 +70,10 @@ namespace VMAP
         protected:
             // Tree to check collision
             ModelFileMap iLoadedModelFiles;
+            // models are acquired by the map threads and the grid preloader
+            ACE_Thread_Mutex iLoadedModelFilesLock;
             InstanceTreeMap iInstanceMapTrees;
+            VMapQueryCache iQueryCache;
 
             bool _loadMap(uint32 pMapId, const std::string &basePath, uint32 tileX, uint32 tileY);
             /* void _unloadMap(uint32 pMapId, uint32 x, uint32 y); */
@@ -83,6 +93,8 @@ namespace VMAP
             void unloadMap(unsigned int pMapId);
 
             bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) ;
+            // traces the rays missing in the query cache in packets
+            void isInLineOfSightBatch(unsigned int pMapId, float x1, float y1, float z1, float const* x2, float const* y2, float const* z2, bool* results, uint32 count);
             // fill the hit pos and return true, if an object was hit
             bool getObjectHitPos(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float &ry, float& rz, float pModifyDist);
             float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist);
@@ -95,6 +107,13 @@ namespace VMAP
             WorldModel* acquireModelInstance(const std::string &basepath, const std::string &filename);
             void releaseModelInstance(const std::string &filename);
 
+            void preloadMapTile(const char* pBasePath, unsigned int pMapId, int x, int y, std::vector<std::string>& modelNames);
+            void releasePreloadedModels(std::vector<std::string> const& modelNames);
+
+            void setQueryCacheSize(uint32 entries) { iQueryCache.setSize(entries); }
+            VMapQueryCacheStats getQueryCacheStats();
+            void resetQueryCacheStats() { iQueryCache.resetStats(); }
+
             // what's the use of this? o.O
             virtual std::string getDirFileName(unsigned int pMapId, int /*x*/, int /*y*/) const
             {
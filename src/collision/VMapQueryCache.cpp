@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ * Copyright (C) 2008-2012 TrinityCore <http://www.trinitycore.org/>
+ * Copyright (C) 2005-2012 MaNGOS <http://getmangos.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "VMapQueryCache.h"
+#include "IVMapManager.h"
+
+#include <ace/Guard_T.h>
+#include <cmath>
+
+namespace VMAP
+{
+    bool VMapQueryCache::Key::operator==(Key const& other) const
+    {
+        if (mapId != other.mapId || type != other.type)
+            return false;
+        for (int i = 0; i < 6; ++i)
+            if (coords[i] != other.coords[i])
+                return false;
+        return true;
+    }
+
+    VMapQueryCache::VMapQueryCache() : iMask(0), iInvalidations(0)
+    {
+        for (int i = 0; i < VMAP_QUERY_CACHE_GENERATIONS; ++i)
+            iGenerations[i] = 0;
+    }
+
+    void VMapQueryCache::setSize(uint32 entries)
+    {
+        // round down to a power of two, every stripe gets at least one entry
+        uint32 size = 0;
+        if (entries)
+        {
+            size = VMAP_QUERY_CACHE_STRIPES;
+            while (size * 2 <= entries)
+                size *= 2;
+        }
+
+        if (size == iEntries.size())
+            return;
+
+        for (int i = 0; i < VMAP_QUERY_CACHE_STRIPES; ++i)
+            iStripes[i].lock.acquire();
+
+        Entry empty;
+        memset(&empty, 0, sizeof(empty));
+        std::vector<Entry>(size, empty).swap(iEntries);
+        iMask = size ? size - 1 : 0;
+
+        for (int i = VMAP_QUERY_CACHE_STRIPES - 1; i >= 0; --i)
+            iStripes[i].lock.release();
+    }
+
+    VMapQueryCache::Key VMapQueryCache::makeKey(uint32 mapId, QueryType type, float const* coords, uint32 count)
+    {
+        Key key;
+        key.mapId = mapId;
+        key.type = type;
+        for (uint32 i = 0; i < 6; ++i)
+            key.coords[i] = i < count ? int32(floor(coords[i] / VMAP_QUERY_CACHE_QUANTUM + 0.5f)) : 0;
+        return key;
+    }
+
+    uint32 VMapQueryCache::hash(Key const& key)
+    {
+        uint32 h = key.mapId * 0x9E3779B1 ^ key.type;
+        for (int i = 0; i < 6; ++i)
+            h = (h ^ uint32(key.coords[i])) * 0x01000193;
+        return h ^ (h >> 15);
+    }
+
+    bool VMapQueryCache::lookup(Key const& key, float &value, uint32 &generation)
+    {
+        generation = currentGeneration(key.mapId);
+
+        uint32 h = hash(key);
+        Stripe& stripe = iStripes[h % VMAP_QUERY_CACHE_STRIPES];
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, stripe.lock, false);
+        if (iEntries.empty())
+            return false;
+
+        // stripes own every VMAP_QUERY_CACHE_STRIPES-th entry, so they never share one
+        Entry const& entry = iEntries[h & iMask];
+        bool hit = entry.generation == generation && entry.key == key;
+        if (hit)
+            value = entry.value;
+
+        if (key.type == QUERY_LOS)
+            ++(hit ? stripe.losHits : stripe.losMisses);
+        else
+            ++(hit ? stripe.heightHits : stripe.heightMisses);
+        return hit;
+    }
+
+    void VMapQueryCache::store(Key const& key, float value, uint32 generation)
+    {
+        uint32 h = hash(key);
+        Stripe& stripe = iStripes[h % VMAP_QUERY_CACHE_STRIPES];
+        ACE_GUARD(ACE_Thread_Mutex, guard, stripe.lock);
+        if (iEntries.empty())
+            return;
+
+        Entry& entry = iEntries[h & iMask];
+        entry.key = key;
+        entry.generation = generation;
+        entry.value = value;
+    }
+
+    bool VMapQueryCache::getLineOfSight(uint32 mapId, float x1, float y1, float z1, float x2, float y2, float z2, bool &result, uint32 &generation)
+    {
+        float coords[6] = { x1, y1, z1, x2, y2, z2 };
+        float value;
+        if (!lookup(makeKey(mapId, QUERY_LOS, coords, 6), value, generation))
+            return false;
+
+        result = value != 0.0f;
+        return true;
+    }
+
+    void VMapQueryCache::storeLineOfSight(uint32 mapId, float x1, float y1, float z1, float x2, float y2, float z2, bool result, uint32 generation)
+    {
+        float coords[6] = { x1, y1, z1, x2, y2, z2 };
+        store(makeKey(mapId, QUERY_LOS, coords, 6), result ? 1.0f : 0.0f, generation);
+    }
+
+    bool VMapQueryCache::getHeight(uint32 mapId, float x, float y, float z, float maxSearchDist, float &height, uint32 &generation)
+    {
+        float coords[4] = { x, y, z, maxSearchDist };
+        return lookup(makeKey(mapId, QUERY_HEIGHT, coords, 4), height, generation);
+    }
+
+    void VMapQueryCache::storeHeight(uint32 mapId, float x, float y, float z, float maxSearchDist, float height, uint32 generation)
+    {
+        float coords[4] = { x, y, z, maxSearchDist };
+        store(makeKey(mapId, QUERY_HEIGHT, coords, 4), height, generation);
+    }
+
+    void VMapQueryCache::invalidate(uint32 mapId)
+    {
+        // results computed before this call carry the old generation and are never stored as valid
+        ++iGenerations[mapId % VMAP_QUERY_CACHE_GENERATIONS];
+        ++iInvalidations;
+    }
+
+    void VMapQueryCache::getStats(VMapQueryCacheStats &stats)
+    {
+        stats = VMapQueryCacheStats();
+        stats.size = uint32(iEntries.size());
+        stats.invalidations = uint64(iInvalidations.value());
+
+        for (int i = 0; i < VMAP_QUERY_CACHE_STRIPES; ++i)
+        {
+            ACE_GUARD(ACE_Thread_Mutex, guard, iStripes[i].lock);
+            stats.losHits += iStripes[i].losHits;
+            stats.losMisses += iStripes[i].losMisses;
+            stats.heightHits += iStripes[i].heightHits;
+            stats.heightMisses += iStripes[i].heightMisses;
+        }
+    }
+
+    void VMapQueryCache::resetStats()
+    {
+        iInvalidations = 0;
+        for (int i = 0; i < VMAP_QUERY_CACHE_STRIPES; ++i)
+        {
+            ACE_GUARD(ACE_Thread_Mutex, guard, iStripes[i].lock);
+            iStripes[i].losHits = iStripes[i].losMisses = 0;
+            iStripes[i].heightHits = iStripes[i].heightMisses = 0;
+        }
+    }
+}
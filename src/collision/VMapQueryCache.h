@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ * Copyright (C) 2008-2012 TrinityCore <http://www.trinitycore.org/>
+ * Copyright (C) 2005-2012 MaNGOS <http://getmangos.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _VMAPQUERYCACHE_H
+#define _VMAPQUERYCACHE_H
+
+#include "Platform/Define.h"
+#include <ace/Thread_Mutex.h>
+#include <ace/Atomic_Op.h>
+
+#include <vector>
+
+// endpoints closer than this share the cached result, in yards
+#define VMAP_QUERY_CACHE_QUANTUM 0.125f
+
+namespace VMAP
+{
+    struct VMapQueryCacheStats;
+
+    // Results of recent line of sight and height queries. The endpoints are
+    // rounded to VMAP_QUERY_CACHE_QUANTUM, so rays from the same spots share an
+    // entry. The table is direct mapped and split into lock stripes, any thread
+    // may query it. Loading or unloading a tile drops the entries of the map.
+    class VMapQueryCache
+    {
+        public:
+            VMapQueryCache();
+
+            // 0 disables the cache, call it before the maps are updated
+            void setSize(uint32 entries);
+            bool isEnabled() const { return !iEntries.empty(); }
+
+            bool getLineOfSight(uint32 mapId, float x1, float y1, float z1, float x2, float y2, float z2, bool &result, uint32 &generation);
+            void storeLineOfSight(uint32 mapId, float x1, float y1, float z1, float x2, float y2, float z2, bool result, uint32 generation);
+
+            bool getHeight(uint32 mapId, float x, float y, float z, float maxSearchDist, float &height, uint32 &generation);
+            void storeHeight(uint32 mapId, float x, float y, float z, float maxSearchDist, float height, uint32 generation);
+
+            void invalidate(uint32 mapId);
+
+            void getStats(VMapQueryCacheStats &stats);
+            void resetStats();
+
+        private:
+            enum QueryType
+            {
+                QUERY_NONE,
+                QUERY_LOS,
+                QUERY_HEIGHT
+            };
+
+            struct Key
+            {
+                uint32 mapId;
+                uint32 type;
+                int32 coords[6];
+
+                bool operator==(Key const& other) const;
+            };
+
+            struct Entry
+            {
+                Key key;
+                uint32 generation;
+                float value;                                // height, or 1.0f if in line of sight
+            };
+
+            struct Stripe
+            {
+                Stripe() : losHits(0), losMisses(0), heightHits(0), heightMisses(0) {}
+
+                ACE_Thread_Mutex lock;
+                uint64 losHits;
+                uint64 losMisses;
+                uint64 heightHits;
+                uint64 heightMisses;
+            };
+
+            static Key makeKey(uint32 mapId, QueryType type, float const* coords, uint32 count);
+            static uint32 hash(Key const& key);
+
+            uint32 currentGeneration(uint32 mapId) const { return uint32(iGenerations[mapId % VMAP_QUERY_CACHE_GENERATIONS].value()); }
+            bool lookup(Key const& key, float &value, uint32 &generation);
+            void store(Key const& key, float value, uint32 generation);
+
+            enum
+            {
+                VMAP_QUERY_CACHE_STRIPES = 64,
+                VMAP_QUERY_CACHE_GENERATIONS = 256          // maps sharing a counter drop each other's entries
+            };
+
+            std::vector<Entry> iEntries;
+            uint32 iMask;
+            Stripe iStripes[VMAP_QUERY_CACHE_STRIPES];
+            ACE_Atomic_Op<ACE_Thread_Mutex, long> iGenerations[VMAP_QUERY_CACHE_GENERATIONS];
+            ACE_Atomic_Op<ACE_Thread_Mutex, long> iInvalidations;
+    };
+}
+#endif
@@ -31,7 +31,7 @@ template<> struct BoundsTrait<VMAP::GroupModel>
 
 namespace VMAP
 {
-    bool IntersectTriangle(const MeshTriangle &tri, std::vector<Vector3>::const_iterator points, const G3D::Ray &ray, float &distance)
+    bool IntersectTriangle(const MeshTriangle &tri, const Vector3 *points, const G3D::Ray &ray, float &distance)
     {
         static const float EPS = 1e-5f;
 
@@ -81,10 +81,59 @@ namespace VMAP
         return false;
     }
 
+    // IntersectTriangle for the rays of mask, with the operations in the same
+    // order so every lane gets the distance the single ray test would.
+    uint32 IntersectTrianglePacket(const MeshTriangle &tri, const Vector3 *points, RayPacket &packet, uint32 mask)
+    {
+        static const float EPS = 1e-5f;
+
+        const Vector3 e1 = points[tri.idx1] - points[tri.idx0];
+        const Vector3 e2 = points[tri.idx2] - points[tri.idx0];
+        const Vector3& p0 = points[tri.idx0];
+
+        RayLanes dx = RayLanes::load(packet.dir[0]), dy = RayLanes::load(packet.dir[1]), dz = RayLanes::load(packet.dir[2]);
+        RayLanes e1x(e1.x), e1y(e1.y), e1z(e1.z);
+        RayLanes e2x(e2.x), e2y(e2.y), e2z(e2.z);
+
+        // p = dir x e2, a = e1 . p
+        RayLanes px = dy * e2z - dz * e2y;
+        RayLanes py = dz * e2x - dx * e2z;
+        RayLanes pz = dx * e2y - dy * e2x;
+        RayLanes a = e1x * px + e1y * py + e1z * pz;
+        mask &= ~RayLanes::less(RayLanes::abs(a), RayLanes(EPS));
+        if (!mask)
+            return 0;
+
+        RayLanes f = RayLanes(1.0f) / a;
+        RayLanes sx = RayLanes::load(packet.org[0]) - RayLanes(p0.x);
+        RayLanes sy = RayLanes::load(packet.org[1]) - RayLanes(p0.y);
+        RayLanes sz = RayLanes::load(packet.org[2]) - RayLanes(p0.z);
+        RayLanes u = f * (sx * px + sy * py + sz * pz);
+        mask &= ~(RayLanes::less(u, RayLanes(0.0f)) | RayLanes::less(RayLanes(1.0f), u));
+        if (!mask)
+            return 0;
+
+        // q = s x e1
+        RayLanes qx = sy * e1z - sz * e1y;
+        RayLanes qy = sz * e1x - sx * e1z;
+        RayLanes qz = sx * e1y - sy * e1x;
+        RayLanes v = f * (dx * qx + dy * qy + dz * qz);
+        mask &= ~(RayLanes::less(v, RayLanes(0.0f)) | RayLanes::less(RayLanes(1.0f), u + v));
+        if (!mask)
+            return 0;
+
+        RayLanes t = f * (e2x * qx + e2y * qy + e2z * qz);
+        RayLanes distance = RayLanes::load(packet.maxDist);
+        mask &= RayLanes::less(RayLanes(0.0f), t) & RayLanes::less(t, distance);
+        if (mask)
+            RayLanes::select(mask, t, distance).store(packet.maxDist);
+        return mask;
+    }
+
     class TriBoundFunc
     {
         public:
-            TriBoundFunc(std::vector<Vector3> &vert): vertices(vert.begin()) {}
+            TriBoundFunc(const Vector3 *vert): vertices(vert) {}
             void operator()(const MeshTriangle &tri, G3D::AABox &out) const
             {
                 G3D::Vector3 lo = vertices[tri.idx0];
@@ -96,9 +145,106 @@ namespace VMAP
                 out = G3D::AABox(lo, hi);
             }
         protected:
-            const std::vector<Vector3>::const_iterator vertices;
+            const Vector3 *vertices;
+    };
+
+    /* The flat model files keep the arrays in their in memory layout behind a
+       table of the group models, so a mapped file is used in place instead of
+       being parsed. Offsets are from the start of the file and 4 byte aligned. */
+    struct FlatTree
+    {
+        float lo[3];
+        float hi[3];
+        uint32 treeOffset;
+        uint32 treeSize;
+        uint32 objectsOffset;
+        uint32 objectsCount;
+    };
+
+    struct FlatGroupModel
+    {
+        float lo[3];
+        float hi[3];
+        uint32 mogpFlags;
+        uint32 groupWMOID;
+        uint32 verticesOffset;
+        uint32 verticesCount;
+        uint32 trianglesOffset;
+        uint32 trianglesCount;
+        FlatTree meshTree;
+        uint32 liquidOffset;
+        uint32 liquidSize;                                  // 0 without liquid
+    };
+
+    struct FlatModelHeader
+    {
+        char magic[8];
+        uint32 rootWMOID;
+        uint32 groupsOffset;
+        uint32 groupsCount;
+        FlatTree groupTree;
     };
 
+    class FlatModelWriter
+    {
+        public:
+            // reserves size bytes at the end and returns their offset
+            uint32 reserve(uint32 size)
+            {
+                uint32 offset = uint32(iData.size() + 3) & ~3;
+                iData.resize(offset + size, 0);
+                return offset;
+            }
+            uint32 append(const void *src, uint32 size)
+            {
+                uint32 offset = reserve(size);
+                if (size)
+                    memcpy(&iData[offset], src, size);
+                return offset;
+            }
+            uint8* at(uint32 offset) { return &iData[offset]; }
+            bool writeToFile(FILE *wf) const { return fwrite(&iData[0], 1, iData.size(), wf) == iData.size(); }
+        private:
+            std::vector<uint8> iData;
+    };
+
+    // points out at count elements at offset, false if they are not inside the data
+    template<class T>
+    bool getFlatArray(const uint8 *data, uint32 size, uint32 offset, uint32 count, const T *&out)
+    {
+        out = 0;
+        if (!count)
+            return true;
+        if (offset % 4 || offset > size || count > (size - offset) / sizeof(T))
+            return false;
+        out = reinterpret_cast<const T*>(data + offset);
+        return true;
+    }
+
+    void writeFlatTree(FlatModelWriter &out, const BIH &tree, FlatTree &desc)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            desc.lo[i] = tree.getBounds().low()[i];
+            desc.hi[i] = tree.getBounds().high()[i];
+        }
+        desc.treeSize = tree.getTree().size();
+        desc.treeOffset = out.append(tree.getTree().begin(), desc.treeSize * sizeof(uint32));
+        desc.objectsCount = tree.getObjects().size();
+        desc.objectsOffset = out.append(tree.getObjects().begin(), desc.objectsCount * sizeof(uint32));
+    }
+
+    bool readFlatTree(const uint8 *data, uint32 size, const FlatTree &desc, BIH &tree)
+    {
+        const uint32 *treeData, *objects;
+        if (!getFlatArray(data, size, desc.treeOffset, desc.treeSize, treeData) ||
+            !getFlatArray(data, size, desc.objectsOffset, desc.objectsCount, objects))
+            return false;
+        G3D::AABox bounds(Vector3(desc.lo[0], desc.lo[1], desc.lo[2]), Vector3(desc.hi[0], desc.hi[1], desc.hi[2]));
+        tree.setView(bounds, treeData, desc.treeSize, objects, desc.objectsCount);
+        return true;
+    }
+
     WmoLiquid::WmoLiquid(uint32 width, uint32 height, const Vector3 &corner, uint32 type):
         iTilesX(width), iTilesY(height), iCorner(corner), iType(type)
     {
@@ -193,7 +339,7 @@ namespace VMAP
 
     uint32 WmoLiquid::GetFileSize()
     {
-        return 2 * sizeof(uint32) +
+        return 3 * sizeof(uint32) +
                 sizeof(Vector3) +
                 (iTilesX + 1)*(iTilesY + 1) * sizeof(float) +
                 iTilesX * iTilesY;
@@ -233,6 +379,46 @@ namespace VMAP
         return result;
     }
 
+    void WmoLiquid::writeToMemory(uint8 *dest)
+    {
+        memcpy(dest, &iTilesX, sizeof(uint32));
+        memcpy(dest + 4, &iTilesY, sizeof(uint32));
+        memcpy(dest + 8, &iCorner, sizeof(Vector3));
+        memcpy(dest + 8 + sizeof(Vector3), &iType, sizeof(uint32));
+        dest += 3 * sizeof(uint32) + sizeof(Vector3);
+        uint32 size = (iTilesX + 1)*(iTilesY + 1);
+        memcpy(dest, iHeight, size * sizeof(float));
+        memcpy(dest + size * sizeof(float), iFlags, iTilesX * iTilesY);
+    }
+
+    bool WmoLiquid::readFromMemory(const uint8 *src, uint32 size, WmoLiquid *&out)
+    {
+        const uint32 headerSize = 3 * sizeof(uint32) + sizeof(Vector3);
+        if (size < headerSize)
+            return false;
+
+        WmoLiquid *liquid = new WmoLiquid();
+        memcpy(&liquid->iTilesX, src, sizeof(uint32));
+        memcpy(&liquid->iTilesY, src + 4, sizeof(uint32));
+        memcpy(&liquid->iCorner, src + 8, sizeof(Vector3));
+        memcpy(&liquid->iType, src + 8 + sizeof(Vector3), sizeof(uint32));
+        if (liquid->iTilesX > 0xFFFF || liquid->iTilesY > 0xFFFF || liquid->GetFileSize() != size)
+        {
+            delete liquid;
+            return false;
+        }
+
+        src += headerSize;
+        uint32 count = (liquid->iTilesX + 1)*(liquid->iTilesY + 1);
+        liquid->iHeight = new float[count];
+        memcpy(liquid->iHeight, src, count * sizeof(float));
+        count = liquid->iTilesX * liquid->iTilesY;
+        liquid->iFlags = new uint8[count];
+        memcpy(liquid->iFlags, src + (liquid->iTilesX + 1)*(liquid->iTilesY + 1) * sizeof(float), count);
+        out = liquid;
+        return true;
+    }
+
     GroupModel::GroupModel(const GroupModel &other):
         iBound(other.iBound), iMogpFlags(other.iMogpFlags), iGroupWMOID(other.iGroupWMOID),
         vertices(other.vertices), triangles(other.triangles), meshTree(other.meshTree), iLiquid(0)
@@ -245,7 +431,7 @@ namespace VMAP
     {
         vertices.swap(vert);
         triangles.swap(tri);
-        TriBoundFunc bFunc(vertices);
+        TriBoundFunc bFunc(vertices.begin());
         meshTree.build(triangles, bFunc);
     }
 
@@ -266,7 +452,7 @@ namespace VMAP
         if (result && fwrite(&count, sizeof(uint32), 1, wf) != 1) result = false;
         if (!count) // models without (collision) geometry end here, unsure if they are useful
             return result;
-        if (result && fwrite(&vertices[0], sizeof(Vector3), count, wf) != count) result = false;
+        if (result && fwrite(vertices.begin(), sizeof(Vector3), count, wf) != count) result = false;
 
         // write triangle mesh
         if (result && fwrite("TRIM", 1, 4, wf) != 4) result = false;
@@ -274,7 +460,7 @@ namespace VMAP
         chunkSize = sizeof(uint32)+ sizeof(MeshTriangle)*count;
         if (result && fwrite(&chunkSize, sizeof(uint32), 1, wf) != 1) result = false;
         if (result && fwrite(&count, sizeof(uint32), 1, wf) != 1) result = false;
-        if (result && fwrite(&triangles[0], sizeof(MeshTriangle), count, wf) != count) result = false;
+        if (result && fwrite(triangles.begin(), sizeof(MeshTriangle), count, wf) != count) result = false;
 
         // write mesh BIH
         if (result && fwrite("MBIH", 1, 4, wf) != 4) result = false;
@@ -315,15 +501,17 @@ namespace VMAP
         if (result && fread(&count, sizeof(uint32), 1, rf) != 1) result = false;
         if (!count) // models without (collision) geometry end here, unsure if they are useful
             return result;
-        if (result) vertices.resize(count);
-        if (result && fread(&vertices[0], sizeof(Vector3), count, rf) != count) result = false;
+        std::vector<Vector3> tempVertices(count);
+        if (result && fread(&tempVertices[0], sizeof(Vector3), count, rf) != count) result = false;
+        vertices.swap(tempVertices);
 
         // read triangle mesh
         if (result && !readChunk(rf, chunk, "TRIM", 4)) result = false;
         if (result && fread(&chunkSize, sizeof(uint32), 1, rf) != 1) result = false;
         if (result && fread(&count, sizeof(uint32), 1, rf) != 1) result = false;
-        if (result) triangles.resize(count);
-        if (result && fread(&triangles[0], sizeof(MeshTriangle), count, rf) != count) result = false;
+        std::vector<MeshTriangle> tempTriangles(result ? count : 0);
+        if (result && count && fread(&tempTriangles[0], sizeof(MeshTriangle), count, rf) != count) result = false;
+        triangles.swap(tempTriangles);
 
         // read mesh BIH
         if (result && !readChunk(rf, chunk, "MBIH", 4)) result = false;
@@ -337,18 +525,64 @@ namespace VMAP
         return result;
     }
 
+    void GroupModel::writeFlat(FlatModelWriter &out, FlatGroupModel &desc)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            desc.lo[i] = iBound.low()[i];
+            desc.hi[i] = iBound.high()[i];
+        }
+        desc.mogpFlags = iMogpFlags;
+        desc.groupWMOID = iGroupWMOID;
+        desc.verticesCount = vertices.size();
+        desc.verticesOffset = out.append(vertices.begin(), desc.verticesCount * sizeof(Vector3));
+        desc.trianglesCount = triangles.size();
+        desc.trianglesOffset = out.append(triangles.begin(), desc.trianglesCount * sizeof(MeshTriangle));
+        writeFlatTree(out, meshTree, desc.meshTree);
+        desc.liquidSize = iLiquid ? iLiquid->GetFileSize() : 0;
+        desc.liquidOffset = out.reserve(desc.liquidSize);
+        if (iLiquid)
+            iLiquid->writeToMemory(out.at(desc.liquidOffset));
+    }
+
+    bool GroupModel::readFlat(const uint8 *data, uint32 size, const FlatGroupModel &desc)
+    {
+        delete iLiquid;
+        iLiquid = 0;
+
+        iBound = G3D::AABox(Vector3(desc.lo[0], desc.lo[1], desc.lo[2]), Vector3(desc.hi[0], desc.hi[1], desc.hi[2]));
+        iMogpFlags = desc.mogpFlags;
+        iGroupWMOID = desc.groupWMOID;
+
+        const Vector3 *vertexData;
+        const MeshTriangle *triangleData;
+        if (!getFlatArray(data, size, desc.verticesOffset, desc.verticesCount, vertexData) ||
+            !getFlatArray(data, size, desc.trianglesOffset, desc.trianglesCount, triangleData) ||
+            !readFlatTree(data, size, desc.meshTree, meshTree))
+            return false;
+        vertices.setView(vertexData, desc.verticesCount);
+        triangles.setView(triangleData, desc.trianglesCount);
+
+        // liquids are small and keep their own copy
+        const uint8 *liquidData;
+        if (desc.liquidSize && (!getFlatArray(data, size, desc.liquidOffset, desc.liquidSize, liquidData) ||
+            !WmoLiquid::readFromMemory(liquidData, desc.liquidSize, iLiquid)))
+            return false;
+        return true;
+    }
+
     struct GModelRayCallback
     {
-        GModelRayCallback(const std::vector<MeshTriangle> &tris, const std::vector<Vector3> &vert):
-            vertices(vert.begin()), triangles(tris.begin()), hit(false) {}
+        GModelRayCallback(const MeshTriangle *tris, const Vector3 *vert):
+            vertices(vert), triangles(tris), hit(false) {}
         bool operator()(const G3D::Ray& ray, uint32 entry, float& distance, bool /*pStopAtFirstHit*/)
         {
             bool result = IntersectTriangle(triangles[entry], vertices, ray, distance);
             if (result)  hit=true;
             return hit;
         }
-        std::vector<Vector3>::const_iterator vertices;
-        std::vector<MeshTriangle>::const_iterator triangles;
+        const Vector3 *vertices;
+        const MeshTriangle *triangles;
         bool hit;
     };
 
@@ -356,16 +590,40 @@ namespace VMAP
     {
         if (!triangles.size())
             return false;
-        GModelRayCallback callback(triangles, vertices);
+        GModelRayCallback callback(triangles.begin(), vertices.begin());
         meshTree.intersectRay(ray, callback, distance, stopAtFirstHit);
         return callback.hit;
     }
 
+    struct GModelPacketCallback
+    {
+        GModelPacketCallback(const MeshTriangle *tris, const Vector3 *vert):
+            vertices(vert), triangles(tris), hits(0) {}
+        uint32 operator()(RayPacket &packet, uint32 entry, uint32 mask, bool /*pStopAtFirstHit*/)
+        {
+            uint32 result = IntersectTrianglePacket(triangles[entry], vertices, packet, mask);
+            hits |= result;
+            return result;
+        }
+        const Vector3 *vertices;
+        const MeshTriangle *triangles;
+        uint32 hits;
+    };
+
+    uint32 GroupModel::IntersectRayPacket(RayPacket &packet, uint32 mask, bool stopAtFirstHit) const
+    {
+        if (!triangles.size())
+            return 0;
+        GModelPacketCallback callback(triangles.begin(), vertices.begin());
+        meshTree.intersectRayPacket(packet, callback, mask, stopAtFirstHit);
+        return callback.hits;
+    }
+
     bool GroupModel::IsInsideObject(const Vector3 &pos, const Vector3 &down, float &z_dist) const
     {
         if (!triangles.size() || !iBound.contains(pos))
             return false;
-        GModelRayCallback callback(triangles, vertices);
+        GModelRayCallback callback(triangles.begin(), vertices.begin());
         Vector3 rPos = pos - 0.1f * down;
         float dist = G3D::inf();
         G3D::Ray ray(rPos, down);
@@ -421,6 +679,29 @@ namespace VMAP
         return isc.hit;
     }
 
+    struct WModelPacketCallback
+    {
+        WModelPacketCallback(const std::vector<GroupModel> &mod): models(mod.begin()), hits(0) {}
+        uint32 operator()(RayPacket &packet, uint32 entry, uint32 mask, bool pStopAtFirstHit)
+        {
+            uint32 result = models[entry].IntersectRayPacket(packet, mask, pStopAtFirstHit);
+            hits |= result;
+            return result;
+        }
+        std::vector<GroupModel>::const_iterator models;
+        uint32 hits;
+    };
+
+    uint32 WorldModel::IntersectRayPacket(RayPacket &packet, uint32 mask, bool stopAtFirstHit) const
+    {
+        if (groupModels.size() == 1)
+            return groupModels[0].IntersectRayPacket(packet, mask, stopAtFirstHit);
+
+        WModelPacketCallback isc(groupModels);
+        groupTree.intersectRayPacket(packet, isc, mask, stopAtFirstHit);
+        return isc.hits;
+    }
+
     class WModelAreaCallback {
         public:
             WModelAreaCallback(const std::vector<GroupModel> &vals, const Vector3 &down):
@@ -493,34 +774,31 @@ namespace VMAP
 
     bool WorldModel::writeFile(const std::string &filename)
     {
+        FlatModelWriter out;
+        FlatModelHeader header;
+        memcpy(header.magic, VMAP_FLAT_MAGIC, 8);
+        header.rootWMOID = RootWMOID;
+        out.reserve(sizeof(FlatModelHeader));
+
+        // write group models, the table entries are filled after their arrays
+        header.groupsCount = groupModels.size();
+        header.groupsOffset = out.reserve(header.groupsCount * sizeof(FlatGroupModel));
+        for (uint32 i = 0; i < header.groupsCount; ++i)
+        {
+            FlatGroupModel desc;
+            groupModels[i].writeFlat(out, desc);
+            memcpy(out.at(header.groupsOffset + i * sizeof(FlatGroupModel)), &desc, sizeof(FlatGroupModel));
+        }
+
+        // write group BIH
+        writeFlatTree(out, groupTree, header.groupTree);
+        memcpy(out.at(0), &header, sizeof(FlatModelHeader));
+
         FILE *wf = fopen(filename.c_str(), "wb");
         if (!wf)
             return false;
 
-        bool result = true;
-        uint32 chunkSize, count;
-        result = fwrite(VMAP_MAGIC,1,8,wf) == 8;
-        if (result && fwrite("WMOD", 1, 4, wf) != 4) result = false;
-        chunkSize = sizeof(uint32) + sizeof(uint32);
-        if (result && fwrite(&chunkSize, sizeof(uint32), 1, wf) != 1) result = false;
-        if (result && fwrite(&RootWMOID, sizeof(uint32), 1, wf) != 1) result = false;
-
-        // write group models
-        count=groupModels.size();
-        if (count)
-        {
-            if (result && fwrite("GMOD", 1, 4, wf) != 4) result = false;
-            //chunkSize = sizeof(uint32)+ sizeof(GroupModel)*count;
-            //if (result && fwrite(&chunkSize, sizeof(uint32), 1, wf) != 1) result = false;
-            if (result && fwrite(&count, sizeof(uint32), 1, wf) != 1) result = false;
-            for (uint32 i=0; i<groupModels.size() && result; ++i)
-                result = groupModels[i].writeToFile(wf);
-
-            // write group BIH
-            if (result && fwrite("GBIH", 1, 4, wf) != 4) result = false;
-            if (result) result = groupTree.writeToFile(wf);
-        }
-
+        bool result = out.writeToFile(wf);
         fclose(wf);
         return result;
     }
@@ -559,5 +837,31 @@ namespace VMAP
         fclose(rf);
         return result;
     }
-}
 
+    bool WorldModel::readFlat(const uint8 *data, uint32 size)
+    {
+        if (size < sizeof(FlatModelHeader))
+            return false;
+
+        FlatModelHeader header;
+        memcpy(&header, data, sizeof(FlatModelHeader));
+        if (memcmp(header.magic, VMAP_FLAT_MAGIC, 8))
+            return false;
+
+        const FlatGroupModel *groups;
+        if (!getFlatArray(data, size, header.groupsOffset, header.groupsCount, groups))
+            return false;
+
+        std::vector<GroupModel> models(header.groupsCount);
+        for (uint32 i = 0; i < header.groupsCount; ++i)
+            if (!models[i].readFlat(data, size, groups[i]))
+                return false;
+
+        // nothing is changed before everything was found valid
+        if (!readFlatTree(data, size, header.groupTree, groupTree))
+            return false;
+        RootWMOID = header.rootWMOID;
+        groupModels.swap(models);
+        return true;
+    }
+}
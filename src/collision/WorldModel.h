@@ -33,6 +33,8 @@ namespace VMAP
     class TreeNode;
     struct AreaInfo;
     struct LocationInfo;
+    struct FlatGroupModel;
+    class FlatModelWriter;
 
     class MeshTriangle
     {
@@ -59,6 +61,9 @@ namespace VMAP
             uint32 GetFileSize();
             bool writeToFile(FILE *wf);
             static bool readFromFile(FILE *rf, WmoLiquid *&liquid);
+            // same layout as the file chunk, dest must hold GetFileSize() bytes
+            void writeToMemory(uint8 *dest);
+            static bool readFromMemory(const uint8 *src, uint32 size, WmoLiquid *&liquid);
         private:
             WmoLiquid(): iHeight(0), iFlags(0) {};
             uint32 iTilesX;  //!< number of tiles in x direction, each
@@ -83,11 +88,16 @@ namespace VMAP
             void setMeshData(std::vector<Vector3> &vert, std::vector<MeshTriangle> &tri);
             void setLiquidData(WmoLiquid *liquid) { iLiquid = liquid; }
             bool IntersectRay(const G3D::Ray &ray, float &distance, bool stopAtFirstHit) const;
+            // returns the lanes of mask that hit, their maxDist is shortened to the hits
+            uint32 IntersectRayPacket(RayPacket &packet, uint32 mask, bool stopAtFirstHit) const;
             bool IsInsideObject(const Vector3 &pos, const Vector3 &down, float &z_dist) const;
             bool GetLiquidLevel(const Vector3 &pos, float &liqHeight) const;
             uint32 GetLiquidType() const;
             bool writeToFile(FILE *wf);
             bool readFromFile(FILE *rf);
+            void writeFlat(FlatModelWriter &out, FlatGroupModel &desc);
+            // the geometry stays in data, which must outlive the model
+            bool readFlat(const uint8 *data, uint32 size, const FlatGroupModel &desc);
             const G3D::AABox& GetBound() const { return iBound; }
             uint32 GetMogpFlags() const { return iMogpFlags; }
             uint32 GetWmoID() const { return iGroupWMOID; }
@@ -95,8 +105,8 @@ namespace VMAP
             G3D::AABox iBound;
             uint32 iMogpFlags;// 0x8 outdor; 0x2000 indoor
             uint32 iGroupWMOID;
-            std::vector<Vector3> vertices;
-            std::vector<MeshTriangle> triangles;
+            FlatArray<Vector3> vertices;
+            FlatArray<MeshTriangle> triangles;
             BIH meshTree;
             WmoLiquid *iLiquid;
     };
@@ -110,10 +120,14 @@ namespace VMAP
             void setGroupModels(std::vector<GroupModel> &models);
             void setRootWmoID(uint32 id) { RootWMOID = id; }
             bool IntersectRay(const G3D::Ray &ray, float &distance, bool stopAtFirstHit) const;
+            uint32 IntersectRayPacket(RayPacket &packet, uint32 mask, bool stopAtFirstHit) const;
             bool IntersectPoint(const G3D::Vector3 &p, const G3D::Vector3 &down, float &dist, AreaInfo &info) const;
             bool GetLocationInfo(const G3D::Vector3 &p, const G3D::Vector3 &down, float &dist, LocationInfo &info) const;
+            // writes the flat layout, readFile() only takes the older chunked files
             bool writeFile(const std::string &filename);
             bool readFile(const std::string &filename);
+            // uses a flat model file in place, data must outlive the model
+            bool readFlat(const uint8 *data, uint32 size);
         protected:
             uint32 RootWMOID;
             std::vector<GroupModel> groupModels;
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _GRIDOBJECTINDEX_H
+#define _GRIDOBJECTINDEX_H
+
+#include "Platform/Define.h"
+
+#include <vector>
+
+template<class OBJECT>
+class GridRefManager;
+
+/*
+  GridObjectIndex keeps the guid, type mask, position and size of the objects of
+  one GridRefManager in packed arrays, so a search can reject the objects out of
+  range without reading them. The objects keep their slot and report their
+  moves, the index knows nothing about them besides the pointer.
+*/
+
+class GridObjectIndex
+{
+    public:
+        size_t size() const { return i_objects.size(); }
+
+        uint64 GetGuid(uint32 slot) const { return i_guids[slot]; }
+        uint32 GetTypeMask(uint32 slot) const { return i_typeMasks[slot]; }
+        void* GetObject(uint32 slot) const { return i_objects[slot]; }
+
+        uint32 Insert(void* obj, uint64 guid, uint32 typeMask, float x, float y, float z, float size)
+        {
+            i_guids.push_back(guid);
+            i_typeMasks.push_back(typeMask);
+            i_x.push_back(x);
+            i_y.push_back(y);
+            i_z.push_back(z);
+            i_sizes.push_back(size);
+            i_objects.push_back(obj);
+            return uint32(i_objects.size() - 1);
+        }
+
+        // the last entry takes the slot, returns its object or NULL if the slot was the last
+        void* Remove(uint32 slot)
+        {
+            uint32 last = uint32(i_objects.size() - 1);
+            void* moved = NULL;
+            if (slot != last)
+            {
+                i_guids[slot] = i_guids[last];
+                i_typeMasks[slot] = i_typeMasks[last];
+                i_x[slot] = i_x[last];
+                i_y[slot] = i_y[last];
+                i_z[slot] = i_z[last];
+                i_sizes[slot] = i_sizes[last];
+                i_objects[slot] = moved = i_objects[last];
+            }
+
+            i_guids.pop_back();
+            i_typeMasks.pop_back();
+            i_x.pop_back();
+            i_y.pop_back();
+            i_z.pop_back();
+            i_sizes.pop_back();
+            i_objects.pop_back();
+            return moved;
+        }
+
+        void Move(uint32 slot, float x, float y, float z, float size)
+        {
+            i_x[slot] = x;
+            i_y[slot] = y;
+            i_z[slot] = z;
+            i_sizes[slot] = size;
+        }
+
+        // calls worker.VisitObject() for the objects of the type mask within the radius
+        // plus their size in the plane, OBJECT must be the type the pointers were inserted as
+        template<class OBJECT, class WORKER> void Visit(float x, float y, float radius, uint32 typeMask, WORKER &worker) const
+        {
+            for (size_t i = 0; i < i_objects.size(); ++i)
+            {
+                float dx = i_x[i] - x;
+                float dy = i_y[i] - y;
+                float reach = radius + i_sizes[i];
+                if (dx * dx + dy * dy > reach * reach || !(i_typeMasks[i] & typeMask))
+                    continue;
+
+                worker.VisitObject(static_cast<OBJECT*>(i_objects[i]));
+            }
+        }
+
+    private:
+        std::vector<uint64> i_guids;
+        std::vector<uint32> i_typeMasks;
+        std::vector<float> i_x;
+        std::vector<float> i_y;
+        std::vector<float> i_z;
+        std::vector<float> i_sizes;
+        std::vector<void*> i_objects;
+};
+
+// TypeContainerVisitor worker that walks the indexes of the cells instead of
+// their lists, WORKER gets VisitObject() calls for the objects that pass
+template<class WORKER>
+struct GridIndexVisitor
+{
+    GridIndexVisitor(float x, float y, float radius, uint32 typeMask, WORKER &worker)
+        : i_x(x), i_y(y), i_radius(radius), i_typeMask(typeMask), i_worker(worker) {}
+
+    template<class T> void Visit(GridRefManager<T> &m)
+    {
+        m.GetIndex().template Visit<T>(i_x, i_y, i_radius, i_typeMask, i_worker);
+    }
+
+    float i_x;
+    float i_y;
+    float i_radius;
+    uint32 i_typeMask;
+    WORKER &i_worker;
+};
+#endif
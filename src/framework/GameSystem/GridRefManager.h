@@ -21,6 +21,7 @@
 #define _GRIDREFMANAGER
 
 #include "Utilities/LinkedReference/RefManager.h"
+#include "GameSystem/GridObjectIndex.h"
 
 template<class OBJECT>
 class GridReference;
@@ -38,6 +39,12 @@ class GridRefManager : public RefManager<GridRefManager<OBJECT>, OBJECT>
         iterator end() { return iterator(NULL); }
         iterator rbegin() { return iterator(getLast()); }
         iterator rend() { return iterator(NULL); }
+
+        GridObjectIndex& GetIndex() { return i_index; }
+        GridObjectIndex const& GetIndex() const { return i_index; }
+
+    private:
+        GridObjectIndex i_index;
 };
 #endif
 
@@ -19,10 +19,110 @@
 
 #include "EventProcessor.h"
 
+#include <ace/Guard_T.h>
+#include <ace/Thread_Mutex.h>
+
+#include <algorithm>
+#include <new>
+
+// Free lists of the event sizes in steps of 16 bytes up to 256, refilled a
+// slab of 64 blocks at a time. The blocks are never given back, the number
+// of events alive stays about the same while the server runs. Events are
+// created and deleted by all map threads, each size has its own lock.
+#define EVENT_SLAB_STEP     16
+#define EVENT_SLAB_SIZES    16
+#define EVENT_SLAB_BLOCKS   64
+
+namespace
+{
+    struct EventBlock
+    {
+        EventBlock* next;
+    };
+
+    class EventSlabs
+    {
+        public:
+            EventSlabs()
+            {
+                for (size_t i = 0; i < EVENT_SLAB_SIZES; ++i)
+                    m_free[i] = NULL;
+            }
+
+            void* Allocate(size_t size)
+            {
+                size_t index = (size - 1) / EVENT_SLAB_STEP;
+
+                ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_locks[index], NULL);
+                if (!m_free[index])
+                {
+                    size_t blockSize = (index + 1) * EVENT_SLAB_STEP;
+                    char* slab = static_cast<char*>(::operator new(blockSize * EVENT_SLAB_BLOCKS));
+                    for (size_t i = 0; i < EVENT_SLAB_BLOCKS; ++i)
+                    {
+                        EventBlock* block = reinterpret_cast<EventBlock*>(slab + i * blockSize);
+                        block->next = m_free[index];
+                        m_free[index] = block;
+                    }
+                }
+
+                EventBlock* block = m_free[index];
+                m_free[index] = block->next;
+                return block;
+            }
+
+            void Free(void* p, size_t size)
+            {
+                size_t index = (size - 1) / EVENT_SLAB_STEP;
+
+                ACE_GUARD(ACE_Thread_Mutex, guard, m_locks[index]);
+                EventBlock* block = static_cast<EventBlock*>(p);
+                block->next = m_free[index];
+                m_free[index] = block;
+            }
+
+        private:
+            EventBlock* m_free[EVENT_SLAB_SIZES];
+            ACE_Thread_Mutex m_locks[EVENT_SLAB_SIZES];
+    };
+
+    // never destroyed, events can be deleted by the destructors of other statics
+    EventSlabs& GetEventSlabs()
+    {
+        static EventSlabs* slabs = new EventSlabs();
+        return *slabs;
+    }
+}
+
+void* BasicEvent::operator new(size_t size)
+{
+    if (size > EVENT_SLAB_STEP * EVENT_SLAB_SIZES)
+        return ::operator new(size);
+
+    if (void* p = GetEventSlabs().Allocate(size))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void BasicEvent::operator delete(void* p, size_t size)
+{
+    if (!p)
+        return;
+
+    if (size > EVENT_SLAB_STEP * EVENT_SLAB_SIZES)
+        ::operator delete(p);
+    else
+        GetEventSlabs().Free(p, size);
+}
+
 EventProcessor::EventProcessor()
 {
     m_time = 0;
+    m_order = 0;
     m_aborting = false;
+    m_addHook = NULL;
+    m_hookOwner = NULL;
 }
 
 EventProcessor::~EventProcessor()
@@ -36,12 +136,12 @@ void EventProcessor::Update(uint32 p_time)
     m_time += p_time;
 
     // main event loop
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    while (!m_events.empty() && m_events.front().e_time <= m_time)
     {
         // get and remove event from queue
-        BasicEvent* Event = i->second;
-        m_events.erase(i);
+        BasicEvent* Event = m_events.front().e_event;
+        std::pop_heap(m_events.begin(), m_events.end());
+        m_events.pop_back();
 
         if (!Event->to_Abort)
         {
@@ -64,33 +164,32 @@ void EventProcessor::KillAllEvents(bool force)
     // prevent event insertions
     m_aborting = true;
 
-    // first, abort all existing events
-    for (EventList::iterator i = m_events.begin(); i != m_events.end();)
+    // first, abort all existing events, taken out of the heap in case Abort() adds new ones
+    EventList events;
+    events.swap(m_events);
+    for (EventList::iterator i = events.begin(); i != events.end(); ++i)
     {
-        EventList::iterator i_old = i;
-        ++i;
-
-        i_old->second->to_Abort = true;
-        i_old->second->Abort(m_time);
-        if (force || i_old->second->IsDeletable())
+        i->e_event->to_Abort = true;
+        i->e_event->Abort(m_time);
+        if (force || i->e_event->IsDeletable())
+            delete i->e_event;
+        else                                                // need per-element cleanup
         {
-            delete i_old->second;
-
-            if (!force)                                      // need per-element cleanup
-                m_events.erase (i_old);
+            m_events.push_back(*i);
+            std::push_heap(m_events.begin(), m_events.end());
         }
     }
-
-    // fast clear event list (in force case)
-    if (force)
-        m_events.clear();
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
 {
+    if (m_addHook)
+        e_time += m_addHook(m_hookOwner);
+
     if (set_addtime) Event->m_addTime = m_time;
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+    m_events.push_back(EventListEntry(e_time, m_order++, Event));
+    std::push_heap(m_events.begin(), m_events.end());
 }
 
 uint64 EventProcessor::CalculateTime(uint64 t_offset)
@@ -98,3 +197,8 @@ uint64 EventProcessor::CalculateTime(uint64 t_offset)
     return(m_time + t_offset);
 }
 
+uint64 EventProcessor::GetTimeToFirstEvent() const
+{
+    uint64 e_time = m_events.front().e_time;
+    return e_time > m_time ? e_time - m_time : 0;
+}
@@ -22,7 +22,8 @@
 
 #include "Platform/Define.h"
 
-#include<map>
+#include <cstddef>
+#include <vector>
 
 // Note. All times are in milliseconds here.
 
@@ -34,6 +35,10 @@ class BasicEvent
         {
         };
 
+        // events of all kinds are allocated from per size free lists
+        static void* operator new(size_t size);
+        static void operator delete(void* p, size_t size);
+
         // this method executes when the event is triggered
         // return false if event does not want to be deleted
         // e_time is execution time, p_time is update interval
@@ -51,7 +56,30 @@ class BasicEvent
         uint64 m_execTime;                                  // planned time of next execution, filled by event handler
 };
 
-typedef std::multimap<uint64, BasicEvent*> EventList;
+struct EventListEntry
+{
+    EventListEntry(uint64 time, uint32 order, BasicEvent* event) : e_time(time), e_order(order), e_event(event) {}
+
+    // the earliest event on top of the heap, the events of the same time in the order they were added
+    bool operator<(EventListEntry const& other) const
+    {
+        if (e_time != other.e_time)
+            return e_time > other.e_time;
+        return int32(e_order - other.e_order) > 0;
+    }
+
+    uint64 e_time;
+    uint32 e_order;
+    BasicEvent* e_event;
+};
+
+// binary heap, the vector keeps its memory while the events come and go
+typedef std::vector<EventListEntry> EventList;
+
+// Called by AddEvent before the event is stored. The owner may stop updating
+// the processor for a while, it returns how far the time of the processor is
+// behind, the new event is delayed by that much.
+typedef uint64 (*EventAddHook)(void* owner);
 
 class EventProcessor
 {
@@ -63,10 +91,16 @@ class EventProcessor
         void KillAllEvents(bool force);
         void AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime = true);
         uint64 CalculateTime(uint64 t_offset);
+        bool Empty() const { return m_events.empty(); }
+        uint64 GetTimeToFirstEvent() const;                 // only if not Empty(), 0 if already due
+        void SetAddHook(EventAddHook hook, void* owner) { m_addHook = hook; m_hookOwner = owner; }
     protected:
         uint64 m_time;
         EventList m_events;
+        uint32 m_order;
         bool m_aborting;
+        EventAddHook m_addHook;
+        void* m_hookOwner;
 };
 #endif
 
@@ -277,6 +277,8 @@ void WorldSession::HandleAuctionSellItem(WorldPacket & recv_data)
 
     pl->MoveItemFromInventory(it->GetBagSlot(), it->GetSlot(), true);
 
+    // the auctions are written with the key of their owner
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, pl->GetGUIDLow());
     CharacterDatabase.BeginTransaction();
     it->DeleteFromInventoryDB();
     it->SaveToDB();                                         // recursive and not have transaction guard into self, not in inventiory and can be save standalone
@@ -322,6 +324,10 @@ void WorldSession::HandleAuctionPlaceBid(WorldPacket & recv_data)
         return;
     }
 
+    // a bid writes the auction of its owner, the money of the bidder and mails
+    // to the bidder before, so it is in order with all of them
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, SQL_ASYNC_KEY_ALL);
+
     // impossible have online own another character (use this for speedup check in case online owner)
     Player* auction_owner = objmgr.GetPlayer(MAKE_NEW_GUID(auction->owner, 0, HIGHGUID_PLAYER));
     if (!auction_owner && objmgr.GetPlayerAccountIdByGUID(MAKE_NEW_GUID(auction->owner, 0, HIGHGUID_PLAYER)) == pl->GetSession()->GetAccountId())
@@ -472,6 +478,7 @@ void WorldSession::HandleAuctionRemoveItem(WorldPacket & recv_data)
     SendAuctionCommandResult(auction->Id, AUCTION_CANCEL, AUCTION_OK);
 
     // Now remove the auction
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, auction->owner);
     CharacterDatabase.BeginTransaction();
     pl->SaveInventoryAndGoldToDB();
     auction->DeleteFromDB();
@@ -167,6 +167,7 @@ void AuctionHouseMgr::SendAuctionWonMail(AuctionEntry *auction)
 
         // set owner to bidder (to prevent delete item with sender char deleting)
         // owner in data will set at mail receive and item extracting
+        SqlAsyncKeyGuard asyncKey(CharacterDatabase, auction->bidder);
         CharacterDatabase.PExecute("UPDATE item_instance SET owner_guid = '%u' WHERE guid='%u'",auction->bidder,pItem->GetGUIDLow());
 
         if (bidder)
@@ -558,7 +559,8 @@ void AuctionHouseObject::Update()
             sAuctionMgr->SendAuctionWonMail(auction);
         }
 
-        ///- In any case clear the auction
+        ///- In any case clear the auction, with the key of its owner
+        SqlAsyncKeyGuard asyncKey(CharacterDatabase, auction->owner);
         CharacterDatabase.BeginTransaction();
         auction->DeleteFromDB();
         uint32 item_template = auction->item_template;
@@ -101,9 +101,9 @@ bool Bag::Create(uint32 guidlow, uint32 itemid, Player const* owner)
     return true;
 }
 
-void Bag::SaveToDB()
+void Bag::SaveToDB(SqlBatchInsert* dataBatch)
 {
-    Item::SaveToDB();
+    Item::SaveToDB(dataBatch);
 }
 
 bool Bag::LoadFromDB(uint32 guid, uint64 owner_guid, QueryResult_AutoPtr result)
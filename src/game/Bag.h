@@ -53,7 +53,7 @@ class Bag : public Item
 
         // DB operations
         // overwrite virtual Item::SaveToDB
-        void SaveToDB();
+        void SaveToDB(SqlBatchInsert* dataBatch = NULL);
         // overwrite virtual Item::LoadFromDB
         bool LoadFromDB(uint32 guid, uint64 owner_guid, QueryResult_AutoPtr result);
         // overwrite virtual Item::DeleteFromDB
@@ -1641,7 +1641,8 @@ void BattleGroundMgr::DistributeArenaPoints()
     //cycle that gives points to all players
     for (std::map<uint32, uint32>::iterator plr_itr = PlayerPoints.begin(); plr_itr != PlayerPoints.end(); ++plr_itr)
     {
-        //update to database
+        //update to database, in order with the saves of the player
+        SqlAsyncKeyGuard asyncKey(CharacterDatabase, plr_itr->first);
         CharacterDatabase.PExecute("UPDATE characters SET arenaPoints = arenaPoints + '%u' WHERE guid = '%u'", plr_itr->second, plr_itr->first);
         //add points if player is online
         Player* pl = objmgr.GetPlayer(plr_itr->first);
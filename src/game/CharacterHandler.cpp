@@ -62,43 +62,31 @@ bool LoginQueryHolder::Initialize()
 
     bool res = true;
 
-    // NOTE: all fields in `characters` must be read to prevent lost character data at next save in case wrong DB structure.
-    // !!! NOTE: including unused `zone`,`online`
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADFROM,
-        "SELECT guid, account, data, name, race, class, gender, level, xp, "
-        "money, playerBytes, playerBytes2, playerFlags, position_x, "
-        "position_y, position_z, map, orientation, taximask, cinematic, "
-        "totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, "
-        "resettalents_cost, resettalents_time, trans_x, trans_y, trans_z, "
-        "trans_o, transguid, extra_flags, stable_slots, at_login, zone, "
-        "online, death_expire_time, taxi_path, dungeon_difficulty, "
-        "arenaPoints, totalHonorPoints, todayHonorPoints, "
-        "yesterdayHonorPoints, totalKills, todayKills, yesterdayKills, "
-        "chosenTitle, watchedFaction, drunk, health, "
-        "powerMana, powerRage, powerFocus, powerEnergy, powerHappiness, instance_id "
-        "FROM characters WHERE guid = '%u'", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADGROUP,           "SELECT leaderGuid FROM group_member WHERE memberGuid ='%u'", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADBOUNDINSTANCES,  "SELECT id, permanent, map, difficulty, resettime FROM character_instance LEFT JOIN instance ON instance = id WHERE guid = '%u'", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADAURAS,           "SELECT caster_guid,spell,effect_index,stackcount,amount,maxduration,remaintime,remaincharges FROM character_aura WHERE guid = '%u'", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADSPELLS,          "SELECT spell,active,disabled FROM character_spell WHERE guid = '%u'", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADQUESTSTATUS,     "SELECT quest,status,rewarded,explored,timer,mobcount1,mobcount2,mobcount3,mobcount4,itemcount1,itemcount2,itemcount3,itemcount4 FROM character_queststatus WHERE guid = '%u'", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADDAILYQUESTSTATUS,"SELECT quest,time FROM character_queststatus_daily WHERE guid = '%u'", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADTUTORIALS,       "SELECT tut0,tut1,tut2,tut3,tut4,tut5,tut6,tut7 FROM character_tutorial WHERE account = '%u' AND realmid = '%u'", GetAccountId(), realmID);
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADREPUTATION,      "SELECT faction,standing,flags FROM character_reputation WHERE guid = '%u'", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADINVENTORY,       "SELECT data,bag,slot,item,item_template FROM character_inventory JOIN item_instance ON character_inventory.item = item_instance.guid WHERE character_inventory.guid = '%u' ORDER BY bag,slot", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADACTIONS,         "SELECT button,action,type,misc FROM character_action WHERE guid = '%u' ORDER BY button", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADMAILCOUNT,       "SELECT COUNT(id) FROM mail WHERE receiver = '%u' AND (checked & 1)=0 AND deliver_time <= '" UI64FMTD "'", GUID_LOPART(m_guid),(uint64)time(NULL));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADMAILDATE,        "SELECT MIN(deliver_time) FROM mail WHERE receiver = '%u' AND (checked & 1)=0", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADSOCIALLIST,      "SELECT friend,flags,note FROM character_social WHERE guid = '%u' LIMIT 255", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADHOMEBIND,        "SELECT map,zone,position_x,position_y,position_z FROM character_homebind WHERE guid = '%u'", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADSPELLCOOLDOWNS,  "SELECT spell,item,time FROM character_spell_cooldown WHERE guid = '%u'", GUID_LOPART(m_guid));
+    uint32 lowGuid = GUID_LOPART(m_guid);
+
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADFROM,              CHAR_SEL_CHARACTER,                   SqlStmtParameters(1).addUInt32(lowGuid));
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADGROUP,             CHAR_SEL_GROUP_MEMBER,                SqlStmtParameters(1).addUInt32(lowGuid));
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADBOUNDINSTANCES,    CHAR_SEL_CHARACTER_INSTANCE,          SqlStmtParameters(1).addUInt32(lowGuid));
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADAURAS,             CHAR_SEL_CHARACTER_AURAS,             SqlStmtParameters(1).addUInt32(lowGuid));
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADSPELLS,            CHAR_SEL_CHARACTER_SPELLS,            SqlStmtParameters(1).addUInt32(lowGuid));
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADQUESTSTATUS,       CHAR_SEL_CHARACTER_QUESTSTATUS,       SqlStmtParameters(1).addUInt32(lowGuid));
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADDAILYQUESTSTATUS,  CHAR_SEL_CHARACTER_QUESTSTATUS_DAILY, SqlStmtParameters(1).addUInt32(lowGuid));
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADTUTORIALS,         CHAR_SEL_CHARACTER_TUTORIALS,         SqlStmtParameters(2).addUInt32(GetAccountId()).addUInt32(realmID));
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADREPUTATION,        CHAR_SEL_CHARACTER_REPUTATION,        SqlStmtParameters(1).addUInt32(lowGuid));
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADINVENTORY,         CHAR_SEL_CHARACTER_INVENTORY,         SqlStmtParameters(1).addUInt32(lowGuid));
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADACTIONS,           CHAR_SEL_CHARACTER_ACTIONS,           SqlStmtParameters(1).addUInt32(lowGuid));
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADMAILCOUNT,         CHAR_SEL_MAIL_COUNT,                  SqlStmtParameters(2).addUInt32(lowGuid).addUInt64(uint64(time(NULL))));
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADMAILDATE,          CHAR_SEL_MAIL_DATE,                   SqlStmtParameters(1).addUInt32(lowGuid));
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADSOCIALLIST,        CHAR_SEL_CHARACTER_SOCIAL,            SqlStmtParameters(1).addUInt32(lowGuid));
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADHOMEBIND,          CHAR_SEL_CHARACTER_HOMEBIND,          SqlStmtParameters(1).addUInt32(lowGuid));
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADSPELLCOOLDOWNS,    CHAR_SEL_CHARACTER_SPELL_COOLDOWNS,   SqlStmtParameters(1).addUInt32(lowGuid));
     if (sWorld.getConfig(CONFIG_DECLINED_NAMES_USED))
-        res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADDECLINEDNAMES,   "SELECT genitive, dative, accusative, instrumental, prepositional FROM character_declinedname WHERE guid = '%u'",GUID_LOPART(m_guid));
+        res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADDECLINEDNAMES, CHAR_SEL_CHARACTER_DECLINEDNAMES,     SqlStmtParameters(1).addUInt32(lowGuid));
     // in other case still be dummy query
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADGUILD,           "SELECT guildid,rank FROM guild_member WHERE guid = '%u'", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADARENAINFO,       "SELECT arenateamid, played_week, played_season, personal_rating FROM arena_team_member WHERE guid='%u'", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADBGDATA,          "SELECT instance_id, team, join_x, join_y, join_z, join_o, join_map, taxi_start, taxi_end, mount_spell FROM character_battleground_data WHERE guid = '%u'", GUID_LOPART(m_guid));
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADSKILLS,          "SELECT skill, value, max FROM character_skills WHERE guid = '%u'", GUID_LOPART(m_guid));
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADGUILD,             CHAR_SEL_GUILD_MEMBER,                SqlStmtParameters(1).addUInt32(lowGuid));
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADARENAINFO,         CHAR_SEL_ARENA_TEAM_MEMBER,           SqlStmtParameters(1).addUInt32(lowGuid));
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADBGDATA,            CHAR_SEL_CHARACTER_BGDATA,            SqlStmtParameters(1).addUInt32(lowGuid));
+    res &= SetPreparedQuery(PLAYER_LOGIN_QUERY_LOADSKILLS,            CHAR_SEL_CHARACTER_SKILLS,            SqlStmtParameters(1).addUInt32(lowGuid));
 
     return res;
 }
@@ -155,7 +143,9 @@ void WorldSession::HandleCharEnum(QueryResult_AutoPtr result)
 
 void WorldSession::HandleCharEnumOpcode(WorldPacket & /*recv_data*/)
 {
-    // get all the data necessary for loading all characters (along with their pets) on the account
+    // get all the data necessary for loading all characters (along with their pets) on the account,
+    // after the creates, deletes and saves of all of them whatever their key
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, SQL_ASYNC_KEY_ALL);
     CharacterDatabase.AsyncPQuery(&chrHandler, &CharacterHandler::HandleCharEnumCallback, GetAccountId(),
          !sWorld.getConfig(CONFIG_DECLINED_NAMES_USED) ?
     //   ------- Query Without Declined Names --------
@@ -465,6 +455,8 @@ void WorldSession::HandlePlayerLoginOpcode(WorldPacket & recv_data)
         return;
     }
 
+    // after the saves of the character at its last logout
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, GUID_LOPART(playerGuid));
     CharacterDatabase.DelayQueryHolder(&chrHandler, &CharacterHandler::HandlePlayerLoginCallback, holder);
 }
 
@@ -629,7 +621,10 @@ void WorldSession::HandlePlayerLogin(LoginQueryHolder * holder)
 
     pCurrChar->SendInitialPacketsAfterAddToMap();
 
-    CharacterDatabase.PExecute("UPDATE characters SET online = 1 WHERE guid = '%u'", pCurrChar->GetGUIDLow());
+    {
+        SqlAsyncKeyGuard asyncKey(CharacterDatabase, pCurrChar->GetGUIDLow());
+        CharacterDatabase.PExecute("UPDATE characters SET online = 1 WHERE guid = '%u'", pCurrChar->GetGUIDLow());
+    }
     LoginDatabase.PExecute("UPDATE account SET online = %d WHERE id = '%u'", realmID, GetAccountId());
     pCurrChar->SetInGameTime(getMSTime());
 
@@ -887,6 +882,7 @@ void WorldSession::HandleChangePlayerNameOpcode(WorldPacket& recv_data)
 
     // make sure that the character belongs to the current account, that rename at login is enabled
     // and that there is no character with the desired new name
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, GUID_LOPART(guid));
     CharacterDatabase.AsyncPQuery(&WorldSession::HandleChangePlayerNameOpcodeCallBack,
         GetAccountId(), newname,
         "SELECT guid, name FROM characters WHERE guid = %d AND account = %d AND (at_login & %d) = %d AND NOT EXISTS (SELECT NULL FROM characters WHERE name = '%s')",
@@ -912,8 +908,12 @@ void WorldSession::HandleChangePlayerNameOpcodeCallBack(QueryResult_AutoPtr resu
     uint64 guid = MAKE_NEW_GUID(guidLow, 0, HIGHGUID_PLAYER);
     std::string oldname = result->Fetch()[1].GetCppString();
 
-    CharacterDatabase.PExecute("UPDATE characters set name = '%s', at_login = at_login & ~ %u WHERE guid ='%u'", newname.c_str(), uint32(AT_LOGIN_RENAME), guidLow);
-    CharacterDatabase.PExecute("DELETE FROM character_declinedname WHERE guid ='%u'", guidLow);
+    {
+        // after the saves of the character, a logout save must not write the old name back
+        SqlAsyncKeyGuard asyncKey(CharacterDatabase, guidLow);
+        CharacterDatabase.PExecute("UPDATE characters set name = '%s', at_login = at_login & ~ %u WHERE guid ='%u'", newname.c_str(), uint32(AT_LOGIN_RENAME), guidLow);
+        CharacterDatabase.PExecute("DELETE FROM character_declinedname WHERE guid ='%u'", guidLow);
+    }
 
     sLog.outChar("Account: %d (IP: %s) Character:[%s] (guid:%u) Changed name to: %s", session->GetAccountId(), session->GetRemoteAddress().c_str(), oldname.c_str(), guidLow, newname.c_str());
 
@@ -999,6 +999,7 @@ void WorldSession::HandleDeclinedPlayerNameOpcode(WorldPacket& recv_data)
     for (int i = 0; i < MAX_DECLINED_NAME_CASES; ++i)
         CharacterDatabase.escape_string(declinedname.name[i]);
 
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, GUID_LOPART(guid));
     CharacterDatabase.BeginTransaction();
     CharacterDatabase.PExecute("DELETE FROM character_declinedname WHERE guid = '%u'", GUID_LOPART(guid));
     CharacterDatabase.PExecute("INSERT INTO character_declinedname (guid, genitive, dative, accusative, instrumental, prepositional) VALUES ('%u','%s','%s','%s','%s','%s')",
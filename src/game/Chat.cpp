@@ -64,6 +64,16 @@ ChatCommand * ChatHandler::getCommandTable()
         { "loglevel",       SEC_CONSOLE,        true,  &ChatHandler::HandleServerSetLogLevelCommand,   "", NULL },
         { "difftime",       SEC_CONSOLE,        true,  &ChatHandler::HandleServerSetDiffTimeCommand,   "", NULL },
         { "motd",           SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerSetMotdCommand,       "", NULL },
+        { "compression",    SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerSetCompressionCommand,"", NULL },
+        { NULL,             0,                  false, NULL,                                           "", NULL }
+    };
+
+    static ChatCommand serverStatsCommandTable[] =
+    {
+        { "compression",    SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerStatsCompressionCommand,"", NULL },
+        { "database",       SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerStatsDatabaseCommand,   "", NULL },
+        { "grids",          SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerStatsGridsCommand,      "", NULL },
+        { "vmap",           SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerStatsVMapCommand,       "", NULL },
         { NULL,             0,                  false, NULL,                                           "", NULL }
     };
 
@@ -107,6 +117,7 @@ ChatCommand * ChatHandler::getCommandTable()
         { "restart",        SEC_ADMINISTRATOR,  true,  NULL,                                           "", serverRestartCommandTable },
         { "shutdown",       SEC_ADMINISTRATOR,  true,  NULL,                                           "", serverShutdownCommandTable },
         { "set",            SEC_ADMINISTRATOR,  true,  NULL,                                           "", serverSetCommandTable },
+        { "stats",          SEC_ADMINISTRATOR,  true,  NULL,                                           "", serverStatsCommandTable },
         { NULL,             0,                  false, NULL,                                           "", NULL }
     };
 
@@ -244,6 +255,14 @@ ChatCommand * ChatHandler::getCommandTable()
         { "threatlist",     SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugThreatList,            "", NULL },
         { "setinstdata",    SEC_ADMINISTRATOR,  false, &ChatHandler::HandleSetInstanceDataCommand,     "", NULL },
         { "getinstdata",    SEC_ADMINISTRATOR,  false, &ChatHandler::HandleGetInstanceDataCommand,     "", NULL },
+        { "terrainbench",   SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugTerrainBenchCommand,   "", NULL },
+        { "visbench",       SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugVisibilityBenchCommand, "", NULL },
+        { "vmapbench",      SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugVMapBenchCommand,      "", NULL },
+        { "mmapbench",      SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugMMapBenchCommand,      "", NULL },
+        { "creatureupdate", SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugCreatureUpdateCommand, "", NULL },
+        { "eventbench",     SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugEventBenchCommand,     "", NULL },
+        { "threatbench",    SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugThreatBenchCommand,    "", NULL },
+        { "movementrelay",  SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugMovementRelayCommand,  "", NULL },
         { NULL,             0,                  false, NULL,                                           "", NULL }
     };
 
@@ -323,6 +323,11 @@ protected:
     bool HandleServerSetLogLevelCommand(const char* args);
     bool HandleServerSetMotdCommand(const char* args);
     bool HandleServerSetDiffTimeCommand(const char* args);
+    bool HandleServerSetCompressionCommand(const char* args);
+    bool HandleServerStatsCompressionCommand(const char* args);
+    bool HandleServerStatsDatabaseCommand(const char* args);
+    bool HandleServerStatsGridsCommand(const char* args);
+    bool HandleServerStatsVMapCommand(const char* args);
     bool HandleServerShutDownCommand(const char* args);
     bool HandleServerShutDownCancelCommand(const char* args);
 
@@ -517,6 +522,14 @@ protected:
     bool HandleDebugBattlegroundCommand(const char * args);
     bool HandleDebugThreatList(const char * args);
     bool HandleDebugHostilRefList(const char * args);
+    bool HandleDebugTerrainBenchCommand(const char* args);
+    bool HandleDebugVisibilityBenchCommand(const char* args);
+    bool HandleDebugVMapBenchCommand(const char* args);
+    bool HandleDebugMMapBenchCommand(const char* args);
+    bool HandleDebugCreatureUpdateCommand(const char* args);
+    bool HandleDebugEventBenchCommand(const char* args);
+    bool HandleDebugThreatBenchCommand(const char* args);
+    bool HandleDebugMovementRelayCommand(const char* args);
     bool HandlePossessCommand(const char* args);
     bool HandleUnPossessCommand(const char* args);
     bool HandleBindSightCommand(const char* args);
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ClientGUIDSet.h"
+
+// the table is kept at most half full
+#define CLIENT_GUID_SET_MIN_SLOTS 64
+
+ClientGUIDSet::Slot* ClientGUIDSet::Find(uint64 guid) const
+{
+    if (!guid || m_slots.empty())
+        return NULL;
+
+    size_t mask = m_slots.size() - 1;
+    for (size_t i = Home(guid);; i = (i + 1) & mask)
+    {
+        if (m_slots[i].guid == guid)
+            return &m_slots[i];
+        if (!m_slots[i].guid)
+            return NULL;
+    }
+}
+
+void ClientGUIDSet::insert(uint64 guid)
+{
+    if (!guid)
+        return;
+
+    if ((m_size + 1) * 2 > m_slots.size())
+        Grow();
+
+    size_t mask = m_slots.size() - 1;
+    size_t i = Home(guid);
+    while (m_slots[i].guid)
+    {
+        if (m_slots[i].guid == guid)
+        {
+            m_slots[i].pass = m_pass;
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+
+    m_slots[i].guid = guid;
+    m_slots[i].pass = m_pass;
+    ++m_size;
+}
+
+void ClientGUIDSet::erase(uint64 guid)
+{
+    Slot* slot = Find(guid);
+    if (!slot)
+        return;
+
+    // shift the following entries of the run back instead of leaving a tombstone
+    size_t mask = m_slots.size() - 1;
+    size_t i = slot - &m_slots[0];
+    for (size_t j = (i + 1) & mask; m_slots[j].guid; j = (j + 1) & mask)
+    {
+        size_t home = Home(m_slots[j].guid);
+        bool movable = i <= j ? (home <= i || home > j) : (home <= i && home > j);
+        if (movable)
+        {
+            m_slots[i] = m_slots[j];
+            i = j;
+        }
+    }
+
+    m_slots[i].guid = 0;
+    --m_size;
+}
+
+void ClientGUIDSet::clear()
+{
+    m_slots.clear();
+    m_size = 0;
+}
+
+uint32 ClientGUIDSet::BeginPass()
+{
+    // after the wrap around all entries must count as older than the new pass
+    if (++m_pass == 0)
+    {
+        for (size_t i = 0; i < m_slots.size(); ++i)
+            m_slots[i].pass = 0;
+        m_pass = 1;
+    }
+
+    return m_pass;
+}
+
+void ClientGUIDSet::TakeUntouched(uint32 pass, std::vector<uint64>& guids)
+{
+    size_t first = guids.size();
+    for (size_t i = 0; i < m_slots.size(); ++i)
+        if (m_slots[i].guid && m_slots[i].pass < pass)
+            guids.push_back(m_slots[i].guid);
+
+    for (size_t i = first; i < guids.size(); ++i)
+        erase(guids[i]);
+}
+
+void ClientGUIDSet::Grow()
+{
+    std::vector<Slot> old;
+    old.swap(m_slots);
+
+    Slot free = { 0, 0 };
+    m_slots.resize(old.empty() ? CLIENT_GUID_SET_MIN_SLOTS : old.size() * 2, free);
+
+    size_t mask = m_slots.size() - 1;
+    for (size_t j = 0; j < old.size(); ++j)
+    {
+        if (!old[j].guid)
+            continue;
+
+        size_t i = Home(old[j].guid);
+        while (m_slots[i].guid)
+            i = (i + 1) & mask;
+        m_slots[i] = old[j];
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLIENTGUIDSET_H
+#define __CLIENTGUIDSET_H
+
+#include "Common.h"
+
+#include <vector>
+
+// Guids of the objects a client knows about, an open addressing hash set with
+// linear probing. Each entry remembers the last visibility pass that saw it,
+// so a pass finds the objects that went out of range without copying the set.
+class ClientGUIDSet
+{
+    struct Slot
+    {
+        uint64 guid;                                        // 0 for free slots
+        uint32 pass;
+    };
+
+    public:
+        class const_iterator
+        {
+            public:
+                const_iterator(Slot const* slot, Slot const* end) : m_slot(slot), m_end(end) { Skip(); }
+
+                uint64 operator*() const { return m_slot->guid; }
+                const_iterator& operator++() { ++m_slot; Skip(); return *this; }
+                bool operator==(const_iterator const& other) const { return m_slot == other.m_slot; }
+                bool operator!=(const_iterator const& other) const { return m_slot != other.m_slot; }
+
+            private:
+                void Skip() { while (m_slot != m_end && !m_slot->guid) ++m_slot; }
+
+                Slot const* m_slot;
+                Slot const* m_end;
+        };
+        typedef const_iterator iterator;
+
+        ClientGUIDSet() : m_size(0), m_pass(1) {}
+
+        bool empty() const { return m_size == 0; }
+        size_t size() const { return m_size; }
+
+        const_iterator begin() const { return const_iterator(Slots(), Slots() + m_slots.size()); }
+        const_iterator end() const { return const_iterator(Slots() + m_slots.size(), Slots() + m_slots.size()); }
+
+        bool contains(uint64 guid) const { return Find(guid) != NULL; }
+        void insert(uint64 guid);
+        void erase(uint64 guid);
+        void clear();
+
+        // Starts a visibility pass, the objects found by it are marked with Touch
+        // and the ones left are taken by TakeUntouched at the end.
+        uint32 BeginPass();
+        void Touch(uint64 guid, uint32 pass)
+        {
+            if (Slot* slot = Find(guid))
+                if (slot->pass < pass)
+                    slot->pass = pass;
+        }
+        bool IsUntouched(uint64 guid, uint32 pass) const
+        {
+            Slot const* slot = Find(guid);
+            return slot && slot->pass < pass;
+        }
+        void TakeUntouched(uint32 pass, std::vector<uint64>& guids);
+
+    private:
+        Slot const* Slots() const { return m_slots.empty() ? NULL : &m_slots[0]; }
+        size_t Home(uint64 guid) const { return size_t((guid * UI64LIT(0x9E3779B97F4A7C15)) >> 32) & (m_slots.size() - 1); }
+
+        Slot* Find(uint64 guid) const;
+        void Grow();
+
+        // mutable only to share Find between the const and the non const users
+        mutable std::vector<Slot> m_slots;
+        size_t m_size;
+        uint32 m_pass;
+};
+#endif
@@ -31,6 +31,7 @@ class AggressorAI : public CreatureAI
         explicit AggressorAI(Creature *c) : CreatureAI(c) {}
 
         void UpdateAI(const uint32);
+        uint32 GetIdleTime() const { return AI_IDLE_FOREVER; }
         static int Permissible(const Creature *);
 };
 
@@ -46,6 +47,7 @@ class CombatAI : public CreatureAI
         void EnterCombat(Unit* who);
         void JustDied(Unit *killer);
         void UpdateAI(const uint32 diff);
+        uint32 GetIdleTime() const { return AI_IDLE_FOREVER; }
         static int Permissible(const Creature *);
     protected:
         EventMap events;
@@ -43,14 +43,22 @@ ConfusedMovementGenerator<T>::Initialize(T &unit)
 
     VMAP::IVMapManager *vMaps = VMAP::VMapFactory::createOrGetVMapManager();
 
+    // the heights of all the waypoints are looked up at once
+    float wanderXs[MAX_CONF_WAYPOINTS+1], wanderYs[MAX_CONF_WAYPOINTS+1], wanderZs[MAX_CONF_WAYPOINTS+1];
     for (uint8 idx = 0; idx <= MAX_CONF_WAYPOINTS; ++idx)
     {
-        float wanderX = x + wander_distance*rand_norm() - wander_distance/2;
-        float wanderY = y + wander_distance*rand_norm() - wander_distance/2;
-        Oregon::NormalizeMapCoord(wanderX);
-        Oregon::NormalizeMapCoord(wanderY);
+        wanderXs[idx] = x + wander_distance*rand_norm() - wander_distance/2;
+        wanderYs[idx] = y + wander_distance*rand_norm() - wander_distance/2;
+        Oregon::NormalizeMapCoord(wanderXs[idx]);
+        Oregon::NormalizeMapCoord(wanderYs[idx]);
+    }
+    map->GetHeights(wanderXs, wanderYs, z, wanderZs, MAX_CONF_WAYPOINTS+1, true);
 
-        float new_z = map->GetHeight(wanderX, wanderY, z, true);
+    for (uint8 idx = 0; idx <= MAX_CONF_WAYPOINTS; ++idx)
+    {
+        float wanderX = wanderXs[idx];
+        float wanderY = wanderYs[idx];
+        float new_z = wanderZs[idx];
         if (new_z > INVALID_HEIGHT && unit.IsWithinLOS(wanderX, wanderY, new_z))
         {
             // Don't move in water if we're not already in
@@ -155,10 +155,13 @@ m_respawnradius(0.0f), m_emoteState(0), m_summonMask(SUMMON_MASK_NONE), m_reactS
 m_defaultMovementType(IDLE_MOTION_TYPE), m_DBTableGuid(0), m_equipmentId(0),
 m_AlreadyCallAssistance(false), m_AlreadySearchedAssistance(false), m_regenHealth(true), m_AI_locked(false), m_isDeadByDefault(false),
 m_meleeDamageSchoolMask(SPELL_SCHOOL_MASK_NORMAL), DisableReputationGain(false), m_creatureData(NULL),
-m_formation(NULL), m_group(NULL), m_creatureInfo(NULL)
+m_formation(NULL), m_group(NULL), m_creatureInfo(NULL),
+m_sleeping(0), m_sleepStart(0), m_wakeTime(0), m_sleepDiff(0)
 {
     m_valuesCount = UNIT_END;
 
+    m_Events.SetAddHook(&Creature::OnEventAdded, this);
+
     for (uint8 i = 0; i < 4; ++i)
         m_spells[i] = 0;
 
@@ -198,6 +201,8 @@ void Creature::RemoveFromWorld()
             m_zoneScript->OnCreatureCreate(this, false);
         if (m_formation)
             formation_mgr.RemoveCreatureFromFormation(m_formation, this);
+        WakeUp();
+        m_sleepDiff = 0;
         Unit::RemoveFromWorld();
         ObjectAccessor::Instance().RemoveObject(this);
     }
@@ -475,6 +480,13 @@ bool Creature::UpdateEntry(uint32 Entry, uint32 team, const CreatureData *data)
 
 void Creature::Update(uint32 diff)
 {
+    // the ticks skipped while asleep
+    if (m_sleepDiff)
+    {
+        diff += m_sleepDiff;
+        m_sleepDiff = 0;
+    }
+
     if (m_GlobalCooldown <= diff)
         m_GlobalCooldown = 0;
     else
@@ -617,6 +629,77 @@ void Creature::Update(uint32 diff)
         default:
             break;
     }
+
+    TrySleep();
+}
+
+// nothing but timers would change in Creature::Update, the few that run out
+// of combat are made up for by the time slept
+bool Creature::IsIdle() const
+{
+    if (m_deathState != ALIVE || m_isDeadByDefault || !IsAIEnabled || NeedChangeAI || IsInEvadeMode())
+        return false;
+
+    if (m_summonMask != SUMMON_MASK_NONE || isCharmed() || GetOwnerGUID() || isInCombat() || getVictim())
+        return false;
+
+    if (GetHealth() < GetMaxHealth() || GetPower(POWER_MANA) < GetMaxPower(POWER_MANA) || HasFlag(UNIT_DYNAMIC_FLAGS, UNIT_DYNFLAG_OTHER_TAGGER))
+        return false;
+
+    if (i_motionMaster.GetCurrentMovementGeneratorType() != IDLE_MOTION_TYPE)
+        return false;
+
+    for (uint32 i = 0; i < CURRENT_MAX_SPELL; ++i)
+        if (GetCurrentSpell(i))
+            return false;
+
+    if (!m_dynObjGUIDs.empty() || !m_gameObj.empty() || !m_removedAuras.empty())
+        return false;
+
+    for (uint32 i = 0; i < MAX_REACTIVE; ++i)
+        if (m_reactiveTimer[i])
+            return false;
+
+    // permanent auras without ticks only
+    for (AuraMap::const_iterator itr = m_Auras.begin(); itr != m_Auras.end(); ++itr)
+    {
+        Aura const* aura = itr->second;
+        if (aura->GetAuraDuration() >= 0 || aura->IsPeriodic() || aura->IsAreaAura())
+            return false;
+    }
+
+    return true;
+}
+
+void Creature::TrySleep()
+{
+    uint32 maxSleep = sWorld.getConfig(CONFIG_CREATURE_IDLE_SLEEP);
+    if (!maxSleep || IsSleeping() || !IsInWorld() || !IsIdle())
+        return;
+
+    uint32 sleep = AI()->GetIdleTime();
+
+    // the first pending event ends the sleep too
+    if (!m_Events.Empty())
+        sleep = uint32(std::min(uint64(sleep), m_Events.GetTimeToFirstEvent()));
+
+    sleep = std::min(sleep, maxSleep);
+    if (sleep)
+        GetMap()->GetCreatureWheel().Schedule(this, sleep);
+}
+
+void Creature::_WakeUp()
+{
+    GetMap()->GetCreatureWheel().Cancel(this);
+}
+
+uint64 Creature::OnEventAdded(void* owner)
+{
+    // the events are run by the update, the time slept is only added to it
+    // by the next one
+    Creature* creature = static_cast<Creature*>(owner);
+    creature->WakeUp();
+    return creature->m_sleepDiff;
 }
 
 void Creature::RegenerateMana()
@@ -685,6 +768,8 @@ bool Creature::AIM_Initialize(CreatureAI* ai)
         return false;
     }
 
+    WakeUp();
+
     UnitAI *oldAI = i_AI;
     i_motionMaster.Initialize();
     i_AI = ai ? ai : FactorySelector::selectAI(this);
@@ -1366,6 +1451,8 @@ float Creature::GetAttackDistance(Unit const* pl) const
 
 void Creature::setDeathState(DeathState s)
 {
+    WakeUp();
+
     if ((s == JUST_DIED && !m_isDeadByDefault)||(s == JUST_ALIVED && m_isDeadByDefault))
     {
         m_corpseRemoveTime = time(NULL) + m_corpseDelay;
@@ -1670,16 +1757,9 @@ void Creature::DoFleeToGetAssistance()
     {
         Creature* pCreature = NULL;
 
-        CellPair p(Oregon::ComputeCellPair(GetPositionX(), GetPositionY()));
-        Cell cell(p);
-        cell.data.Part.reserved = ALL_DISTRICT;
-        cell.SetNoCreate();
         Oregon::NearestAssistCreatureInCreatureRangeCheck u_check(this, getVictim(), radius);
         Oregon::CreatureLastSearcher<Oregon::NearestAssistCreatureInCreatureRangeCheck> searcher(pCreature, u_check);
-
-        TypeContainerVisitor<Oregon::CreatureLastSearcher<Oregon::NearestAssistCreatureInCreatureRangeCheck>, GridTypeMapContainer > grid_creature_searcher(searcher);
-
-        cell.Visit(p, grid_creature_searcher, *GetMap(), *this, radius);
+        VisitNearbyGridObjectInRange(radius, TYPEMASK_UNIT, searcher);
 
         SetNoSearchAssistance(true);
         if (!pCreature)
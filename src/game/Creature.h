@@ -429,6 +429,12 @@ class Creature : public Unit, public GridObject<Creature>
         char const* GetSubName() const { return GetCreatureInfo()->SubName; }
 
         void Update(uint32 time);                         // overwrited Unit::Update
+
+        // asleep creatures are skipped by the map update, see CreatureUpdateWheel,
+        // anything that gives the creature something to do must wake it, adding
+        // an event to m_Events does
+        bool IsSleeping() const { return m_sleeping.value() != 0; }
+        void WakeUp() { if (IsSleeping()) _WakeUp(); }
         void GetRespawnCoord(float &x, float &y, float &z, float* ori = NULL, float* dist =NULL) const;
         uint32 GetEquipmentId() const { return m_equipmentId; }
 
@@ -711,6 +717,20 @@ class Creature : public Unit, public GridObject<Creature>
         CreatureData const* m_creatureData;
 
     private:
+        friend class CreatureUpdateWheel;
+
+        bool IsIdle() const;
+        void TrySleep();
+        void _WakeUp();
+        // every new event wakes the creature, see EventProcessor::SetAddHook
+        static uint64 OnEventAdded(void* owner);
+
+        // written under the lock of the wheel, read without it by the cell updates
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_sleeping;
+        uint32 m_sleepStart;                                // map times of CreatureUpdateWheel
+        uint32 m_wakeTime;
+        uint32 m_sleepDiff;                                 // time slept, added to the next update
+
         //WaypointMovementGenerator vars
         uint32 m_waypointID;
         uint32 m_path_id;
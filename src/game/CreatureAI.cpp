@@ -31,6 +31,7 @@ void CreatureAI::OnCharmed(bool /*apply*/)
     //me->IsAIEnabled = !apply;*/
     me->NeedChangeAI = true;
     me->IsAIEnabled = false;
+    me->WakeUp();
 }
 
 AISpellInfoType * UnitAI::AISpellInfo;
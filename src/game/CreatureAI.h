@@ -31,6 +31,7 @@ struct SpellEntry;
 
 #define TIME_INTERVAL_LOOK   5000
 #define VISIBILITY_RANGE    10000
+#define AI_IDLE_FOREVER     0xFFFFFFFF
 
 //Spell targets used by SelectSpell
 enum SelectTargetType
@@ -166,6 +167,10 @@ class CreatureAI : public UnitAI
 
         virtual void PassengerBoarded(Unit * /*who*/, int8 /*seatId*/, bool /*apply*/) {}
 
+        // ms the AI can go without UpdateAI while the creature is idle, see Creature::IsIdle,
+        // AI_IDLE_FOREVER if UpdateAI does nothing out of combat
+        virtual uint32 GetIdleTime() const { return 0; }
+
     protected:
         virtual void MoveInLineOfSight(Unit *);
 
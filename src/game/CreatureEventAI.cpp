@@ -116,6 +116,9 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
     if (pHolder.Event.event_inverse_phase_mask & (1 << Phase))
         return false;
 
+    // the actions can start anything, the creature updates are needed again
+    me->WakeUp();
+
     CreatureEventAI_Event const& event = pHolder.Event;
 
     //Check event conditions based on the event type, also reset events
@@ -552,9 +555,9 @@ void CreatureEventAI::ProcessAction(CreatureEventAI_Action const& action, uint32
             break;
         case ACTION_T_THREAT_ALL_PCT:
         {
-            std::list<HostileReference*>& threatList = me->getThreatManager().getThreatList();
-            for (std::list<HostileReference*>::iterator i = threatList.begin(); i != threatList.end(); ++i)
-                if (Unit* Temp = Unit::GetUnit(*me,(*i)->getUnitGuid()))
+            ThreatList& threatList = me->getThreatManager().getThreatList();
+            for (size_t i = 0; i < threatList.size(); ++i)
+                if (Unit* Temp = Unit::GetUnit(*me,threatList[i]->getUnitGuid()))
                     me->getThreatManager().modifyThreatPercent(Temp, action.threat_all_pct.percent);
             break;
         }
@@ -654,8 +657,8 @@ void CreatureEventAI::ProcessAction(CreatureEventAI_Action const& action, uint32
             break;
         case ACTION_T_CAST_EVENT_ALL:
         {
-            std::list<HostileReference*>& threatList = me->getThreatManager().getThreatList();
-            for (std::list<HostileReference*>::iterator i = threatList.begin(); i != threatList.end(); ++i)
+            ThreatList& threatList = me->getThreatManager().getThreatList();
+            for (ThreatList::iterator i = threatList.begin(); i != threatList.end(); ++i)
                 if (Unit* Temp = Unit::GetUnit(*me,(*i)->getUnitGuid()))
                     if (Temp->GetTypeId() == TYPEID_PLAYER)
                         Temp->ToPlayer()->CastedCreatureOrGO(action.cast_event_all.creatureId, me->GetGUID(), action.cast_event_all.spellId);
@@ -1036,6 +1039,25 @@ void CreatureEventAI::SpellHit(Unit* pUnit, const SpellEntry* pSpell)
                     ProcessEvent(*i, pUnit);
 }
 
+uint32 CreatureEventAI::GetIdleTime() const
+{
+    // out of combat only the timers of the enabled out of combat events run down
+    uint32 idleTime = AI_IDLE_FOREVER;
+    for (std::list<CreatureEventAIHolder>::const_iterator i = CreatureEventAIList.begin(); i != CreatureEventAIList.end(); ++i)
+    {
+        if ((*i).Event.event_type != EVENT_T_TIMER_OOC || !(*i).Enabled)
+            continue;
+
+        if ((*i).Event.event_inverse_phase_mask & (1 << Phase))
+            continue;
+
+        // EventDiff has passed since the timers were decremented
+        idleTime = std::min(idleTime, (*i).Time > EventDiff ? (*i).Time - EventDiff : 0);
+    }
+
+    return idleTime;
+}
+
 void CreatureEventAI::UpdateAI(const uint32 diff)
 {
     //Check if we are in combat (also updates calls threat update code)
@@ -72,9 +72,11 @@ extern CreatureFormationDataType    CreatureFormationDataMap;
 
 class CreatureFormation
 {
+    public:
+        typedef std::map<Creature*, Formation*>  CreatureFormationMemberType;
+
     private:
         Creature *m_leader;
-        typedef std::map<Creature*, Formation*>  CreatureFormationMemberType;
         CreatureFormationMemberType m_members;
 
         uint32 m_formationID;
@@ -88,6 +90,7 @@ class CreatureFormation
         Creature* getLeader() const { return m_leader; }
         uint32 GetId() const { return m_formationID; }
         bool isEmpty() const { return m_members.empty(); }
+        CreatureFormationMemberType const& GetMembers() const { return m_members; }
         bool isFormed() const { return m_Formed; }
 
         void AddMember(Creature *member);
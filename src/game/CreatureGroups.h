@@ -48,8 +48,10 @@ extern CreatureGroupDataType    CreatureGroupDataMap;
 
 class CreatureGroup
 {
-    private:
+    public:
         typedef std::map<Creature*, GroupInfo*>  CreatureGroupMemberType;
+
+    private:
         CreatureGroupMemberType m_members;
 
         uint32 m_groupID;
@@ -61,6 +63,7 @@ class CreatureGroup
 
         uint32 GetId() const { return m_groupID; }
         bool isEmpty() const { return m_members.empty(); }
+        CreatureGroupMemberType const& GetMembers() const { return m_members; }
 
         void AddMember(Creature *member);
         void RemoveMember(Creature *member);
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CreatureUpdateWheel.h"
+#include "Creature.h"
+
+#include <ace/Guard_T.h>
+
+#include <algorithm>
+
+CreatureUpdateWheel::CreatureUpdateWheel() : m_time(0), m_lastDiff(0), m_nextSlotTime(CREATURE_WHEEL_RESOLUTION), m_count(0)
+{
+}
+
+void CreatureUpdateWheel::Schedule(Creature* creature, uint32 sleepTime)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    if (creature->IsSleeping())
+        return;
+
+    // the slot starting at or after the wake time, never one already processed
+    creature->m_sleeping = 1;
+    creature->m_sleepStart = m_time;
+    creature->m_wakeTime = m_time + std::max(sleepTime, uint32(1));
+    m_slots[GetSlot(creature->m_wakeTime)].push_back(creature);
+    ++m_count;
+}
+
+void CreatureUpdateWheel::Cancel(Creature* creature)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    if (!creature->IsSleeping())
+        return;
+
+    std::vector<Creature*>& slot = m_slots[GetSlot(creature->m_wakeTime)];
+    std::vector<Creature*>::iterator itr = std::find(slot.begin(), slot.end(), creature);
+    if (itr != slot.end())
+    {
+        *itr = slot.back();
+        slot.pop_back();
+    }
+
+    Wake(creature);
+}
+
+void CreatureUpdateWheel::Update(uint32 diff)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    m_time += diff;
+    m_lastDiff = diff;
+
+    // differences instead of comparisons, the times wrap around
+    while (int32(m_time - m_nextSlotTime) >= 0)
+    {
+        std::vector<Creature*>& slot = m_slots[GetSlot(m_nextSlotTime)];
+        for (size_t i = 0; i < slot.size();)
+        {
+            Creature* creature = slot[i];
+            if (int32(m_time - creature->m_wakeTime) < 0)
+            {
+                ++i;
+                continue;
+            }
+
+            slot[i] = slot.back();
+            slot.pop_back();
+            Wake(creature);
+        }
+
+        m_nextSlotTime += CREATURE_WHEEL_RESOLUTION;
+    }
+}
+
+void CreatureUpdateWheel::Wake(Creature* creature)
+{
+    // the time of this tick is passed by the map update itself, a creature
+    // already skipped in this tick loses it
+    int32 slept = int32(m_time - m_lastDiff - creature->m_sleepStart);
+    creature->m_sleepDiff = slept > 0 ? uint32(slept) : 0;
+    creature->m_sleeping = 0;
+    --m_count;
+}
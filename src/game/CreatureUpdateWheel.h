@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CREATUREUPDATEWHEEL_H
+#define __CREATUREUPDATEWHEEL_H
+
+#include "Platform/Define.h"
+
+#include <ace/Thread_Mutex.h>
+
+#include <vector>
+
+class Creature;
+
+// one slot per 64 ms, a turn of the wheel is about 16 seconds
+#define CREATURE_WHEEL_RESOLUTION   64
+#define CREATURE_WHEEL_SLOTS        256
+
+// Creatures with nothing to do for a while are left out of the map update
+// until their time is due or something happens to them. The wheel only looks
+// at the slots that came due, a sleeping creature costs nothing per tick.
+// Sleeps longer than a turn stay in their slot for the extra turns.
+class CreatureUpdateWheel
+{
+    public:
+        CreatureUpdateWheel();
+
+        // map time in ms, wraps around
+        uint32 GetTime() const { return m_time; }
+        size_t GetSleepingCount() const { return m_count; }
+
+        // the creature is skipped by the map update for sleepTime ms
+        void Schedule(Creature* creature, uint32 sleepTime);
+        // wakes the creature before its time
+        void Cancel(Creature* creature);
+        // advances the map time and wakes the creatures that are due,
+        // called once per map update before anything else
+        void Update(uint32 diff);
+
+    private:
+        static uint32 GetSlot(uint32 time) { return ((time + CREATURE_WHEEL_RESOLUTION - 1) / CREATURE_WHEEL_RESOLUTION) % CREATURE_WHEEL_SLOTS; }
+
+        void Wake(Creature* creature);
+
+        std::vector<Creature*> m_slots[CREATURE_WHEEL_SLOTS];
+        uint32 m_time;
+        uint32 m_lastDiff;
+        uint32 m_nextSlotTime;                              // start of the first slot not processed yet
+        size_t m_count;
+
+        // creatures fall asleep and wake up during the parallel cell updates
+        ACE_Thread_Mutex m_lock;
+};
+#endif
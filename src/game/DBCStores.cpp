@@ -154,6 +154,10 @@ static bool LoadDBC_assert_print(uint32 fsize, uint32 rsize, const std::string&
     return false;
 }
 
+// DBC files mapped instead of read, see DBCStorage::Load
+static bool dbcMapFiles = false;
+static uint32 dbcInPlaceCount = 0;
+
 template<class T>
 inline void LoadDBC(uint32& availableDbcLocales, barGoLink& bar, StoreProblemList& errlist, DBCStorage<T>& storage, const std::string& dbc_path, const std::string& filename)
 {
@@ -161,16 +165,19 @@ inline void LoadDBC(uint32& availableDbcLocales, barGoLink& bar, StoreProblemLis
     ASSERT(DBCFileLoader::GetFormatRecordSize(storage.GetFormat()) == sizeof(T) || LoadDBC_assert_print(DBCFileLoader::GetFormatRecordSize(storage.GetFormat()),sizeof(T),filename));
 
     std::string dbc_filename = dbc_path + filename;
-    if (storage.Load(dbc_filename.c_str()))
+    if (storage.Load(dbc_filename.c_str(), dbcMapFiles))
     {
         bar.step();
+        if (storage.IsInPlace())
+            ++dbcInPlaceCount;
+
         for (uint8 i = 0; i < MAX_LOCALE; ++i)
         {
             if (!(availableDbcLocales & (1 << i)))
                 continue;
 
             std::string dbc_filename_loc = dbc_path + localeNames[i] + "/" + filename;
-            if (!storage.LoadStringsFrom(dbc_filename_loc.c_str()))
+            if (!storage.LoadStringsFrom(dbc_filename_loc.c_str(), dbcMapFiles))
                 availableDbcLocales &= ~(1<<i); // Mark as not available for speedup next checks
         }
     }
@@ -190,8 +197,11 @@ inline void LoadDBC(uint32& availableDbcLocales, barGoLink& bar, StoreProblemLis
     }
 }
 
-void LoadDBCStores(const std::string& dataPath)
+void LoadDBCStores(const std::string& dataPath, bool mapFiles)
 {
+    dbcMapFiles = mapFiles;
+    dbcInPlaceCount = 0;
+
     std::string dbcPath = dataPath + "dbc/";
     const uint32 DBCFilesCount = 60;
     barGoLink bar(DBCFilesCount);
@@ -480,7 +490,10 @@ void LoadDBCStores(const std::string& dataPath)
     }
 
     sLog.outString();
-    sLog.outString(">> Initialized %d data stores", DBCFilesCount);
+    if (dbcMapFiles)
+        sLog.outString(">> Initialized %d data stores, %u used in place of the mapped files", DBCFilesCount, dbcInPlaceCount);
+    else
+        sLog.outString(">> Initialized %d data stores", DBCFilesCount);
 }
 
 SimpleFactionsList const* GetFactionTeamList(uint32 faction)
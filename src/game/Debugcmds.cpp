@@ -35,6 +35,13 @@
 #include <fstream>
 #include "ObjectMgr.h"
 #include "InstanceData.h"
+#include "Util.h"
+#include "VMapFactory.h"
+#include "MoveMap.h"
+#include "CellImpl.h"
+#include "GridNotifiersImpl.h"
+
+#include <ace/High_Res_Timer.h>
 
 bool ChatHandler::HandleDebugInArcCommand(const char* /*args*/)
 {
@@ -607,8 +614,8 @@ bool ChatHandler::HandleDebugThreatList(const char * /*args*/)
     if (!target || target->isTotem() || target->isPet())
         return false;
 
-    std::list<HostileReference*>& tlist = target->getThreatManager().getThreatList();
-    std::list<HostileReference*>::iterator itr;
+    ThreatList& tlist = target->getThreatManager().getThreatList();
+    ThreatList::iterator itr;
     uint32 cnt = 0;
     PSendSysMessage("Threat list of %s (guid %u)",target->GetName(), target->GetGUIDLow());
     for (itr = tlist.begin(); itr != tlist.end(); ++itr)
@@ -694,3 +701,590 @@ bool ChatHandler::HandleGetInstanceDataCommand(const char *args)
     return true;
 }
 
+// Heights of random points in the grid of the player, one by one through
+// GetHeight() and at once through GetTerrainHeights(), both without vmaps
+bool ChatHandler::HandleDebugTerrainBenchCommand(const char* args)
+{
+    uint32 count = *args ? uint32(atoi(args)) : 100000;
+    if (!count || count > 10000000)
+        return false;
+
+    Player* player = m_session->GetPlayer();
+    Map* map = player->GetMap();
+
+    int gx = (int)(32 - player->GetPositionX() / SIZE_OF_GRIDS);
+    int gy = (int)(32 - player->GetPositionY() / SIZE_OF_GRIDS);
+    float lowX = (32 - gx - 1) * SIZE_OF_GRIDS + 0.01f;
+    float lowY = (32 - gy - 1) * SIZE_OF_GRIDS + 0.01f;
+
+    std::vector<float> x(count), y(count), z(count), scalar(count), batch(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        x[i] = lowX + float(rand_norm()) * (SIZE_OF_GRIDS - 0.02f);
+        y[i] = lowY + float(rand_norm()) * (SIZE_OF_GRIDS - 0.02f);
+        z[i] = player->GetPositionZ();
+    }
+
+    ACE_Time_Value start = ACE_High_Res_Timer::gettimeofday_hr();
+    for (uint32 i = 0; i < count; ++i)
+        scalar[i] = map->GetHeight(x[i], y[i], MAX_HEIGHT, false);
+    ACE_UINT64 scalarUs;
+    (ACE_High_Res_Timer::gettimeofday_hr() - start).to_usec(scalarUs);
+
+    start = ACE_High_Res_Timer::gettimeofday_hr();
+    map->GetTerrainHeights(&x[0], &y[0], &batch[0], count);
+    ACE_UINT64 batchUs;
+    (ACE_High_Res_Timer::gettimeofday_hr() - start).to_usec(batchUs);
+
+    uint32 mismatches = 0;
+    for (uint32 i = 0; i < count; ++i)
+        if (memcmp(&scalar[i], &batch[i], sizeof(float)) != 0)
+            ++mismatches;
+
+    std::vector<ZLiquidStatus> status(count);
+    start = ACE_High_Res_Timer::gettimeofday_hr();
+    map->GetTerrainLiquidStatus(&x[0], &y[0], &z[0], MAP_ALL_LIQUIDS, &status[0], NULL, count);
+    ACE_UINT64 liquidUs;
+    (ACE_High_Res_Timer::gettimeofday_hr() - start).to_usec(liquidUs);
+
+    PSendSysMessage("%u points in grid [%i,%i] of map %u", count, 63 - gx, 63 - gy, map->GetId());
+    PSendSysMessage("GetHeight: " UI64FMTD " us, GetTerrainHeights: " UI64FMTD " us, %u different results", scalarUs, batchUs, mismatches);
+    PSendSysMessage("GetTerrainLiquidStatus: " UI64FMTD " us", liquidUs);
+    return true;
+}
+
+// Line of sight from the player to #rays random points around, one ray at a
+// time and in packets. The query cache is off meanwhile, both runs trace every ray.
+bool ChatHandler::HandleDebugVMapBenchCommand(const char* args)
+{
+    uint32 count = *args ? uint32(atoi(args)) : 10000;
+    if (!count || count > 1000000)
+        return false;
+
+    Player* player = m_session->GetPlayer();
+    uint32 mapId = player->GetMapId();
+    float x = player->GetPositionX(), y = player->GetPositionY(), z = player->GetPositionZ() + 2.0f;
+
+    std::vector<float> tx(count), ty(count), tz(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        float angle = float(rand_norm()) * 2.0f * M_PI;
+        float dist = float(rand_norm()) * 40.0f;
+        tx[i] = x + dist * cos(angle);
+        ty[i] = y + dist * sin(angle);
+        tz[i] = z + float(rand_norm()) * 10.0f - 5.0f;
+    }
+
+    VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
+    uint32 cacheSize = vmgr->getQueryCacheStats().size;
+    vmgr->setQueryCacheSize(0);
+
+    std::vector<bool> scalar(count);
+    ACE_Time_Value start = ACE_High_Res_Timer::gettimeofday_hr();
+    for (uint32 i = 0; i < count; ++i)
+        scalar[i] = vmgr->isInLineOfSight(mapId, x, y, z, tx[i], ty[i], tz[i]);
+    ACE_UINT64 scalarUs;
+    (ACE_High_Res_Timer::gettimeofday_hr() - start).to_usec(scalarUs);
+
+    bool* batch = new bool[count];
+    start = ACE_High_Res_Timer::gettimeofday_hr();
+    vmgr->isInLineOfSightBatch(mapId, x, y, z, &tx[0], &ty[0], &tz[0], batch, count);
+    ACE_UINT64 batchUs;
+    (ACE_High_Res_Timer::gettimeofday_hr() - start).to_usec(batchUs);
+
+    vmgr->setQueryCacheSize(cacheSize);
+
+    uint32 blocked = 0, mismatches = 0;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        if (!scalar[i])
+            ++blocked;
+        if (scalar[i] != batch[i])
+            ++mismatches;
+    }
+    delete[] batch;
+
+    PSendSysMessage("%u rays within 40 yards on map %u, %u blocked", count, mapId, blocked);
+    PSendSysMessage("isInLineOfSight: " UI64FMTD " us, isInLineOfSightBatch: " UI64FMTD " us, %u different results", scalarUs, batchUs, mismatches);
+    return true;
+}
+
+// Paths between #paths random pairs of points within 60 yards on one core,
+// searched and then taken from the path cache
+bool ChatHandler::HandleDebugMMapBenchCommand(const char* args)
+{
+    uint32 count = *args ? uint32(atoi(args)) : 1000;
+    if (!count || count > 100000)
+        return false;
+
+    if (!sMoveMapMgr.IsEnabled())
+    {
+        SendSysMessage("Path finding is disabled (mmap.enablePathFinding)");
+        return true;
+    }
+
+    Player* player = m_session->GetPlayer();
+    Map* map = player->GetMap();
+    uint32 mapId = player->GetMapId();
+
+    std::vector<float> points(count * 6);
+    for (uint32 i = 0; i < count * 2; ++i)
+    {
+        float angle = float(rand_norm()) * 2.0f * M_PI;
+        float dist = float(rand_norm()) * 60.0f;
+        float* point = &points[i * 3];
+        point[0] = player->GetPositionX() + dist * cos(angle);
+        point[1] = player->GetPositionY() + dist * sin(angle);
+        point[2] = map->GetHeight(point[0], point[1], player->GetPositionZ() + 10.0f);
+    }
+
+    uint32 results[3] = { 0, 0, 0 };
+    uint32 corners = 0;
+    Path path;
+
+    ACE_Time_Value start = ACE_High_Res_Timer::gettimeofday_hr();
+    for (uint32 i = 0; i < count; ++i)
+    {
+        float const* p = &points[i * 6];
+        NavPathResult result = sMoveMapMgr.FindPath(mapId, p[0], p[1], p[2], p[3], p[4], p[5], path, false);
+        ++results[result];
+        if (result != NAV_PATH_NO_MESH)
+            corners += path.Size();
+    }
+    ACE_UINT64 searchUs;
+    (ACE_High_Res_Timer::gettimeofday_hr() - start).to_usec(searchUs);
+
+    // the first round fills the cache
+    ACE_UINT64 cachedUs = 0;
+    for (uint32 round = 0; round < 2; ++round)
+    {
+        start = ACE_High_Res_Timer::gettimeofday_hr();
+        for (uint32 i = 0; i < count; ++i)
+        {
+            float const* p = &points[i * 6];
+            sMoveMapMgr.FindPath(mapId, p[0], p[1], p[2], p[3], p[4], p[5], path);
+        }
+        (ACE_High_Res_Timer::gettimeofday_hr() - start).to_usec(cachedUs);
+    }
+
+    uint32 found = results[NAV_PATH_COMPLETE] + results[NAV_PATH_INCOMPLETE];
+    PSendSysMessage("%u paths within 60 yards on map %u: %u complete, %u incomplete, %u without mesh, %.1f points per path",
+        count, mapId, results[NAV_PATH_COMPLETE], results[NAV_PATH_INCOMPLETE], results[NAV_PATH_NO_MESH], found ? float(corners) / found : 0.0f);
+    PSendSysMessage("searched: " UI64FMTD " us (%.0f paths/s), cached: " UI64FMTD " us (%.0f paths/s)",
+        searchUs, searchUs ? count * 1000000.0 / searchUs : 0.0, cachedUs, cachedUs ? count * 1000000.0 / cachedUs : 0.0);
+    return true;
+}
+
+// Cost of the cell updates of your map since the last call against the number
+// of idle creatures left out of them, CreatureIdleSleep = 0 gives the cost
+// with every creature updated.
+bool ChatHandler::HandleDebugCreatureUpdateCommand(const char* /*args*/)
+{
+    Map* map = m_session->GetPlayer()->GetMap();
+    CreatureUpdateStats stats = map->GetCreatureUpdateStats(true);
+    if (!stats.ticks)
+    {
+        SendSysMessage("No map update since the last call");
+        return true;
+    }
+
+    PSendSysMessage("Map %u: %u creatures sleeping, idle sleep up to %u ms",
+        map->GetId(), uint32(map->GetCreatureWheel().GetSleepingCount()), sWorld.getConfig(CONFIG_CREATURE_IDLE_SLEEP));
+    PSendSysMessage(UI64FMTD " ticks, per tick: %.1f creatures updated, %.1f asleep, %.1f us in the cell updates (%.2f us per updated creature)",
+        stats.ticks, double(stats.updated) / stats.ticks, double(stats.asleep) / stats.ticks,
+        double(stats.cellTime) / stats.ticks, stats.updated ? double(stats.cellTime) / stats.updated : 0.0);
+    return true;
+}
+
+// One relocation of the player as Map::ProcessRelocationNotifies does it. With
+// everyMove the view of the client is updated at each move, as before
+// Visibility.RelocationLowerLimit.
+static void BenchPlayerRelocation(Player* player, float x, float y, float z, bool everyMove)
+{
+    Map* map = player->GetMap();
+    map->PlayerRelocation(player, x, y, z, player->GetOrientation());
+
+    bool updateClient = everyMove || player->m_clientVisibilityPending;
+    player->m_clientVisibilityPending = false;
+
+    CellPair pair(Oregon::ComputeCellPair(x, y));
+    Cell cell(pair);
+
+    Oregon::PlayerRelocationNotifier relocate(*player, updateClient);
+    TypeContainerVisitor<Oregon::PlayerRelocationNotifier, WorldTypeMapContainer > c2world_relocation(relocate);
+    TypeContainerVisitor<Oregon::PlayerRelocationNotifier, GridTypeMapContainer >  c2grid_relocation(relocate);
+
+    cell.Visit(pair, c2world_relocation, *map, *player, map->GetVisibilityDistance());
+    cell.Visit(pair, c2grid_relocation, *map, *player, map->GetVisibilityDistance());
+
+    if (updateClient)
+        relocate.SendToSelf();
+
+    player->ResetAllNotifies();
+}
+
+// Summons #creatures creatures of the entry within 40 yards and walks the
+// player #moves steps of 2 yards ahead through PlayerRelocationNotifier, first
+// updating the view of the client at every move, then as Map::PlayerRelocation
+// does now. The other players of the map are notified as in a real move. The
+// creatures react to the moves, better use it in gm mode.
+bool ChatHandler::HandleDebugVisibilityBenchCommand(const char* args)
+{
+    char* entryStr = strtok((char*)args, " ");
+    char* creaturesStr = strtok(NULL, " ");
+    char* movesStr = strtok(NULL, " ");
+
+    uint32 entry = entryStr ? uint32(atoi(entryStr)) : 0;
+    uint32 creatures = creaturesStr ? uint32(atoi(creaturesStr)) : 200;
+    uint32 moves = movesStr ? uint32(atoi(movesStr)) : 50;
+    if (!entry || !creatures || creatures > 5000 || !moves || moves > 1000)
+        return false;
+
+    if (!objmgr.GetCreatureTemplate(entry))
+    {
+        PSendSysMessage(LANG_COMMAND_INVALIDCREATUREID, entry);
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    Player* player = m_session->GetPlayer();
+    if (player->m_seer != player || player->isInFlight())
+        return false;
+
+    Map* map = player->GetMap();
+    float startX = player->GetPositionX(), startY = player->GetPositionY(), startZ = player->GetPositionZ();
+    float angle = player->GetOrientation();
+
+    uint32 summoned = 0;
+    for (uint32 i = 0; i < creatures; ++i)
+    {
+        float a = float(rand_norm()) * 2.0f * M_PI;
+        float dist = float(rand_norm()) * 40.0f;
+        float x = startX + dist * cos(a);
+        float y = startY + dist * sin(a);
+        float z = map->GetHeight(x, y, startZ + 10.0f);
+        if (z <= INVALID_HEIGHT)
+            z = startZ;
+
+        if (player->SummonCreature(entry, x, y, z, a, TEMPSUMMON_TIMED_DESPAWN, 10000))
+            ++summoned;
+    }
+
+    uint32 players = 0;
+    Map::PlayerList const& list = map->GetPlayers();
+    for (Map::PlayerList::const_iterator itr = list.begin(); itr != list.end(); ++itr)
+        if (itr->getSource() != player && itr->getSource()->IsWithinDistInMap(player, map->GetVisibilityDistance()))
+            ++players;
+
+    ACE_UINT64 runUs[2];
+    for (uint32 run = 0; run < 2; ++run)
+    {
+        // both runs start from the same place with the creatures at the client
+        BenchPlayerRelocation(player, startX, startY, startZ, true);
+
+        ACE_Time_Value start = ACE_High_Res_Timer::gettimeofday_hr();
+        for (uint32 i = 1; i <= moves; ++i)
+        {
+            float x = startX + 2.0f * i * cos(angle);
+            float y = startY + 2.0f * i * sin(angle);
+            BenchPlayerRelocation(player, x, y, map->GetHeight(x, y, startZ + 10.0f), run == 0);
+        }
+        (ACE_High_Res_Timer::gettimeofday_hr() - start).to_usec(runUs[run]);
+    }
+
+    BenchPlayerRelocation(player, startX, startY, startZ, true);
+
+    PSendSysMessage("%u moves of 2 yards among %u summoned creatures, %u other players around", moves, summoned, players);
+    PSendSysMessage("client view at every move: " UI64FMTD " us, with Visibility.RelocationLowerLimit %u: " UI64FMTD " us",
+        runUs[0], sWorld.getConfig(CONFIG_VISIBILITY_RELOCATION_LIMIT), runUs[1]);
+    return true;
+}
+
+// re-adds itself once, like a SpellEvent waiting for the spell to land
+class BenchEvent : public BasicEvent
+{
+    public:
+        BenchEvent(EventProcessor& events, bool repeat) : m_events(events), m_repeat(repeat) {}
+
+        bool Execute(uint64 e_time, uint32 /*p_time*/)
+        {
+            if (!m_repeat)
+                return true;
+
+            m_repeat = false;
+            m_events.AddEvent(this, e_time + 100, false);
+            return false;
+        }
+
+    private:
+        EventProcessor& m_events;
+        bool m_repeat;
+};
+
+// the std::multimap queue of heap allocated events EventProcessor had before
+class LegacyEventProcessor
+{
+    public:
+        struct Event
+        {
+            virtual ~Event() {}
+
+            bool repeat;
+            uint64 m_addTime;
+            uint64 m_execTime;
+        };
+
+        LegacyEventProcessor() : m_time(0) {}
+        ~LegacyEventProcessor()
+        {
+            for (std::multimap<uint64, Event*>::iterator itr = m_events.begin(); itr != m_events.end(); ++itr)
+                delete itr->second;
+        }
+
+        void Update(uint32 p_time)
+        {
+            m_time += p_time;
+
+            std::multimap<uint64, Event*>::iterator i;
+            while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+            {
+                Event* event = i->second;
+                uint64 e_time = i->first;
+                m_events.erase(i);
+
+                if (event->repeat)
+                {
+                    event->repeat = false;
+                    AddEvent(event, e_time + 100);
+                }
+                else
+                    delete event;
+            }
+        }
+
+        void AddEvent(Event* event, uint64 e_time)
+        {
+            event->m_addTime = m_time;
+            event->m_execTime = e_time;
+            m_events.insert(std::pair<uint64, Event*>(e_time, event));
+        }
+
+        uint64 CalculateTime(uint64 t_offset) const { return m_time + t_offset; }
+        bool Empty() const { return m_events.empty(); }
+
+    private:
+        uint64 m_time;
+        std::multimap<uint64, Event*> m_events;
+};
+
+static void AddBenchEvent(EventProcessor& events, uint32 delay, bool repeat)
+{
+    events.AddEvent(new BenchEvent(events, repeat), events.CalculateTime(delay));
+}
+
+static void AddBenchEvent(LegacyEventProcessor& events, uint32 delay, bool repeat)
+{
+    LegacyEventProcessor::Event* event = new LegacyEventProcessor::Event();
+    event->repeat = repeat;
+    events.AddEvent(event, events.CalculateTime(delay));
+}
+
+// the events are added over the first ticks, every other one runs twice
+template<class Processor>
+static ACE_UINT64 RunEventBench(std::vector<uint32> const& delays, uint32 units, uint32 addTicks)
+{
+    std::vector<Processor> processors(units);
+    size_t perTick = delays.size() / addTicks + 1;
+    size_t added = 0;
+
+    ACE_Time_Value start = ACE_High_Res_Timer::gettimeofday_hr();
+    for (uint32 tick = 0; ; ++tick)
+    {
+        for (size_t i = 0; i < perTick && added < delays.size(); ++i, ++added)
+            AddBenchEvent(processors[added % units], delays[added], (added & 1) != 0);
+
+        bool empty = true;
+        for (typename std::vector<Processor>::iterator itr = processors.begin(); itr != processors.end(); ++itr)
+        {
+            itr->Update(50);
+            empty = empty && itr->Empty();
+        }
+
+        if (empty && added == delays.size())
+            break;
+    }
+    ACE_UINT64 us;
+    (ACE_High_Res_Timer::gettimeofday_hr() - start).to_usec(us);
+    return us;
+}
+
+// Events with delays up to 3 s added to #units event processors over 5 s of
+// 50 ms ticks and run until none is left, the old multimap against the heap.
+bool ChatHandler::HandleDebugEventBenchCommand(const char* args)
+{
+    char* eventsStr = strtok((char*)args, " ");
+    char* unitsStr = strtok(NULL, " ");
+
+    uint32 count = eventsStr ? uint32(atoi(eventsStr)) : 100000;
+    uint32 units = unitsStr ? uint32(atoi(unitsStr)) : 200;
+    if (!count || count > 10000000 || !units || units > 100000)
+        return false;
+
+    std::vector<uint32> delays(count);
+    for (uint32 i = 0; i < count; ++i)
+        delays[i] = urand(0, 3000);
+
+    // the first run fills the free lists of the event slabs
+    RunEventBench<EventProcessor>(delays, units, 100);
+
+    ACE_UINT64 legacyUs = RunEventBench<LegacyEventProcessor>(delays, units, 100);
+    ACE_UINT64 heapUs = RunEventBench<EventProcessor>(delays, units, 100);
+
+    PSendSysMessage("%u events (%u executions) on %u units", count, count + count / 2, units);
+    PSendSysMessage("std::multimap: " UI64FMTD " us, heap and slabs: " UI64FMTD " us", legacyUs, heapUs);
+    return true;
+}
+
+// stands in for a HostileReference, the threat table only needs these two
+class BenchThreatRef
+{
+    public:
+        BenchThreatRef(uint64 guid) : m_guid(guid), m_threat(0.0f) {}
+
+        uint64 getUnitGuid() const { return m_guid; }
+        float getThreat() const { return m_threat; }
+        void addThreat(float threat) { m_threat += threat; }
+
+    private:
+        uint64 m_guid;
+        float m_threat;
+};
+
+static bool BenchThreatRefGreater(BenchThreatRef const* lhs, BenchThreatRef const* rhs)
+{
+    return lhs->getThreat() > rhs->getThreat();
+}
+
+static BenchThreatRef* FindBenchThreatRef(std::list<BenchThreatRef*>& refs, uint64 guid)
+{
+    for (std::list<BenchThreatRef*>::iterator itr = refs.begin(); itr != refs.end(); ++itr)
+        if ((*itr)->getUnitGuid() == guid)
+            return *itr;
+    return NULL;
+}
+
+// A boss with #attackers on its threat list for #ticks updates. Every tick
+// each attacker adds threat found by guid like ThreatManager::addThreat, the
+// tank the most, and the victim is taken from the sorted list. Every tenth
+// tick one attacker goes offline and the one offline before comes back.
+bool ChatHandler::HandleDebugThreatBenchCommand(const char* args)
+{
+    char* attackersStr = strtok((char*)args, " ");
+    char* ticksStr = strtok(NULL, " ");
+
+    uint32 attackers = attackersStr ? uint32(atoi(attackersStr)) : 40;
+    uint32 ticks = ticksStr ? uint32(atoi(ticksStr)) : 10000;
+    if (attackers < 2 || attackers > 1000 || !ticks || ticks > 1000000)
+        return false;
+
+    // the same guids, threats and moves for both runs
+    std::vector<uint64> guids(attackers);
+    for (uint32 i = 0; i < attackers; ++i)
+        guids[i] = MAKE_NEW_GUID(urand(1, 0xFFFFFF), 0, HIGHGUID_PLAYER);
+    std::vector<float> threats(attackers * 16);
+    for (size_t i = 0; i < threats.size(); ++i)
+        threats[i] = float(urand(0, 1000));
+
+    std::vector<BenchThreatRef> oldRefs, newRefs;
+    for (uint32 i = 0; i < attackers; ++i)
+    {
+        oldRefs.push_back(BenchThreatRef(guids[i]));
+        newRefs.push_back(BenchThreatRef(guids[i]));
+    }
+
+    uint64 oldVictims = 0;
+    ACE_Time_Value start = ACE_High_Res_Timer::gettimeofday_hr();
+    {
+        std::list<BenchThreatRef*> online, offline;
+        for (uint32 i = 0; i < attackers; ++i)
+            online.push_back(&oldRefs[i]);
+
+        for (uint32 tick = 0; tick < ticks; ++tick)
+        {
+            for (uint32 i = 0; i < attackers; ++i)
+                if (BenchThreatRef* ref = FindBenchThreatRef(online, guids[i]))
+                    ref->addThreat(threats[(tick * attackers + i) % threats.size()] * (i ? 1.0f : 3.0f));
+
+            online.sort(BenchThreatRefGreater);
+            oldVictims += online.front()->getUnitGuid() == guids[0];
+
+            if (tick % 10 == 0)
+            {
+                if (!offline.empty())
+                {
+                    online.push_back(offline.front());
+                    offline.pop_front();
+                }
+                BenchThreatRef* ref = &oldRefs[1 + tick % (attackers - 1)];
+                online.remove(ref);
+                offline.push_back(ref);
+            }
+        }
+    }
+    ACE_UINT64 oldUs;
+    (ACE_High_Res_Timer::gettimeofday_hr() - start).to_usec(oldUs);
+
+    uint64 newVictims = 0;
+    start = ACE_High_Res_Timer::gettimeofday_hr();
+    {
+        ThreatTable<BenchThreatRef> online, offline;
+        for (uint32 i = 0; i < attackers; ++i)
+            online.add(&newRefs[i]);
+
+        for (uint32 tick = 0; tick < ticks; ++tick)
+        {
+            for (uint32 i = 0; i < attackers; ++i)
+                if (BenchThreatRef* ref = online.find(guids[i]))
+                    ref->addThreat(threats[(tick * attackers + i) % threats.size()] * (i ? 1.0f : 3.0f));
+
+            online.sort();
+            newVictims += online.refs().front()->getUnitGuid() == guids[0];
+
+            if (tick % 10 == 0)
+            {
+                if (!offline.refs().empty())
+                {
+                    BenchThreatRef* back = offline.refs().front();
+                    offline.remove(back);
+                    online.add(back);
+                }
+                BenchThreatRef* ref = &newRefs[1 + tick % (attackers - 1)];
+                online.remove(ref);
+                offline.add(ref);
+            }
+        }
+    }
+    ACE_UINT64 newUs;
+    (ACE_High_Res_Timer::gettimeofday_hr() - start).to_usec(newUs);
+
+    PSendSysMessage("%u attackers, %u ticks, tank on top " UI64FMTD " / " UI64FMTD " ticks", attackers, ticks, oldVictims, newVictims);
+    PSendSysMessage("std::list: " UI64FMTD " us, ThreatTable: " UI64FMTD " us", oldUs, newUs);
+    return true;
+}
+
+bool ChatHandler::HandleDebugMovementRelayCommand(const char* /*args*/)
+{
+    Map* map = m_session->GetPlayer()->GetMap();
+    MovementRelayStats stats = map->GetMovementRelay().GetStats(true);
+    if (!stats.flushes)
+    {
+        SendSysMessage("No movement relayed since the last call");
+        return true;
+    }
+
+    PSendSysMessage("Map %u: " UI64FMTD " flushes, " UI64FMTD " movement packets received, " UI64FMTD " heartbeats merged",
+        map->GetId(), stats.flushes, stats.received, stats.merged);
+    PSendSysMessage(UI64FMTD " packets sent to observers (%.1f per packet), " UI64FMTD " heartbeats held back from far observers",
+        stats.delivered, stats.received > stats.merged ? double(stats.delivered) / (stats.received - stats.merged) : 0.0, stats.farSkipped);
+    return true;
+}
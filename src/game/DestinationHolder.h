@@ -22,6 +22,7 @@
 
 #include "Platform/Define.h"
 #include "Timer.h"
+#include "Path.h"
 
 class WorldObject;
 class Map;
@@ -37,13 +38,28 @@ class DestinationHolder
     bool i_destSet;
     float i_fromX, i_fromY, i_fromZ;
     float i_destX, i_destY, i_destZ;
+    Path i_path;                                            // the corners to walk along, the current one is i_destX..Z
+    uint32 i_pathNode;
 
     public:
         DestinationHolder() : i_tracker(TRAVELLER_UPDATE_INTERVAL), i_totalTravelTime(0), i_timeElapsed(0),
-            i_destSet(false), i_fromX(0), i_fromY(0), i_fromZ(0), i_destX(0), i_destY(0), i_destZ(0) {}
+            i_destSet(false), i_fromX(0), i_fromY(0), i_fromZ(0), i_destX(0), i_destY(0), i_destZ(0), i_pathNode(0) {}
 
         uint32 SetDestination(TRAVELLER &traveller, float dest_x, float dest_y, float dest_z, bool sendMove = true);
-        void GetDestination(float &x, float &y, float &z) const { x = i_destX; y = i_destY; z = i_destZ; }
+        // walks around the obstacles if the traveller has a path there, returns the time of the whole way
+        uint32 SetPathDestination(TRAVELLER &traveller, float dest_x, float dest_y, float dest_z);
+        void GetDestination(float &x, float &y, float &z) const
+        {
+            if (i_path.Empty())
+            {
+                x = i_destX; y = i_destY; z = i_destZ;
+            }
+            else
+            {
+                Path::PathNode const& node = i_path(i_path.Size() - 1);
+                x = node.x; y = node.y; z = node.z;
+            }
+        }
         bool UpdateExpired(void) const { return i_tracker.Passed(); }
         void ResetUpdate(uint32 t = TRAVELLER_UPDATE_INTERVAL) { i_tracker.Reset(t); }
         uint32 GetTotalTravelTime(void) const { return i_totalTravelTime; }
@@ -51,7 +67,7 @@ class DestinationHolder
         void ResetTravelTime() { i_totalTravelTime = 0; }
         bool HasDestination(void) const { return i_destSet; }
         float GetDestinationDiff(float x, float y, float z) const;
-        bool HasArrived(void) const { return (i_totalTravelTime == 0 || i_timeElapsed >= i_totalTravelTime); }
+        bool HasArrived(void) const { return (i_totalTravelTime == 0 || i_timeElapsed >= i_totalTravelTime) && !_hasPathNodesLeft(); }
         bool UpdateTraveller(TRAVELLER &traveller, uint32 diff, bool micro_movement=false);
         uint32 StartTravel(TRAVELLER &traveller, bool sendMove = true);
         void GetLocationNow(const Map * map, float &x, float &y, float &z, bool is3D = false) const;
@@ -60,6 +76,8 @@ class DestinationHolder
 
     private:
         void _findOffSetPoint(float x1, float y1, float x2, float y2, float offset, float &x, float &y);
+        bool _hasPathNodesLeft() const { return i_pathNode + 1 < i_path.Size(); }
+        void _startNextPathNode(TRAVELLER &traveller);
 
 };
 #endif
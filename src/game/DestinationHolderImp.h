@@ -69,10 +69,45 @@ DestinationHolder<TRAVELLER>::SetDestination(TRAVELLER &traveller, float dest_x,
     i_destX = dest_x;
     i_destY = dest_y;
     i_destZ = dest_z;
+    i_path.Clear();
+    i_pathNode = 0;
 
     return StartTravel(traveller, sendMove);
 }
 
+template<typename TRAVELLER>
+uint32
+DestinationHolder<TRAVELLER>::SetPathDestination(TRAVELLER &traveller, float dest_x, float dest_y, float dest_z)
+{
+    Path path;
+    if (!traveller.GetPath(dest_x, dest_y, dest_z, path))
+        return SetDestination(traveller, dest_x, dest_y, dest_z);
+
+    // the first node is where the traveller stands, the last is dest unless it was not reachable
+    Path::PathNode const& end = path(path.Size() - 1);
+    if (path.Size() <= 2)
+        return SetDestination(traveller, end.x, end.y, end.z);
+
+    SetDestination(traveller, path[1].x, path[1].y, path[1].z);
+    i_path = path;
+    i_pathNode = 1;
+    return traveller.GetTravelTime(i_path.GetTotalLength());
+}
+
+template<typename TRAVELLER>
+void
+DestinationHolder<TRAVELLER>::_startNextPathNode(TRAVELLER &traveller)
+{
+    // continue from the corner reached, the server position may still lag behind it
+    traveller.Relocation(i_destX, i_destY, i_destZ, traveller.GetTraveller().GetAngle(i_path[i_pathNode + 1].x, i_path[i_pathNode + 1].y));
+
+    ++i_pathNode;
+    i_destX = i_path[i_pathNode].x;
+    i_destY = i_path[i_pathNode].y;
+    i_destZ = i_path[i_pathNode].z;
+    StartTravel(traveller);
+}
+
 template<typename TRAVELLER>
 uint32
 DestinationHolder<TRAVELLER>::StartTravel(TRAVELLER &traveller, bool sendMove)
@@ -96,6 +131,14 @@ DestinationHolder<TRAVELLER>::UpdateTraveller(TRAVELLER &traveller, uint32 diff,
 {
     i_timeElapsed += diff;
 
+    // turn at the corners of a path right away
+    if (i_destSet && _hasPathNodesLeft() && i_timeElapsed >= i_totalTravelTime)
+    {
+        _startNextPathNode(traveller);
+        ResetUpdate();
+        return true;
+    }
+
     // Update every TRAVELLER_UPDATE_INTERVAL
     i_tracker.Update(diff);
     if (!i_tracker.Passed())
@@ -46,7 +46,7 @@ FleeingMovementGenerator<T>::_setTargetLocation(T &owner)
 
     owner.addUnitState(UNIT_STAT_FLEEING | UNIT_STAT_ROAMING);
     Traveller<T> traveller(owner);
-    i_destinationHolder.SetDestination(traveller, x, y, z);
+    i_destinationHolder.SetPathDestination(traveller, x, y, z);
 }
 
 template<>
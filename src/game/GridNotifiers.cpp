@@ -40,9 +40,9 @@ VisibleNotifier::SendToSelf()
     if (Transport* transport = i_player.GetTransport())
         for (Transport::PlayerSet::const_iterator itr = transport->GetPassengers().begin();itr != transport->GetPassengers().end();++itr)
         {
-            if (vis_guids.find((*itr)->GetGUID()) != vis_guids.end())
+            if (i_player.m_clientGUIDs.IsUntouched((*itr)->GetGUID(), i_pass))
             {
-                vis_guids.erase((*itr)->GetGUID());
+                i_player.m_clientGUIDs.Touch((*itr)->GetGUID(), i_pass);
 
                 i_player.UpdateVisibilityOf((*itr), i_data, i_visibleNow);
 
@@ -51,9 +51,10 @@ VisibleNotifier::SendToSelf()
             }
         }
 
-    for (Player::ClientGUIDs::const_iterator it = vis_guids.begin();it != vis_guids.end(); ++it)
+    std::vector<uint64> outOfRange;
+    i_player.m_clientGUIDs.TakeUntouched(i_pass, outOfRange);
+    for (std::vector<uint64>::const_iterator it = outOfRange.begin(); it != outOfRange.end(); ++it)
     {
-        i_player.m_clientGUIDs.erase(*it);
         i_data.AddOutOfRangeGUID(*it);
 
         if (IS_PLAYER_GUID(*it))
@@ -130,9 +131,12 @@ void PlayerRelocationNotifier::Visit(PlayerMapType &m)
     {
         Player* plr = iter->getSource();
 
-        vis_guids.erase(plr->GetGUID());
+        if (i_updateClient)
+        {
+            i_player.m_clientGUIDs.Touch(plr->GetGUID(), i_pass);
 
-        i_player.UpdateVisibilityOf(plr,i_data,i_visibleNow);
+            i_player.UpdateVisibilityOf(plr,i_data,i_visibleNow);
+        }
 
         if (plr->m_seer->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
             continue;
@@ -149,9 +153,12 @@ void PlayerRelocationNotifier::Visit(CreatureMapType &m)
     {
         Creature * c = iter->getSource();
 
-        vis_guids.erase(c->GetGUID());
+        if (i_updateClient)
+        {
+            i_player.m_clientGUIDs.Touch(c->GetGUID(), i_pass);
 
-        i_player.UpdateVisibilityOf(c,i_data,i_visibleNow);
+            i_player.UpdateVisibilityOf(c,i_data,i_visibleNow);
+        }
 
         if (relocated_for_ai && !c->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
             CreatureUnitRelocationWorker(c, &i_player);
@@ -221,14 +228,19 @@ void DelayedUnitRelocation::Visit(PlayerMapType &m)
         Cell cell2(pair2);
         //cell.SetNoCreate(); need load cells around viewPoint or player, that's why its commented
 
-        PlayerRelocationNotifier relocate(*player);
+        // a player moving less than Visibility.RelocationLowerLimit keeps the view of its client
+        bool updateClient = player->m_clientVisibilityPending || player != viewPoint;
+        player->m_clientVisibilityPending = false;
+
+        PlayerRelocationNotifier relocate(*player, updateClient);
         TypeContainerVisitor<PlayerRelocationNotifier, WorldTypeMapContainer > c2world_relocation(relocate);
         TypeContainerVisitor<PlayerRelocationNotifier, GridTypeMapContainer >  c2grid_relocation(relocate);
 
         cell2.Visit(pair2, c2world_relocation, i_map, *viewPoint, i_radius);
         cell2.Visit(pair2, c2grid_relocation, i_map, *viewPoint, i_radius);
 
-        relocate.SendToSelf();
+        if (updateClient)
+            relocate.SendToSelf();
     }
 }
 
@@ -320,60 +332,77 @@ void
 MessageDistDeliverer::Visit(PlayerMapType &m)
 {
     for (PlayerMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
-    {
-        Player *target = iter->getSource();
-
-        if (target->GetExactDistSq(i_source) > i_distSq)
-            continue;
-
-        // Send packet to all who are sharing the player's vision
-        if (!target->GetSharedVisionList().empty())
-        {
-            SharedVisionList::const_iterator i = target->GetSharedVisionList().begin();
-            for (; i != target->GetSharedVisionList().end(); ++i)
-                if ((*i)->m_seer == target)
-                    SendPacket(*i);
-        }
-
-        if (target->m_seer == target)
-            SendPacket(target);
-    }
+        VisitObject(iter->getSource());
 }
 
 void
 MessageDistDeliverer::Visit(CreatureMapType &m)
 {
     for (CreatureMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
+        VisitObject(iter->getSource());
+}
+
+void
+MessageDistDeliverer::Visit(DynamicObjectMapType &m)
+{
+    for (DynamicObjectMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
+        VisitObject(iter->getSource());
+}
+
+void
+MessageDistDeliverer::VisitObject(Player* target)
+{
+    float distSq = target->GetExactDistSq(i_source);
+    if (distSq > i_distSq)
+        return;
+
+    if (i_farDistSq && distSq > i_farDistSq)
     {
-        if (iter->getSource()->GetExactDistSq(i_source) > i_distSq)
-            continue;
+        ++i_farSkipped;
+        return;
+    }
 
-        // Send packet to all who are sharing the creature's vision
-        if (!iter->getSource()->GetSharedVisionList().empty())
-        {
-            SharedVisionList::const_iterator i = iter->getSource()->GetSharedVisionList().begin();
-            for (; i != iter->getSource()->GetSharedVisionList().end(); ++i)
-                if ((*i)->m_seer == iter->getSource())
-                    SendPacket(*i);
-        }
+    // Send packet to all who are sharing the player's vision
+    if (!target->GetSharedVisionList().empty())
+    {
+        SharedVisionList::const_iterator i = target->GetSharedVisionList().begin();
+        for (; i != target->GetSharedVisionList().end(); ++i)
+            if ((*i)->m_seer == target)
+                SendPacket(*i);
     }
+
+    if (target->m_seer == target)
+        SendPacket(target);
 }
 
 void
-MessageDistDeliverer::Visit(DynamicObjectMapType &m)
+MessageDistDeliverer::VisitObject(Creature* target)
 {
-    for (DynamicObjectMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
+    if (target->GetExactDistSq(i_source) > i_distSq)
+        return;
+
+    // Send packet to all who are sharing the creature's vision
+    if (!target->GetSharedVisionList().empty())
     {
-        if (iter->getSource()->GetExactDistSq(i_source) > i_distSq)
-            continue;
+        SharedVisionList::const_iterator i = target->GetSharedVisionList().begin();
+        for (; i != target->GetSharedVisionList().end(); ++i)
+            if ((*i)->m_seer == target)
+                SendPacket(*i);
+    }
+}
 
-        if (IS_PLAYER_GUID(iter->getSource()->GetCasterGUID()))
-        {
-            // Send packet back to the caster if the caster has vision of dynamic object
-            Player* caster = iter->getSource()->GetCaster()->ToPlayer();
-            if (caster && caster->m_seer == iter->getSource())
-                SendPacket(caster);
-        }
+void
+MessageDistDeliverer::VisitObject(DynamicObject* target)
+{
+    if (target->GetExactDistSq(i_source) > i_distSq)
+        return;
+
+    if (IS_PLAYER_GUID(target->GetCasterGUID()))
+    {
+        // Send packet back to the caster if the caster has vision of dynamic object
+        Player* caster = target->GetCaster()->ToPlayer();
+        if (caster && caster->m_seer == target)
+            SendPacket(caster);
     }
 }
 
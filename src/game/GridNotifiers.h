@@ -23,6 +23,7 @@
 #include "ObjectGridLoader.h"
 #include "ByteBuffer.h"
 #include "UpdateData.h"
+#include "SharedPacket.h"
 #include <iostream>
 
 #include "Corpse.h"
@@ -43,9 +44,9 @@ namespace Oregon
         Player &i_player;
         UpdateData i_data;
         std::set<Unit*> i_visibleNow;
-        Player::ClientGUIDs vis_guids;
+        uint32 i_pass;                                      // objects not seen by the pass are out of range
 
-        VisibleNotifier(Player &player) : i_player(player), vis_guids(player.m_clientGUIDs) {}
+        VisibleNotifier(Player &player) : i_player(player), i_pass(player.m_clientGUIDs.BeginPass()) {}
         template<class T> void Visit(GridRefManager<T> &m);
         void SendToSelf(void);
     };
@@ -63,9 +64,11 @@ namespace Oregon
 
     struct PlayerRelocationNotifier : public VisibleNotifier
     {
-        PlayerRelocationNotifier(Player &pl) : VisibleNotifier(pl) {}
+        bool i_updateClient;                                // false: only the objects around are told
 
-        template<class T> void Visit(GridRefManager<T> &m) { VisibleNotifier::Visit(m); }
+        PlayerRelocationNotifier(Player &pl, bool updateClient = true) : VisibleNotifier(pl), i_updateClient(updateClient) {}
+
+        template<class T> void Visit(GridRefManager<T> &m) { if (i_updateClient) VisibleNotifier::Visit(m); }
         void Visit(CreatureMapType &);
         void Visit(PlayerMapType &);
     };
@@ -126,16 +129,32 @@ namespace Oregon
         WorldPacket *i_message;
         float i_distSq;
         uint32 team;
+        SharedPacket* i_shared;                             // payload copied once for all receivers
+        float i_farDistSq;                                  // players beyond are left out, 0 for none
+        uint32 i_farSkipped;
+        uint32 i_delivered;
         MessageDistDeliverer(WorldObject *src, WorldPacket *msg, float dist, bool own_team_only = false)
             : i_source(src), i_message(msg), i_distSq(dist * dist)
             , team((own_team_only && src->GetTypeId() == TYPEID_PLAYER) ? ((Player*)src)->GetTeam() : 0)
+            , i_shared(NULL), i_farDistSq(0.0f), i_farSkipped(0), i_delivered(0)
+        {
+        }
+        ~MessageDistDeliverer()
         {
+            if (i_shared)
+                i_shared->RemoveReference();
         }
         void Visit(PlayerMapType &m);
         void Visit(CreatureMapType &m);
         void Visit(DynamicObjectMapType &m);
         template<class SKIP> void Visit(GridRefManager<SKIP> &) {}
 
+        // also called by Map::VisitWorldInRange
+        void VisitObject(Player* target);
+        void VisitObject(Creature* target);
+        void VisitObject(DynamicObject* target);
+        template<class SKIP> void VisitObject(SKIP*) {}
+
         void SendPacket(Player* plr)
         {
             // never send packet to self
@@ -143,14 +162,25 @@ namespace Oregon
                 return;
 
             if (WorldSession* session = plr->GetSession())
-                session->SendPacket(i_message);
+            {
+                if (!i_shared)
+                    i_shared = SharedPacket::Create(*i_message);
+                session->SendPacket(i_shared);
+                ++i_delivered;
+            }
         }
+
+    private:
+        MessageDistDeliverer(MessageDistDeliverer const&);
+        MessageDistDeliverer& operator=(MessageDistDeliverer const&);
     };
 
     struct ObjectUpdater
     {
         uint32 i_timeDiff;
-        explicit ObjectUpdater(const uint32 &diff) : i_timeDiff(diff) {}
+        uint32 i_creaturesUpdated;
+        uint32 i_creaturesAsleep;                           // skipped, see CreatureUpdateWheel
+        explicit ObjectUpdater(const uint32 &diff) : i_timeDiff(diff), i_creaturesUpdated(0), i_creaturesAsleep(0) {}
         template<class T> void Visit(GridRefManager<T> &m);
         void Visit(PlayerMapType &) {}
         void Visit(CorpseMapType &) {}
@@ -340,6 +370,14 @@ namespace Oregon
         void Visit(CreatureMapType &m);
 
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED> &) {}
+
+        // called by the InRange visits
+        void VisitObject(Player* u) { VisitUnit(u); }
+        void VisitObject(Creature* u) { VisitUnit(u); }
+        template<class NOT_INTERESTED> void VisitObject(NOT_INTERESTED*) {}
+
+    private:
+        void VisitUnit(Unit* u);
     };
 
     // Creature searchers
@@ -369,6 +407,10 @@ namespace Oregon
         void Visit(CreatureMapType &m);
 
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED> &) {}
+
+        // called by the InRange visits
+        void VisitObject(Creature* u);
+        template<class NOT_INTERESTED> void VisitObject(NOT_INTERESTED*) {}
     };
 
     template<class Check>
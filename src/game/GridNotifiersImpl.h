@@ -34,7 +34,7 @@ Oregon::VisibleNotifier::Visit(GridRefManager<T> &m)
 {
     for (typename GridRefManager<T>::iterator iter = m.begin(); iter != m.end(); ++iter)
     {
-        vis_guids.erase(iter->getSource()->GetGUID());
+        i_player.m_clientGUIDs.Touch(iter->getSource()->GetGUID(), i_pass);
         i_player.UpdateVisibilityOf(iter->getSource(),i_data,i_visibleNow);
     }
 }
@@ -43,8 +43,20 @@ inline void
 Oregon::ObjectUpdater::Visit(CreatureMapType &m)
 {
     for (CreatureMapType::iterator iter=m.begin(); iter != m.end(); ++iter)
-        if (iter->getSource()->IsInWorld() && !iter->getSource()->isSpiritService())
-            iter->getSource()->Update(i_timeDiff);
+    {
+        Creature* creature = iter->getSource();
+        if (!creature->IsInWorld() || creature->isSpiritService())
+            continue;
+
+        if (creature->IsSleeping())
+        {
+            ++i_creaturesAsleep;
+            continue;
+        }
+
+        creature->Update(i_timeDiff);
+        ++i_creaturesUpdated;
+    }
 }
 
 // SEARCHERS & LIST SEARCHERS & WORKERS
@@ -285,6 +297,13 @@ void Oregon::UnitListSearcher<Check>::Visit(CreatureMapType &m)
             i_objects.push_back(itr->getSource());
 }
 
+template<class Check>
+void Oregon::UnitListSearcher<Check>::VisitUnit(Unit* u)
+{
+    if (i_check(u))
+        i_objects.push_back(u);
+}
+
 // Creature searchers
 
 template<class Check>
@@ -314,6 +333,13 @@ void Oregon::CreatureLastSearcher<Check>::Visit(CreatureMapType &m)
     }
 }
 
+template<class Check>
+void Oregon::CreatureLastSearcher<Check>::VisitObject(Creature* u)
+{
+    if (i_check(u))
+        i_object = u;
+}
+
 template<class Check>
 void Oregon::CreatureListSearcher<Check>::Visit(CreatureMapType &m)
 {
@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GridPreloader.h"
+#include "Map.h"
+#include "World.h"
+#include "Timer.h"
+#include "VMapFactory.h"
+
+#include <ace/Guard_T.h>
+#include <ace/Method_Request.h>
+
+// grids nobody entered are dropped after this time
+#define GRID_PRELOAD_EXPIRY     60000
+// bounds the memory held by wrong predictions
+#define GRID_PRELOAD_MAX_GRIDS  64
+
+uint32 const GridLoadHistogramBounds[GRID_LOAD_HISTOGRAM_BUCKETS - 1] = { 1, 2, 5, 10, 20, 50, 100, 200, 500 };
+
+class GridPreloadRequest : public ACE_Method_Request
+{
+    public:
+        GridPreloader& m_preloader;
+        uint32 m_key;
+        GridPreloadRequest(GridPreloader& p, uint32 k) : m_preloader(p), m_key(k) {}
+        virtual int
+
+    call (void)
+    {
+        m_preloader.LoadGrid(m_key);
+        return 0;
+    }
+};
+
+PreloadedGrid::~PreloadedGrid()
+{
+    delete gridMap;
+
+    if (!vmapModels.empty())
+        VMAP::VMapFactory::createOrGetVMapManager()->releasePreloadedModels(vmapModels);
+}
+
+GridPreloader::GridPreloader() :
+m_executor(),
+m_mutex(),
+m_condition(m_mutex)
+{
+}
+
+GridPreloader::~GridPreloader()
+{
+    this->deactivate();
+}
+
+int GridPreloader::activate(size_t num_threads)
+{
+    return m_executor.activate(static_cast<int>(num_threads));
+}
+
+int GridPreloader::deactivate()
+{
+    int res = m_executor.deactivate();
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mutex, -1);
+    for (PreloadedGridMap::iterator itr = m_grids.begin(); itr != m_grids.end(); ++itr)
+        delete itr->second;
+    m_grids.clear();
+
+    return res;
+}
+
+bool GridPreloader::activated()
+{
+    return m_executor.activated();
+}
+
+void GridPreloader::Request(uint32 mapId, int gx, int gy)
+{
+    if (!activated())
+        return;
+
+    uint32 key = MakeKey(mapId, gx, gy);
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+    if (m_grids.find(key) != m_grids.end())
+        return;
+
+    if (m_grids.size() >= GRID_PRELOAD_MAX_GRIDS)
+    {
+        ACE_GUARD(ACE_Thread_Mutex, statsGuard, m_statsLock);
+        ++m_stats.dropped;
+        return;
+    }
+
+    if (m_executor.execute(new GridPreloadRequest(*this, key)) == -1)
+        return;
+
+    m_grids[key] = new PreloadedGrid(mapId, gx, gy);
+
+    ACE_GUARD(ACE_Thread_Mutex, statsGuard, m_statsLock);
+    ++m_stats.requested;
+}
+
+PreloadedGrid* GridPreloader::Take(uint32 mapId, int gx, int gy)
+{
+    uint32 key = MakeKey(mapId, gx, gy);
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mutex, NULL);
+
+    PreloadedGridMap::iterator itr = m_grids.find(key);
+    if (itr == m_grids.end())
+        return NULL;
+
+    // the file reads are already running, waiting is never slower than reading again
+    while (itr->second->state == PreloadedGrid::STATE_LOADING)
+    {
+        m_condition.wait();
+        itr = m_grids.find(key);
+    }
+
+    PreloadedGrid* grid = itr->second;
+    m_grids.erase(itr);
+
+    // the map loads it itself, the worker skips the missing entry
+    if (grid->state == PreloadedGrid::STATE_QUEUED)
+    {
+        delete grid;
+        return NULL;
+    }
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, statsGuard, m_statsLock, grid);
+    ++m_stats.used;
+    return grid;
+}
+
+void GridPreloader::Update()
+{
+    uint32 now = getMSTime();
+    uint32 expired = 0;
+
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+        for (PreloadedGridMap::iterator itr = m_grids.begin(); itr != m_grids.end();)
+        {
+            PreloadedGrid* grid = itr->second;
+            if (grid->state == PreloadedGrid::STATE_READY && getMSTimeDiff(grid->readyTime, now) > GRID_PRELOAD_EXPIRY)
+            {
+                delete grid;
+                m_grids.erase(itr++);
+                ++expired;
+            }
+            else
+                ++itr;
+        }
+    }
+
+    if (expired)
+    {
+        ACE_GUARD(ACE_Thread_Mutex, statsGuard, m_statsLock);
+        m_stats.expired += expired;
+    }
+}
+
+void GridPreloader::LoadGrid(uint32 key)
+{
+    uint32 mapId;
+    int gx, gy;
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+        PreloadedGridMap::iterator itr = m_grids.find(key);
+        if (itr == m_grids.end() || itr->second->state != PreloadedGrid::STATE_QUEUED)
+            return;
+
+        itr->second->state = PreloadedGrid::STATE_LOADING;
+        mapId = itr->second->mapId;
+        gx = itr->second->gx;
+        gy = itr->second->gy;
+    }
+
+    // same file as Map::LoadMap, on failure the map thread reads it again and reports the error
+    char tmp[512];
+    snprintf(tmp, sizeof(tmp), (sWorld.GetDataPath()+"maps/%03u%02u%02u.map").c_str(), mapId, gx, gy);
+    GridMap* gridMap = new GridMap();
+    if (!gridMap->loadData(tmp))
+    {
+        delete gridMap;
+        gridMap = NULL;
+    }
+
+    std::vector<std::string> vmapModels;
+    VMAP::VMapFactory::createOrGetVMapManager()->preloadMapTile((sWorld.GetDataPath()+"vmaps").c_str(), mapId, gx, gy, vmapModels);
+
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+        PreloadedGrid* grid = m_grids[key];                 // nobody removes loading entries
+        grid->gridMap = gridMap;
+        grid->vmapModels.swap(vmapModels);
+        grid->readyTime = getMSTime();
+        grid->state = PreloadedGrid::STATE_READY;
+        m_condition.broadcast();
+    }
+
+    ACE_GUARD(ACE_Thread_Mutex, statsGuard, m_statsLock);
+    ++m_stats.loaded;
+}
+
+void GridPreloader::RecordLoadTime(GridLoadStage stage, uint32 ms)
+{
+    uint32 bucket = 0;
+    while (bucket < GRID_LOAD_HISTOGRAM_BUCKETS - 1 && ms > GridLoadHistogramBounds[bucket])
+        ++bucket;
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_statsLock);
+    GridLoadHistogram& histogram = m_stats.stages[stage];
+    ++histogram.buckets[bucket];
+    ++histogram.count;
+    histogram.total += ms;
+    if (ms > histogram.max)
+        histogram.max = ms;
+}
+
+GridPreloadStats GridPreloader::GetStats()
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_statsLock, GridPreloadStats());
+    return m_stats;
+}
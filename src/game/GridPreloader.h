@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _GRID_PRELOADER_H_INCLUDED
+#define _GRID_PRELOADER_H_INCLUDED
+
+#include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+
+#include "Platform/Define.h"
+#include "Utilities/UnorderedMap.h"
+#include "DelayExecutor.h"
+
+#include <string>
+#include <vector>
+
+class GridMap;
+
+// how often the maps look for the grids their players are heading to
+#define GRID_PRELOAD_PREDICT_INTERVAL 1000
+
+enum GridLoadStage
+{
+    GRID_LOAD_STAGE_TERRAIN,                                // map and vmap read by the map thread
+    GRID_LOAD_STAGE_TERRAIN_PRELOADED,                      // map and vmap handed over by the preloader
+    GRID_LOAD_STAGE_OBJECTS,                                // creatures, gameobjects and corpses
+    MAX_GRID_LOAD_STAGES
+};
+
+// upper bounds in ms, the last bucket takes the rest
+#define GRID_LOAD_HISTOGRAM_BUCKETS 10
+extern uint32 const GridLoadHistogramBounds[GRID_LOAD_HISTOGRAM_BUCKETS - 1];
+
+struct GridLoadHistogram
+{
+    GridLoadHistogram() : count(0), total(0), max(0)
+    {
+        for (uint32 i = 0; i < GRID_LOAD_HISTOGRAM_BUCKETS; ++i)
+            buckets[i] = 0;
+    }
+
+    uint64 buckets[GRID_LOAD_HISTOGRAM_BUCKETS];
+    uint64 count;
+    uint64 total;
+    uint32 max;
+};
+
+struct GridPreloadStats
+{
+    GridPreloadStats() : requested(0), loaded(0), used(0), expired(0), dropped(0) {}
+
+    GridLoadHistogram stages[MAX_GRID_LOAD_STAGES];
+    uint64 requested;                                       // queued for the workers
+    uint64 loaded;                                          // read by the workers
+    uint64 used;                                            // handed over to a map
+    uint64 expired;                                         // never needed
+    uint64 dropped;                                         // queue was full
+};
+
+// Terrain of a grid read ahead of time. The data is owned by the entry until
+// the map takes the GridMap, the vmap models are held until it is deleted.
+struct PreloadedGrid
+{
+    enum State
+    {
+        STATE_QUEUED,
+        STATE_LOADING,
+        STATE_READY
+    };
+
+    PreloadedGrid(uint32 _mapId, int _gx, int _gy) : mapId(_mapId), gx(_gx), gy(_gy), state(STATE_QUEUED), readyTime(0), gridMap(NULL) {}
+    ~PreloadedGrid();
+
+    uint32 mapId;
+    int gx;
+    int gy;
+    State state;
+    uint32 readyTime;
+    GridMap* gridMap;
+    std::vector<std::string> vmapModels;
+};
+
+class GridPreloader
+{
+    public:
+        GridPreloader();
+        virtual ~GridPreloader();
+
+        friend class GridPreloadRequest;
+
+        int activate(size_t num_threads);
+        int deactivate();
+        bool activated();
+
+        // queues the terrain of the grid, gx and gy are the GridMaps indexes of the map
+        void Request(uint32 mapId, int gx, int gy);
+
+        // hands over the entry of the grid and waits if it is being read right now,
+        // NULL if it was not requested or no worker picked it up yet
+        PreloadedGrid* Take(uint32 mapId, int gx, int gy);
+
+        // drops the grids nobody walked into, called by the world thread
+        void Update();
+
+        void RecordLoadTime(GridLoadStage stage, uint32 ms);
+        GridPreloadStats GetStats();
+
+    private:
+        static uint32 MakeKey(uint32 mapId, int gx, int gy) { return (mapId << 12) | (uint32(gx) << 6) | uint32(gy); }
+
+        void LoadGrid(uint32 key);
+
+        typedef UNORDERED_MAP<uint32, PreloadedGrid*> PreloadedGridMap;
+
+        DelayExecutor m_executor;
+        ACE_Thread_Mutex m_mutex;
+        ACE_Condition_Thread_Mutex m_condition;
+        PreloadedGridMap m_grids;
+
+        ACE_Thread_Mutex m_statsLock;
+        GridPreloadStats m_stats;
+};
+#endif //_GRID_PRELOADER_H_INCLUDED
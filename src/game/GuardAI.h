@@ -43,6 +43,7 @@ class GuardAI : public CreatureAI
         bool IsVisible(Unit *) const;
 
         void UpdateAI(const uint32);
+        uint32 GetIdleTime() const { return AI_IDLE_FOREVER; }
         static int Permissible(const Creature *);
 
     private:
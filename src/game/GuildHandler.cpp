@@ -938,6 +938,8 @@ void WorldSession::HandleGuildBankDeposit(WorldPacket & recv_data)
     if (GetPlayer()->GetMoney() < money)
         return;
 
+    // in order with the saves of the player and the bank changes of the other members
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, SQL_ASYNC_KEY_ALL);
     CharacterDatabase.BeginTransaction();
 
     pGuild->SetBankMoney(pGuild->GetGuildBankMoney()+money);
@@ -989,6 +991,7 @@ void WorldSession::HandleGuildBankWithdraw(WorldPacket & recv_data)
     if (!pGuild->HasRankRight(GetPlayer()->GetRank(), GR_RIGHT_WITHDRAW_GOLD))
         return;
 
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, SQL_ASYNC_KEY_ALL);
     CharacterDatabase.BeginTransaction();
 
     if (!pGuild->MemberMoneyWithdraw(money, GetPlayer()->GetGUIDLow()))
@@ -1016,6 +1019,9 @@ void WorldSession::HandleGuildBankDepositItem(WorldPacket & recv_data)
     sLog.outDebug("WORLD: Received (CMSG_GUILD_BANK_SWAP_ITEMS)");
     //recv_data.hexlike();
 
+    // the items change owner between the player and the bank
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, SQL_ASYNC_KEY_ALL);
+
     uint64 GoGuid;
     uint8 BankToBank;
 
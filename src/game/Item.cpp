@@ -286,38 +286,44 @@ void Item::UpdateDuration(Player* owner, uint32 diff)
     SetState(ITEM_CHANGED, owner);                          // save new time in database
 }
 
-void Item::SaveToDB()
+void Item::SaveToDB(SqlBatchInsert* dataBatch)
 {
     uint32 guid = GetGUIDLow();
     switch (uState)
     {
         case ITEM_NEW:
-        {
-            std::ostringstream ss;
-            ss << "REPLACE INTO item_instance (guid, owner_guid, data) VALUES (" << guid << "," << GUID_LOPART(GetOwnerGUID()) << ",'";
-            for (uint16 i = 0; i < m_valuesCount; ++i)
-                ss << GetUInt32Value(i) << " ";
-            ss << "')";
-            CharacterDatabase.Execute(ss.str().c_str());
-        } break;
         case ITEM_CHANGED:
         {
-            std::ostringstream ss;
-            ss << "UPDATE item_instance SET data = '";
-            for (uint16 i = 0; i < m_valuesCount; ++i)
-                ss << GetUInt32Value(i) << " ";
-            ss << "', owner_guid = '" << GUID_LOPART(GetOwnerGUID()) << "' WHERE guid = '" << guid << "'";
-
-            CharacterDatabase.Execute(ss.str().c_str());
+            if (dataBatch)
+            {
+                std::ostringstream& ss = dataBatch->NextRow();
+                ss << guid << ", " << GUID_LOPART(GetOwnerGUID()) << ", '";
+                for (uint16 i = 0; i < m_valuesCount; ++i)
+                    ss << GetUInt32Value(i) << " ";
+                ss << "'";
+            }
+            else
+            {
+                std::ostringstream ss;
+                for (uint16 i = 0; i < m_valuesCount; ++i)
+                    ss << GetUInt32Value(i) << " ";
+
+                if (uState == ITEM_NEW)
+                    CharacterDatabase.Execute(CHAR_REP_ITEM_INSTANCE, SqlStmtParameters(3).addUInt32(guid)
+                        .addUInt32(GUID_LOPART(GetOwnerGUID())).addString(ss.str()));
+                else
+                    CharacterDatabase.Execute(CHAR_UPD_ITEM_INSTANCE, SqlStmtParameters(3).addString(ss.str())
+                        .addUInt32(GUID_LOPART(GetOwnerGUID())).addUInt32(guid));
+            }
 
-            if (HasFlag(ITEM_FIELD_FLAGS, ITEM_FLAGS_WRAPPED))
+            if (uState == ITEM_CHANGED && HasFlag(ITEM_FIELD_FLAGS, ITEM_FLAGS_WRAPPED))
                 CharacterDatabase.PExecute("UPDATE character_gifts SET guid = '%u' WHERE item_guid = '%u'", GUID_LOPART(GetOwnerGUID()),GetGUIDLow());
         } break;
         case ITEM_REMOVED:
         {
             if (GetUInt32Value(ITEM_FIELD_ITEM_TEXT_ID) > 0)
                 CharacterDatabase.PExecute("DELETE FROM item_text WHERE id = '%u'", GetUInt32Value(ITEM_FIELD_ITEM_TEXT_ID));
-            CharacterDatabase.PExecute("DELETE FROM item_instance WHERE guid = '%u'", guid);
+            CharacterDatabase.Execute(CHAR_DEL_ITEM_INSTANCE, SqlStmtParameters(1).addUInt32(guid));
             if (HasFlag(ITEM_FIELD_FLAGS, ITEM_FLAGS_WRAPPED))
                 CharacterDatabase.PExecute("DELETE FROM character_gifts WHERE item_guid = '%u'", GetGUIDLow());
             delete this;
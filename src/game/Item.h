@@ -29,6 +29,7 @@
 struct SpellEntry;
 class Bag;
 class QueryResult;
+class SqlBatchInsert;
 
 struct ItemSetEffect
 {
@@ -213,7 +214,8 @@ class Item : public Object
         bool IsSoulBound() const { return HasFlag(ITEM_FIELD_FLAGS, ITEM_FLAGS_BINDED); }
         bool IsBindedNotWith(uint64 guid) const { return IsSoulBound() && GetOwnerGUID() != guid; }
         bool IsBoundByEnchant() const;
-        virtual void SaveToDB();
+        // With a batch, the item_instance row of a new or changed item is added to it
+        virtual void SaveToDB(SqlBatchInsert* dataBatch = NULL);
         virtual bool LoadFromDB(uint32 guid, uint64 owner_guid, QueryResult_AutoPtr result = QueryResult_AutoPtr(NULL));
         virtual void DeleteFromDB();
         void DeleteFromInventoryDB();
@@ -3084,6 +3084,7 @@ bool ChatHandler::HandleCharacterRenameCommand(const char* args)
     else
     {
         PSendSysMessage(LANG_RENAME_PLAYER_GUID, oldname.c_str(), GUID_LOPART(targetGUID));
+        SqlAsyncKeyGuard asyncKey(CharacterDatabase, GUID_LOPART(targetGUID));
         CharacterDatabase.PExecute("UPDATE characters SET at_login = at_login | '1' WHERE guid = '%u'", GUID_LOPART(targetGUID));
     }
 
@@ -53,6 +53,7 @@
 #include "InstanceData.h"
 #include "AuctionHouseBot.h"
 #include "CreatureEventAIMgr.h"
+#include "VMapFactory.h"
 
 bool ChatHandler::HandleAHBotOptionsCommand(const char *args)
 {
@@ -4527,6 +4528,7 @@ bool ChatHandler::HandleLevelUpCommand(const char *args)
     else
     {
         // update level and XP at level, all other will be updated at loading
+        SqlAsyncKeyGuard asyncKey(CharacterDatabase, GUID_LOPART(chr_guid));
         CharacterDatabase.PExecute("UPDATE characters SET level = '%u', xp = 0 WHERE guid = '%llu'", newlevel, chr_guid);
     }
 
@@ -5179,6 +5181,7 @@ bool ChatHandler::HandleResetSpellsCommand(const char * args)
     }
     else
     {
+        SqlAsyncKeyGuard asyncKey(CharacterDatabase, GUID_LOPART(playerGUID));
         CharacterDatabase.PExecute("UPDATE characters SET at_login = at_login | '%u' WHERE guid = '%u'",uint32(AT_LOGIN_RESET_SPELLS), GUID_LOPART(playerGUID));
         PSendSysMessage(LANG_RESET_SPELLS_OFFLINE,pName);
     }
@@ -5226,6 +5229,7 @@ bool ChatHandler::HandleResetTalentsCommand(const char * args)
     }
     else
     {
+        SqlAsyncKeyGuard asyncKey(CharacterDatabase, GUID_LOPART(playerGUID));
         CharacterDatabase.PExecute("UPDATE characters SET at_login = at_login | '%u' WHERE guid = '%u'",uint32(AT_LOGIN_RESET_TALENTS), GUID_LOPART(playerGUID));
         PSendSysMessage(LANG_RESET_TALENTS_OFFLINE,pName);
     }
@@ -5260,7 +5264,11 @@ bool ChatHandler::HandleResetAllCommand(const char * args)
         return false;
     }
 
-    CharacterDatabase.PExecute("UPDATE characters SET at_login = at_login | '%u' WHERE (at_login & '%u') = '0'",atLogin,atLogin);
+    {
+        // every character, after their pending saves
+        SqlAsyncKeyGuard asyncKey(CharacterDatabase, SQL_ASYNC_KEY_ALL);
+        CharacterDatabase.PExecute("UPDATE characters SET at_login = at_login | '%u' WHERE (at_login & '%u') = '0'",atLogin,atLogin);
+    }
 
     ObjectAccessor::Guard guard(*HashMapHolder<Player>::GetLock());
     HashMapHolder<Player>::MapType const& plist = ObjectAccessor::Instance().GetPlayers();
@@ -7510,3 +7518,130 @@ bool ChatHandler::HandleUnbindSightCommand(const char * /*args*/)
     return true;
 }
 
+
+bool ChatHandler::HandleServerSetCompressionCommand(const char* args)
+{
+    if (!*args)
+        return false;
+
+    char* levelStr = strtok((char*)args, " ");
+    char* thresholdStr = strtok(NULL, " ");
+
+    int32 level = atoi(levelStr);
+    if (level < 1 || level > 9)
+    {
+        PSendSysMessage("Compression level (%i) must be in range 1..9.", level);
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    uint32 threshold = thresholdStr ? uint32(atoi(thresholdStr)) : UpdateData::GetCompressionThreshold();
+
+    UpdateData::SetCompression(level, threshold);
+    PSendSysMessage("Update packets bigger than %u bytes are now compressed with level %i.", threshold, level);
+    return true;
+}
+
+bool ChatHandler::HandleServerStatsCompressionCommand(const char* args)
+{
+    UpdateDataCompressionStats stats = UpdateData::GetCompressionStats();
+
+    PSendSysMessage("Compression level: %i, threshold: %u bytes", UpdateData::GetCompressionLevel(), UpdateData::GetCompressionThreshold());
+    PSendSysMessage("Compressed packets: " UI64FMTD, stats.packets);
+    PSendSysMessage("Bytes in: " UI64FMTD ", bytes out: " UI64FMTD " (%.1f%%)", stats.bytesIn, stats.bytesOut,
+        stats.bytesIn ? float(stats.bytesOut) * 100.0f / float(stats.bytesIn) : 0.0f);
+    PSendSysMessage("Time spent: " UI64FMTD " us (%.2f us per packet)", stats.timeUs,
+        stats.packets ? float(stats.timeUs) / float(stats.packets) : 0.0f);
+
+    if (*args && strncmp(args, "reset", strlen(args)) == 0)
+    {
+        UpdateData::ResetCompressionStats();
+        SendSysMessage("Compression stats reset.");
+    }
+    return true;
+}
+
+static void SendDatabaseStats(ChatHandler* handler, char const* name, Database& db)
+{
+    DatabaseStats stats;
+    db.GetStats(stats);
+
+    handler->PSendSysMessage("%s: " UI64FMTD " synchronous queries, " UI64FMTD " waited for a connection",
+        name, stats.syncQueries, stats.syncWaits);
+
+    for (size_t i = 0; i < stats.executors.size(); ++i)
+    {
+        SqlDelayStats const& exec = stats.executors[i];
+        handler->PSendSysMessage("  async thread " SIZEFMTD ": %li queued, " UI64FMTD " done, wait %.1f ms avg %u ms max, execution %.1f ms avg",
+            i, stats.queueSizes[i], exec.operations,
+            exec.operations ? float(exec.waitTime) / float(exec.operations) : 0.0f, exec.maxWaitTime,
+            exec.operations ? float(exec.execTime) / float(exec.operations) : 0.0f);
+    }
+}
+
+bool ChatHandler::HandleServerStatsDatabaseCommand(const char* /*args*/)
+{
+    SendDatabaseStats(this, "World", WorldDatabase);
+    SendDatabaseStats(this, "Character", CharacterDatabase);
+    SendDatabaseStats(this, "Login", LoginDatabase);
+    return true;
+}
+
+bool ChatHandler::HandleServerStatsGridsCommand(const char* /*args*/)
+{
+    static char const* stageNames[MAX_GRID_LOAD_STAGES] = { "terrain", "terrain (preloaded)", "objects" };
+
+    GridPreloader* preloader = MapManager::Instance().GetGridPreloader();
+    GridPreloadStats stats = preloader->GetStats();
+
+    PSendSysMessage("Grid preloading %s: " UI64FMTD " requested, " UI64FMTD " read, " UI64FMTD " used, " UI64FMTD " expired, " UI64FMTD " dropped",
+        preloader->activated() ? "enabled" : "disabled", stats.requested, stats.loaded, stats.used, stats.expired, stats.dropped);
+
+    for (uint32 i = 0; i < MAX_GRID_LOAD_STAGES; ++i)
+    {
+        GridLoadHistogram const& histogram = stats.stages[i];
+        PSendSysMessage("%s: " UI64FMTD " loads, %.1f ms avg, %u ms max", stageNames[i], histogram.count,
+            histogram.count ? float(histogram.total) / float(histogram.count) : 0.0f, histogram.max);
+
+        if (!histogram.count)
+            continue;
+
+        std::ostringstream buckets;
+        for (uint32 j = 0; j < GRID_LOAD_HISTOGRAM_BUCKETS; ++j)
+        {
+            if (j < GRID_LOAD_HISTOGRAM_BUCKETS - 1)
+                buckets << " <=" << GridLoadHistogramBounds[j] << ":";
+            else
+                buckets << " >" << GridLoadHistogramBounds[j - 1] << ":";
+            buckets << histogram.buckets[j];
+        }
+        PSendSysMessage("  ms%s", buckets.str().c_str());
+    }
+    return true;
+}
+
+static void SendCacheRate(ChatHandler* handler, char const* name, uint64 hits, uint64 misses)
+{
+    handler->PSendSysMessage("%s: " UI64FMTD " hits, " UI64FMTD " misses (%.1f%% hit rate)", name, hits, misses,
+        hits + misses ? float(hits) * 100.0f / float(hits + misses) : 0.0f);
+}
+
+bool ChatHandler::HandleServerStatsVMapCommand(const char* args)
+{
+    VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
+    VMAP::VMapQueryCacheStats stats = vmgr->getQueryCacheStats();
+
+    if (!stats.size)
+        SendSysMessage("VMap query cache: disabled");
+    else
+        PSendSysMessage("VMap query cache: %u entries, " UI64FMTD " invalidations by tile loads", stats.size, stats.invalidations);
+    SendCacheRate(this, "Line of sight", stats.losHits, stats.losMisses);
+    SendCacheRate(this, "Height", stats.heightHits, stats.heightMisses);
+
+    if (*args && strncmp(args, "reset", strlen(args)) == 0)
+    {
+        vmgr->resetQueryCacheStats();
+        SendSysMessage("VMap query cache stats reset.");
+    }
+    return true;
+}
@@ -230,6 +230,8 @@ void WorldSession::HandleSendMail(WorldPacket & recv_data)
 
         if (items_count > 0)
         {
+            // in order with the saves of both the sender and the receiver as the items change owner
+            SqlAsyncKeyGuard asyncKey(CharacterDatabase, SQL_ASYNC_KEY_ALL);
             for (uint8 i = 0; i < items_count; ++i)
             {
                 Item* item = items[i];
@@ -270,6 +272,7 @@ void WorldSession::HandleSendMail(WorldPacket & recv_data)
         .AddCOD(COD)
         .SendMailTo(MailReceiver(receive, GUID_LOPART(rc)), pl, body.empty() ? MAIL_CHECK_MASK_COPIED : MAIL_CHECK_MASK_HAS_BODY, deliver_delay);
 
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, pl->GetGUIDLow());
     CharacterDatabase.BeginTransaction();
     pl->SaveInventoryAndGoldToDB();
     CharacterDatabase.CommitTransaction();
@@ -374,11 +377,14 @@ void WorldSession::HandleReturnToSender(WorldPacket & recv_data)
 
     // we can return mail now
     // so firstly delete the old one
-    CharacterDatabase.BeginTransaction();
-    CharacterDatabase.PExecute("DELETE FROM mail WHERE id = '%u'", mailId);
+    {
+        SqlAsyncKeyGuard asyncKey(CharacterDatabase, pl->GetGUIDLow());
+        CharacterDatabase.BeginTransaction();
+        CharacterDatabase.PExecute("DELETE FROM mail WHERE id = '%u'", mailId);
                                                             // needed?
-    CharacterDatabase.PExecute("DELETE FROM mail_items WHERE mail_id = '%u'", mailId);
-    CharacterDatabase.CommitTransaction();
+        CharacterDatabase.PExecute("DELETE FROM mail_items WHERE mail_id = '%u'", mailId);
+        CharacterDatabase.CommitTransaction();
+    }
     pl->RemoveMail(mailId);
 
     // send back only to existing players and simple drop for other cases
@@ -496,6 +502,7 @@ void WorldSession::HandleTakeItem(WorldPacket & recv_data)
         uint32 count = it->GetCount();                      // save counts before store and possible merge with deleting
         pl->MoveItemToInventory(dest, it, true);
 
+        SqlAsyncKeyGuard asyncKey(CharacterDatabase, pl->GetGUIDLow());
         CharacterDatabase.BeginTransaction();
         pl->SaveInventoryAndGoldToDB();
         pl->_SaveMail();
@@ -537,6 +544,7 @@ void WorldSession::HandleTakeMoney(WorldPacket & recv_data)
     pl->m_mailsUpdated = true;
 
     // save money and mail to prevent cheating
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, pl->GetGUIDLow());
     CharacterDatabase.BeginTransaction();
     pl->SaveGoldToDB();
     pl->_SaveMail();
@@ -951,6 +959,7 @@ void MailDraft::SendReturnToSender(uint32 sender_acc, uint32 sender_guid, uint32
         needItemDelay = sender_acc != rc_account;
 
         // set owner to new receiver (to prevent delete item with sender char deleting)
+        SqlAsyncKeyGuard asyncKey(CharacterDatabase, receiver_guid);
         CharacterDatabase.BeginTransaction();
         for (MailItemMap::iterator mailItemIter = m_items.begin(); mailItemIter != m_items.end(); ++mailItemIter)
         {
@@ -1005,9 +1014,10 @@ void MailDraft::SendMailTo(MailReceiver const& receiver, MailSender const& sende
 
     time_t expire_time = deliver_time + expire_delay;
 
-    // Add to DB
+    // Add to DB, in order with the saves of the receiver
     std::string safe_subject = GetSubject();
 
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, receiver.GetPlayerGUIDLow());
     CharacterDatabase.BeginTransaction();
     CharacterDatabase.escape_string(safe_subject);
     CharacterDatabase.PExecute("INSERT INTO mail (id,messageType,stationery,mailTemplateId,sender,receiver,subject,itemTextId,has_items,expire_time,deliver_time,money,cod,checked) "
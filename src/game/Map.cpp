@@ -21,6 +21,7 @@
 #include "GridStates.h"
 #include "ScriptMgr.h"
 #include "VMapFactory.h"
+#include "MoveMap.h"
 #include "MapInstanced.h"
 #include "CellImpl.h"
 #include "GridNotifiers.h"
@@ -30,6 +31,20 @@
 #include "ObjectAccessor.h"
 #include "MapManager.h"
 #include "ObjectMgr.h"
+#include "World.h"
+#include "WorldSession.h"
+#include "GridPreloader.h"
+#include "WaypointMovementGenerator.h"
+#include "CreatureFormations.h"
+#include "CreatureGroups.h"
+#include "OutdoorPvPMgr.h"
+
+#include <ace/High_Res_Timer.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GRIDMAP_SSE2
+#include <emmintrin.h>
+#endif
 
 #define DEFAULT_GRID_EXPIRY     300
 #define MAX_GRID_LOAD_TIME      50
@@ -162,9 +177,35 @@ void Map::LoadMap(int gx,int gy, bool reload)
 
 void Map::LoadMapAndVMap(int gx,int gy)
 {
-    LoadMap(gx,gy);
+    uint32 loadStart = getMSTime();
+    GridPreloader* preloader = MapManager::Instance().GetGridPreloader();
+
+    // instances share the terrain of the base map, see LoadMap
+    PreloadedGrid* preloaded = NULL;
+    if (i_InstanceId == 0)
+        preloaded = preloader->Take(GetId(), gx, gy);
+
+    bool usePreloaded = preloaded && preloaded->gridMap && !GridMaps[gx][gy];
+    if (usePreloaded)
+    {
+        GridMaps[gx][gy] = preloaded->gridMap;
+        preloaded->gridMap = NULL;
+    }
+    else
+        LoadMap(gx,gy);
+
     if (i_InstanceId == 0)
+    {
         LoadVMap(gx, gy);                                   // Only load the data for the base map
+        sMoveMapMgr.LoadTile(GetId(), gx, gy);
+    }
+
+    GridLoadStage stage = usePreloaded ? GRID_LOAD_STAGE_TERRAIN_PRELOADED : GRID_LOAD_STAGE_TERRAIN;
+
+    // the tree holds its own model references now
+    delete preloaded;
+
+    preloader->RecordLoadTime(stage, getMSTimeDiff(loadStart, getMSTime()));
 }
 
 void Map::InitStateMachine()
@@ -192,6 +233,8 @@ i_scriptLock(false)
 {
     m_parentMap = (_parent ? _parent : this);
 
+    m_gridPreloadTimer.SetInterval(GRID_PRELOAD_PREDICT_INTERVAL);
+
     for (unsigned int idx=0; idx < MAX_NUMBER_OF_GRIDS; ++idx)
     {
         for (unsigned int j=0; j < MAX_NUMBER_OF_GRIDS; ++j)
@@ -199,6 +242,7 @@ i_scriptLock(false)
             //z code
             GridMaps[idx][j] = NULL;
             setNGrid(NULL, idx, j);
+            i_gridObjectDataReady[idx][j] = false;
         }
     }
 
@@ -293,6 +337,67 @@ void Map::DeleteFromWorld(Player* pl)
     delete pl;
 }
 
+void Map::PreloadGridAt(float x, float y)
+{
+    if (!Oregon::IsValidMapCoord(x, y))
+        return;
+
+    GridPair p = Oregon::ComputeGridPair(x, y);
+    int gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
+    int gy = (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord;
+
+    if (!GridMaps[gx][gy])
+        MapManager::Instance().GetGridPreloader()->Request(GetId(), gx, gy);
+}
+
+void Map::PreloadGridsAhead(Player* player)
+{
+    float lookAhead = float(sWorld.getConfig(CONFIG_GRID_PRELOAD_LOOKAHEAD));
+
+    // taxi flights follow a known path, take the nodes ahead on this map
+    if (player->isInFlight())
+    {
+        if (player->GetMotionMaster()->GetCurrentMovementGeneratorType() != FLIGHT_MOTION_TYPE)
+            return;
+
+        FlightPathMovementGenerator* flight = (FlightPathMovementGenerator*)(player->GetMotionMaster()->top());
+        Path& path = flight->GetPath();
+
+        float range = lookAhead * PLAYER_FLIGHT_SPEED;
+        float x = player->GetPositionX(), y = player->GetPositionY();
+        float dist = 0.0f;
+        for (uint32 node = flight->GetCurrentNode(); node < flight->GetPathAtMapEnd() && dist < range; ++node)
+        {
+            dist += sqrtf((path[node].x - x) * (path[node].x - x) + (path[node].y - y) * (path[node].y - y));
+            x = path[node].x;
+            y = path[node].y;
+            PreloadGridAt(x, y);
+        }
+        return;
+    }
+
+    if (!player->HasUnitMovementFlag(MOVEFLAG_FORWARD | MOVEFLAG_BACKWARD))
+        return;
+
+    UnitMoveType moveType = MOVE_RUN;
+    if (player->IsFlying())
+        moveType = MOVE_FLIGHT;
+    else if (player->IsInWater())
+        moveType = MOVE_SWIM;
+    else if (player->HasUnitMovementFlag(MOVEFLAG_WALK_MODE))
+        moveType = MOVE_WALK;
+
+    float orientation = player->GetOrientation();
+    if (player->HasUnitMovementFlag(MOVEFLAG_BACKWARD))
+        orientation += M_PI;
+
+    // sample the straight line often enough to not skip the corner of a grid
+    float range = lookAhead * player->GetSpeed(moveType);
+    float step = SIZE_OF_GRIDS / 4;
+    for (float dist = step; dist <= range; dist += step)
+        PreloadGridAt(player->GetPositionX() + dist * cos(orientation), player->GetPositionY() + dist * sin(orientation));
+}
+
 void
 Map::EnsureGridCreated(const GridPair &p)
 {
@@ -324,6 +429,8 @@ Map::EnsureGridCreated(const GridPair &p)
 void
 Map::EnsureGridLoadedAtEnter(const Cell &cell, Player *player)
 {
+    ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, m_updateListsLock);
+
     EnsureGridLoaded(cell);
     NGridType *grid = getNGrid(cell.GridX(), cell.GridY());
     ASSERT(grid != NULL);
@@ -347,6 +454,12 @@ Map::EnsureGridLoadedAtEnter(const Cell &cell, Player *player)
 
 bool Map::EnsureGridLoaded(const Cell &cell)
 {
+    // every visit passes here, the loaded grids do not need the lock
+    if (isGridObjectDataReady(cell.GridX(), cell.GridY()))
+        return false;
+
+    ACE_GUARD_RETURN(ACE_Recursive_Thread_Mutex, guard, m_updateListsLock, false);
+
     EnsureGridCreated(GridPair(cell.GridX(), cell.GridY()));
     NGridType *grid = getNGrid(cell.GridX(), cell.GridY());
 
@@ -357,11 +470,18 @@ bool Map::EnsureGridLoaded(const Cell &cell)
 
         setGridObjectDataLoaded(true,cell.GridX(), cell.GridY());
 
+        uint32 loadStart = getMSTime();
+
         ObjectGridLoader loader(*grid, this, cell);
         loader.LoadN();
 
         // Add resurrectable corpses to world object list in grid
         ObjectAccessor::Instance().AddCorpsesToGrid(GridPair(cell.GridX(),cell.GridY()),(*grid)(cell.CellX(), cell.CellY()), this);
+
+        // the other threads skip the lock from now on
+        setGridObjectDataReady(true, cell.GridX(), cell.GridY());
+
+        MapManager::Instance().GetGridPreloader()->RecordLoadTime(GRID_LOAD_STAGE_OBJECTS, getMSTimeDiff(loadStart, getMSTime()));
         return true;
     }
 
@@ -400,6 +520,7 @@ bool Map::Add(Player *player)
     SendInitTransports(player);
 
     player->m_clientGUIDs.clear();
+    player->m_visibilityRelocationPos.Relocate(player->GetPositionX(), player->GetPositionY(), player->GetPositionZ(), player->GetOrientation());
     player->UpdateObjectVisibility(true);
 
     return true;
@@ -535,11 +656,56 @@ void Map::MessageDistBroadcast(WorldObject *obj, WorldPacket *msg, float dist)
 
 bool Map::loaded(const GridPair &p) const
 {
+    if (isGridObjectDataReady(p.x_coord, p.y_coord))
+        return true;
+
+    // a grid being loaded is only seen by the thread that loads it
+    ACE_GUARD_RETURN(ACE_Recursive_Thread_Mutex, guard, m_updateListsLock, false);
     return (getNGrid(p.x_coord, p.y_coord) && isGridObjectDataLoaded(p.x_coord, p.y_coord));
 }
 
+bool Map::isGridObjectDataReady(uint32 x, uint32 y) const
+{
+    ASSERT(x < MAX_NUMBER_OF_GRIDS);
+    ASSERT(y < MAX_NUMBER_OF_GRIDS);
+#if COMPILER == COMPILER_MICROSOFT
+    return i_gridObjectDataReady[x][y];                     // volatile reads have acquire semantics
+#else
+    return __atomic_load_n(&i_gridObjectDataReady[x][y], __ATOMIC_ACQUIRE);
+#endif
+}
+
+void Map::setGridObjectDataReady(bool ready, uint32 x, uint32 y)
+{
+    ASSERT(x < MAX_NUMBER_OF_GRIDS);
+    ASSERT(y < MAX_NUMBER_OF_GRIDS);
+#if COMPILER == COMPILER_MICROSOFT
+    i_gridObjectDataReady[x][y] = ready;                    // volatile writes have release semantics
+#else
+    __atomic_store_n(&i_gridObjectDataReady[x][y], ready, __ATOMIC_RELEASE);
+#endif
+}
+
 void Map::Update(const uint32 &t_diff)
 {
+    // before anything can wake a creature, it must be given the time of this tick
+    m_creatureWheel.Update(t_diff);
+
+    // handle the thread safe packets of the players in the map, far teleports
+    // done by them are delayed to the end of the Player::Update below
+    if (sWorld.getConfig(CONFIG_MAP_PACKET_PROCESSING))
+    {
+        for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+        {
+            Player* plr = m_mapRefIter->getSource();
+            if (!plr || !plr->IsInWorld())
+                continue;
+
+            MapSessionFilter filter(plr->GetSession());
+            plr->GetSession()->ProcessPackets(filter);
+        }
+    }
+
     // update players at tick
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
@@ -548,9 +714,59 @@ void Map::Update(const uint32 &t_diff)
             plr->Update(t_diff);
     }
 
+    // the movement of the players during this tick, sent together
+    m_movementRelay.Flush(this);
+
+    // queue the terrain of the grids the players are heading to, instances are small enough to load on enter
+    if (!Instanceable() && MapManager::Instance().GetGridPreloader()->activated())
+    {
+        m_gridPreloadTimer.Update(t_diff);
+        if (m_gridPreloadTimer.Passed())
+        {
+            m_gridPreloadTimer.Reset();
+            for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+            {
+                Player* plr = m_mapRefIter->getSource();
+                if (plr && plr->IsInWorld())
+                    PreloadGridsAhead(plr);
+            }
+        }
+    }
+
     // update active cells around players and active objects
     resetMarkedCells();
 
+    ACE_Time_Value cellsStart = ACE_High_Res_Timer::gettimeofday_hr();
+
+    if (!Instanceable() && sWorld.getConfig(CONFIG_MAP_PARALLEL_CELLS) && MapManager::Instance().GetMapUpdater()->activated())
+        UpdateCellsInParallel(t_diff);
+    else
+        UpdateActiveCells(t_diff);
+
+    ACE_UINT64 cellTime;
+    (ACE_High_Res_Timer::gettimeofday_hr() - cellsStart).to_usec(cellTime);
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_creatureUpdateStatsLock);
+        ++m_creatureUpdateStats.ticks;
+        m_creatureUpdateStats.cellTime += cellTime;
+    }
+
+    // Process necessary scripts
+    if (!m_scriptSchedule.empty())
+    {
+        i_scriptLock = true;
+        ScriptsProcess();
+        i_scriptLock = false;
+    }
+
+    MoveAllCreaturesInMoveList();
+
+    if (!m_mapRefManager.isEmpty() || !m_activeNonPlayers.empty())
+        ProcessRelocationNotifies(t_diff);
+}
+
+void Map::UpdateActiveCells(const uint32 &t_diff)
+{
     Oregon::ObjectUpdater updater(t_diff);
     // for creature
     TypeContainerVisitor<Oregon::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
@@ -649,18 +865,291 @@ void Map::Update(const uint32 &t_diff)
         }
     }
 
-    // Process necessary scripts
-    if (!m_scriptSchedule.empty())
+    AddCreatureUpdateCounts(updater.i_creaturesUpdated, updater.i_creaturesAsleep);
+}
+
+void Map::AddCreatureUpdateCounts(uint32 updated, uint32 asleep)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_creatureUpdateStatsLock);
+    m_creatureUpdateStats.updated += updated;
+    m_creatureUpdateStats.asleep += asleep;
+}
+
+CreatureUpdateStats Map::GetCreatureUpdateStats(bool reset)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_creatureUpdateStatsLock, CreatureUpdateStats());
+    CreatureUpdateStats stats = m_creatureUpdateStats;
+    if (reset)
+        m_creatureUpdateStats = CreatureUpdateStats();
+    return stats;
+}
+
+// Union-find over the blocks of cells UpdateCellsInParallel groups into islands
+class MapIslandBlocks
+{
+    public:
+        explicit MapIslandBlocks(uint32 blocksPerRow) : m_blocksPerRow(blocksPerRow) {}
+
+        uint32 GetCount() const { return uint32(m_parent.size()); }
+
+        uint32 GetBlock(uint32 bx, uint32 by)
+        {
+            uint32 key = by * m_blocksPerRow + bx;
+            std::map<uint32, uint32>::const_iterator itr = m_index.find(key);
+            if (itr != m_index.end())
+                return itr->second;
+
+            uint32 block = uint32(m_parent.size());
+            m_index[key] = block;
+            m_keys.push_back(key);
+            m_parent.push_back(block);
+            return block;
+        }
+
+        uint32 Find(uint32 block)
+        {
+            while (m_parent[block] != block)
+                block = m_parent[block] = m_parent[m_parent[block]];
+            return block;
+        }
+
+        void Unite(uint32 a, uint32 b)
+        {
+            a = Find(a);
+            b = Find(b);
+            if (a != b)
+                m_parent[a] = b;
+        }
+
+        // unites the blocks that touch each other, diagonals included
+        void UniteNeighbours()
+        {
+            for (size_t b = 0; b < m_keys.size(); ++b)
+            {
+                int32 bx = m_keys[b] % m_blocksPerRow;
+                int32 by = m_keys[b] / m_blocksPerRow;
+                for (int32 dx = -1; dx <= 1; ++dx)
+                {
+                    for (int32 dy = -1; dy <= 1; ++dy)
+                    {
+                        if (bx + dx < 0 || by + dy < 0 || bx + dx >= int32(m_blocksPerRow))
+                            continue;
+
+                        std::map<uint32, uint32>::const_iterator itr = m_index.find((by + dy) * m_blocksPerRow + bx + dx);
+                        if (itr != m_index.end())
+                            Unite(uint32(b), itr->second);
+                    }
+                }
+            }
+        }
+
+    private:
+        uint32 m_blocksPerRow;
+        std::map<uint32, uint32> m_index;
+        std::vector<uint32> m_keys;
+        std::vector<uint32> m_parent;
+};
+
+template<class MEMBERS>
+static void UniteMemberBlocks(MEMBERS const& members, uint32 blockSize, MapIslandBlocks& blocks)
+{
+    uint32 first = uint32(-1);
+    for (typename MEMBERS::const_iterator itr = members.begin(); itr != members.end(); ++itr)
     {
-        i_scriptLock = true;
-        ScriptsProcess();
-        i_scriptLock = false;
+        Creature* member = itr->first;
+        if (!member->IsInWorld())
+            continue;
+
+        CellPair p(Oregon::ComputeCellPair(member->GetPositionX(), member->GetPositionY()));
+        if (p.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || p.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
+            continue;
+
+        uint32 block = blocks.GetBlock(p.x_coord / blockSize, p.y_coord / blockSize);
+        if (first == uint32(-1))
+            first = block;
+        else
+            blocks.Unite(first, block);
     }
+}
 
-    MoveAllCreaturesInMoveList();
+// Cells of one island, updated by one thread
+class MapIslandBatch : public ParallelUpdateBatch
+{
+    public:
+        MapIslandBatch(Map& map, std::vector<std::vector<CellPair> > const& islands, uint32 diff) : m_map(map), m_islands(islands), m_diff(diff) {}
 
-    if (!m_mapRefManager.isEmpty() || !m_activeNonPlayers.empty())
-        ProcessRelocationNotifies(t_diff);
+        void RunItem(size_t index)
+        {
+            Oregon::ObjectUpdater updater(m_diff);
+            TypeContainerVisitor<Oregon::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
+            TypeContainerVisitor<Oregon::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
+
+            std::vector<CellPair> const& cells = m_islands[index];
+            for (std::vector<CellPair>::const_iterator itr = cells.begin(); itr != cells.end(); ++itr)
+            {
+                Cell cell(*itr);
+                cell.data.Part.reserved = CENTER_DISTRICT;
+                cell.Visit(*itr, grid_object_update,  m_map);
+                cell.Visit(*itr, world_object_update, m_map);
+            }
+
+            m_map.AddCreatureUpdateCounts(updater.i_creaturesUpdated, updater.i_creaturesAsleep);
+        }
+
+    private:
+        Map& m_map;
+        std::vector<std::vector<CellPair> > const& m_islands;
+        uint32 m_diff;
+};
+
+static bool IslandSizeGreater(std::vector<CellPair> const& a, std::vector<CellPair> const& b)
+{
+    return a.size() > b.size();
+}
+
+void Map::CollectActiveCells(CellPair begin_cell, CellPair end_cell, std::vector<CellPair>& cells)
+{
+    for (uint32 x = begin_cell.x_coord; x <= end_cell.x_coord; ++x)
+    {
+        for (uint32 y = begin_cell.y_coord; y <= end_cell.y_coord; ++y)
+        {
+            uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
+            if (!isCellMarked(cell_id))
+            {
+                markCell(cell_id);
+                cells.push_back(CellPair(x, y));
+            }
+        }
+    }
+}
+
+void Map::UpdateCellsInParallel(const uint32 &t_diff)
+{
+    // same cells as UpdateActiveCells, nothing is updated while they are collected
+    std::vector<CellPair> cells;
+
+    for (MapRefManager::iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+    {
+        Player* plr = itr->getSource();
+        if (!plr->IsInWorld())
+            continue;
+
+        CellPair standing_cell(Oregon::ComputeCellPair(plr->GetPositionX(), plr->GetPositionY()));
+        if (standing_cell.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || standing_cell.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
+            continue;
+
+        CellPair begin_cell(standing_cell), end_cell(standing_cell);
+        CellArea area = Cell::CalculateCellArea(*plr, GetVisibilityDistance());
+        area.ResizeBorders(begin_cell, end_cell);
+        CollectActiveCells(begin_cell, end_cell, cells);
+    }
+
+    for (ActiveNonPlayers::iterator itr = m_activeNonPlayers.begin(); itr != m_activeNonPlayers.end(); ++itr)
+    {
+        WorldObject* obj = *itr;
+        if (!obj->IsInWorld())
+            continue;
+
+        CellPair standing_cell(Oregon::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY()));
+        if (standing_cell.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || standing_cell.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
+            continue;
+
+        CellPair begin_cell(standing_cell), end_cell(standing_cell);
+        begin_cell << 1; begin_cell -= 1;                   // upper left
+        end_cell >> 1; end_cell += 1;                       // lower right
+        CollectActiveCells(begin_cell, end_cell, cells);
+    }
+
+    if (cells.empty())
+        return;
+
+    // An object reaches the cells within the visibility distance, so two cells can
+    // share a target only if they are at most twice that far apart. Blocks of that
+    // size are only neighbours when their cells could interact, the islands are the
+    // groups of neighbouring blocks that contain active cells. The blocks are made of
+    // whole grids, so the grid states and timers belong to one island.
+    uint32 reach = uint32(ceil(GetVisibilityDistance() / SIZE_OF_GRID_CELL));
+    uint32 blockSize = (2 * reach + MAX_NUMBER_OF_CELLS) / MAX_NUMBER_OF_CELLS * MAX_NUMBER_OF_CELLS;
+    MapIslandBlocks blocks(TOTAL_NUMBER_OF_CELLS_PER_MAP / blockSize + 1);
+
+    std::vector<uint32> cellBlocks(cells.size());
+    for (size_t i = 0; i < cells.size(); ++i)
+        cellBlocks[i] = blocks.GetBlock(cells[i].x_coord / blockSize, cells[i].y_coord / blockSize);
+
+    // Formation and group members reach each other by pointer wherever they stand,
+    // so the blocks of all members of one are united. The members standing in cells
+    // no island updates still get a block, the searchers of a neighbouring island
+    // may reach them.
+    for (CreatureFormationHolderType::const_iterator itr = CreatureFormationHolder.begin(); itr != CreatureFormationHolder.end(); ++itr)
+        UniteMemberBlocks(itr->second->GetMembers(), blockSize, blocks);
+    for (CreatureGroupHolderType::const_iterator itr = CreatureGroupHolder.begin(); itr != CreatureGroupHolder.end(); ++itr)
+        UniteMemberBlocks(itr->second->GetMembers(), blockSize, blocks);
+
+    // The creatures and gameobjects of an outdoor pvp zone share its zone script,
+    // all active cells of such a zone are updated by one island. A cell is checked
+    // at its corners, so the cells on the zone border are caught as well.
+    std::map<ZoneScript*, uint32> zoneBlocks;
+    for (size_t i = 0; i < cells.size(); ++i)
+    {
+        float x = (float(cells[i].x_coord) - CENTER_GRID_CELL_ID) * SIZE_OF_GRID_CELL;
+        float y = (float(cells[i].y_coord) - CENTER_GRID_CELL_ID) * SIZE_OF_GRID_CELL;
+        for (uint32 corner = 0; corner < 4; ++corner)
+        {
+            ZoneScript* zoneScript = sOutdoorPvPMgr.GetZoneScript(GetTerrainZoneId(
+                x + (corner & 1 ? SIZE_OF_GRID_CELL - 0.5f : 0.5f), y + (corner & 2 ? SIZE_OF_GRID_CELL - 0.5f : 0.5f)));
+            if (!zoneScript)
+                continue;
+
+            std::map<ZoneScript*, uint32>::const_iterator zone = zoneBlocks.find(zoneScript);
+            if (zone == zoneBlocks.end())
+                zoneBlocks[zoneScript] = cellBlocks[i];
+            else
+                blocks.Unite(zone->second, cellBlocks[i]);
+        }
+    }
+
+    blocks.UniteNeighbours();
+
+    std::vector<std::vector<CellPair> > islands;
+    std::vector<uint32> blockIsland(blocks.GetCount(), uint32(-1));
+    for (size_t i = 0; i < cells.size(); ++i)
+    {
+        uint32 root = blocks.Find(cellBlocks[i]);
+        if (blockIsland[root] == uint32(-1))
+        {
+            blockIsland[root] = uint32(islands.size());
+            islands.push_back(std::vector<CellPair>());
+        }
+        islands[blockIsland[root]].push_back(cells[i]);
+    }
+
+    MapIslandBatch batch(*this, islands, t_diff);
+    if (islands.size() == 1)
+    {
+        batch.RunItem(0);
+        return;
+    }
+
+    // grids are loaded by the map thread only, the islands share the NGrid objects
+    for (std::vector<CellPair>::const_iterator itr = cells.begin(); itr != cells.end(); ++itr)
+        EnsureGridLoaded(Cell(*itr));
+
+    // the biggest islands are started first
+    std::sort(islands.begin(), islands.end(), IslandSizeGreater);
+
+    // the players are updated by Map::Update, but the creatures of an island may
+    // teleport them to another cell or map, that waits until the islands are done
+    for (MapRefManager::iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+        itr->getSource()->StartTeleportDelay();
+
+    // creature moves between cells, removes and scripts are queued by the islands
+    // and done by Map::Update after all of them are finished
+    i_scriptLock = true;
+    MapManager::Instance().GetMapUpdater()->run_parallel(batch, islands.size());
+    i_scriptLock = false;
+
+    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+        m_mapRefIter->getSource()->FinishTeleportDelay();
 }
 
 struct ResetNotifier
@@ -846,7 +1335,18 @@ Map::PlayerRelocation(Player *player, float x, float y, float z, float orientati
         NGridType* newGrid = getNGrid(new_cell.GridX(), new_cell.GridY());
         AddToGrid(player, newGrid,new_cell);
     }
+    // the view of the client only changes with a new cell or after a few yards,
+    // the objects around still see the player move
+    else if (float limit = float(sWorld.getConfig(CONFIG_VISIBILITY_RELOCATION_LIMIT)))
+    {
+        if (player->GetExactDist2dSq(&player->m_visibilityRelocationPos) < limit * limit)
+        {
+            player->AddToNotify(NOTIFY_VISIBILITY_CHANGED);
+            return;
+        }
+    }
 
+    player->m_visibilityRelocationPos.Relocate(x, y, z, orientation);
     player->UpdateObjectVisibility(false);
 }
 
@@ -884,6 +1384,7 @@ void Map::AddCreatureToMoveList(Creature *c, float x, float y, float z, float an
     if (!c)
         return;
 
+    ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, m_updateListsLock);
     i_creaturesToMove[c] = CreatureMover(x, y, z, ang);
 }
 
@@ -1056,6 +1557,7 @@ bool Map::UnloadGrid(const uint32 &x, const uint32 &y, bool unloadAll)
 
         ASSERT(i_objectsToRemove.empty());
 
+        setGridObjectDataReady(false, x, y);
         delete grid;
         setNGrid(NULL, x, y);
     }
@@ -1074,6 +1576,7 @@ bool Map::UnloadGrid(const uint32 &x, const uint32 &y, bool unloadAll)
                 delete GridMaps[gx][gy];
             }
             VMAP::VMapFactory::createOrGetVMapManager()->unloadMap(GetId(), gx, gy);
+            sMoveMapMgr.UnloadTile(GetId(), gx, gy);
         }
         else
             ((MapInstanced*)m_parentMap)->RemoveGridMapReference(GridPair(gx, gy));
@@ -1149,56 +1652,68 @@ bool GridMap::loadData(char *filename)
     // Unload old data if exist
     unloadData();
 
-    map_fileheader header;
     // Not return error if file not found
-    FILE *in = fopen(filename, "rb");
-    if (!in)
+    if (ACE_OS::access(filename, F_OK) == -1)
         return true;
 
-    if (fread(&header, sizeof(header),1,in) != 1)
+    if (m_file.map(filename, static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_READ, ACE_MAP_SHARED) == -1)
     {
-        fclose(in);
+        sLog.outError("Could not map file '%s'", filename);
+        return false;
+    }
+
+    // the mapping stays valid, do not hold a descriptor for each loaded grid
+    m_file.close_handle();
+
+#ifdef MADV_WILLNEED
+    // let the kernel read the pages ahead, the first lookups would fault them in one by one
+    m_file.advise(MADV_WILLNEED);
+#endif
+
+    map_fileheader header;
+    if (!readHeader(header, 0))
+    {
+        unloadData();
         return false;
     }
 
     if (header.mapMagic == uint32(MAP_MAGIC) && header.versionMagic == uint32(MAP_VERSION_MAGIC))
     {
         // loadup area data
-        if (header.areaMapOffset && !loadAreaData(in, header.areaMapOffset, header.areaMapSize))
+        if (header.areaMapOffset && !loadAreaData(header.areaMapOffset, header.areaMapSize))
         {
             sLog.outError("Error loading map area data\n");
-            fclose(in);
+            unloadData();
             return false;
         }
         // loadup height data
-        if (header.heightMapOffset && !loadHeightData(in, header.heightMapOffset, header.heightMapSize))
+        if (header.heightMapOffset && !loadHeightData(header.heightMapOffset, header.heightMapSize))
         {
             sLog.outError("Error loading map height data\n");
-            fclose(in);
+            unloadData();
             return false;
         }
         // loadup liquid data
-        if (header.liquidMapOffset && !loadLiquidData(in, header.liquidMapOffset, header.liquidMapSize))
+        if (header.liquidMapOffset && !loadLiquidData(header.liquidMapOffset, header.liquidMapSize))
         {
             sLog.outError("Error loading map liquids data\n");
-            fclose(in);
+            unloadData();
             return false;
         }
-        fclose(in);
         return true;
     }
     sLog.outError("Map file '%s' is from an incompatible clientversion. Please recreate using the mapextractor.", filename);
-    fclose(in);
+    unloadData();
     return false;
 }
 
 void GridMap::unloadData()
 {
-    delete[] m_area_map;
-    delete[] m_V9;
-    delete[] m_V8;
-    delete[] m_liquid_type;
-    delete[] m_liquid_map;
+    for (std::vector<uint8*>::iterator itr = m_copies.begin(); itr != m_copies.end(); ++itr)
+        delete[] *itr;
+    m_copies.clear();
+    m_file.close();
+
     m_area_map = NULL;
     m_V9 = NULL;
     m_V8 = NULL;
@@ -1207,61 +1722,78 @@ void GridMap::unloadData()
     m_gridGetHeight = &GridMap::getHeightFromFlat;
 }
 
-bool GridMap::loadAreaData(FILE *in, uint32 offset, uint32 /*size*/)
+template<class T>
+bool GridMap::readHeader(T& header, uint32 offset)
 {
-    map_areaHeader header;
-    fseek(in, offset, SEEK_SET);
+    if (size_t(offset) + sizeof(T) > m_file.size())
+        return false;
+
+    memcpy(&header, static_cast<uint8 const*>(m_file.addr()) + offset, sizeof(T));
+    return true;
+}
 
-    if (fread(&header, sizeof(header), 1, in) != 1 || header.fourcc != uint32(MAP_AREA_MAGIC))
+template<class T>
+bool GridMap::mapArray(T*& dest, uint32 offset, uint32 count)
+{
+    if (size_t(offset) + count * sizeof(T) > m_file.size())
         return false;
 
-    m_gridArea = header.gridArea;
-    if (!(header.flags & MAP_AREA_NO_AREA))
+    uint8* src = static_cast<uint8*>(m_file.addr()) + offset;
+    if (size_t(src) % sizeof(T) == 0)
     {
-        m_area_map = new uint16 [16*16];
-        if (fread(m_area_map, sizeof(uint16), 16*16, in) != 16*16)
-            return false;
+        dest = reinterpret_cast<T*>(src);
+        return true;
     }
+
+    uint8* copy = new uint8[count * sizeof(T)];
+    memcpy(copy, src, count * sizeof(T));
+    m_copies.push_back(copy);
+    dest = reinterpret_cast<T*>(copy);
     return true;
 }
 
-bool GridMap::loadHeightData(FILE *in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadAreaData(uint32 offset, uint32 /*size*/)
 {
-    map_heightHeader header;
-    fseek(in, offset, SEEK_SET);
+    map_areaHeader header;
+    if (!readHeader(header, offset) || header.fourcc != uint32(MAP_AREA_MAGIC))
+        return false;
+
+    m_gridArea = header.gridArea;
+    if (!(header.flags & MAP_AREA_NO_AREA))
+        return mapArray(m_area_map, offset + sizeof(header), 16*16);
+    return true;
+}
 
-    if (fread(&header, sizeof(header), 1, in) != 1 || header.fourcc != uint32(MAP_HEIGHT_MAGIC))
+bool GridMap::loadHeightData(uint32 offset, uint32 /*size*/)
+{
+    map_heightHeader header;
+    if (!readHeader(header, offset) || header.fourcc != uint32(MAP_HEIGHT_MAGIC))
         return false;
 
+    offset += sizeof(header);
     m_gridHeight = header.gridHeight;
     if (!(header.flags & MAP_HEIGHT_NO_HEIGHT))
     {
         if ((header.flags & MAP_HEIGHT_AS_INT16))
         {
-            m_uint16_V9 = new uint16 [129*129];
-            m_uint16_V8 = new uint16 [128*128];
-            if (fread(m_uint16_V9, sizeof(uint16), 129*129, in) != 129*129 ||
-                fread(m_uint16_V8, sizeof(uint16), 128*128, in) != 128*128)
+            if (!mapArray(m_uint16_V9, offset, 129*129) ||
+                !mapArray(m_uint16_V8, offset + 129*129*sizeof(uint16), 128*128))
                 return false;
             m_gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 65535;
             m_gridGetHeight = &GridMap::getHeightFromUint16;
         }
         else if ((header.flags & MAP_HEIGHT_AS_INT8))
         {
-            m_uint8_V9 = new uint8 [129*129];
-            m_uint8_V8 = new uint8 [128*128];
-            if (fread(m_uint8_V9, sizeof(uint8), 129*129, in) != 129*129 ||
-                fread(m_uint8_V8, sizeof(uint8), 128*128, in) != 128*128)
+            if (!mapArray(m_uint8_V9, offset, 129*129) ||
+                !mapArray(m_uint8_V8, offset + 129*129*sizeof(uint8), 128*128))
                 return false;
             m_gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 255;
             m_gridGetHeight = &GridMap::getHeightFromUint8;
         }
         else
         {
-            m_V9 = new float [129*129];
-            m_V8 = new float [128*128];
-            if (fread(m_V9, sizeof(float), 129*129, in) != 129*129 ||
-                fread(m_V8, sizeof(float), 128*128, in) != 128*128)
+            if (!mapArray(m_V9, offset, 129*129) ||
+                !mapArray(m_V8, offset + 129*129*sizeof(float), 128*128))
                 return false;
             m_gridGetHeight = &GridMap::getHeightFromFloat;
         }
@@ -1271,14 +1803,13 @@ bool GridMap::loadHeightData(FILE *in, uint32 offset, uint32 /*size*/)
     return true;
 }
 
-bool  GridMap::loadLiquidData(FILE *in, uint32 offset, uint32 /*size*/)
+bool  GridMap::loadLiquidData(uint32 offset, uint32 /*size*/)
 {
     map_liquidHeader header;
-    fseek(in, offset, SEEK_SET);
-
-    if (fread(&header, sizeof(header), 1, in) != 1 || header.fourcc != uint32(MAP_LIQUID_MAGIC))
+    if (!readHeader(header, offset) || header.fourcc != uint32(MAP_LIQUID_MAGIC))
         return false;
 
+    offset += sizeof(header);
     m_liquidType   = header.liquidType;
     m_liquid_offX  = header.offsetX;
     m_liquid_offY  = header.offsetY;
@@ -1288,16 +1819,12 @@ bool  GridMap::loadLiquidData(FILE *in, uint32 offset, uint32 /*size*/)
 
     if (!(header.flags & MAP_LIQUID_NO_TYPE))
     {
-        m_liquid_type = new uint8 [16*16];
-        if (fread(m_liquid_type, sizeof(uint8), 16*16, in) != 16*16)
+        if (!mapArray(m_liquid_type, offset, 16*16))
             return false;
+        offset += 16*16*sizeof(uint8);
     }
     if (!(header.flags & MAP_LIQUID_NO_HEIGHT))
-    {
-        m_liquid_map = new float [m_liquid_width*m_liquid_height];
-        if (fread(m_liquid_map, sizeof(float), m_liquid_width*m_liquid_height, in) != m_liquid_width*m_liquid_height)
-            return false;
-    }
+        return mapArray(m_liquid_map, offset, m_liquid_width*m_liquid_height);
     return true;
 }
 
@@ -1534,6 +2061,95 @@ float  GridMap::getHeightFromUint16(float x, float y) const
     return (float)((a * x) + (b * y) + c)*m_gridIntHeightMultiplier + m_gridHeight;
 }
 
+// Same arithmetic in the same order as getHeightFrom*(), only 4 lanes wide,
+// so the results are bit for bit the ones of the single point functions. The
+// packed heights are small integers which floats represent exactly.
+template<class T>
+void GridMap::getHeightsPacked(T const* V9, T const* V8, bool isInt, float const* x, float const* y, float* heights, uint32 count) const
+{
+    uint32 i = 0;
+#ifdef GRIDMAP_SSE2
+    __m128 const resolution = _mm_set1_ps(float(MAP_RESOLUTION));
+    __m128 const center = _mm_set1_ps(32.0f);
+    __m128 const gridSize = _mm_set1_ps(SIZE_OF_GRIDS);
+    __m128 const one = _mm_set1_ps(1.0f);
+    __m128 const two = _mm_set1_ps(2.0f);
+    __m128i const mask = _mm_set1_epi32(MAP_RESOLUTION - 1);
+    __m128 const multiplier = _mm_set1_ps(m_gridIntHeightMultiplier);
+    __m128 const base = _mm_set1_ps(m_gridHeight);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 fx = _mm_mul_ps(resolution, _mm_sub_ps(center, _mm_div_ps(_mm_loadu_ps(x + i), gridSize)));
+        __m128 fy = _mm_mul_ps(resolution, _mm_sub_ps(center, _mm_div_ps(_mm_loadu_ps(y + i), gridSize)));
+        __m128i ix = _mm_cvttps_epi32(fx);
+        __m128i iy = _mm_cvttps_epi32(fy);
+        fx = _mm_sub_ps(fx, _mm_cvtepi32_ps(ix));
+        fy = _mm_sub_ps(fy, _mm_cvtepi32_ps(iy));
+
+        int32 x_int[4], y_int[4];
+        _mm_storeu_si128((__m128i*)x_int, _mm_and_si128(ix, mask));
+        _mm_storeu_si128((__m128i*)y_int, _mm_and_si128(iy, mask));
+
+        // no gather in SSE2, the corners are loaded one by one
+        float c1[4], c2[4], c3[4], c4[4], c5[4];
+        for (uint32 j = 0; j < 4; ++j)
+        {
+            T const* V9_h1_ptr = &V9[x_int[j]*129 + y_int[j]];
+            c1[j] = float(V9_h1_ptr[  0]);
+            c2[j] = float(V9_h1_ptr[129]);
+            c3[j] = float(V9_h1_ptr[  1]);
+            c4[j] = float(V9_h1_ptr[130]);
+            c5[j] = float(V8[x_int[j]*128 + y_int[j]]);
+        }
+        __m128 h1 = _mm_loadu_ps(c1);
+        __m128 h2 = _mm_loadu_ps(c2);
+        __m128 h3 = _mm_loadu_ps(c3);
+        __m128 h4 = _mm_loadu_ps(c4);
+        __m128 h5 = _mm_mul_ps(two, _mm_loadu_ps(c5));
+
+        // all four triangles, then select by x+y < 1 and x > y
+        __m128 a1 = _mm_sub_ps(h2, h1),                  b1 = _mm_sub_ps(_mm_sub_ps(h5, h1), h2);
+        __m128 a2 = _mm_sub_ps(_mm_sub_ps(h5, h1), h3),  b2 = _mm_sub_ps(h3, h1);
+        __m128 a3 = _mm_sub_ps(_mm_add_ps(h2, h4), h5),  b3 = _mm_sub_ps(h4, h2);
+        __m128 a4 = _mm_sub_ps(h4, h3),                  b4 = _mm_sub_ps(_mm_add_ps(h3, h4), h5);
+        __m128 c12 = h1, c34 = _mm_sub_ps(h5, h4);
+
+        __m128 lower = _mm_cmplt_ps(_mm_add_ps(fx, fy), one);
+        __m128 right = _mm_cmpgt_ps(fx, fy);
+
+        __m128 a = _mm_or_ps(_mm_and_ps(lower, _mm_or_ps(_mm_and_ps(right, a1), _mm_andnot_ps(right, a2))),
+                          _mm_andnot_ps(lower, _mm_or_ps(_mm_and_ps(right, a3), _mm_andnot_ps(right, a4))));
+        __m128 b = _mm_or_ps(_mm_and_ps(lower, _mm_or_ps(_mm_and_ps(right, b1), _mm_andnot_ps(right, b2))),
+                          _mm_andnot_ps(lower, _mm_or_ps(_mm_and_ps(right, b3), _mm_andnot_ps(right, b4))));
+        __m128 c = _mm_or_ps(_mm_and_ps(lower, c12), _mm_andnot_ps(lower, c34));
+
+        __m128 h = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, fx), _mm_mul_ps(b, fy)), c);
+        if (isInt)
+            h = _mm_add_ps(_mm_mul_ps(h, multiplier), base);
+        _mm_storeu_ps(heights + i, h);
+    }
+#endif
+
+    for (; i < count; ++i)
+        heights[i] = (this->*m_gridGetHeight)(x[i], y[i]);
+}
+
+void GridMap::getHeights(float const* x, float const* y, float* heights, uint32 count) const
+{
+    if (m_gridGetHeight == &GridMap::getHeightFromFloat && m_V8 && m_V9)
+        getHeightsPacked(m_V9, m_V8, false, x, y, heights, count);
+    else if (m_gridGetHeight == &GridMap::getHeightFromUint16 && m_uint16_V8 && m_uint16_V9)
+        getHeightsPacked(m_uint16_V9, m_uint16_V8, true, x, y, heights, count);
+    else if (m_gridGetHeight == &GridMap::getHeightFromUint8 && m_uint8_V8 && m_uint8_V9)
+        getHeightsPacked(m_uint8_V9, m_uint8_V8, true, x, y, heights, count);
+    else
+    {
+        for (uint32 i = 0; i < count; ++i)
+            heights[i] = (this->*m_gridGetHeight)(x[i], y[i]);
+    }
+}
+
 float  GridMap::getLiquidLevel(float x, float y)
 {
     if (!m_liquid_map)
@@ -1567,6 +2183,32 @@ uint8  GridMap::getTerrainType(float x, float y)
 
 // Get water state on map
 inline ZLiquidStatus GridMap::getLiquidStatus(float x, float y, float z, uint8 ReqLiquidType, LiquidData *data)
+{
+    return getLiquidStatus(x, y, z, ReqLiquidType, data, NULL);
+}
+
+void GridMap::getLiquidStatus(float const* x, float const* y, float const* z, uint8 ReqLiquidType, ZLiquidStatus* status, LiquidData* data, uint32 count)
+{
+    // Check water type (if no water return)
+    if (!m_liquid_type && !m_liquidType)
+    {
+        for (uint32 i = 0; i < count; ++i)
+            status[i] = LIQUID_MAP_NO_WATER;
+        return;
+    }
+
+    float ground[64];
+    for (uint32 i = 0; i < count; i += 64)
+    {
+        uint32 n = std::min(count - i, uint32(64));
+        getHeights(x + i, y + i, ground, n);
+        for (uint32 j = 0; j < n; ++j)
+            status[i + j] = getLiquidStatus(x[i + j], y[i + j], z[i + j], ReqLiquidType, data ? &data[i + j] : NULL, &ground[j]);
+    }
+}
+
+// groundLevel is computed if not given
+ZLiquidStatus GridMap::getLiquidStatus(float x, float y, float z, uint8 ReqLiquidType, LiquidData *data, float const* groundLevel)
 {
     // Check water type (if no water return)
     if (!m_liquid_type && !m_liquidType)
@@ -1600,7 +2242,7 @@ inline ZLiquidStatus GridMap::getLiquidStatus(float x, float y, float z, uint8 R
     // Get water level
     float liquid_level = m_liquid_map ? m_liquid_map[lx_int*m_liquid_width + ly_int] : m_liquidLevel;
     // Get ground level (sub 0.2 for fix some errors)
-    float ground_level = getHeight(x, y);
+    float ground_level = groundLevel ? *groundLevel : getHeight(x, y);
 
     // Check water level and ground level
     if (liquid_level < ground_level || z < ground_level - 2)
@@ -1640,20 +2282,38 @@ inline GridMap *Map::GetGrid(float x, float y)
     return GridMaps[gx][gy];
 }
 
+uint32 Map::GetTerrainZoneId(float x, float y)
+{
+    if (GridMap *gmap = GetGrid(x, y))
+        return GetZoneId(gmap->getArea(x, y), GetId());
+
+    return GetZoneId(GetAreaFlagByMapId(i_mapEntry->MapID), GetId());
+}
+
 float Map::GetHeight(float x, float y, float z, bool pUseVmaps, float maxSearchDist) const
 {
     // find raw .map surface under Z coordinates
-    float mapHeight;
+    float _mapheight = VMAP_INVALID_HEIGHT_VALUE;
     if (GridMap *gmap = const_cast<Map*>(this)->GetGrid(x, y))
-    {
-        float _mapheight = gmap->getHeight(x,y);
+        _mapheight = gmap->getHeight(x,y);
 
-        // look from a bit higher pos to find the floor, ignore under surface case
-        if (z + 2.0f > _mapheight)
-            mapHeight = _mapheight;
-        else
-            mapHeight = VMAP_INVALID_HEIGHT_VALUE;
-    }
+    return SelectHeight(_mapheight, x, y, z, pUseVmaps, maxSearchDist);
+}
+
+void Map::GetHeights(float const* x, float const* y, float z, float* heights, uint32 count, bool pUseVmaps, float maxSearchDist) const
+{
+    GetTerrainHeights(x, y, heights, count);
+
+    for (uint32 i = 0; i < count; ++i)
+        heights[i] = SelectHeight(heights[i], x[i], y[i], z, pUseVmaps, maxSearchDist);
+}
+
+float Map::SelectHeight(float _mapheight, float x, float y, float z, bool pUseVmaps, float maxSearchDist) const
+{
+    // look from a bit higher pos to find the floor, ignore under surface case
+    float mapHeight;
+    if (z + 2.0f > _mapheight)
+        mapHeight = _mapheight;
     else
         mapHeight = VMAP_INVALID_HEIGHT_VALUE;
 
@@ -1703,6 +2363,49 @@ float Map::GetHeight(float x, float y, float z, bool pUseVmaps, float maxSearchD
     }
 }
 
+void Map::GetTerrainHeights(float const* x, float const* y, float* heights, uint32 count) const
+{
+    // hand the runs of points in the same grid over at once
+    for (uint32 i = 0; i < count;)
+    {
+        int gx = (int)(32-x[i]/SIZE_OF_GRIDS);
+        int gy = (int)(32-y[i]/SIZE_OF_GRIDS);
+        uint32 end = i + 1;
+        while (end < count && (int)(32-x[end]/SIZE_OF_GRIDS) == gx && (int)(32-y[end]/SIZE_OF_GRIDS) == gy)
+            ++end;
+
+        if (GridMap *gmap = const_cast<Map*>(this)->GetGrid(x[i], y[i]))
+            gmap->getHeights(x + i, y + i, heights + i, end - i);
+        else
+        {
+            for (uint32 j = i; j < end; ++j)
+                heights[j] = VMAP_INVALID_HEIGHT_VALUE;
+        }
+        i = end;
+    }
+}
+
+void Map::GetTerrainLiquidStatus(float const* x, float const* y, float const* z, uint8 ReqLiquidType, ZLiquidStatus* status, LiquidData* data, uint32 count) const
+{
+    for (uint32 i = 0; i < count;)
+    {
+        int gx = (int)(32-x[i]/SIZE_OF_GRIDS);
+        int gy = (int)(32-y[i]/SIZE_OF_GRIDS);
+        uint32 end = i + 1;
+        while (end < count && (int)(32-x[end]/SIZE_OF_GRIDS) == gx && (int)(32-y[end]/SIZE_OF_GRIDS) == gy)
+            ++end;
+
+        if (GridMap *gmap = const_cast<Map*>(this)->GetGrid(x[i], y[i]))
+            gmap->getLiquidStatus(x + i, y + i, z + i, ReqLiquidType, status + i, data ? data + i : NULL, end - i);
+        else
+        {
+            for (uint32 j = i; j < end; ++j)
+                status[j] = LIQUID_MAP_NO_WATER;
+        }
+        i = end;
+    }
+}
+
 inline bool IsOutdoorWMO(uint32 mogpFlags, uint32 mapId)
 {
     // if this flag is set we are outdoors and can mount up
@@ -2066,6 +2769,7 @@ void Map::AddObjectToRemoveList(WorldObject *obj)
 
     obj->CleanupsBeforeDelete();                            // remove or simplify at least cross referenced links
 
+    ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, m_updateListsLock);
     i_objectsToRemove.insert(obj);
     //sLog.outDebug("Object (GUID: %u TypeId: %u) added to removing list.",obj->GetGUIDLow(),obj->GetTypeId());
 }
@@ -2074,6 +2778,7 @@ void Map::AddObjectToSwitchList(WorldObject *obj, bool on)
 {
     ASSERT(obj->GetMapId() == GetId() && obj->GetInstanceId() == GetInstanceId());
 
+    ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, m_updateListsLock);
     std::map<WorldObject*, bool>::iterator itr = i_objectsToSwitch.find(obj);
     if (itr == i_objectsToSwitch.end())
         i_objectsToSwitch.insert(itr, std::make_pair(obj, on));
@@ -2154,8 +2859,10 @@ uint32 Map::GetPlayersCountExceptGMs() const
 
 void Map::SendToPlayers(WorldPacket const* data) const
 {
+    SharedPacket* shared = SharedPacket::Create(*data);
     for (MapRefManager::const_iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
-        itr->getSource()->GetSession()->SendPacket(data);
+        itr->getSource()->GetSession()->SendPacket(shared);
+    shared->RemoveReference();
 }
 
 bool Map::ActiveObjectsNearGrid(uint32 x, uint32 y) const
@@ -24,6 +24,9 @@
 #include "Policies/ThreadingModel.h"
 #include "ace/RW_Thread_Mutex.h"
 #include "ace/Thread_Mutex.h"
+#include "ace/Recursive_Thread_Mutex.h"
+#include "ace/Guard_T.h"
+#include "ace/Mem_Map.h"
 
 #include "DBCStructure.h"
 #include "GridDefines.h"
@@ -32,9 +35,12 @@
 #include "SharedDefines.h"
 #include "GameSystem/GridRefManager.h"
 #include "MapRefManager.h"
+#include "CreatureUpdateWheel.h"
+#include "MovementRelay.h"
 
 #include <bitset>
 #include <list>
+#include <vector>
 
 class Unit;
 class WorldPacket;
@@ -173,9 +179,18 @@ class GridMap
     uint8  *m_liquid_type;
     float  *m_liquid_map;
 
-    bool  loadAreaData(FILE *in, uint32 offset, uint32 size);
-    bool  loadHeightData(FILE *in, uint32 offset, uint32 size);
-    bool  loadLiquidData(FILE *in, uint32 offset, uint32 size);
+    // The arrays above point into the read only mapping of the file, its pages
+    // are shared by all processes through the page cache. Only the arrays left
+    // misaligned by older extractors are copied.
+    ACE_Mem_Map m_file;
+    std::vector<uint8*> m_copies;
+
+    template<class T> bool mapArray(T*& dest, uint32 offset, uint32 count);
+    template<class T> bool readHeader(T& header, uint32 offset);
+
+    bool  loadAreaData(uint32 offset, uint32 size);
+    bool  loadHeightData(uint32 offset, uint32 size);
+    bool  loadLiquidData(uint32 offset, uint32 size);
 
     // Get height functions and pointers
     typedef float (GridMap::*pGetHeightPtr) (float x, float y) const;
@@ -185,6 +200,11 @@ class GridMap
     float  getHeightFromUint8(float x, float y) const;
     float  getHeightFromFlat(float x, float y) const;
 
+    // interpolates 4 points per step, T is the type of the stored heights
+    template<class T> void getHeightsPacked(T const* V9, T const* V8, bool isInt, float const* x, float const* y, float* heights, uint32 count) const;
+
+    ZLiquidStatus getLiquidStatus(float x, float y, float z, uint8 ReqLiquidType, LiquidData *data, float const* groundLevel);
+
 public:
     GridMap();
     ~GridMap();
@@ -196,6 +216,11 @@ public:
     float  getLiquidLevel(float x, float y);
     uint8  getTerrainType(float x, float y);
     ZLiquidStatus getLiquidStatus(float x, float y, float z, uint8 ReqLiquidType, LiquidData *data = 0);
+
+    // Answer count points of this grid at once, the results are the same as
+    // the ones of getHeight() and getLiquidStatus(), data may be NULL
+    void  getHeights(float const* x, float const* y, float* heights, uint32 count) const;
+    void  getLiquidStatus(float const* x, float const* y, float const* z, uint8 ReqLiquidType, ZLiquidStatus* status, LiquidData* data, uint32 count);
 };
 
 struct CreatureMover
@@ -246,6 +271,17 @@ typedef UNORDERED_MAP<Creature*, CreatureMover> CreatureMoveList;
 #define DEFAULT_HEIGHT_SEARCH     10.0f                     // default search distance to find height at nearby locations
 #define MIN_UNLOAD_DELAY      1                             // immediate unload
 
+// creature update counts since the last reset, shown by .debug creatureupdate
+struct CreatureUpdateStats
+{
+    CreatureUpdateStats() : ticks(0), updated(0), asleep(0), cellTime(0) {}
+
+    uint64 ticks;
+    uint64 updated;                                         // Creature::Update calls
+    uint64 asleep;                                          // creatures in the updated cells left out sleeping
+    uint64 cellTime;                                        // us spent in the cell updates
+};
+
 typedef std::map<uint32/*leaderDBGUID*/, CreatureFormation*>        CreatureFormationHolderType;
 typedef std::map<uint32/*groupId*/, CreatureGroup*>            CreatureGroupHolderType;
 
@@ -325,9 +361,16 @@ class Map : public GridRefManager<NGridType>, public Oregon::ObjectLevelLockable
         // some calls like isInWater should not use vmaps due to processor power
         // can return INVALID_HEIGHT if under z+2 z coord not found height
         float GetHeight(float x, float y, float z, bool pCheckVMap=true, float maxSearchDist=DEFAULT_HEIGHT_SEARCH) const;
+        // GetHeight() of many points searched from the same z, the .map part at once
+        void GetHeights(float const* x, float const* y, float z, float* heights, uint32 count, bool pCheckVMap=true, float maxSearchDist=DEFAULT_HEIGHT_SEARCH) const;
 
         ZLiquidStatus getLiquidStatus(float x, float y, float z, uint8 ReqLiquidType, LiquidData *data = 0) const;
 
+        // .map surface and liquid only (no vmaps) for many points, VMAP_INVALID_HEIGHT_VALUE
+        // and LIQUID_MAP_NO_WATER where no grid map exists, data may be NULL
+        void GetTerrainHeights(float const* x, float const* y, float* heights, uint32 count) const;
+        void GetTerrainLiquidStatus(float const* x, float const* y, float const* z, uint8 ReqLiquidType, ZLiquidStatus* status, LiquidData* data, uint32 count) const;
+
         uint16 GetAreaFlag(float x, float y, float z, bool *isOutdoors=0) const;
         bool GetAreaInfo(float x, float y, float z, uint32 &mogpflags, int32 &adtId, int32 &rootId, int32 &groupId) const;
 
@@ -389,8 +432,16 @@ class Map : public GridRefManager<NGridType>, public Oregon::ObjectLevelLockable
         uint32 GetPlayersCountExceptGMs() const;
         bool ActiveObjectsNearGrid(uint32 x, uint32 y) const;
 
-        void AddWorldObject(WorldObject *obj) { i_worldObjects.insert(obj); }
-        void RemoveWorldObject(WorldObject *obj) { i_worldObjects.erase(obj); }
+        void AddWorldObject(WorldObject *obj)
+        {
+            ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, m_updateListsLock);
+            i_worldObjects.insert(obj);
+        }
+        void RemoveWorldObject(WorldObject *obj)
+        {
+            ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, m_updateListsLock);
+            i_worldObjects.erase(obj);
+        }
 
         void SendToPlayers(WorldPacket const* data) const;
 
@@ -417,6 +468,11 @@ class Map : public GridRefManager<NGridType>, public Oregon::ObjectLevelLockable
         template<class NOTIFIER> void VisitAll(const float &x, const float &y, float radius, NOTIFIER &notifier);
         template<class NOTIFIER> void VisitWorld(const float &x, const float &y, float radius, NOTIFIER &notifier);
         template<class NOTIFIER> void VisitGrid(const float &x, const float &y, float radius, NOTIFIER &notifier);
+        // like VisitAll/VisitWorld/VisitGrid, but passes only the objects of the type mask
+        // within the radius plus their size to notifier.VisitObject()
+        template<class NOTIFIER> void VisitAllInRange(const float &x, const float &y, float radius, uint32 typeMask, NOTIFIER &notifier);
+        template<class NOTIFIER> void VisitGridInRange(const float &x, const float &y, float radius, uint32 typeMask, NOTIFIER &notifier);
+        template<class NOTIFIER> void VisitWorldInRange(const float &x, const float &y, float radius, uint32 typeMask, NOTIFIER &notifier);
         CreatureFormationHolderType CreatureFormationHolder;
         CreatureGroupHolderType CreatureGroupHolder;
 
@@ -426,11 +482,23 @@ class Map : public GridRefManager<NGridType>, public Oregon::ObjectLevelLockable
         Creature* GetCreature(uint64 guid);
         GameObject* GetGameObject(uint64 guid);
         DynamicObject* GetDynamicObject(uint64 guid);
+
+        CreatureUpdateWheel& GetCreatureWheel() { return m_creatureWheel; }
+        CreatureUpdateStats GetCreatureUpdateStats(bool reset);
+        // called by the cell updaters, also from the parallel islands
+        void AddCreatureUpdateCounts(uint32 updated, uint32 asleep);
+
+        MovementRelay& GetMovementRelay() { return m_movementRelay; }
     private:
         void LoadMapAndVMap(int gx, int gy);
         void LoadVMap(int gx, int gy);
         void LoadMap(int gx,int gy, bool reload = false);
         GridMap *GetGrid(float x, float y);
+        // the choice of GetHeight() between the .map height at x, y and the vmaps
+        float SelectHeight(float _mapheight, float x, float y, float z, bool pUseVmaps, float maxSearchDist) const;
+
+        void PreloadGridsAhead(Player* player);
+        void PreloadGridAt(float x, float y);
 
         void SetTimer(uint32 t) { i_gridExpiry = t < MIN_GRID_DELAY ? MIN_GRID_DELAY : t; }
 
@@ -464,10 +532,20 @@ class Map : public GridRefManager<NGridType>, public Oregon::ObjectLevelLockable
         bool isGridObjectDataLoaded(uint32 x, uint32 y) const { return getNGrid(x,y)->isGridObjectDataLoaded(); }
         void setGridObjectDataLoaded(bool pLoaded, uint32 x, uint32 y) { getNGrid(x,y)->setGridObjectDataLoaded(pLoaded); }
 
+        // set once all objects of the grid are loaded, can be read without m_updateListsLock
+        bool isGridObjectDataReady(uint32 x, uint32 y) const;
+        void setGridObjectDataReady(bool ready, uint32 x, uint32 y);
+
         void setNGrid(NGridType* grid, uint32 x, uint32 y);
         void ScriptsProcess();
 
-        void UpdateActiveCells(const float &x, const float &y, const uint32 &t_diff);
+        void UpdateActiveCells(const uint32 &t_diff);
+
+        // updates the active cells in groups that are too far apart to reach each other
+        void UpdateCellsInParallel(const uint32 &t_diff);
+        void CollectActiveCells(CellPair begin_cell, CellPair end_cell, std::vector<CellPair>& cells);
+        // zone of the terrain only, without the vmap area of the position
+        uint32 GetTerrainZoneId(float x, float y);
     protected:
         void SetUnloadReferenceLock(const GridPair &p, bool on) { getNGrid(p.x_coord, p.y_coord)->setUnloadReferenceLock(on); }
 
@@ -505,6 +583,7 @@ class Map : public GridRefManager<NGridType>, public Oregon::ObjectLevelLockable
         Map* m_parentMap;
 
         NGridType* i_grids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        volatile bool i_gridObjectDataReady[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         GridMap *GridMaps[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP*TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
 
@@ -512,12 +591,24 @@ class Map : public GridRefManager<NGridType>, public Oregon::ObjectLevelLockable
         //visibility calculations. Highly optimized for massive calculations
         void ProcessRelocationNotifies(const uint32 &diff);
 
+        IntervalTimer m_gridPreloadTimer;
+
+        CreatureUpdateWheel m_creatureWheel;
+        CreatureUpdateStats m_creatureUpdateStats;
+        ACE_Thread_Mutex m_creatureUpdateStatsLock;
+
+        MovementRelay m_movementRelay;
+
         bool i_scriptLock;
         std::set<WorldObject *> i_objectsToRemove;
         std::map<WorldObject*, bool> i_objectsToSwitch;
         std::set<WorldObject*> i_worldObjects;
         std::multimap<time_t, ScriptAction> m_scriptSchedule;
 
+        // guards the lists above, the move list, the active objects and the grid
+        // loading while the cells are updated in parallel
+        mutable ACE_Recursive_Thread_Mutex m_updateListsLock;
+
         // Type specific code for add/remove to/from grid
         template<class T>
             void AddToGrid(T*, NGridType *, Cell const&);
@@ -531,12 +622,15 @@ class Map : public GridRefManager<NGridType>, public Oregon::ObjectLevelLockable
         template<class T>
         void AddToActiveHelper(T* obj)
         {
+            ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, m_updateListsLock);
             m_activeNonPlayers.insert(obj);
         }
 
         template<class T>
         void RemoveFromActiveHelper(T* obj)
         {
+            ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, m_updateListsLock);
+
             // Map::Update for active object in proccess
             if (m_activeNonPlayersIter != m_activeNonPlayers.end())
             {
@@ -674,5 +768,49 @@ Map::VisitGrid(const float &x, const float &y, float radius, NOTIFIER &notifier)
     TypeContainerVisitor<NOTIFIER, GridTypeMapContainer >  grid_object_notifier(notifier);
     cell.Visit(p, grid_object_notifier, *this, radius, x, y);
 }
+
+template<class NOTIFIER>
+inline void
+Map::VisitAllInRange(const float &x, const float &y, float radius, uint32 typeMask, NOTIFIER &notifier)
+{
+    CellPair p(Oregon::ComputeCellPair(x, y));
+    Cell cell(p);
+    cell.data.Part.reserved = ALL_DISTRICT;
+    cell.SetNoCreate();
+
+    GridIndexVisitor<NOTIFIER> index_notifier(x, y, radius, typeMask, notifier);
+    TypeContainerVisitor<GridIndexVisitor<NOTIFIER>, WorldTypeMapContainer> world_object_notifier(index_notifier);
+    cell.Visit(p, world_object_notifier, *this, radius, x, y);
+    TypeContainerVisitor<GridIndexVisitor<NOTIFIER>, GridTypeMapContainer >  grid_object_notifier(index_notifier);
+    cell.Visit(p, grid_object_notifier, *this, radius, x, y);
+}
+
+template<class NOTIFIER>
+inline void
+Map::VisitGridInRange(const float &x, const float &y, float radius, uint32 typeMask, NOTIFIER &notifier)
+{
+    CellPair p(Oregon::ComputeCellPair(x, y));
+    Cell cell(p);
+    cell.data.Part.reserved = ALL_DISTRICT;
+    cell.SetNoCreate();
+
+    GridIndexVisitor<NOTIFIER> index_notifier(x, y, radius, typeMask, notifier);
+    TypeContainerVisitor<GridIndexVisitor<NOTIFIER>, GridTypeMapContainer >  grid_object_notifier(index_notifier);
+    cell.Visit(p, grid_object_notifier, *this, radius, x, y);
+}
+
+template<class NOTIFIER>
+inline void
+Map::VisitWorldInRange(const float &x, const float &y, float radius, uint32 typeMask, NOTIFIER &notifier)
+{
+    CellPair p(Oregon::ComputeCellPair(x, y));
+    Cell cell(p);
+    cell.data.Part.reserved = ALL_DISTRICT;
+    cell.SetNoCreate();
+
+    GridIndexVisitor<NOTIFIER> index_notifier(x, y, radius, typeMask, notifier);
+    TypeContainerVisitor<GridIndexVisitor<NOTIFIER>, WorldTypeMapContainer> world_object_notifier(index_notifier);
+    cell.Visit(p, world_object_notifier, *this, radius, x, y);
+}
 #endif
 
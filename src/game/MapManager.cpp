@@ -71,6 +71,11 @@ void MapManager::Initialize()
     if (num_threads > 0 && m_updater.activate(num_threads) == -1)
         abort();
 
+    // read the terrain ahead of the players
+    int preload_threads(sWorld.getConfig(CONFIG_GRID_PRELOAD_THREADS));
+    if (preload_threads > 0 && m_gridPreloader.activate(preload_threads) == -1)
+        abort();
+
     InitMaxInstanceId();
 }
 
@@ -257,6 +262,9 @@ void MapManager::Update(time_t diff)
     for (iter = i_maps.begin(); iter != i_maps.end(); ++iter)
         iter->second->DelayedUpdate(uint32(i_timer.GetCurrent()));
 
+    if (m_gridPreloader.activated())
+        m_gridPreloader.Update();
+
     ObjectAccessor::Instance().Update(i_timer.GetCurrent());
     for (TransportSet::iterator iter = m_Transports.begin(); iter != m_Transports.end(); ++iter)
         (*iter)->Update(i_timer.GetCurrent());
@@ -297,6 +305,9 @@ void MapManager::UnloadAll()
 
     if (m_updater.activated())
         m_updater.deactivate();
+
+    if (m_gridPreloader.activated())
+        m_gridPreloader.deactivate();
 }
 
 void MapManager::InitMaxInstanceId()
@@ -27,6 +27,7 @@
 #include "Map.h"
 #include "GridStates.h"
 #include "MapUpdater.h"
+#include "GridPreloader.h"
 
 class Transport;
 
@@ -131,6 +132,9 @@ class MapManager : public Oregon::Singleton<MapManager, Oregon::ClassLevelLockab
         uint32 GetNumInstances();
         uint32 GetNumPlayersInInstances();
 
+        MapUpdater* GetMapUpdater() { return &m_updater; }
+        GridPreloader* GetGridPreloader() { return &m_gridPreloader; }
+
     private:
         // debugging code, should be deleted some day
         void checkAndCorrectGridStatesArray();              // just for debugging to find some memory overwrites
@@ -157,6 +161,7 @@ class MapManager : public Oregon::Singleton<MapManager, Oregon::ClassLevelLockab
 
         uint32 i_MaxInstanceId;
         MapUpdater m_updater;
+        GridPreloader m_gridPreloader;
 };
 #endif
 
@@ -54,7 +54,10 @@ void Map::ScriptsStart(ScriptMapMap const& scripts, uint32 id, Object* source, O
         sa.ownerGUID  = ownerGUID;
 
         sa.script = &iter->second;
-        m_scriptSchedule.insert(std::pair<time_t, ScriptAction>(time_t(sWorld.GetGameTime() + iter->first), sa));
+        {
+            ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, m_updateListsLock);
+            m_scriptSchedule.insert(std::pair<time_t, ScriptAction>(time_t(sWorld.GetGameTime() + iter->first), sa));
+        }
         if (iter->first == 0)
             immedScript = true;
 
@@ -84,7 +87,10 @@ void Map::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* sou
     sa.ownerGUID  = ownerGUID;
 
     sa.script = &script;
-    m_scriptSchedule.insert(std::pair<time_t, ScriptAction>(time_t(sWorld.GetGameTime() + delay), sa));
+    {
+        ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, m_updateListsLock);
+        m_scriptSchedule.insert(std::pair<time_t, ScriptAction>(time_t(sWorld.GetGameTime() + delay), sa));
+    }
 
     sWorld.IncreaseScheduledScriptsCount();
 
@@ -20,6 +20,7 @@
 #include "MapUpdater.h"
 #include "DelayExecutor.h"
 #include "Map.h"
+#include "ObjectAccessor.h"
 #include "Database/DatabaseEnv.h"
 
 #include <ace/Guard_T.h>
@@ -71,11 +72,105 @@ class MapUpdateRequest : public ACE_Method_Request
     }
 };
 
+class ObjectUpdateRequest : public ACE_Method_Request
+{
+    public:
+        std::vector<Object*>& m_objects;
+        MapUpdater& m_updater;
+        ObjectUpdateRequest(std::vector<Object*>& o, MapUpdater& u) : m_objects(o), m_updater(u){}
+        virtual int
+
+    call (void)
+    {
+        ObjectAccessor::BuildAndSendUpdates(m_objects);
+        m_updater.update_finished ();
+        return 0;
+    }
+};
+
+// Shared by the thread running the batch and the helper requests. A helper may
+// be picked up after the batch is done, so the state lives until the last
+// reference is gone while the batch itself is only used for claimed items.
+class ParallelUpdateState
+{
+    public:
+        ParallelUpdateState(ParallelUpdateBatch& batch, size_t count, size_t refs) :
+            m_batch(batch), m_condition(m_mutex), m_next(0), m_count(count), m_running(0), m_refs(refs) {}
+
+        void Work()
+        {
+            for (;;)
+            {
+                size_t index;
+                {
+                    ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+                    if (m_next >= m_count)
+                        return;
+
+                    index = m_next++;
+                    ++m_running;
+                }
+
+                m_batch.RunItem(index);
+
+                ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+                if (--m_running == 0 && m_next >= m_count)
+                    m_condition.broadcast();
+            }
+        }
+
+        void Wait()
+        {
+            ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+            while (m_running > 0 || m_next < m_count)
+                m_condition.wait();
+        }
+
+        void Release()
+        {
+            bool last;
+            {
+                ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+                last = --m_refs == 0;
+            }
+
+            if (last)
+                delete this;
+        }
+
+    private:
+        ParallelUpdateBatch& m_batch;
+        ACE_Thread_Mutex m_mutex;
+        ACE_Condition_Thread_Mutex m_condition;
+        size_t m_next;
+        size_t m_count;
+        size_t m_running;
+        size_t m_refs;
+};
+
+class ParallelUpdateRequest : public ACE_Method_Request
+{
+    public:
+        ParallelUpdateState* m_state;
+        MapUpdater& m_updater;
+        ParallelUpdateRequest(ParallelUpdateState* s, MapUpdater& u) : m_state(s), m_updater(u){}
+        virtual int
+
+    call (void)
+    {
+        m_state->Work();
+        m_state->Release();
+        m_updater.update_finished ();
+        return 0;
+    }
+};
+
 MapUpdater::MapUpdater() :
 m_executor(),
 m_condition(m_mutex),
 m_mutex(),
-pedning_requests(0)
+pedning_requests(0),
+m_threads(0)
 {
     return;
 }
@@ -87,6 +182,7 @@ MapUpdater::~MapUpdater()
 
 int MapUpdater::activate(size_t num_threads)
 {
+    m_threads = num_threads;
     return this->m_executor.activate(static_cast<int> (num_threads), new WDBThreadStartReq1, new WDBThreadEndReq1);
 }
 
@@ -108,12 +204,42 @@ int MapUpdater::wait()
 }
 
 int MapUpdater::schedule_update(Map& map, ACE_UINT32 diff)
+{
+    return schedule_request(new MapUpdateRequest(map, *this, diff));
+}
+
+int MapUpdater::schedule_object_update(std::vector<Object*>& objects)
+{
+    return schedule_request(new ObjectUpdateRequest(objects, *this));
+}
+
+void MapUpdater::run_parallel(ParallelUpdateBatch& batch, size_t count)
+{
+    if (!count)
+        return;
+
+    // the calling thread is one of the workers already
+    size_t helpers = count - 1;
+    if (helpers >= m_threads)
+        helpers = m_threads ? m_threads - 1 : 0;
+
+    ParallelUpdateState* state = new ParallelUpdateState(batch, count, helpers + 1);
+    for (size_t i = 0; i < helpers; ++i)
+        if (schedule_request(new ParallelUpdateRequest(state, *this)) == -1)
+            state->Release();
+
+    state->Work();
+    state->Wait();
+    state->Release();
+}
+
+int MapUpdater::schedule_request(ACE_Method_Request* request)
 {
     ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, this->m_mutex, -1);
 
     ++this->pedning_requests;
 
-    if (this->m_executor.execute(new MapUpdateRequest(map, *this, diff)) == -1)
+    if (this->m_executor.execute(request) == -1)
     {
         ACE_DEBUG((LM_ERROR, ACE_TEXT("(%t) \n"), ACE_TEXT("Failed to schedule Map Update")));
 
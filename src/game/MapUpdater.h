@@ -25,7 +25,18 @@
 
 #include "DelayExecutor.h"
 
+#include <vector>
+
 class Map;
+class Object;
+
+// Independent pieces of work of one map update, see MapUpdater::run_parallel
+class ParallelUpdateBatch
+{
+    public:
+        virtual ~ParallelUpdateBatch() {}
+        virtual void RunItem(size_t index) = 0;
+};
 
 class MapUpdater
 {
@@ -34,9 +45,20 @@ class MapUpdater
         virtual ~MapUpdater();
 
         friend class MapUpdateRequest;
+        friend class ObjectUpdateRequest;
+        friend class ParallelUpdateRequest;
 
         int schedule_update(Map& map, ACE_UINT32 diff);
 
+        // builds and sends the values updates of the given objects on a worker,
+        // the vector must stay untouched until wait() returns
+        int schedule_object_update(std::vector<Object*>& objects);
+
+        // runs the items of the batch on the workers and the calling thread and
+        // returns when all of them are done, the caller takes part in the work so
+        // it never waits for a worker that is busy with another map
+        void run_parallel(ParallelUpdateBatch& batch, size_t count);
+
         int wait();
 
         int activate(size_t num_threads);
@@ -45,12 +67,14 @@ class MapUpdater
 
         bool activated();
     private:
+        int schedule_request(ACE_Method_Request* request);
         void update_finished();
 
         DelayExecutor m_executor;
         ACE_Condition_Thread_Mutex m_condition;
         ACE_Thread_Mutex m_mutex;
         size_t pedning_requests;
+        size_t m_threads;
 };
 #endif //_MAP_UPDATER_H_INCLUDED
 
@@ -523,6 +523,8 @@ void WorldSession::HandleAddFriendOpcode(WorldPacket & recv_data)
     DEBUG_LOG("WORLD: %s asked to add friend : '%s'",
         GetPlayer()->GetName(), friendName.c_str());
 
+    // read only lookup, no need to wait behind the saves of the default key
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, GetAccountId());
     CharacterDatabase.AsyncPQuery(&WorldSession::HandleAddFriendOpcodeCallBack, GetAccountId(), friendNote, "SELECT guid, race, account FROM characters WHERE name = '%s'", friendName.c_str());
 }
 
@@ -611,6 +613,7 @@ void WorldSession::HandleAddIgnoreOpcode(WorldPacket & recv_data)
     DEBUG_LOG("WORLD: %s asked to Ignore: '%s'",
         GetPlayer()->GetName(), IgnoreName.c_str());
 
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, GetAccountId());
     CharacterDatabase.AsyncPQuery(&WorldSession::HandleAddIgnoreOpcodeCallBack, GetAccountId(), "SELECT guid FROM characters WHERE name = '%s'", IgnoreName.c_str());
 }
 
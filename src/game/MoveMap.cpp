@@ -0,0 +1,481 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MoveMap.h"
+#include "Policies/SingletonImp.h"
+#include "Log.h"
+
+#include <ace/Guard_T.h>
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+INSTANTIATE_SINGLETON_1(MoveMapManager);
+
+#define NAV_DIAGONAL_COST   (NAV_CELL_SIZE * 1.41421356f)
+
+bool NavTile::Load(const char* filename, uint32 mapId, uint32 tileX, uint32 tileY)
+{
+    if (m_file.map(filename, static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_READ, ACE_MAP_SHARED) == -1)
+        return false;
+
+    m_file.close_handle();
+
+    size_t const cells = NAV_TILE_CELLS * NAV_TILE_CELLS;
+    size_t const tableSize = sizeof(NavTileHeader) + (cells + 1) * sizeof(uint32);
+    uint8 const* data = static_cast<uint8 const*>(m_file.addr());
+    if (m_file.size() < tableSize)
+        return false;
+
+    NavTileHeader header;
+    memcpy(&header, data, sizeof(NavTileHeader));
+    if (header.magic != NAV_TILE_MAGIC || header.version != NAV_TILE_VERSION || header.mapId != mapId ||
+        header.tileX != tileX || header.tileY != tileY || m_file.size() != tableSize + header.layerCount * sizeof(NavLayer))
+        return false;
+
+    m_firstLayer = reinterpret_cast<uint32 const*>(data + sizeof(NavTileHeader));
+    m_layers = reinterpret_cast<NavLayer const*>(data + tableSize);
+
+    // the searches trust the table from here on
+    if (m_firstLayer[0] != 0 || m_firstLayer[cells] != header.layerCount)
+        return false;
+    for (size_t i = 0; i < cells; ++i)
+        if (m_firstLayer[i + 1] < m_firstLayer[i] || m_firstLayer[i + 1] - m_firstLayer[i] > NAV_MAX_LAYERS)
+            return false;
+
+    return true;
+}
+
+NavMap::NavMap(uint32 mapId, uint32 cacheSize) : m_mapId(mapId), m_generation(0)
+{
+    for (uint32 i = 0; i < 64; ++i)
+        for (uint32 j = 0; j < 64; ++j)
+            m_tiles[i][j] = NULL;
+
+    // rounded down to a power of two for the index mask
+    uint32 size = 1;
+    while (size * 2 <= cacheSize)
+        size *= 2;
+    if (cacheSize)
+        m_cache.resize(size);
+}
+
+NavMap::~NavMap()
+{
+    for (uint32 i = 0; i < 64; ++i)
+        for (uint32 j = 0; j < 64; ++j)
+            delete m_tiles[i][j];
+}
+
+bool NavMap::LoadTile(std::string const& basePath, int gx, int gy)
+{
+    ACE_WRITE_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, m_lock, false);
+
+    if (m_tiles[gx][gy])
+    {
+        m_tiles[gx][gy]->AddRef();
+        return true;
+    }
+
+    char filename[32];
+    snprintf(filename, sizeof(filename), "%03u%02u%02u.mmtile", m_mapId, gx, gy);
+
+    NavTile* tile = new NavTile();
+    if (!tile->Load((basePath + filename).c_str(), m_mapId, gx, gy))
+    {
+        delete tile;
+        return false;
+    }
+
+    tile->AddRef();
+    m_tiles[gx][gy] = tile;
+    ++m_generation;
+    return true;
+}
+
+void NavMap::UnloadTile(int gx, int gy)
+{
+    ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, m_lock);
+
+    NavTile* tile = m_tiles[gx][gy];
+    if (!tile || tile->DecRef() > 0)
+        return;
+
+    delete tile;
+    m_tiles[gx][gy] = NULL;
+    ++m_generation;
+}
+
+NavLayer const* NavMap::GetLayer(int32 cx, int32 cy, uint32 layer) const
+{
+    if (cx < 0 || cy < 0 || cx >= NAV_MAP_CELLS || cy >= NAV_MAP_CELLS)
+        return NULL;
+
+    NavTile const* tile = m_tiles[cx / NAV_TILE_CELLS][cy / NAV_TILE_CELLS];
+    if (!tile)
+        return NULL;
+
+    uint32 count;
+    NavLayer const* layers = tile->GetLayers(cx % NAV_TILE_CELLS + (cy % NAV_TILE_CELLS) * NAV_TILE_CELLS, count);
+    return layer < count ? &layers[layer] : NULL;
+}
+
+// the layer closest to z in the cell of the position, or in a neighbour cell
+// for positions right at a wall or ledge where the own cell has none
+bool NavMap::FindNode(float x, float y, float z, uint32 &node) const
+{
+    int32 cx = NavCellFromCoord(x);
+    int32 cy = NavCellFromCoord(y);
+
+    for (int32 dir = -1; dir < MAX_NAV_DIRECTIONS; ++dir)
+    {
+        int32 nx = dir < 0 ? cx : cx + NavDirectionX[dir];
+        int32 ny = dir < 0 ? cy : cy + NavDirectionY[dir];
+
+        float best = NAV_MAX_SNAP_HEIGHT;
+        bool found = false;
+        for (uint32 layer = 0; layer < NAV_MAX_LAYERS; ++layer)
+        {
+            NavLayer const* l = GetLayer(nx, ny, layer);
+            if (!l)
+                break;
+            if (fabs(l->z - z) <= best)
+            {
+                best = fabs(l->z - z);
+                node = MakeNode(nx, ny, layer);
+                found = true;
+            }
+        }
+
+        if (found)
+            return true;
+    }
+
+    return false;
+}
+
+struct NavSearchNode
+{
+    uint32 node;
+    uint32 parent;                                          // index in the search list
+    float cost;
+    bool closed;
+};
+
+struct NavOpenEntry
+{
+    NavOpenEntry(float _estimate, uint32 _index) : estimate(_estimate), index(_index) {}
+
+    // std::priority_queue keeps the greatest on top
+    bool operator<(NavOpenEntry const& other) const { return estimate > other.estimate; }
+
+    float estimate;
+    uint32 index;
+};
+
+// the octile distance, never more than the walk along the links
+static float NavEstimate(int32 fromX, int32 fromY, int32 toX, int32 toY)
+{
+    int32 dx = abs(toX - fromX);
+    int32 dy = abs(toY - fromY);
+    return dx > dy ? (dx - dy) * NAV_CELL_SIZE + dy * NAV_DIAGONAL_COST : (dy - dx) * NAV_CELL_SIZE + dx * NAV_DIAGONAL_COST;
+}
+
+// A* over the cell layers, nodes gets the way from start to end or to the
+// node closest to end when end is not reached
+NavPathResult NavMap::Search(uint32 start, uint32 end, std::vector<uint32> &nodes) const
+{
+    int32 endX = NodeX(end);
+    int32 endY = NodeY(end);
+
+    std::vector<NavSearchNode> list;
+    UNORDERED_MAP<uint32, uint32> index;
+    std::priority_queue<NavOpenEntry> open;
+
+    NavSearchNode first = { start, 0, 0.0f, false };
+    list.push_back(first);
+    index[start] = 0;
+    open.push(NavOpenEntry(NavEstimate(NodeX(start), NodeY(start), endX, endY), 0));
+
+    uint32 closest = 0;
+    float closestEstimate = open.top().estimate;
+    bool reached = false;
+
+    while (!open.empty() && list.size() < NAV_MAX_SEARCH_NODES)
+    {
+        uint32 current = open.top().index;
+        open.pop();
+        if (list[current].closed)
+            continue;
+
+        list[current].closed = true;
+        uint32 node = list[current].node;
+        float cost = list[current].cost;
+        if (node == end)
+        {
+            closest = current;
+            reached = true;
+            break;
+        }
+
+        int32 x = NodeX(node);
+        int32 y = NodeY(node);
+        float estimate = NavEstimate(x, y, endX, endY);
+        if (estimate < closestEstimate)
+        {
+            closest = current;
+            closestEstimate = estimate;
+        }
+
+        NavLayer const* layer = GetLayer(node);
+        for (uint32 dir = 0; dir < MAX_NAV_DIRECTIONS; ++dir)
+        {
+            if (!layer->IsLinked(dir))
+                continue;
+
+            int32 nx = x + NavDirectionX[dir];
+            int32 ny = y + NavDirectionY[dir];
+            NavLayer const* next = GetLayer(nx, ny, layer->GetLinkedLayer(dir));
+            if (!next)
+                continue;
+
+            float nextCost = cost + ((dir & 1) ? NAV_DIAGONAL_COST : NAV_CELL_SIZE) + fabs(next->z - layer->z);
+            uint32 nextNode = MakeNode(nx, ny, layer->GetLinkedLayer(dir));
+
+            UNORDERED_MAP<uint32, uint32>::iterator itr = index.find(nextNode);
+            uint32 nextIndex;
+            if (itr == index.end())
+            {
+                NavSearchNode entry = { nextNode, current, nextCost, false };
+                nextIndex = list.size();
+                list.push_back(entry);
+                index[nextNode] = nextIndex;
+            }
+            else
+            {
+                nextIndex = itr->second;
+                if (list[nextIndex].closed || list[nextIndex].cost <= nextCost)
+                    continue;
+                list[nextIndex].cost = nextCost;
+                list[nextIndex].parent = current;
+            }
+
+            open.push(NavOpenEntry(nextCost + NavEstimate(nx, ny, endX, endY), nextIndex));
+        }
+    }
+
+    nodes.clear();
+    for (uint32 i = closest; ; i = list[i].parent)
+    {
+        nodes.push_back(list[i].node);
+        if (!i)
+            break;
+    }
+    std::reverse(nodes.begin(), nodes.end());
+
+    return reached ? NAV_PATH_COMPLETE : NAV_PATH_INCOMPLETE;
+}
+
+// walks the cells on the line between the centers of both nodes, every step
+// must follow a link and end on the layer of to
+bool NavMap::CanWalkStraight(uint32 from, uint32 to) const
+{
+    // the direction of a step of (sx, sy), indexed by (sx + 1) * 3 + sy + 1
+    static const uint32 stepDirection[9] =
+    {
+        NAV_DIR_NEG_X_NEG_Y, NAV_DIR_NEG_X, NAV_DIR_NEG_X_POS_Y,
+        NAV_DIR_NEG_Y, MAX_NAV_DIRECTIONS, NAV_DIR_POS_Y,
+        NAV_DIR_POS_X_NEG_Y, NAV_DIR_POS_X, NAV_DIR_POS_X_POS_Y
+    };
+
+    int32 x = NodeX(from);
+    int32 y = NodeY(from);
+    uint32 layer = NodeLayer(from);
+
+    int32 dx = NodeX(to) - x;
+    int32 dy = NodeY(to) - y;
+    int32 sx = dx > 0 ? 1 : (dx < 0 ? -1 : 0);
+    int32 sy = dy > 0 ? 1 : (dy < 0 ? -1 : 0);
+    int32 nx = abs(dx);
+    int32 ny = abs(dy);
+
+    for (int32 ix = 0, iy = 0; ix < nx || iy < ny;)
+    {
+        // which cell border the line crosses next, both at once through a corner
+        int32 side = (1 + 2 * ix) * ny - (1 + 2 * iy) * nx;
+        int32 stepX = side <= 0 ? sx : 0;
+        int32 stepY = side >= 0 ? sy : 0;
+
+        NavLayer const* l = GetLayer(x, y, layer);
+        uint32 dir = stepDirection[(stepX + 1) * 3 + stepY + 1];
+        if (!l || !l->IsLinked(dir))
+            return false;
+
+        layer = l->GetLinkedLayer(dir);
+        x += stepX;
+        y += stepY;
+        if (stepX)
+            ++ix;
+        if (stepY)
+            ++iy;
+    }
+
+    return layer == NodeLayer(to);
+}
+
+// keeps only the nodes where the way has to turn
+void NavMap::Smooth(std::vector<uint32> const& nodes, std::vector<uint32> &corners) const
+{
+    corners.clear();
+    corners.push_back(nodes[0]);
+
+    size_t anchor = 0;
+    for (size_t i = 2; i < nodes.size(); ++i)
+    {
+        if (!CanWalkStraight(nodes[anchor], nodes[i]))
+        {
+            anchor = i - 1;
+            corners.push_back(nodes[anchor]);
+        }
+    }
+
+    if (nodes.size() > 1)
+        corners.push_back(nodes.back());
+}
+
+NavPathResult NavMap::FindPath(float sx, float sy, float sz, float ex, float ey, float ez, Path &path, bool useCache)
+{
+    ACE_READ_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, m_lock, NAV_PATH_NO_MESH);
+
+    uint32 start, end;
+    if (!FindNode(sx, sy, sz, start) || !FindNode(ex, ey, ez, end))
+        return NAV_PATH_NO_MESH;
+
+    NavPathResult result = NAV_PATH_NO_MESH;
+    std::vector<uint32> corners;
+
+    // the generation does not change while the read lock is held
+    CachedPath* cached = NULL;
+    if (useCache && !m_cache.empty())
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, cacheGuard, m_cacheLock, NAV_PATH_NO_MESH);
+        cached = &m_cache[(start * 2654435761u ^ end) & (m_cache.size() - 1)];
+        if (cached->start == start && cached->end == end && cached->generation == m_generation)
+        {
+            result = cached->result;
+            corners = cached->corners;
+        }
+    }
+
+    if (result == NAV_PATH_NO_MESH)
+    {
+        std::vector<uint32> nodes;
+        result = Search(start, end, nodes);
+        Smooth(nodes, corners);
+
+        if (cached)
+        {
+            ACE_GUARD_RETURN(ACE_Thread_Mutex, cacheGuard, m_cacheLock, NAV_PATH_NO_MESH);
+            cached->start = start;
+            cached->end = end;
+            cached->generation = m_generation;
+            cached->result = result;
+            cached->corners = corners;
+        }
+    }
+
+    // the exact positions replace the centers of the first and the reached last cell
+    path.Resize(corners.size() < 2 ? 2 : corners.size());
+    for (size_t i = 0; i < corners.size(); ++i)
+    {
+        path[i].x = NavCoordFromCell(NodeX(corners[i]));
+        path[i].y = NavCoordFromCell(NodeY(corners[i]));
+        path[i].z = GetLayer(corners[i])->z;
+    }
+
+    path[0].x = sx;
+    path[0].y = sy;
+    path[0].z = sz;
+    if (result == NAV_PATH_COMPLETE)
+    {
+        path[path.Size() - 1].x = ex;
+        path[path.Size() - 1].y = ey;
+        path[path.Size() - 1].z = ez;
+    }
+    else if (corners.size() < 2)
+        path[1] = path[0];
+
+    return result;
+}
+
+MoveMapManager::MoveMapManager() : m_enabled(false), m_cacheSize(0)
+{
+}
+
+MoveMapManager::~MoveMapManager()
+{
+    for (NavMapMap::iterator itr = m_maps.begin(); itr != m_maps.end(); ++itr)
+        delete itr->second;
+}
+
+void MoveMapManager::Initialize(std::string const& dataPath, bool enabled, uint32 cacheSize)
+{
+    m_basePath = dataPath + "mmaps/";
+    m_enabled = enabled;
+    m_cacheSize = cacheSize;
+}
+
+NavMap* MoveMapManager::GetNavMap(uint32 mapId)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, NULL);
+
+    NavMapMap::iterator itr = m_maps.find(mapId);
+    if (itr != m_maps.end())
+        return itr->second;
+
+    NavMap* navMap = new NavMap(mapId, m_cacheSize);
+    m_maps[mapId] = navMap;
+    return navMap;
+}
+
+void MoveMapManager::LoadTile(uint32 mapId, int gx, int gy)
+{
+    if (!m_enabled)
+        return;
+
+    if (GetNavMap(mapId)->LoadTile(m_basePath, gx, gy))
+        sLog.outDetail("MMAP loaded id:%u, x:%d, y:%d", mapId, gx, gy);
+    else
+        DEBUG_LOG("Could not load MMAP id:%u, x:%d, y:%d", mapId, gx, gy);
+}
+
+void MoveMapManager::UnloadTile(uint32 mapId, int gx, int gy)
+{
+    if (!m_enabled)
+        return;
+
+    GetNavMap(mapId)->UnloadTile(gx, gy);
+}
+
+NavPathResult MoveMapManager::FindPath(uint32 mapId, float sx, float sy, float sz, float ex, float ey, float ez, Path &path, bool useCache)
+{
+    if (!m_enabled)
+        return NAV_PATH_NO_MESH;
+
+    return GetNavMap(mapId)->FindPath(sx, sy, sz, ex, ey, ez, path, useCache);
+}
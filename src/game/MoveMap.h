@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MOVEMAP_H
+#define _MOVEMAP_H
+
+#include <ace/Thread_Mutex.h>
+#include <ace/RW_Thread_Mutex.h>
+#include <ace/Mem_Map.h>
+
+#include "Platform/Define.h"
+#include "Policies/Singleton.h"
+#include "Utilities/UnorderedMap.h"
+#include "MoveMapSharedDefines.h"
+#include "Path.h"
+
+#include <string>
+#include <vector>
+
+enum NavPathResult
+{
+    NAV_PATH_NO_MESH,                                       // start or end not on a loaded tile, move straight
+    NAV_PATH_COMPLETE,
+    NAV_PATH_INCOMPLETE                                     // end not reachable, the path ends at the closest reachable cell
+};
+
+// the most cells a search looks at before it settles for the closest one found
+#define NAV_MAX_SEARCH_NODES    4096
+// how far above or below a layer a position still counts as standing on it
+#define NAV_MAX_SNAP_HEIGHT     4.0f
+
+// A tile file mapped in place, see MoveMapSharedDefines.h for the layout.
+class NavTile
+{
+    public:
+        NavTile() : m_firstLayer(NULL), m_layers(NULL), m_refCount(0) {}
+
+        bool Load(const char* filename, uint32 mapId, uint32 tileX, uint32 tileY);
+
+        NavLayer const* GetLayers(uint32 cell, uint32 &count) const
+        {
+            count = m_firstLayer[cell + 1] - m_firstLayer[cell];
+            return m_layers + m_firstLayer[cell];
+        }
+
+        void AddRef() { ++m_refCount; }
+        int DecRef() { return --m_refCount; }
+
+    private:
+        ACE_Mem_Map m_file;
+        uint32 const* m_firstLayer;
+        NavLayer const* m_layers;
+        int m_refCount;
+};
+
+// The tiles of one map id, shared by all its instances like the vmaps. Searches
+// run in parallel from the map threads, tile loads wait for them to finish.
+class NavMap
+{
+    public:
+        NavMap(uint32 mapId, uint32 cacheSize);
+        ~NavMap();
+
+        bool LoadTile(std::string const& basePath, int gx, int gy);
+        void UnloadTile(int gx, int gy);
+
+        NavPathResult FindPath(float sx, float sy, float sz, float ex, float ey, float ez, Path &path, bool useCache);
+
+    private:
+        // cells are counted over the whole map, a node is a layer of a cell
+        static uint32 MakeNode(int32 cx, int32 cy, uint32 layer) { return (uint32(cx) << 16 | uint32(cy)) << 2 | layer; }
+        static int32 NodeX(uint32 node) { return int32(node >> 18); }
+        static int32 NodeY(uint32 node) { return int32((node >> 2) & 0xFFFF); }
+        static uint32 NodeLayer(uint32 node) { return node & 3; }
+
+        NavLayer const* GetLayer(int32 cx, int32 cy, uint32 layer) const;
+        NavLayer const* GetLayer(uint32 node) const { return GetLayer(NodeX(node), NodeY(node), NodeLayer(node)); }
+        bool FindNode(float x, float y, float z, uint32 &node) const;
+
+        NavPathResult Search(uint32 start, uint32 end, std::vector<uint32> &nodes) const;
+        bool CanWalkStraight(uint32 from, uint32 to) const;
+        void Smooth(std::vector<uint32> const& nodes, std::vector<uint32> &corners) const;
+
+        struct CachedPath
+        {
+            CachedPath() : start(0), end(0), generation(0), result(NAV_PATH_NO_MESH) {}
+
+            uint32 start;
+            uint32 end;
+            uint32 generation;
+            NavPathResult result;
+            std::vector<uint32> corners;
+        };
+
+        uint32 m_mapId;
+
+        ACE_RW_Thread_Mutex m_lock;                         // read by searches, written by tile loads
+        NavTile* m_tiles[64][64];
+        uint32 m_generation;                                // changes with the loaded tiles
+
+        ACE_Thread_Mutex m_cacheLock;
+        std::vector<CachedPath> m_cache;
+};
+
+class MoveMapManager
+{
+    public:
+        MoveMapManager();
+        ~MoveMapManager();
+
+        void Initialize(std::string const& dataPath, bool enabled, uint32 cacheSize);
+        bool IsEnabled() const { return m_enabled; }
+
+        // called with the vmaps, by the base map of the map id only
+        void LoadTile(uint32 mapId, int gx, int gy);
+        void UnloadTile(uint32 mapId, int gx, int gy);
+
+        // the path starts with the start position, useCache is for benchmarks
+        NavPathResult FindPath(uint32 mapId, float sx, float sy, float sz, float ex, float ey, float ez, Path &path, bool useCache = true);
+
+    private:
+        NavMap* GetNavMap(uint32 mapId);
+
+        typedef UNORDERED_MAP<uint32, NavMap*> NavMapMap;
+
+        bool m_enabled;
+        std::string m_basePath;
+        uint32 m_cacheSize;
+
+        ACE_Thread_Mutex m_lock;
+        NavMapMap m_maps;                                   // never removed before shutdown
+};
+
+#define sMoveMapMgr Oregon::Singleton<MoveMapManager>::Instance()
+#endif
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MOVEMAPSHAREDDEFINES_H
+#define _MOVEMAPSHAREDDEFINES_H
+
+#include "Platform/Define.h"
+
+//******************************************
+// Navigation tile format, written by movemap_generator
+//******************************************
+// One tile per map grid, named like the .map files. A tile is a square of
+// NAV_TILE_CELLS * NAV_TILE_CELLS cells, each holding the heights a creature
+// can stand at (layers, highest first) and for each layer the neighbour cells
+// it can walk to without passing a wall, a drop or a too steep slope.
+
+#define NAV_TILE_MAGIC          0x50414D4D // MMAP
+#define NAV_TILE_VERSION        1
+
+#define NAV_GRID_SIZE           533.33333f                  // SIZE_OF_GRIDS
+#define NAV_TILE_CELLS          256
+#define NAV_CELL_SIZE           (NAV_GRID_SIZE / NAV_TILE_CELLS)
+#define NAV_MAX_LAYERS          4
+
+// the walking creature the links are built for
+#define NAV_AGENT_HEIGHT        2.0f                        // free space needed above a layer
+#define NAV_AGENT_CLIMB         0.6f                        // height of a step on flat ground
+#define NAV_AGENT_SLOPE         1.2f                        // tangent of the steepest slope, about 50 degrees
+#define NAV_AGENT_EYE_HEIGHT    1.5f                        // height of the line of sight check between cells
+
+struct NavTileHeader
+{
+    uint32 magic;
+    uint32 version;
+    uint32 mapId;
+    uint32 tileX;
+    uint32 tileY;
+    uint32 layerCount;
+};
+// followed by uint32 firstLayer[NAV_TILE_CELLS * NAV_TILE_CELLS + 1], the layers of
+// cell x + y * NAV_TILE_CELLS being firstLayer[cell] to firstLayer[cell + 1] - 1,
+// and by NavLayer layers[layerCount]
+
+// the 8 neighbours, diagonal directions are odd
+enum NavDirection
+{
+    NAV_DIR_POS_X,
+    NAV_DIR_POS_X_POS_Y,
+    NAV_DIR_POS_Y,
+    NAV_DIR_NEG_X_POS_Y,
+    NAV_DIR_NEG_X,
+    NAV_DIR_NEG_X_NEG_Y,
+    NAV_DIR_NEG_Y,
+    NAV_DIR_POS_X_NEG_Y,
+    MAX_NAV_DIRECTIONS
+};
+
+static const int32 NavDirectionX[MAX_NAV_DIRECTIONS] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+static const int32 NavDirectionY[MAX_NAV_DIRECTIONS] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+
+struct NavLayer
+{
+    float z;
+    uint32 links;                                           // bits 0-15 layer of the neighbour, 2 per direction, bits 16-23 linked directions
+
+    bool IsLinked(uint32 dir) const { return (links & (1 << (16 + dir))) != 0; }
+    uint32 GetLinkedLayer(uint32 dir) const { return (links >> (dir * 2)) & 3; }
+    void Link(uint32 dir, uint32 layer) { links |= (1 << (16 + dir)) | (layer << (dir * 2)); }
+};
+
+// Cells are counted over the whole map like the grids, so cell c belongs to
+// grid c / NAV_TILE_CELLS and its neighbours are simply c - 1 and c + 1.
+#define NAV_MAP_CELLS           (64 * NAV_TILE_CELLS)
+
+inline int32 NavCellFromCoord(float c)
+{
+    return int32((32.0f - c / NAV_GRID_SIZE) * NAV_TILE_CELLS);
+}
+
+inline float NavCoordFromCell(int32 cell)
+{
+    return (32.0f - (cell + 0.5f) / NAV_TILE_CELLS) * NAV_GRID_SIZE;
+}
+#endif
@@ -22,6 +22,7 @@
 #include "WorldSession.h"
 #include "Opcodes.h"
 #include "Log.h"
+#include "World.h"
 #include "Corpse.h"
 #include "Player.h"
 #include "MapManager.h"
@@ -325,10 +326,11 @@ void WorldSession::HandleMovementOpcodes(WorldPacket & recv_data)
     WorldPacket data(opcode, mover->GetPackGUID().size() + recv_data.size());
     data << mover->GetPackGUID();
     data.append(recv_data.contents(), recv_data.size());
-    if (mover->isCharmed() && mover->GetCharmer())
-        mover->GetCharmer()->SendMessageToSet(&data, false);
+    WorldObject* source = mover->isCharmed() && mover->GetCharmer() ? mover->GetCharmer() : mover;
+    if (sWorld.getConfig(CONFIG_MOVEMENT_RELAY) && source->GetTypeId() == TYPEID_PLAYER)
+        source->GetMap()->GetMovementRelay().Add(source->ToPlayer(), mover->GetGUID(), data);
     else
-        mover->SendMessageToSet(&data, false);
+        source->SendMessageToSet(&data, false);
 
     mover->m_movementInfo = movementInfo;
     mover->SetPosition(movementInfo.GetPos()->GetPositionX(), movementInfo.GetPos()->GetPositionY(), movementInfo.GetPos()->GetPositionZ(), movementInfo.GetPos()->GetOrientation());
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MovementRelay.h"
+#include "Map.h"
+#include "Player.h"
+#include "ObjectAccessor.h"
+#include "CellImpl.h"
+#include "GridNotifiers.h"
+#include "GridNotifiersImpl.h"
+#include "World.h"
+#include "Opcodes.h"
+#include "Timer.h"
+
+#include <ace/Guard_T.h>
+
+void MovementRelay::Add(Player* source, uint64 moverGuid, WorldPacket const& data)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    ++m_stats.received;
+
+    // the last state wins, a heartbeat tells nothing the next one does not
+    if (data.GetOpcode() == MSG_MOVE_HEARTBEAT)
+    {
+        UNORDERED_MAP<uint64, size_t>::const_iterator itr = m_lastPending.find(moverGuid);
+        if (itr != m_lastPending.end())
+        {
+            PendingMove& last = m_pending[itr->second];
+            if (last.packet.GetOpcode() == MSG_MOVE_HEARTBEAT && last.source == source->GetGUID())
+            {
+                last.packet = data;
+                ++m_stats.merged;
+                return;
+            }
+        }
+    }
+
+    m_lastPending[moverGuid] = m_pending.size();
+    m_pending.push_back(PendingMove());
+
+    PendingMove& move = m_pending.back();
+    move.source = source->GetGUID();
+    move.mover = moverGuid;
+    move.packet = data;
+}
+
+void MovementRelay::Send(Map* map, PendingMove& move, uint32 now)
+{
+    // gone from the map since, the observers got the destroy packet instead
+    Player* source = ObjectAccessor::FindPlayer(move.source);
+    if (!source || source->GetMap() != map)
+        return;
+
+    float const visDist = map->GetVisibilityDistance();
+    float const farDist = float(sWorld.getConfig(CONFIG_MOVEMENT_RELAY_FAR_DISTANCE));
+    uint32 const farInterval = sWorld.getConfig(CONFIG_MOVEMENT_RELAY_FAR_INTERVAL);
+
+    Oregon::MessageDistDeliverer notifier(source, &move.packet, visDist);
+
+    if (farDist && farDist < visDist)
+    {
+        UNORDERED_MAP<uint64, uint32>::iterator sent = m_farSendTime.find(move.mover);
+        if (move.packet.GetOpcode() == MSG_MOVE_HEARTBEAT && sent != m_farSendTime.end() &&
+            getMSTimeDiff(sent->second, now) < farInterval)
+            notifier.i_farDistSq = farDist * farDist;
+        else
+            m_farSendTime[move.mover] = now;
+    }
+
+    source->VisitNearbyWorldObjectInRange(visDist, TYPEMASK_SEER, notifier);
+
+    m_stats.delivered += notifier.i_delivered;
+    m_stats.farSkipped += notifier.i_farSkipped;
+}
+
+void MovementRelay::FlushMover(Map* map, uint64 moverGuid)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    UNORDERED_MAP<uint64, size_t>::iterator last = m_lastPending.find(moverGuid);
+    if (last == m_lastPending.end())
+        return;
+
+    uint32 const now = getMSTime();
+    for (size_t i = 0; i <= last->second; ++i)
+    {
+        if (m_pending[i].mover != moverGuid)
+            continue;
+
+        Send(map, m_pending[i], now);
+        m_pending[i].mover = 0;
+    }
+
+    m_lastPending.erase(last);
+}
+
+void MovementRelay::Flush(Map* map)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    if (m_pending.empty())
+        return;
+
+    uint32 const farInterval = sWorld.getConfig(CONFIG_MOVEMENT_RELAY_FAR_INTERVAL);
+    uint32 const now = getMSTime();
+
+    for (std::vector<PendingMove>::iterator itr = m_pending.begin(); itr != m_pending.end(); ++itr)
+        if (itr->mover)
+            Send(map, *itr, now);
+
+    m_pending.clear();
+    m_lastPending.clear();
+    ++m_stats.flushes;
+
+    // movers quiet for longer than the interval are sent in full again anyway
+    if (++m_flushCount % 64 == 0)
+    {
+        for (UNORDERED_MAP<uint64, uint32>::iterator itr = m_farSendTime.begin(); itr != m_farSendTime.end();)
+        {
+            if (getMSTimeDiff(itr->second, now) >= farInterval)
+                m_farSendTime.erase(itr++);
+            else
+                ++itr;
+        }
+    }
+}
+
+MovementRelayStats MovementRelay::GetStats(bool reset)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, MovementRelayStats());
+
+    MovementRelayStats stats = m_stats;
+    if (reset)
+        m_stats = MovementRelayStats();
+    return stats;
+}
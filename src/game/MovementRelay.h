@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __MOVEMENTRELAY_H
+#define __MOVEMENTRELAY_H
+
+#include "Platform/Define.h"
+#include "Utilities/UnorderedMap.h"
+#include "WorldPacket.h"
+
+#include <ace/Thread_Mutex.h>
+
+#include <vector>
+
+class Map;
+class Player;
+
+// movement relay counts since the last reset, shown by .debug movementrelay
+struct MovementRelayStats
+{
+    MovementRelayStats() : flushes(0), received(0), merged(0), delivered(0), farSkipped(0) {}
+
+    uint64 flushes;
+    uint64 received;                                        // movement packets of the players
+    uint64 merged;                                          // heartbeats replaced by a later one of the same mover
+    uint64 delivered;                                       // packets queued to the observers
+    uint64 farSkipped;                                      // heartbeats held back from far observers
+};
+
+// The movement packets the players send are collected during the map update
+// and sent to the observers together once per tick. A heartbeat replaces the
+// heartbeat of the same mover still waiting, every other opcode (start, stop,
+// jump, fall ...) is kept in order. Observers beyond the far distance get the
+// heartbeats of a mover only once per far interval. Any other broadcast of
+// a mover sends its collected packets first, so the observers never see e.g.
+// a spell start before the stop that came ahead of it.
+class MovementRelay
+{
+    public:
+        MovementRelay() : m_flushCount(0) {}
+
+        // data starts with the packed guid of the mover, source is the player
+        // whose client sent it (the charmer of a possessed mover)
+        void Add(Player* source, uint64 moverGuid, WorldPacket const& data);
+        // sends everything collected, called once per map update
+        void Flush(Map* map);
+        // sends what is collected of one mover, called before its other broadcasts
+        void FlushMover(Map* map, uint64 moverGuid);
+
+        MovementRelayStats GetStats(bool reset);
+
+    private:
+        struct PendingMove
+        {
+            uint64 source;
+            uint64 mover;                                   // 0 once sent by FlushMover
+            WorldPacket packet;
+        };
+
+        void Send(Map* map, PendingMove& move, uint32 now);
+
+        std::vector<PendingMove> m_pending;
+        UNORDERED_MAP<uint64, size_t> m_lastPending;        // mover -> its last packet in m_pending
+        UNORDERED_MAP<uint64, uint32> m_farSendTime;        // mover -> last heartbeat the far observers got
+        uint32 m_flushCount;
+        MovementRelayStats m_stats;
+
+        // packets may be handled by the world thread while the map is idle
+        ACE_Thread_Mutex m_lock;
+};
+#endif
@@ -881,6 +881,10 @@ void Object::SetFloatValue(uint16 index, float value)
     {
         m_floatValues[ index ] = value;
 
+        // the cell index keeps the combat reach as the object size
+        if (index == UNIT_FIELD_COMBATREACH && isType(TYPEMASK_UNIT))
+            ((Unit*)this)->UpdateGridIndex();
+
         if (m_inWorld)
         {
             if (!m_objectUpdated)
@@ -1112,6 +1116,7 @@ WorldObject::WorldObject()
     , m_isActive(false)
     , m_zoneScript(NULL)
     , m_currMap(NULL)
+    , m_gridIndex(NULL), m_gridIndexSlot(0)
     , m_InstanceId(0)
     , m_notifyflags(0), m_executed_notifies(0)
 {
@@ -1562,14 +1567,25 @@ void WorldObject::BuildMonsterChat(WorldPacket *data, uint8 msgtype, char const*
 
 void WorldObject::SendMessageToSet(WorldPacket *data, bool /*fake*/)
 {
+    FlushRelayedMoves();
+
     Oregon::MessageDistDeliverer notifier(this, data, GetMap()->GetVisibilityDistance());
-    VisitNearbyWorldObject(GetMap()->GetVisibilityDistance(), notifier);
+    VisitNearbyWorldObjectInRange(GetMap()->GetVisibilityDistance(), TYPEMASK_SEER, notifier);
 }
 
 void WorldObject::SendMessageToSetInRange(WorldPacket *data, float dist, bool /*bToSelf*/)
 {
+    FlushRelayedMoves();
+
     Oregon::MessageDistDeliverer notifier(this, data, dist);
-    VisitNearbyWorldObject(dist, notifier);
+    VisitNearbyWorldObjectInRange(dist, TYPEMASK_SEER, notifier);
+}
+
+void WorldObject::FlushRelayedMoves()
+{
+    // only the players and what they charm have their moves relayed
+    if (GetTypeId() == TYPEID_PLAYER || (GetTypeId() == TYPEID_UNIT && ToCreature()->isCharmed()))
+        GetMap()->GetMovementRelay().FlushMover(GetMap(), GetGUID());
 }
 
 void WorldObject::SendObjectDeSpawnAnim(uint64 guid)
@@ -1923,7 +1939,7 @@ Creature* WorldObject::FindNearestCreature(uint32 entry, float range, bool alive
     Creature *creature = NULL;
     Oregon::NearestCreatureEntryWithLiveStateInObjectRangeCheck checker(*this, entry, alive, range);
     Oregon::CreatureLastSearcher<Oregon::NearestCreatureEntryWithLiveStateInObjectRangeCheck> searcher(creature, checker);
-    VisitNearbyObject(range, searcher);
+    VisitNearbyObjectInRange(range, TYPEMASK_UNIT, searcher);
     return creature;
 }
 
@@ -25,6 +25,7 @@
 #include "UpdateFields.h"
 #include "UpdateData.h"
 #include "GameSystem/GridReference.h"
+#include "GameSystem/GridObjectIndex.h"
 #include "ObjectGuid.h"
 #include "GridDefines.h"
 #include "Map.h"
@@ -170,6 +171,7 @@ class Object
 
         uint8 GetTypeId() const { return m_objectTypeId; }
         bool isType(uint16 mask) const { return (mask & m_objectType); }
+        uint16 GetTypeMask() const { return m_objectType; }
 
         virtual void BuildCreateUpdateBlockForPlayer(UpdateData *data, Player *target) const;
         void SendUpdateToPlayer(Player* player);
@@ -542,13 +544,47 @@ class WorldLocation : public Position
         uint32 m_mapId;
 };
 
+// Grid reference that also keeps the object in the index of its cell
+template<class T>
+class GridObjectReference : public GridReference<T>
+{
+    protected:
+        void targetObjectBuildLink()
+        {
+            GridReference<T>::targetObjectBuildLink();
+            T* obj = this->getSource();
+            GridObjectIndex& index = this->getTarget()->GetIndex();
+            obj->SetGridIndex(&index, index.Insert(obj, obj->GetGUID(), obj->GetTypeMask(), obj->GetPositionX(), obj->GetPositionY(), obj->GetPositionZ(), obj->GetObjectSize()));
+        }
+        void targetObjectDestroyLink()
+        {
+            if (this->isValid())
+            {
+                GridObjectIndex& index = this->getTarget()->GetIndex();
+                uint32 slot = this->getSource()->GetGridIndexSlot();
+                if (void* moved = index.Remove(slot))
+                    static_cast<T*>(moved)->SetGridIndex(&index, slot);
+                this->getSource()->SetGridIndex(NULL, 0);
+            }
+            GridReference<T>::targetObjectDestroyLink();
+        }
+        void sourceObjectDestroyLink()
+        {
+            // the index goes away with the cell
+            this->getSource()->SetGridIndex(NULL, 0);
+            GridReference<T>::sourceObjectDestroyLink();
+        }
+    public:
+        ~GridObjectReference() { this->unlink(); }
+};
+
 template<class T>
 class GridObject
 {
     public:
         GridReference<T> &GetGridRef() { return m_gridRef; }
     protected:
-        GridReference<T> m_gridRef;
+        GridObjectReference<T> m_gridRef;
 };
 
 class WorldObject : public Object, public WorldLocation
@@ -680,6 +716,8 @@ class WorldObject : public Object, public WorldLocation
 
         virtual void SendMessageToSet(WorldPacket *data, bool self);
         virtual void SendMessageToSetInRange(WorldPacket *data, float dist, bool self);
+        // sends the moves the movement relay holds back ahead of another broadcast
+        void FlushRelayedMoves();
 
         void MonsterSay(const char* text, uint32 language, uint64 TargetGuid);
         void MonsterYell(const char* text, uint32 language, uint64 TargetGuid);
@@ -753,12 +791,31 @@ class WorldObject : public Object, public WorldLocation
         void SetNotified(uint16 f) { m_executed_notifies |= f;}
         void ResetAllNotifies() { m_notifyflags = 0; m_executed_notifies = 0; }
 
+        // keep the index of the cell in sync, the grids are left to the Map
+        void Relocate(float x, float y) { Position::Relocate(x, y); UpdateGridIndex(); }
+        void Relocate(float x, float y, float z) { Position::Relocate(x, y, z); UpdateGridIndex(); }
+        void Relocate(float x, float y, float z, float orientation) { Position::Relocate(x, y, z, orientation); UpdateGridIndex(); }
+        void Relocate(const Position &pos) { Position::Relocate(pos); UpdateGridIndex(); }
+        void Relocate(const Position *pos) { Position::Relocate(pos); UpdateGridIndex(); }
+
+        void SetGridIndex(GridObjectIndex* index, uint32 slot) { m_gridIndex = index; m_gridIndexSlot = slot; }
+        uint32 GetGridIndexSlot() const { return m_gridIndexSlot; }
+        void UpdateGridIndex()
+        {
+            if (m_gridIndex)
+                m_gridIndex->Move(m_gridIndexSlot, m_positionX, m_positionY, m_positionZ, GetObjectSize());
+        }
+
         bool isActiveObject() const { return m_isActive; }
         void setActive(bool isActiveObject);
         void SetWorldObject(bool apply);
         template<class NOTIFIER> void VisitNearbyObject(const float &radius, NOTIFIER &notifier) const { GetMap()->VisitAll(GetPositionX(), GetPositionY(), radius, notifier); }
         template<class NOTIFIER> void VisitNearbyGridObject(const float &radius, NOTIFIER &notifier) const { GetMap()->VisitGrid(GetPositionX(), GetPositionY(), radius, notifier); }
         template<class NOTIFIER> void VisitNearbyWorldObject(const float &radius, NOTIFIER &notifier) const { GetMap()->VisitWorld(GetPositionX(), GetPositionY(), radius, notifier); }
+        // the InRange variants keep the objects within the radius plus both object sizes, like IsWithinDist()
+        template<class NOTIFIER> void VisitNearbyObjectInRange(const float &radius, uint32 typeMask, NOTIFIER &notifier) const { GetMap()->VisitAllInRange(GetPositionX(), GetPositionY(), radius + GetObjectSize(), typeMask, notifier); }
+        template<class NOTIFIER> void VisitNearbyGridObjectInRange(const float &radius, uint32 typeMask, NOTIFIER &notifier) const { GetMap()->VisitGridInRange(GetPositionX(), GetPositionY(), radius + GetObjectSize(), typeMask, notifier); }
+        template<class NOTIFIER> void VisitNearbyWorldObjectInRange(const float &radius, uint32 typeMask, NOTIFIER &notifier) const { GetMap()->VisitWorldInRange(GetPositionX(), GetPositionY(), radius + GetObjectSize(), typeMask, notifier); }
 
         uint32 m_groupLootTimer;                            // (msecs)timer used for group loot
         uint64 lootingGroupLeaderGUID;                      // used to find group which is looting corpse
@@ -781,6 +838,8 @@ class WorldObject : public Object, public WorldLocation
 
     private:
         Map * m_currMap;                                    //current object's Map location
+        GridObjectIndex* m_gridIndex;                       // index of the cell the object is linked to
+        uint32 m_gridIndexSlot;
 
         //uint32 m_mapId;                                     // object at map with map_id
         uint32 m_InstanceId;                                // in map copy with instance id
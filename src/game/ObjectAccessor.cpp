@@ -339,21 +339,84 @@ void ObjectAccessor::RemoveOldCorpses()
 
 void ObjectAccessor::Update(uint32 /*diff*/)
 {
-    UpdateDataMapType update_players;
+    MapUpdater* updater = MapManager::Instance().GetMapUpdater();
+    if (!updater->activated())
+    {
+        UpdateDataMapType update_players;
+
+        // Critical section
+        {
+            Guard guard(i_updateGuard);
+
+            while (!i_objects.empty())
+            {
+                Object* obj = *i_objects.begin();
+                ASSERT(obj && obj->IsInWorld());
+                i_objects.erase(i_objects.begin());
+                obj->BuildUpdate(update_players);
+            }
+        }
+
+        _sendUpdates(update_players);
+        return;
+    }
 
     // Critical section
     {
         Guard guard(i_updateGuard);
 
-        while (!i_objects.empty())
+        // split the objects by the map their receivers are in, keeping the set order
+        // inside every map so each player gets the same update blocks as before
+        for (std::set<Object*>::const_iterator itr = i_objects.begin(); itr != i_objects.end(); ++itr)
         {
-            Object* obj = *i_objects.begin();
+            Object* obj = *itr;
             ASSERT(obj && obj->IsInWorld());
-            i_objects.erase(i_objects.begin());
-            obj->BuildUpdate(update_players);
+
+            Map* map = NULL;
+            if (obj->isType(TYPEMASK_ITEM))
+            {
+                if (Player* owner = ((Item*)obj)->GetOwner())
+                    map = owner->GetMap();
+            }
+            else
+                map = ((WorldObject*)obj)->GetMap();
+
+            i_objectsByMap[map].push_back(obj);
+        }
+        i_objects.clear();
+
+        for (UpdateObjectsByMapType::iterator itr = i_objectsByMap.begin(); itr != i_objectsByMap.end(); ++itr)
+            if (!itr->second.empty() && updater->schedule_object_update(itr->second) == -1)
+                BuildAndSendUpdates(itr->second);
+
+        updater->wait();
+    }
+
+    // keep the vectors of maps still alive to avoid reallocation next tick
+    for (UpdateObjectsByMapType::iterator itr = i_objectsByMap.begin(); itr != i_objectsByMap.end();)
+    {
+        if (itr->second.empty())
+            i_objectsByMap.erase(itr++);
+        else
+        {
+            itr->second.clear();
+            ++itr;
         }
     }
+}
 
+void ObjectAccessor::BuildAndSendUpdates(std::vector<Object*> const& objects)
+{
+    UpdateDataMapType update_players;
+
+    for (std::vector<Object*>::const_iterator itr = objects.begin(); itr != objects.end(); ++itr)
+        (*itr)->BuildUpdate(update_players);
+
+    _sendUpdates(update_players);
+}
+
+void ObjectAccessor::_sendUpdates(UpdateDataMapType& update_players)
+{
     WorldPacket packet;                                     // here we allocate a std::vector with a size of 0x10000
     for (UpdateDataMapType::iterator iter = update_players.begin(); iter != update_players.end(); ++iter)
     {
@@ -34,6 +34,7 @@
 #include "Player.h"
 
 #include <set>
+#include <vector>
 
 class Creature;
 class Corpse;
@@ -217,6 +218,10 @@ class ObjectAccessor : public Oregon::Singleton<ObjectAccessor, Oregon::ClassLev
 
         void Update(uint32 diff);
 
+        // builds the values updates of the objects and sends them to the receiving players,
+        // called from the map update threads with all objects of one map
+        static void BuildAndSendUpdates(std::vector<Object*> const& objects);
+
         Corpse* GetCorpseForPlayerGUID(uint64 guid);
         void RemoveCorpse(Corpse* corpse);
         void AddCorpse(Corpse* corpse);
@@ -233,9 +238,13 @@ class ObjectAccessor : public Oregon::Singleton<ObjectAccessor, Oregon::ClassLev
 
         static void _buildChangeObjectForPlayer(WorldObject*, UpdateDataMapType&);
         static void _buildPacket(Player*, Object*, UpdateDataMapType&);
+        static void _sendUpdates(UpdateDataMapType&);
         void _update();
 
+        typedef UNORDERED_MAP<Map*, std::vector<Object*> > UpdateObjectsByMapType;
+
         std::set<Object*> i_objects;
+        UpdateObjectsByMapType i_objectsByMap;
 
         LockType i_updateGuard;
         LockType i_corpseGuard;
@@ -46,6 +46,7 @@
 #include "WaypointManager.h"
 #include "GossipDef.h"
 #include "InstanceData.h"
+#include "WorldDataCache.h"
 
 INSTANTIATE_SINGLETON_1(ObjectMgr);
 
@@ -963,9 +964,55 @@ bool ObjectMgr::SetCreatureLinkedRespawn(uint32 guid, uint32 linkedGuid)
     return false;
 }
 
+// tables the spawn data is built from, the cache is used while none of them changed
+#define CREATURE_CACHE_TABLES   "creature, creature_template, creature_equip_template, game_event_creature, pool_creature"
+#define GAMEOBJECT_CACHE_TABLES "gameobject, gameobject_template, game_event_gameobject, pool_gameobject"
+
+// oldMSTime is taken before the checksums, the times of both paths include them
+bool ObjectMgr::LoadCreaturesFromCache(std::vector<uint64> const& checksums, uint32 oldMSTime)
+{
+    WorldCacheReader cache;
+    if (!cache.Open(WorldDataCache::GetFilename("creature"), sizeof(CreatureData), checksums))
+        return false;
+
+    for (uint32 i = 0; i < cache.GetCount(); ++i)
+    {
+        uint32 guid, flags;
+        CreatureData data;
+        cache.GetRecord(i, guid, flags, &data);
+
+        CreatureData& stored = mCreatureDataMap[guid];
+        stored = data;
+        if (flags & WORLD_CACHE_IN_GRID)
+            AddCreatureToGrid(guid, &stored);
+    }
+
+    sLog.outString();
+    sLog.outString(">> Loaded %u creatures from the world cache in %u ms", cache.GetCount(), getMSTimeDiff(oldMSTime, getMSTime()));
+    return true;
+}
+
+void ObjectMgr::SaveCreaturesToCache(std::vector<uint64> const& checksums, std::set<uint32> const& gridGuids)
+{
+    WorldCacheWriter cache(sizeof(CreatureData), checksums);
+    for (CreatureDataMap::const_iterator itr = mCreatureDataMap.begin(); itr != mCreatureDataMap.end(); ++itr)
+        cache.Add(itr->first, gridGuids.find(itr->first) != gridGuids.end() ? WORLD_CACHE_IN_GRID : 0, &itr->second);
+
+    cache.Save(WorldDataCache::GetFilename("creature"));
+}
+
 void ObjectMgr::LoadCreatures()
 {
     uint32 count = 0;
+    uint32 oldMSTime = getMSTime();
+
+    std::vector<uint64> checksums;
+    bool useCache = sWorld.getConfig(CONFIG_WORLD_CACHE) && WorldDataCache::GetChecksums(CREATURE_CACHE_TABLES, checksums);
+    if (useCache)
+        sLog.outString(">> Checksummed the creature tables in %u ms", getMSTimeDiff(oldMSTime, getMSTime()));
+    if (useCache && LoadCreaturesFromCache(checksums, oldMSTime))
+        return;
+
     //                                                       0              1   2    3
     QueryResult_AutoPtr result = WorldDatabase.Query("SELECT creature.guid, id, map, modelid,"
     //   4             5           6           7           8            9              10         11
@@ -993,6 +1040,8 @@ void ObjectMgr::LoadCreatures()
             if (cInfo->HeroicEntry)
                 heroicCreatures.insert(cInfo->HeroicEntry);
 
+    std::set<uint32> gridGuids;
+
     barGoLink bar(result->GetRowCount());
 
     do
@@ -1081,14 +1130,20 @@ void ObjectMgr::LoadCreatures()
         }
 
         if (gameEvent == 0 && PoolId == 0)                      // if not this is to be managed by GameEvent System or Pool system
+        {
             AddCreatureToGrid(guid, &data);
+            gridGuids.insert(guid);
+        }
 
         ++count;
 
     } while (result->NextRow());
 
+    if (useCache)
+        SaveCreaturesToCache(checksums, gridGuids);
+
     sLog.outString();
-    sLog.outString(">> Loaded %u creatures", mCreatureDataMap.size());
+    sLog.outString(">> Loaded %u creatures in %u ms", mCreatureDataMap.size(), getMSTimeDiff(oldMSTime, getMSTime()));
 }
 
 void ObjectMgr::AddCreatureToGrid(uint32 guid, CreatureData const* data)
@@ -1219,9 +1274,51 @@ uint32 ObjectMgr::AddCreData(uint32 entry, uint32 /*team*/, uint32 mapId, float
     return guid;
 }
 
+// oldMSTime is taken before the checksums, the times of both paths include them
+bool ObjectMgr::LoadGameobjectsFromCache(std::vector<uint64> const& checksums, uint32 oldMSTime)
+{
+    WorldCacheReader cache;
+    if (!cache.Open(WorldDataCache::GetFilename("gameobject"), sizeof(GameObjectData), checksums))
+        return false;
+
+    for (uint32 i = 0; i < cache.GetCount(); ++i)
+    {
+        uint32 guid, flags;
+        GameObjectData data;
+        cache.GetRecord(i, guid, flags, &data);
+
+        GameObjectData& stored = mGameObjectDataMap[guid];
+        stored = data;
+        if (flags & WORLD_CACHE_IN_GRID)
+            AddGameobjectToGrid(guid, &stored);
+    }
+
+    sLog.outString();
+    sLog.outString(">> Loaded %u gameobjects from the world cache in %u ms", cache.GetCount(), getMSTimeDiff(oldMSTime, getMSTime()));
+    return true;
+}
+
+void ObjectMgr::SaveGameobjectsToCache(std::vector<uint64> const& checksums, std::set<uint32> const& gridGuids)
+{
+    WorldCacheWriter cache(sizeof(GameObjectData), checksums);
+    for (GameObjectDataMap::const_iterator itr = mGameObjectDataMap.begin(); itr != mGameObjectDataMap.end(); ++itr)
+        cache.Add(itr->first, gridGuids.find(itr->first) != gridGuids.end() ? WORLD_CACHE_IN_GRID : 0, &itr->second);
+
+    cache.Save(WorldDataCache::GetFilename("gameobject"));
+}
+
 void ObjectMgr::LoadGameobjects()
 {
     uint32 count = 0;
+    uint32 oldMSTime = getMSTime();
+
+    std::vector<uint64> checksums;
+    bool useCache = sWorld.getConfig(CONFIG_WORLD_CACHE) && WorldDataCache::GetChecksums(GAMEOBJECT_CACHE_TABLES, checksums);
+    if (useCache)
+        sLog.outString(">> Checksummed the gameobject tables in %u ms", getMSTimeDiff(oldMSTime, getMSTime()));
+    if (useCache && LoadGameobjectsFromCache(checksums, oldMSTime))
+        return;
+
 
     //                                                       0                1   2    3           4           5           6
     QueryResult_AutoPtr result = WorldDatabase.Query("SELECT gameobject.guid, id, map, position_x, position_y, position_z, orientation,"
@@ -1241,6 +1338,8 @@ void ObjectMgr::LoadGameobjects()
         return;
     }
 
+    std::set<uint32> gridGuids;
+
     barGoLink bar(result->GetRowCount());
 
     do
@@ -1306,13 +1405,19 @@ void ObjectMgr::LoadGameobjects()
         }
 
         if (gameEvent == 0 && PoolId == 0)                      // if not this is to be managed by GameEvent System or Pool system
+        {
             AddGameobjectToGrid(guid, &data);
+            gridGuids.insert(guid);
+        }
         ++count;
 
     } while (result->NextRow());
 
+    if (useCache)
+        SaveGameobjectsToCache(checksums, gridGuids);
+
     sLog.outString();
-    sLog.outString(">> Loaded %u gameobjects", mGameObjectDataMap.size());
+    sLog.outString(">> Loaded %u gameobjects in %u ms", mGameObjectDataMap.size(), getMSTimeDiff(oldMSTime, getMSTime()));
 }
 
 void ObjectMgr::AddGameobjectToGrid(uint32 guid, GameObjectData const* data)
@@ -6073,9 +6178,19 @@ void ObjectMgr::LoadWeatherZoneChances()
     sLog.outString(">> Loaded %u weather definitions", count);
 }
 
+time_t ObjectMgr::GetCreatureRespawnTime(uint32 loguid, uint32 instance)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_respawnTimesLock, 0);
+    RespawnTimes::const_iterator itr = mCreatureRespawnTimes.find(MAKE_PAIR64(loguid,instance));
+    return itr != mCreatureRespawnTimes.end() ? itr->second : 0;
+}
+
 void ObjectMgr::SaveCreatureRespawnTime(uint32 loguid, uint32 instance, time_t t)
 {
-    mCreatureRespawnTimes[MAKE_PAIR64(loguid,instance)] = t;
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_respawnTimesLock);
+        mCreatureRespawnTimes[MAKE_PAIR64(loguid,instance)] = t;
+    }
     WorldDatabase.PExecute("DELETE FROM creature_respawn WHERE guid = '%u' AND instance = '%u'", loguid, instance);
     if (t)
         WorldDatabase.PExecute("INSERT INTO creature_respawn VALUES ('%u', '" UI64FMTD "', '%u')", loguid, uint64(t), instance);
@@ -6091,9 +6206,19 @@ void ObjectMgr::DeleteCreatureData(uint32 guid)
     mCreatureDataMap.erase(guid);
 }
 
+time_t ObjectMgr::GetGORespawnTime(uint32 loguid, uint32 instance)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_respawnTimesLock, 0);
+    RespawnTimes::const_iterator itr = mGORespawnTimes.find(MAKE_PAIR64(loguid,instance));
+    return itr != mGORespawnTimes.end() ? itr->second : 0;
+}
+
 void ObjectMgr::SaveGORespawnTime(uint32 loguid, uint32 instance, time_t t)
 {
-    mGORespawnTimes[MAKE_PAIR64(loguid,instance)] = t;
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_respawnTimesLock);
+        mGORespawnTimes[MAKE_PAIR64(loguid,instance)] = t;
+    }
     WorldDatabase.PExecute("DELETE FROM gameobject_respawn WHERE guid = '%u' AND instance = '%u'", loguid, instance);
     if (t)
         WorldDatabase.PExecute("INSERT INTO gameobject_respawn VALUES ('%u', '" UI64FMTD "', '%u')", loguid, uint64(t), instance);
@@ -6101,6 +6226,8 @@ void ObjectMgr::SaveGORespawnTime(uint32 loguid, uint32 instance, time_t t)
 
 void ObjectMgr::DeleteRespawnTimeForInstance(uint32 instance)
 {
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_respawnTimesLock);
+
     RespawnTimes::iterator next;
 
     for (RespawnTimes::iterator itr = mGORespawnTimes.begin(); itr != mGORespawnTimes.end(); itr = next)
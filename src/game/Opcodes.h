@@ -1105,12 +1105,20 @@ enum SessionStatus
     STATUS_NEVER                                            // Opcode not accepted from client (deprecated or server side only)
 };
 
+// Where the opcode may be handled
+enum PacketProcessing
+{
+    PROCESS_THREADUNSAFE = 0,                               // World thread only, handler touches global state
+    PROCESS_THREADSAFE                                      // Map update thread of the player allowed, handler touches only the player's map
+};
+
 class WorldPacket;
 
 struct OpcodeHandler
 {
     char const* name;
     SessionStatus status;
+    PacketProcessing packetProcessing;
     void (WorldSession::*handler)(WorldPacket& recvPacket);
 };
 
@@ -31,6 +31,7 @@ class PassiveAI : public CreatureAI
         void MoveInLineOfSight(Unit *) {}
         void AttackStart(Unit *) {}
         void UpdateAI(const uint32);
+        uint32 GetIdleTime() const { return AI_IDLE_FOREVER; }
 
         static int Permissible(const Creature *) { return PERMIT_BASE_IDLE;  }
 };
@@ -61,6 +62,7 @@ class NullCreatureAI : public CreatureAI
         void UpdateAI(const uint32) {}
         void EnterEvadeMode() {}
         void OnCharmed(bool /*apply*/) {}
+        uint32 GetIdleTime() const { return AI_IDLE_FOREVER; }
 
         static int Permissible(const Creature *) { return PERMIT_BASE_IDLE;  }
 };
@@ -274,6 +274,7 @@ bool Pet::LoadPetFromDB(Player* owner, uint32 petentry, uint32 petnumber, bool c
     // set current pet as current
     if (fields[10].GetUInt32() != 0)
     {
+        SqlAsyncKeyGuard asyncKey(CharacterDatabase, ownerid);
         CharacterDatabase.BeginTransaction();
         CharacterDatabase.PExecute("UPDATE character_pet SET slot = '3' WHERE owner = '%u' AND slot = '0' AND id <> '%u'",ownerid, m_charmInfo->GetPetNumber());
         CharacterDatabase.PExecute("UPDATE character_pet SET slot = '0' WHERE owner = '%u' AND id = '%u'",ownerid, m_charmInfo->GetPetNumber());
@@ -362,6 +363,9 @@ void Pet::SavePetToDB(PetSaveMode mode)
     if (!isControlled())
         return;
 
+    // in order with the saves of the owner
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, GUID_LOPART(GetOwnerGUID()));
+
     uint32 curhealth = GetHealth();
     uint32 curmana = GetPower(POWER_MANA);
 
@@ -497,6 +497,7 @@ void WorldSession::HandlePetRename(WorldPacket & recv_data)
         }
     }
 
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, _player->GetGUIDLow());
     CharacterDatabase.BeginTransaction();
     if (isdeclined)
     {
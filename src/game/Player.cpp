@@ -255,6 +255,8 @@ UpdateMask Player::updateVisualBits;
 Player::Player (WorldSession *session): Unit()
 {
     m_transport = 0;
+    m_visibilityRelocationPos.Relocate(0.0f, 0.0f, 0.0f, 0.0f);
+    m_clientVisibilityPending = false;
 
     m_speakTime = 0;
     m_speakCount = 0;
@@ -386,6 +388,10 @@ Player::Player (WorldSession *session): Unit()
 
     m_mailsLoaded = false;
     m_mailsUpdated = false;
+
+    m_aurasSaved = false;
+    m_spellCooldownsSaved = false;
+    m_bgDataSaved = false;
     unReadMails = 0;
     m_nextMailDelivereTime = 0;
 
@@ -1246,9 +1252,14 @@ void Player::Update(uint32 p_time)
     {
         if (p_time >= m_nextSave)
         {
-            // m_nextSave reseted in SaveToDB call
-            SaveToDB();
-            sLog.outDetail("Player '%s' (GUID: %u) saved", GetName(), GetGUIDLow());
+            if (sWorld.AcquireAutosave())
+            {
+                // m_nextSave reseted in SaveToDB call
+                SaveToDB();
+                sLog.outDetail("Player '%s' (GUID: %u) saved", GetName(), GetGUIDLow());
+            }
+            else
+                m_nextSave = urand(IN_MILLISECONDS / 10, IN_MILLISECONDS);  // too many saves in this tick, retry soon
         }
         else
             m_nextSave -= p_time;
@@ -3265,6 +3276,8 @@ void Player::_LoadSpellCooldowns(QueryResult_AutoPtr result)
 
     if (result)
     {
+        m_spellCooldownsSaved = true;
+
         time_t curTime = time(NULL);
 
         do
@@ -3295,10 +3308,16 @@ void Player::_LoadSpellCooldowns(QueryResult_AutoPtr result)
 
 void Player::_SaveSpellCooldowns()
 {
+    // nothing to write and nothing to clear
+    if (m_spellCooldowns.empty() && !m_spellCooldownsSaved)
+        return;
+
     CharacterDatabase.PExecute("DELETE FROM character_spell_cooldown WHERE guid = '%u'", GetGUIDLow());
 
     time_t curTime = time(NULL);
 
+    SqlBatchInsert batch("INSERT INTO character_spell_cooldown (guid,spell,item,time) VALUES ");
+
     // remove outdated and save active
     for (SpellCooldowns::iterator itr = m_spellCooldowns.begin();itr != m_spellCooldowns.end();)
     {
@@ -3306,10 +3325,13 @@ void Player::_SaveSpellCooldowns()
             m_spellCooldowns.erase(itr++);
         else
         {
-            CharacterDatabase.PExecute("INSERT INTO character_spell_cooldown (guid,spell,item,time) VALUES ('%u', '%u', '%u', '" UI64FMTD "')", GetGUIDLow(), itr->first, itr->second.itemid, uint64(itr->second.end));
+            batch.NextRow() << GetGUIDLow() << ", " << itr->first << ", " << itr->second.itemid << ", " << uint64(itr->second.end);
             ++itr;
         }
     }
+
+    m_spellCooldownsSaved = batch.GetRowCount() != 0;
+    batch.Execute(CharacterDatabase);
 }
 
 uint32 Player::resetTalentsCost() const
@@ -3351,6 +3373,7 @@ bool Player::resetTalents(bool no_cost)
     if (HasAtLoginFlag(AT_LOGIN_RESET_TALENTS))
     {
         m_atLoginFlags = m_atLoginFlags & ~AT_LOGIN_RESET_TALENTS;
+        SqlAsyncKeyGuard asyncKey(CharacterDatabase, GetGUIDLow());
         CharacterDatabase.PExecute("UPDATE characters set at_login = at_login & ~ %u WHERE guid ='%u'", uint32(AT_LOGIN_RESET_TALENTS), GetGUIDLow());
     }
 
@@ -3727,6 +3750,9 @@ TrainerSpellState Player::GetTrainerSpellState(TrainerSpell const* trainer_spell
  */
 void Player::DeleteFromDB(uint64 playerguid, uint32 accountId, bool updateRealmChars, bool deleteFinally)
 {
+    // after every pending write of the character, also the mails and items others sent it
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, SQL_ASYNC_KEY_ALL);
+
     // for not existed account avoid update realm
     if (accountId == 0)
         updateRealmChars = false;
@@ -5618,10 +5644,12 @@ void Player::SendMessageToSet(WorldPacket *data, bool self)
     if (self)
         GetSession()->SendPacket(data);
 
+    FlushRelayedMoves();
+
     // we use World::GetMaxVisibleDistance() because i cannot see why not use a distance
     // update: replaced by GetMap()->GetVisibilityDistance()
     Oregon::MessageDistDeliverer notifier(this, data, GetMap()->GetVisibilityDistance());
-    VisitNearbyWorldObject(GetMap()->GetVisibilityDistance(), notifier);
+    VisitNearbyWorldObjectInRange(GetMap()->GetVisibilityDistance(), TYPEMASK_SEER, notifier);
 }
 
 void Player::SendMessageToSetInRange(WorldPacket *data, float dist, bool self)
@@ -5629,8 +5657,10 @@ void Player::SendMessageToSetInRange(WorldPacket *data, float dist, bool self)
     if (self)
         GetSession()->SendPacket(data);
 
+    FlushRelayedMoves();
+
     Oregon::MessageDistDeliverer notifier(this, data, dist);
-    VisitNearbyWorldObject(dist, notifier);
+    VisitNearbyWorldObjectInRange(dist, TYPEMASK_SEER, notifier);
 }
 
 void Player::SendMessageToSetInRange(WorldPacket *data, float dist, bool self, bool own_team_only)
@@ -5638,8 +5668,10 @@ void Player::SendMessageToSetInRange(WorldPacket *data, float dist, bool self, b
     if (self)
         GetSession()->SendPacket(data);
 
+    FlushRelayedMoves();
+
     Oregon::MessageDistDeliverer notifier(this, data, dist, own_team_only);
-    VisitNearbyWorldObject(dist, notifier);
+    VisitNearbyWorldObjectInRange(dist, TYPEMASK_SEER, notifier);
 }
 
 void Player::SendDirectMessage(WorldPacket *data)
@@ -6575,6 +6607,7 @@ uint32 Player::GetZoneIdFromDB(uint64 guid)
 
         ss.str("");
         ss << "UPDATE characters SET zone='"<<zone<<"' WHERE guid='"<<GUID_LOPART(guid)<<"'";
+        SqlAsyncKeyGuard asyncKey(CharacterDatabase, GUID_LOPART(guid));
         CharacterDatabase.Execute(ss.str().c_str());
     }
 
@@ -14517,6 +14550,8 @@ void Player::_LoadBGData(QueryResult_AutoPtr result)
     if (!result)
         return;
 
+    m_bgDataSaved = true;
+
     // Expecting only one row
     Field *fields = result->Fetch();
     /* bgInstanceID, bgTeam, x, y, z, o, map, taxi[0], taxi[1], mountSpell */
@@ -14637,6 +14672,7 @@ bool Player::LoadFromDB(uint32 guid, SqlQueryHolder *holder)
     // check name limitations
     if (!ObjectMgr::IsValidName(m_name) || (GetSession()->GetSecurity() == SEC_PLAYER && objmgr.IsReservedName(m_name)))
     {
+        SqlAsyncKeyGuard asyncKey(CharacterDatabase, guid);
         CharacterDatabase.PExecute("UPDATE characters SET at_login = at_login | '%u' WHERE guid ='%u'", uint32(AT_LOGIN_RENAME),guid);
         return false;
     }
@@ -15234,6 +15270,8 @@ void Player::_LoadAuras(QueryResult_AutoPtr result, uint32 timediff)
 
     if (result)
     {
+        m_aurasSaved = true;
+
         do
         {
             Field *fields = result->Fetch();
@@ -16269,6 +16307,9 @@ bool Player::_LoadHomeBind(QueryResult_AutoPtr result)
 
 void Player::SaveToDB()
 {
+    // the saves of a player are only in order with its own writes
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, GetGUIDLow());
+
     // delay auto save at any saves (manual, in code, or autosave)
     m_nextSave = sWorld.getConfig(CONFIG_INTERVAL_SAVE);
 
@@ -16308,130 +16349,91 @@ void Player::SaveToDB()
     RemoveFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_STUNNED);
     SetDisplayId(GetNativeDisplayId());
 
-    std::string sql_name = m_name;
-    CharacterDatabase.escape_string(sql_name);
-
-    std::ostringstream ss;
-    ss << "REPLACE INTO characters (guid,account,name,race,class,gender,level,xp,money,playerBytes,playerBytes2,playerFlags,"
-        "map, instance_id, dungeon_difficulty, position_x, position_y, position_z, orientation, data, "
-        "taximask, online, cinematic, "
-        "totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, resettalents_cost, resettalents_time, "
-        "trans_x, trans_y, trans_z, trans_o, transguid, extra_flags, stable_slots, at_login, zone, "
-        "death_expire_time, taxi_path, arenaPoints, totalHonorPoints, todayHonorPoints, yesterdayHonorPoints, "
-        "totalKills, todayKills, yesterdayKills, chosenTitle, watchedFaction, drunk, health, "
-        "powerMana, powerRage, powerFocus, powerEnergy, powerHappiness, latency) VALUES ("
-        << GetGUIDLow() << ", "
-        << GetSession()->GetAccountId() << ", '"
-        << sql_name << "', "
-        << uint32(getRace()) << ", "
-        << uint32(getClass()) << ", "
-        << uint32(getGender()) << ", "
-        << uint32(getLevel()) << ", "
-        << GetUInt32Value(PLAYER_XP) << ", "
-        << GetMoney() << ", "
-        << GetUInt32Value(PLAYER_BYTES) << ", "
-        << GetUInt32Value(PLAYER_BYTES_2) << ", "
-        << GetUInt32Value(PLAYER_FLAGS) << ", ";
+    SqlStmtParameters params(58);
+    params.addUInt32(GetGUIDLow())
+        .addUInt32(GetSession()->GetAccountId())
+        .addString(m_name)
+        .addUInt8(getRace())
+        .addUInt8(getClass())
+        .addUInt8(getGender())
+        .addUInt32(getLevel())
+        .addUInt32(GetUInt32Value(PLAYER_XP))
+        .addUInt32(GetMoney())
+        .addUInt32(GetUInt32Value(PLAYER_BYTES))
+        .addUInt32(GetUInt32Value(PLAYER_BYTES_2))
+        .addUInt32(GetUInt32Value(PLAYER_FLAGS));
 
     if (!IsBeingTeleported())
     {
-        ss << GetMapId() << ", "
-        << (uint32)GetInstanceId() << ", "
-        << (uint32)GetDifficulty() << ", "
-        << finiteAlways(GetPositionX()) << ", "
-        << finiteAlways(GetPositionY()) << ", "
-        << finiteAlways(GetPositionZ()) << ", "
-        << finiteAlways(GetOrientation()) << ", '";
+        params.addUInt32(GetMapId())
+            .addUInt32(GetInstanceId())
+            .addUInt32(GetDifficulty())
+            .addFloat(finiteAlways(GetPositionX()))
+            .addFloat(finiteAlways(GetPositionY()))
+            .addFloat(finiteAlways(GetPositionZ()))
+            .addFloat(finiteAlways(GetOrientation()));
     }
     else
     {
-        ss << GetTeleportDest().GetMapId() << ", "
-        << (uint32)0 << ", "
-        << (uint32)GetDifficulty() << ", "
-        << finiteAlways(GetTeleportDest().GetPositionX()) << ", "
-        << finiteAlways(GetTeleportDest().GetPositionY()) << ", "
-        << finiteAlways(GetTeleportDest().GetPositionZ()) << ", "
-        << finiteAlways(GetTeleportDest().GetOrientation()) << ", '";
+        params.addUInt32(GetTeleportDest().GetMapId())
+            .addUInt32(0)
+            .addUInt32(GetDifficulty())
+            .addFloat(finiteAlways(GetTeleportDest().GetPositionX()))
+            .addFloat(finiteAlways(GetTeleportDest().GetPositionY()))
+            .addFloat(finiteAlways(GetTeleportDest().GetPositionZ()))
+            .addFloat(finiteAlways(GetTeleportDest().GetOrientation()));
     }
 
-    uint16 i;
-    for (i = 0; i < m_valuesCount; ++i)
+    std::ostringstream ss;
+    for (uint16 i = 0; i < m_valuesCount; ++i)
         ss << GetUInt32Value(i) << " ";
+    params.addString(ss.str());
 
-    ss << "', '";
-
-    for (i = 0; i < 8; i++)
+    ss.str("");
+    for (uint8 i = 0; i < 8; i++)
         ss << m_taxi.GetTaximask(i) << " ";
-
-    ss << "', ";
-    ss << (IsInWorld() ? 1 : 0) << ", ";
-
-    ss << m_cinematic << ", ";
-
-    ss << m_Played_time[PLAYED_TIME_TOTAL] << ", ";
-    ss << m_Played_time[PLAYED_TIME_LEVEL] << ", ";
-
-    ss << finiteAlways(m_rest_bonus) << ", ";
-    ss << (uint64)time(NULL) << ", ";
-    ss << is_save_resting << ", ";
-    ss << m_resetTalentsCost << ", ";
-    ss << (uint64)m_resetTalentsTime << ", ";
-
-    ss << finiteAlways(m_movementInfo.GetTransportPos()->GetPositionX()) << ", ";
-    ss << finiteAlways(m_movementInfo.GetTransportPos()->GetPositionY()) << ", ";
-    ss << finiteAlways(m_movementInfo.GetTransportPos()->GetPositionZ()) << ", ";
-    ss << finiteAlways(m_movementInfo.GetTransportPos()->GetOrientation()) << ", ";
-    if (m_transport)
-        ss << m_transport->GetGUIDLow();
-    else
-        ss << "0";
-
-    ss << ", ";
-
-    ss << m_ExtraFlags << ", ";
-
-    ss << uint32(m_stableSlots) << ", ";                    // to prevent save uint8 as char
-
-    ss << uint32(m_atLoginFlags) << ", ";
-
-    ss << GetZoneId() << ", ";
-
-    ss << (uint64)m_deathExpireTime << ", '";
-
-    ss << m_taxi.SaveTaxiDestinationsToString() << "', ";
-
-    ss << GetArenaPoints() << ", ";
-
-    ss << GetHonorPoints() << ", ";
-
-    ss << GetUInt32Value(PLAYER_FIELD_TODAY_CONTRIBUTION) << ", ";
-
-    ss << GetUInt32Value(PLAYER_FIELD_YESTERDAY_CONTRIBUTION) << ", ";
-
-    ss << GetUInt32Value(PLAYER_FIELD_LIFETIME_HONORABLE_KILLS) << ", ";
-
-    ss << GetUInt16Value(PLAYER_FIELD_KILLS, 0) << ", ";
-
-    ss << GetUInt16Value(PLAYER_FIELD_KILLS, 1) << ", ";
-
-    ss << GetUInt32Value(PLAYER_CHOSEN_TITLE) << ", ";
-
-    ss << GetUInt32Value(PLAYER_FIELD_WATCHED_FACTION_INDEX) << ", ";
-
-    ss << (uint16)(GetUInt32Value(PLAYER_BYTES_3) & 0xFFFE) << ", ";
-
-    ss << GetHealth();
+    params.addString(ss.str());
+
+    params.addUInt8(IsInWorld() ? 1 : 0)
+        .addUInt32(m_cinematic)
+        .addUInt32(m_Played_time[PLAYED_TIME_TOTAL])
+        .addUInt32(m_Played_time[PLAYED_TIME_LEVEL])
+        .addFloat(finiteAlways(m_rest_bonus))
+        .addUInt64(uint64(time(NULL)))
+        .addUInt8(is_save_resting)
+        .addUInt32(m_resetTalentsCost)
+        .addUInt64(uint64(m_resetTalentsTime))
+        .addFloat(finiteAlways(m_movementInfo.GetTransportPos()->GetPositionX()))
+        .addFloat(finiteAlways(m_movementInfo.GetTransportPos()->GetPositionY()))
+        .addFloat(finiteAlways(m_movementInfo.GetTransportPos()->GetPositionZ()))
+        .addFloat(finiteAlways(m_movementInfo.GetTransportPos()->GetOrientation()))
+        .addUInt32(m_transport ? m_transport->GetGUIDLow() : 0)
+        .addUInt32(m_ExtraFlags)
+        .addUInt32(m_stableSlots)
+        .addUInt32(m_atLoginFlags)
+        .addUInt32(GetZoneId())
+        .addUInt64(uint64(m_deathExpireTime))
+        .addString(m_taxi.SaveTaxiDestinationsToString())
+        .addUInt32(GetArenaPoints())
+        .addUInt32(GetHonorPoints())
+        .addUInt32(GetUInt32Value(PLAYER_FIELD_TODAY_CONTRIBUTION))
+        .addUInt32(GetUInt32Value(PLAYER_FIELD_YESTERDAY_CONTRIBUTION))
+        .addUInt32(GetUInt32Value(PLAYER_FIELD_LIFETIME_HONORABLE_KILLS))
+        .addUInt16(GetUInt16Value(PLAYER_FIELD_KILLS, 0))
+        .addUInt16(GetUInt16Value(PLAYER_FIELD_KILLS, 1))
+        .addUInt32(GetUInt32Value(PLAYER_CHOSEN_TITLE))
+        .addUInt32(GetUInt32Value(PLAYER_FIELD_WATCHED_FACTION_INDEX))
+        .addUInt16(uint16(GetUInt32Value(PLAYER_BYTES_3) & 0xFFFE))
+        .addUInt32(GetHealth());
 
     for (uint32 i = 0; i < MAX_POWERS; ++i)
-        ss << ", " << GetPower(Powers(i));
-    ss << ", '";
+        params.addUInt32(GetPower(Powers(i)));
 
-    ss << GetSession()->GetLatency();
-    ss << "')";
+    params.addUInt32(GetSession()->GetLatency());
 
     CharacterDatabase.BeginTransaction();
 
-    CharacterDatabase.Execute(ss.str().c_str());
+    CharacterDatabase.Execute(CHAR_REP_CHARACTER, params);
 
     if (m_mailsUpdated)                                     //save mails only when needed
         _SaveMail();
@@ -16465,35 +16467,35 @@ void Player::SaveToDB()
 // fast save function for item/money cheating preventing - save only inventory and money state
 void Player::SaveInventoryAndGoldToDB()
 {
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, GetGUIDLow());
     _SaveInventory();
     SaveGoldToDB();
 }
 
 void Player::SaveGoldToDB()
 {
-    CharacterDatabase.PExecute("UPDATE characters SET money = '%u' WHERE guid = '%u'", GetMoney(), GetGUIDLow());
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, GetGUIDLow());
+    CharacterDatabase.Execute(CHAR_UPD_CHARACTER_MONEY, SqlStmtParameters(2).addUInt32(GetMoney()).addUInt32(GetGUIDLow()));
 }
 
 void Player::_SaveActions()
 {
+    SqlBatchInsert batch("INSERT INTO character_action (guid,button,action,type,misc) VALUES ",
+        " ON DUPLICATE KEY UPDATE action = VALUES(action), type = VALUES(type), misc = VALUES(misc)");
+
     for (ActionButtonList::iterator itr = m_actionButtons.begin(); itr != m_actionButtons.end();)
     {
         switch (itr->second.uState)
         {
             case ACTIONBUTTON_NEW:
-                CharacterDatabase.PExecute("INSERT INTO character_action (guid,button,action,type,misc) VALUES ('%u', '%u', '%u', '%u', '%u')",
-                    GetGUIDLow(), (uint32)itr->first, (uint32)itr->second.action, (uint32)itr->second.type, (uint32)itr->second.misc);
-                itr->second.uState = ACTIONBUTTON_UNCHANGED;
-                ++itr;
-                break;
             case ACTIONBUTTON_CHANGED:
-                CharacterDatabase.PExecute("UPDATE character_action  SET action = '%u', type = '%u', misc= '%u' WHERE guid= '%u' AND button= '%u' ",
-                    (uint32)itr->second.action, (uint32)itr->second.type, (uint32)itr->second.misc, GetGUIDLow(), (uint32)itr->first);
+                batch.NextRow() << GetGUIDLow() << ", " << uint32(itr->first) << ", " << uint32(itr->second.action) << ", "
+                    << uint32(itr->second.type) << ", " << uint32(itr->second.misc);
                 itr->second.uState = ACTIONBUTTON_UNCHANGED;
                 ++itr;
                 break;
             case ACTIONBUTTON_DELETED:
-                CharacterDatabase.PExecute("DELETE FROM character_action WHERE guid = '%u' and button = '%u'", GetGUIDLow(), (uint32)itr->first);
+                CharacterDatabase.Execute(CHAR_DEL_CHARACTER_ACTION, SqlStmtParameters(2).addUInt32(GetGUIDLow()).addUInt32(itr->first));
                 m_actionButtons.erase(itr++);
                 break;
             default:
@@ -16501,16 +16503,23 @@ void Player::_SaveActions()
                 break;
         }
     }
+
+    batch.Execute(CharacterDatabase);
 }
 
 void Player::_SaveAuras()
 {
-    CharacterDatabase.PExecute("DELETE FROM character_aura WHERE guid = '%u'",GetGUIDLow());
-
     AuraMap const& auras = GetAuras();
 
     if (auras.empty())
+    {
+        if (m_aurasSaved)
+            CharacterDatabase.Execute(CHAR_DEL_CHARACTER_AURAS, SqlStmtParameters(1).addUInt32(GetGUIDLow()));
+        m_aurasSaved = false;
         return;
+    }
+
+    SqlBatchInsert batch("INSERT INTO character_aura (guid,caster_guid,spell,effect_index,stackcount,amount,maxduration,remaintime,remaincharges) VALUES ");
 
     spellEffectPair lastEffectPair = auras.begin()->first;
     uint32 stackCounter = 1;
@@ -16539,9 +16548,10 @@ void Player::_SaveAuras()
 
                     if (i == 3)
                     {
-                        CharacterDatabase.PExecute("INSERT INTO character_aura (guid,caster_guid,spell,effect_index,stackcount,amount,maxduration,remaintime,remaincharges) "
-                            "VALUES ('%u', '" UI64FMTD "' ,'%u', '%u', '%u', '%d', '%d', '%d', '%d')",
-                            GetGUIDLow(), itr2->second->GetCasterGUID(), (uint32)itr2->second->GetId(), (uint32)itr2->second->GetEffIndex(), (uint32)itr2->second->GetStackAmount(), itr2->second->GetModifier()->m_amount,int(itr2->second->GetAuraMaxDuration()),int(itr2->second->GetAuraDuration()),int(itr2->second->m_procCharges));
+                        batch.NextRow() << GetGUIDLow() << ", " << itr2->second->GetCasterGUID() << ", " << uint32(itr2->second->GetId()) << ", "
+                            << uint32(itr2->second->GetEffIndex()) << ", " << uint32(itr2->second->GetStackAmount()) << ", "
+                            << itr2->second->GetModifier()->m_amount << ", " << int32(itr2->second->GetAuraMaxDuration()) << ", "
+                            << int32(itr2->second->GetAuraDuration()) << ", " << int32(itr2->second->m_procCharges);
                     }
                 }
             }
@@ -16559,6 +16569,14 @@ void Player::_SaveAuras()
             stackCounter = 1;
         }
     }
+
+    // nothing to write and nothing to clear
+    if (!batch.GetRowCount() && !m_aurasSaved)
+        return;
+
+    CharacterDatabase.Execute(CHAR_DEL_CHARACTER_AURAS, SqlStmtParameters(1).addUInt32(GetGUIDLow()));
+    m_aurasSaved = batch.GetRowCount() != 0;
+    batch.Execute(CharacterDatabase);
 }
 
 void Player::_SaveInventory()
@@ -16570,8 +16588,8 @@ void Player::_SaveInventory()
         Item *item = m_items[i];
         if (!item || item->GetState() == ITEM_NEW)
             continue;
-        CharacterDatabase.PExecute("DELETE FROM character_inventory WHERE item = '%u'", item->GetGUIDLow());
-        CharacterDatabase.PExecute("DELETE FROM item_instance WHERE guid = '%u'", item->GetGUIDLow());
+        CharacterDatabase.Execute(CHAR_DEL_CHARACTER_INVENTORY_BY_ITEM, SqlStmtParameters(1).addUInt32(item->GetGUIDLow()));
+        CharacterDatabase.Execute(CHAR_DEL_ITEM_INSTANCE, SqlStmtParameters(1).addUInt32(item->GetGUIDLow()));
         m_items[i]->FSetState(ITEM_NEW);
     }
 
@@ -16583,6 +16601,11 @@ void Player::_SaveInventory()
     if (m_itemUpdateQueue.empty())
         return;
 
+    SqlBatchInsert inventoryBatch("INSERT INTO character_inventory (guid,bag,slot,item,item_template) VALUES ",
+        " ON DUPLICATE KEY UPDATE guid = VALUES(guid), bag = VALUES(bag), slot = VALUES(slot), item_template = VALUES(item_template)");
+    SqlBatchInsert dataBatch("INSERT INTO item_instance (guid,owner_guid,data) VALUES ",
+        " ON DUPLICATE KEY UPDATE owner_guid = VALUES(owner_guid), data = VALUES(data)");
+
     // do not save if the update queue is corrupt
     uint32 lowGuid = GetGUIDLow();
     for (size_t i = 0; i < m_itemUpdateQueue.size(); ++i)
@@ -16604,7 +16627,7 @@ void Player::_SaveInventory()
                     bagTestGUID = test2->GetGUIDLow();
                 sLog.outError("Player(GUID: %u Name: %s)::_SaveInventory - the bag(%u) and slot(%u) values for the item with guid %u (state %d) are incorrect, the player doesn't have an item at that position!", lowGuid, GetName(), item->GetBagSlot(), item->GetSlot(), item->GetGUIDLow(), (int32)item->GetState());
                 // according to the test that was just performed nothing should be in this slot, delete
-                CharacterDatabase.PExecute("DELETE FROM character_inventory WHERE bag=%u AND slot=%u", bagTestGUID, item->GetSlot());
+                CharacterDatabase.Execute(CHAR_DEL_CHARACTER_INVENTORY_BY_SLOT, SqlStmtParameters(2).addUInt32(bagTestGUID).addUInt8(item->GetSlot()));
                 // also THIS item should be somewhere else, cheat attempt
                 item->FSetState(ITEM_REMOVED); // we are IN updateQueue right now, can't use SetState which modifies the queue
                 // don't skip, let the switch delete it
@@ -16615,7 +16638,7 @@ void Player::_SaveInventory()
                 sLog.outError("Player(GUID: %u Name: %s)::_SaveInventory - the bag(%u) and slot(%u) values for the item with guid %u are incorrect, the item with guid %u is there instead!", lowGuid, GetName(), item->GetBagSlot(), item->GetSlot(), item->GetGUIDLow(), test->GetGUIDLow());
                 // save all changes to the item...
                 if (item->GetState() != ITEM_NEW) // only for existing items, no dupes
-                    item->SaveToDB();
+                    item->SaveToDB(&dataBatch);
                 // ...but do not save position in invntory
                 continue;
             }
@@ -16624,21 +16647,23 @@ void Player::_SaveInventory()
         switch (item->GetState())
         {
             case ITEM_NEW:
-                CharacterDatabase.PExecute("INSERT INTO character_inventory (guid,bag,slot,item,item_template) VALUES ('%u', '%u', '%u', '%u', '%u')", lowGuid, bag_guid, item->GetSlot(), item->GetGUIDLow(), item->GetEntry());
-                break;
             case ITEM_CHANGED:
-                CharacterDatabase.PExecute("UPDATE character_inventory SET guid='%u', bag='%u', slot='%u', item_template='%u' WHERE item='%u'", lowGuid, bag_guid, item->GetSlot(), item->GetEntry(), item->GetGUIDLow());
+                inventoryBatch.NextRow() << lowGuid << ", " << bag_guid << ", " << uint32(item->GetSlot()) << ", "
+                    << item->GetGUIDLow() << ", " << item->GetEntry();
                 break;
             case ITEM_REMOVED:
-                CharacterDatabase.PExecute("DELETE FROM character_inventory WHERE item = '%u'", item->GetGUIDLow());
+                CharacterDatabase.Execute(CHAR_DEL_CHARACTER_INVENTORY_BY_ITEM, SqlStmtParameters(1).addUInt32(item->GetGUIDLow()));
                 break;
             case ITEM_UNCHANGED:
                 break;
         }
 
-        item->SaveToDB();                                   // item have unchanged inventory record and can be save standalone
+        item->SaveToDB(&dataBatch);                         // item have unchanged inventory record and can be save standalone
     }
     m_itemUpdateQueue.clear();
+
+    inventoryBatch.Execute(CharacterDatabase);
+    dataBatch.Execute(CharacterDatabase);
 }
 
 void Player::_SaveMail()
@@ -16692,25 +16717,27 @@ void Player::_SaveMail()
 
 void Player::_SaveQuestStatus()
 {
-    // we don't need transactions here.
+    SqlBatchInsert batch("INSERT INTO character_queststatus (guid,quest,status,rewarded,explored,timer,mobcount1,mobcount2,mobcount3,mobcount4,itemcount1,itemcount2,itemcount3,itemcount4) VALUES ",
+        " ON DUPLICATE KEY UPDATE status = VALUES(status), rewarded = VALUES(rewarded), explored = VALUES(explored), timer = VALUES(timer),"
+        " mobcount1 = VALUES(mobcount1), mobcount2 = VALUES(mobcount2), mobcount3 = VALUES(mobcount3), mobcount4 = VALUES(mobcount4),"
+        " itemcount1 = VALUES(itemcount1), itemcount2 = VALUES(itemcount2), itemcount3 = VALUES(itemcount3), itemcount4 = VALUES(itemcount4)");
+
     for (QuestStatusMap::iterator i = mQuestStatus.begin(); i != mQuestStatus.end(); ++i)
     {
-        switch (i->second.uState)
-        {
-            case QUEST_NEW:
-                CharacterDatabase.PExecute("INSERT INTO character_queststatus (guid,quest,status,rewarded,explored,timer,mobcount1,mobcount2,mobcount3,mobcount4,itemcount1,itemcount2,itemcount3,itemcount4) "
-                    "VALUES ('%u', '%u', '%u', '%u', '%u', '" UI64FMTD "', '%u', '%u', '%u', '%u', '%u', '%u', '%u', '%u')",
-                    GetGUIDLow(), i->first, i->second.m_status, i->second.m_rewarded, i->second.m_explored, uint64(i->second.m_timer / IN_MILLISECONDS + sWorld.GetGameTime()), i->second.m_creatureOrGOcount[0], i->second.m_creatureOrGOcount[1], i->second.m_creatureOrGOcount[2], i->second.m_creatureOrGOcount[3], i->second.m_itemcount[0], i->second.m_itemcount[1], i->second.m_itemcount[2], i->second.m_itemcount[3]);
-                break;
-            case QUEST_CHANGED:
-                CharacterDatabase.PExecute("UPDATE character_queststatus SET status = '%u',rewarded = '%u',explored = '%u',timer = '" UI64FMTD "',mobcount1 = '%u',mobcount2 = '%u',mobcount3 = '%u',mobcount4 = '%u',itemcount1 = '%u',itemcount2 = '%u',itemcount3 = '%u',itemcount4 = '%u'  WHERE guid = '%u' AND quest = '%u' ",
-                    i->second.m_status, i->second.m_rewarded, i->second.m_explored, uint64(i->second.m_timer / IN_MILLISECONDS + sWorld.GetGameTime()), i->second.m_creatureOrGOcount[0], i->second.m_creatureOrGOcount[1], i->second.m_creatureOrGOcount[2], i->second.m_creatureOrGOcount[3], i->second.m_itemcount[0], i->second.m_itemcount[1], i->second.m_itemcount[2], i->second.m_itemcount[3], GetGUIDLow(), i->first);
-                break;
-            case QUEST_UNCHANGED:
-                break;
-        };
+        if (i->second.uState == QUEST_UNCHANGED)
+            continue;
+
+        batch.NextRow() << GetGUIDLow() << ", " << i->first << ", " << uint32(i->second.m_status) << ", "
+            << uint32(i->second.m_rewarded) << ", " << uint32(i->second.m_explored) << ", "
+            << uint64(i->second.m_timer / IN_MILLISECONDS + sWorld.GetGameTime()) << ", "
+            << i->second.m_creatureOrGOcount[0] << ", " << i->second.m_creatureOrGOcount[1] << ", "
+            << i->second.m_creatureOrGOcount[2] << ", " << i->second.m_creatureOrGOcount[3] << ", "
+            << i->second.m_itemcount[0] << ", " << i->second.m_itemcount[1] << ", "
+            << i->second.m_itemcount[2] << ", " << i->second.m_itemcount[3];
         i->second.uState = QUEST_UNCHANGED;
     }
+
+    batch.Execute(CharacterDatabase);
 }
 
 void Player::_SaveDailyQuestStatus()
@@ -16722,17 +16749,20 @@ void Player::_SaveDailyQuestStatus()
 
     // save last daily quest time for all quests: we need only mostly reset time for reset check anyway
 
-    // we don't need transactions here.
-    CharacterDatabase.PExecute("DELETE FROM character_queststatus_daily WHERE guid = '%u'",GetGUIDLow());
+    CharacterDatabase.Execute(CHAR_DEL_CHARACTER_QUESTSTATUS_DAILY, SqlStmtParameters(1).addUInt32(GetGUIDLow()));
+
+    SqlBatchInsert batch("INSERT INTO character_queststatus_daily (guid,quest,time) VALUES ");
     for (uint32 quest_daily_idx = 0; quest_daily_idx < PLAYER_MAX_DAILY_QUESTS; ++quest_daily_idx)
-        if (GetUInt32Value(PLAYER_FIELD_DAILY_QUESTS_1+quest_daily_idx))
-            CharacterDatabase.PExecute("INSERT INTO character_queststatus_daily (guid,quest,time) VALUES ('%u', '%u','" UI64FMTD "')",
-                GetGUIDLow(), GetUInt32Value(PLAYER_FIELD_DAILY_QUESTS_1+quest_daily_idx),uint64(m_lastDailyQuestTime));
+        if (uint32 quest = GetUInt32Value(PLAYER_FIELD_DAILY_QUESTS_1+quest_daily_idx))
+            batch.NextRow() << GetGUIDLow() << ", " << quest << ", " << uint64(m_lastDailyQuestTime);
+    batch.Execute(CharacterDatabase);
 }
 
 void Player::_SaveSkills()
 {
-    // we don't need transactions here.
+    SqlBatchInsert batch("INSERT INTO character_skills (guid, skill, value, max) VALUES ",
+        " ON DUPLICATE KEY UPDATE value = VALUES(value), max = VALUES(max)");
+
     for (SkillStatusMap::iterator itr = mSkillStatus.begin(); itr != mSkillStatus.end();)
     {
         if (itr->second.uState == SKILL_UNCHANGED)
@@ -16743,63 +16773,58 @@ void Player::_SaveSkills()
 
         if (itr->second.uState == SKILL_DELETED)
         {
-            CharacterDatabase.PExecute("DELETE FROM character_skills WHERE guid = '%u' AND skill = '%u'", GetGUIDLow(), itr->first);
+            CharacterDatabase.Execute(CHAR_DEL_CHARACTER_SKILL, SqlStmtParameters(2).addUInt32(GetGUIDLow()).addUInt32(itr->first));
             mSkillStatus.erase(itr++);
             continue;
         }
 
         uint32 valueData = GetUInt32Value(PLAYER_SKILL_VALUE_INDEX(itr->second.pos));
-        uint16 value = SKILL_VALUE(valueData);
-        uint16 max = SKILL_MAX(valueData);
-
-        switch (itr->second.uState)
-        {
-            case SKILL_NEW:
-                CharacterDatabase.PExecute("INSERT INTO character_skills (guid, skill, value, max) VALUES ('%u', '%u', '%u', '%u')",
-                    GetGUIDLow(), itr->first, value, max);
-                break;
-            case SKILL_CHANGED:
-                CharacterDatabase.PExecute("UPDATE character_skills SET value = '%u',max = '%u'WHERE guid = '%u' AND skill = '%u' ",
-                    value, max, GetGUIDLow(), itr->first );
-                break;
-            case SKILL_UNCHANGED:
-            case SKILL_DELETED:
-                break;
-        };
+        batch.NextRow() << GetGUIDLow() << ", " << itr->first << ", " << uint32(SKILL_VALUE(valueData)) << ", " << uint32(SKILL_MAX(valueData));
         itr->second.uState = SKILL_UNCHANGED;
 
         ++itr;
     }
+
+    batch.Execute(CharacterDatabase);
 }
 
 void Player::_SaveReputation()
 {
+    SqlBatchInsert batch("INSERT INTO character_reputation (guid,faction,standing,flags) VALUES ",
+        " ON DUPLICATE KEY UPDATE standing = VALUES(standing), flags = VALUES(flags)");
+
     for (FactionStateList::iterator itr = m_factions.begin(); itr != m_factions.end(); ++itr)
     {
         if (itr->second.Changed)
         {
-            CharacterDatabase.PExecute("DELETE FROM character_reputation WHERE guid = '%u' AND faction='%u'", GetGUIDLow(), itr->second.ID);
-            CharacterDatabase.PExecute("INSERT INTO character_reputation (guid,faction,standing,flags) VALUES ('%u', '%u', '%i', '%u')", GetGUIDLow(), itr->second.ID, itr->second.Standing, itr->second.Flags);
+            batch.NextRow() << GetGUIDLow() << ", " << itr->second.ID << ", " << itr->second.Standing << ", " << itr->second.Flags;
             itr->second.Changed = false;
         }
     }
+
+    batch.Execute(CharacterDatabase);
 }
 
 void Player::_SaveSpells()
 {
+    SqlBatchInsert batch("INSERT INTO character_spell (guid,spell,active,disabled) VALUES ",
+        " ON DUPLICATE KEY UPDATE active = VALUES(active), disabled = VALUES(disabled)");
+
     for (PlayerSpellMap::const_iterator itr = m_spells.begin(), next = m_spells.begin(); itr != m_spells.end(); itr = next)
     {
         ++next;
-        if (itr->second->state == PLAYERSPELL_REMOVED || itr->second->state == PLAYERSPELL_CHANGED)
-            CharacterDatabase.PExecute("DELETE FROM character_spell WHERE guid = '%u' and spell = '%u'", GetGUIDLow(), itr->first);
-        if (itr->second->state == PLAYERSPELL_NEW || itr->second->state == PLAYERSPELL_CHANGED)
-            CharacterDatabase.PExecute("INSERT INTO character_spell (guid,spell,active,disabled) VALUES ('%u', '%u', '%u', '%u')", GetGUIDLow(), itr->first, itr->second->active ? 1 : 0,itr->second->disabled ? 1 : 0);
+        if (itr->second->state == PLAYERSPELL_REMOVED)
+            CharacterDatabase.Execute(CHAR_DEL_CHARACTER_SPELL, SqlStmtParameters(2).addUInt32(GetGUIDLow()).addUInt32(itr->first));
+        else if (itr->second->state == PLAYERSPELL_NEW || itr->second->state == PLAYERSPELL_CHANGED)
+            batch.NextRow() << GetGUIDLow() << ", " << itr->first << ", " << (itr->second->active ? 1 : 0) << ", " << (itr->second->disabled ? 1 : 0);
 
         if (itr->second->state == PLAYERSPELL_REMOVED)
             _removeSpell(itr->first);
         else
             itr->second->state = PLAYERSPELL_UNCHANGED;
     }
+
+    batch.Execute(CharacterDatabase);
 }
 
 void Player::_SaveTutorials()
@@ -16904,6 +16929,7 @@ void Player::SavePositionInDB(uint32 mapid, float x,float y,float z,float o,uint
         << "',zone='"<<zone<<"',trans_x='0',trans_y='0',trans_z='0',"
         << "transguid='0',taxi_path='' WHERE guid='"<< GUID_LOPART(guid) <<"'";
     DEBUG_LOG("%s", ss.str().c_str());
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, GUID_LOPART(guid));
     CharacterDatabase.Execute(ss.str().c_str());
 }
 
@@ -16918,6 +16944,7 @@ void Player::SaveDataFieldToDB()
     }
     ss<<"' WHERE guid='"<< GUID_LOPART(GetGUIDLow()) <<"'";
 
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, GetGUIDLow());
     CharacterDatabase.Execute(ss.str().c_str());
 }
 
@@ -16932,6 +16959,7 @@ bool Player::SaveValuesArrayInDB(Tokens const& tokens, uint64 guid)
     }
     ss2<<"' WHERE guid='"<< GUID_LOPART(guid) <<"'";
 
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, GUID_LOPART(guid));
     return CharacterDatabase.Execute(ss2.str().c_str());
 }
 
@@ -18886,27 +18914,27 @@ bool Player::IsVisibleGloballyFor(Player* u) const
 }
 
 template<class T>
-inline void UpdateVisibilityOf_helper(std::set<uint64>& s64, T* target, std::set<Unit*>& /*v*/)
+inline void UpdateVisibilityOf_helper(Player::ClientGUIDs& s64, T* target, std::set<Unit*>& /*v*/)
 {
     s64.insert(target->GetGUID());
 }
 
 template<>
-inline void UpdateVisibilityOf_helper(std::set<uint64>& s64, GameObject* target, std::set<Unit*>& /*v*/)
+inline void UpdateVisibilityOf_helper(Player::ClientGUIDs& s64, GameObject* target, std::set<Unit*>& /*v*/)
 {
     if (!target->IsTransport())
         s64.insert(target->GetGUID());
 }
 
 template<>
-inline void UpdateVisibilityOf_helper(std::set<uint64>& s64, Creature* target, std::set<Unit*>& v)
+inline void UpdateVisibilityOf_helper(Player::ClientGUIDs& s64, Creature* target, std::set<Unit*>& v)
 {
     s64.insert(target->GetGUID());
     v.insert(target);
 }
 
 template<>
-inline void UpdateVisibilityOf_helper(std::set<uint64>& s64, Player* target, std::set<Unit*>& v)
+inline void UpdateVisibilityOf_helper(Player::ClientGUIDs& s64, Player* target, std::set<Unit*>& v)
 {
     s64.insert(target->GetGUID());
     v.insert(target);
@@ -19019,7 +19047,10 @@ template void Player::UpdateVisibilityOf(DynamicObject* target, UpdateData& data
 void Player::UpdateObjectVisibility(bool forced)
 {
     if (!forced)
+    {
+        m_clientVisibilityPending = true;
         AddToNotify(NOTIFY_VISIBILITY_CHANGED);
+    }
     else
     {
         Unit::UpdateObjectVisibility(true);
@@ -19297,6 +19328,7 @@ void Player::resetSpells()
     if (HasAtLoginFlag(AT_LOGIN_RESET_SPELLS))
     {
         m_atLoginFlags = m_atLoginFlags & ~AT_LOGIN_RESET_SPELLS;
+        SqlAsyncKeyGuard asyncKey(CharacterDatabase, GetGUIDLow());
         CharacterDatabase.PExecute("UPDATE characters SET at_login = at_login & ~ %u WHERE guid ='%u'", uint32(AT_LOGIN_RESET_SPELLS), GetGUIDLow());
     }
 
@@ -19717,6 +19749,7 @@ void Player::AutoUnequipOffhandIfNeed()
     else
     {
         MoveItemFromInventory(INVENTORY_SLOT_BAG_0, EQUIPMENT_SLOT_OFFHAND, true);
+        SqlAsyncKeyGuard asyncKey(CharacterDatabase, GetGUIDLow());
         CharacterDatabase.BeginTransaction();
         offItem->DeleteFromInventoryDB();                   // deletes item from character's inventory
         offItem->SaveToDB();                                // recursive and not have transaction guard into self, item not in inventory and can be save standalone
@@ -20684,7 +20717,12 @@ void Player::SetHomebindToLocation(WorldLocation const& loc, uint32 area_id)
 
 void Player::_SaveBGData()
 {
+    // nothing to write and nothing to clear
+    if (!m_bgData.bgInstanceID && !m_bgDataSaved)
+        return;
+
     CharacterDatabase.PExecute("DELETE FROM character_battleground_data WHERE guid='%u'", GetGUIDLow());
+    m_bgDataSaved = m_bgData.bgInstanceID != 0;
     if (m_bgData.bgInstanceID)
     {
         /* guid, bgInstanceID, bgTeam, x, y, z, o, map, taxi[0], taxi[1], mountSpell */
@@ -34,6 +34,7 @@
 #include "WorldSession.h"
 #include "Pet.h"
 #include "MapReference.h"
+#include "ClientGUIDSet.h"
 #include "Util.h"                                           // for Tokens typedef
 
 #include<string>
@@ -1679,6 +1680,14 @@ class Player : public Unit, public GridObject<Player>
         void learnSkillRewardedSpells();
 
         WorldLocation& GetTeleportDest() { return m_teleport_dest; }
+        // teleports started in between are saved and done by FinishTeleportDelay()
+        void StartTeleportDelay() { SetCanDelayTeleport(true); }
+        void FinishTeleportDelay()
+        {
+            SetCanDelayTeleport(false);
+            if (IsHasDelayedTeleport())
+                TeleportTo(m_teleport_dest, m_teleport_options);
+        }
         bool IsBeingTeleported() const { return mSemaphoreTeleport_Near || mSemaphoreTeleport_Far; }
         bool IsBeingTeleportedNear() const { return mSemaphoreTeleport_Near; }
         bool IsBeingTeleportedFar() const { return mSemaphoreTeleport_Far; }
@@ -2018,10 +2027,15 @@ class Player : public Unit, public GridObject<Player>
         bool TeleportToHomebind(uint32 options = 0) { return TeleportTo(m_homebindMapId, m_homebindX, m_homebindY, m_homebindZ, GetOrientation(), options); }
 
         // currently visible objects at player client
-        typedef std::set<uint64> ClientGUIDs;
+        typedef ClientGUIDSet ClientGUIDs;
         ClientGUIDs m_clientGUIDs;
 
-        bool HaveAtClient(WorldObject const* u) const { return u == this || m_clientGUIDs.find(u->GetGUID()) != m_clientGUIDs.end(); }
+        bool HaveAtClient(WorldObject const* u) const { return u == this || m_clientGUIDs.contains(u->GetGUID()); }
+
+        // where the last move asked for a visibility update of the client, see
+        // Map::PlayerRelocation, smaller moves only notify the objects around
+        Position m_visibilityRelocationPos;
+        bool m_clientVisibilityPending;
 
         bool canSeeOrDetect(Unit const* u, bool detect, bool inVisibleList = false, bool is3dDistance = true) const;
         bool IsVisibleInGridForPlayer(Player const* pl) const;
@@ -2186,6 +2200,11 @@ class Player : public Unit, public GridObject<Player>
         void _SaveTutorials();
         void _SaveBGData();
 
+        // rows of these sections may exist in the DB, else saving them is skipped while they are empty
+        bool m_aurasSaved;
+        bool m_spellCooldownsSaved;
+        bool m_bgDataSaved;
+
         void _SetCreateBits(UpdateMask *updateMask, Player *target) const;
         void _SetUpdateBits(UpdateMask *updateMask, Player *target) const;
 
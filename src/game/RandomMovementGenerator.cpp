@@ -109,18 +109,18 @@ RandomMovementGenerator<Creature>::_setRandomLocation(Creature &creature)
     Traveller<Creature> traveller(creature);
 
     creature.SetOrientation(creature.GetAngle(nx, ny));
-    i_destinationHolder.SetDestination(traveller, nx, ny, nz);
+    uint32 travelTime = i_destinationHolder.SetPathDestination(traveller, nx, ny, nz);
     creature.addUnitState(UNIT_STAT_ROAMING);
 
     if (is_air_ok)
     {
-        i_nextMoveTime.Reset(i_destinationHolder.GetTotalTravelTime());
+        i_nextMoveTime.Reset(travelTime);
         creature.AddUnitMovementFlag(MOVEFLAG_FLYING2);
     }
     //else if (is_water_ok)                                 // Swimming mode to be done with more than this check
     else
     {
-        i_nextMoveTime.Reset(urand(500+i_destinationHolder.GetTotalTravelTime(), 10000+i_destinationHolder.GetTotalTravelTime()));
+        i_nextMoveTime.Reset(urand(500+travelTime, 10000+travelTime));
         creature.SetUnitMovementFlags(MOVEFLAG_WALK_MODE);
     }
 }
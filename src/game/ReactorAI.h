@@ -33,6 +33,7 @@ class ReactorAI : public CreatureAI
         void MoveInLineOfSight(Unit *);
 
         void UpdateAI(const uint32);
+        uint32 GetIdleTime() const { return AI_IDLE_FOREVER; }
         static int Permissible(const Creature *);
 };
 #endif
@@ -179,9 +179,9 @@ Creature* ScriptedAI::DoSpawnCreature(uint32 uiId, float fX, float fY, float fZ,
 Unit* ScriptedAI::SelectUnit(SelectAggroTarget pTarget, uint32 uiPosition)
 {
     //ThreatList m_threatlist;
-    std::list<HostileReference*>& threatlist = me->getThreatManager().getThreatList();
-    std::list<HostileReference*>::iterator itr = threatlist.begin();
-    std::list<HostileReference*>::reverse_iterator ritr = threatlist.rbegin();
+    ThreatList& threatlist = me->getThreatManager().getThreatList();
+    ThreatList::iterator itr = threatlist.begin();
+    ThreatList::reverse_iterator ritr = threatlist.rbegin();
 
     if (uiPosition >= threatlist.size() || !threatlist.size())
         return NULL;
@@ -413,11 +413,11 @@ void ScriptedAI::DoResetThreat()
         return;
     }
 
-    std::list<HostileReference*>& threatlist = me->getThreatManager().getThreatList();
+    ThreatList& threatlist = me->getThreatManager().getThreatList();
 
-    for (std::list<HostileReference*>::iterator itr = threatlist.begin(); itr != threatlist.end(); ++itr)
+    for (size_t i = 0; i < threatlist.size(); ++i)
     {
-        Unit* pUnit = Unit::GetUnit((*me), (*itr)->getUnitGuid());
+        Unit* pUnit = Unit::GetUnit((*me), threatlist[i]->getUnitGuid());
 
         if (pUnit && DoGetThreat(pUnit))
             DoModifyThreatPercent(pUnit, -100);
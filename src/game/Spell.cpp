@@ -697,12 +697,12 @@ void Spell::CleanupTargetList()
     m_delayMoment = 0;
 }
 
-void Spell::AddUnitTarget(Unit* pVictim, uint32 effIndex)
+void Spell::AddUnitTarget(Unit* pVictim, uint32 effIndex, bool checkLOS)
 {
     if (m_spellInfo->Effect[effIndex] == 0)
         return;
 
-    if (!CheckTarget(pVictim, effIndex))
+    if (!CheckTarget(pVictim, effIndex, checkLOS))
         return;
 
     // Check for effect immune skip if immuned
@@ -1421,6 +1421,62 @@ void Spell::SearchAreaTarget(std::list<Unit*> &TagUnitMap, float radius, const u
         m_caster->GetMap()->VisitAll(pos->m_positionX, pos->m_positionY, radius, notifier);
 }
 
+bool Spell::RemoveTargetsOutOfLOS(std::list<Unit*> &unitList, uint32 effIndex)
+{
+    // the same cases as CheckTarget
+    if (m_IsTriggeredSpell)
+        return false;
+
+    switch(m_spellInfo->Effect[effIndex])
+    {
+        case SPELL_EFFECT_SUMMON_PLAYER:
+        case SPELL_EFFECT_RESURRECT_NEW:
+            return false;
+        case SPELL_EFFECT_DUMMY:
+            if (m_spellInfo->Id == 20577)
+                return false;
+            break;
+    }
+
+    std::vector<Unit*> targets;
+    std::vector<float> x, y, z;
+    for (std::list<Unit*>::const_iterator itr = unitList.begin(); itr != unitList.end(); ++itr)
+    {
+        if (*itr == m_caster)
+            continue;
+
+        targets.push_back(*itr);
+        x.push_back((*itr)->GetPositionX());
+        y.push_back((*itr)->GetPositionY());
+        z.push_back((*itr)->GetPositionZ() + 2.0f);
+    }
+
+    if (targets.empty())
+        return true;
+
+    // rays from the caster to the targets, as WorldObject::IsWithinLOS with the ends swapped
+    bool* inLOS = new bool[targets.size()];
+    VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSightBatch(m_caster->GetMapId(),
+        m_caster->GetPositionX(), m_caster->GetPositionY(), m_caster->GetPositionZ() + 2.0f,
+        &x[0], &y[0], &z[0], inLOS, targets.size());
+
+    std::set<Unit*> outOfLOS;
+    for (size_t i = 0; i < targets.size(); ++i)
+        if (!inLOS[i])
+            outOfLOS.insert(targets[i]);
+    delete[] inLOS;
+
+    for (std::list<Unit*>::iterator itr = unitList.begin(); itr != unitList.end();)
+    {
+        if (outOfLOS.find(*itr) != outOfLOS.end())
+            itr = unitList.erase(itr);
+        else
+            ++itr;
+    }
+
+    return true;
+}
+
 WorldObject* Spell::SearchNearbyTarget(float range, SpellTargets TargetType)
 {
     switch(TargetType)
@@ -2033,8 +2089,9 @@ void Spell::SetTargetMap(uint32 i, uint32 cur)
             }else if (m_spellInfo->Id == 27285) // Seed of Corruption proc spell
                 unitList.remove(m_targets.getUnitTarget());
 
+            bool checkLOS = !RemoveTargetsOutOfLOS(unitList, i);
             for (std::list<Unit*>::iterator itr = unitList.begin(); itr != unitList.end(); ++itr)
-                AddUnitTarget(*itr, i);
+                AddUnitTarget(*itr, i, checkLOS);
         }
     }
 }
@@ -5142,7 +5199,7 @@ CurrentSpellTypes Spell::GetCurrentContainer()
         return(CURRENT_GENERIC_SPELL);
 }
 
-bool Spell::CheckTarget(Unit* target, uint32 eff)
+bool Spell::CheckTarget(Unit* target, uint32 eff, bool checkLOS)
 {
     // Check targets for creature type mask and remove not appropriate (skip explicit self target case, maybe need other explicit targets)
     if (m_spellInfo->EffectImplicitTargetA[eff] != TARGET_UNIT_CASTER)
@@ -5211,7 +5268,7 @@ bool Spell::CheckTarget(Unit* target, uint32 eff)
             // all ok by some way or another, skip normal check
             break;
         default:                                            // normal case
-            if (target != m_caster && !target->IsWithinLOSInMap(m_caster))
+            if (checkLOS && target != m_caster && !target->IsWithinLOSInMap(m_caster))
                 return false;
             break;
     }
@@ -392,7 +392,7 @@ class Spell
 
         Unit* SelectMagnetTarget();
         void HandleHitTriggerAura();
-        bool CheckTarget(Unit* target, uint32 eff);
+        bool CheckTarget(Unit* target, uint32 eff, bool checkLOS = true);
 
         void CheckSrc() { if (!m_targets.HasSrc()) m_targets.setSrc(m_caster); }
         void CheckDst() { if (!m_targets.HasDst()) m_targets.setDst(m_caster); }
@@ -565,7 +565,7 @@ class Spell
         };
         std::list<ItemTargetInfo> m_UniqueItemInfo;
 
-        void AddUnitTarget(Unit* target, uint32 effIndex);
+        void AddUnitTarget(Unit* target, uint32 effIndex, bool checkLOS = true);
         void AddUnitTarget(uint64 unitGUID, uint32 effIndex);
         void AddGOTarget(GameObject* target, uint32 effIndex);
         void AddGOTarget(uint64 goGUID, uint32 effIndex);
@@ -576,6 +576,8 @@ class Spell
         void DoAllEffectOnTarget(ItemTargetInfo *target);
         bool IsAliveUnitPresentInTargetList();
         void SearchAreaTarget(std::list<Unit*> &unitList, float radius, const uint32 type, SpellTargets TargetType, uint32 entry = 0);
+        // the line of sight of all area targets at once, false if the effect does not check it this way
+        bool RemoveTargetsOutOfLOS(std::list<Unit*> &unitList, uint32 effIndex);
         void SearchChainTarget(std::list<Unit*> &unitList, float radius, uint32 unMaxTargets, SpellTargets TargetType);
         WorldObject* SearchNearbyTarget(float range, SpellTargets TargetType);
         bool IsValidSingleTargetEffect(Unit const* target, Targets type) const;
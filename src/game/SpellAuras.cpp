@@ -679,14 +679,14 @@ void AreaAura::Update(uint32 diff)
                 {
                     Oregon::AnyFriendlyUnitInObjectRangeCheck u_check(caster, caster, m_radius);
                     Oregon::UnitListSearcher<Oregon::AnyFriendlyUnitInObjectRangeCheck> searcher(targets, u_check);
-                    caster->VisitNearbyObject(m_radius, searcher);
+                    caster->VisitNearbyObjectInRange(m_radius, TYPEMASK_UNIT, searcher);
                     break;
                 }
                 case AREA_AURA_ENEMY:
                 {
                     Oregon::AnyAoETargetUnitInObjectRangeCheck u_check(caster, caster, m_radius); // No GetCharmer in searcher
                     Oregon::UnitListSearcher<Oregon::AnyAoETargetUnitInObjectRangeCheck> searcher(targets, u_check);
-                    caster->VisitNearbyObject(m_radius, searcher);
+                    caster->VisitNearbyObjectInRange(m_radius, TYPEMASK_UNIT, searcher);
                     break;
                 }
                 case AREA_AURA_OWNER:
@@ -3196,7 +3196,7 @@ void Aura::HandleFeignDeath(bool apply, bool Real)
         std::list<Unit*> targets;
         Oregon::AnyUnfriendlyUnitInObjectRangeCheck u_check(m_target, m_target, m_target->GetMap()->GetVisibilityDistance());
         Oregon::UnitListSearcher<Oregon::AnyUnfriendlyUnitInObjectRangeCheck> searcher(targets, u_check);
-        m_target->VisitNearbyObject(m_target->GetMap()->GetVisibilityDistance(), searcher);
+        m_target->VisitNearbyObjectInRange(m_target->GetMap()->GetVisibilityDistance(), TYPEMASK_UNIT, searcher);
         for (std::list<Unit*>::iterator iter = targets.begin(); iter != targets.end(); ++iter)
         {
             if (!(*iter)->hasUnitState(UNIT_STAT_CASTING))
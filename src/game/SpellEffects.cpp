@@ -5285,7 +5285,7 @@ void Spell::EffectSanctuary(uint32 /*i*/)
     std::list<Unit*> targets;
     Oregon::AnyUnfriendlyUnitInObjectRangeCheck u_check(unitTarget, unitTarget, m_caster->GetMap()->GetVisibilityDistance());
     Oregon::UnitListSearcher<Oregon::AnyUnfriendlyUnitInObjectRangeCheck> searcher(targets, u_check);
-    unitTarget->VisitNearbyObject(m_caster->GetMap()->GetVisibilityDistance(), searcher);
+    unitTarget->VisitNearbyObjectInRange(m_caster->GetMap()->GetVisibilityDistance(), TYPEMASK_UNIT, searcher);
     for (std::list<Unit*>::iterator iter = targets.begin(); iter != targets.end(); ++iter)
     {
         if (!(*iter)->hasUnitState(UNIT_STAT_CASTING))
@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Common.h"
+#include "StartupLoader.h"
+#include "DelayExecutor.h"
+#include "Database/DatabaseEnv.h"
+#include "ProgressBar.h"
+#include "Timer.h"
+#include "Log.h"
+
+#include <ace/Guard_T.h>
+#include <ace/Method_Request.h>
+
+#include <algorithm>
+#include <sstream>
+
+#if PLATFORM == PLATFORM_UNIX
+#include <stdio.h>
+#include <unistd.h>
+#endif
+
+// resident size of the process in bytes, 0 where it is not known
+static size_t GetProcessMemory()
+{
+#if PLATFORM == PLATFORM_UNIX
+    unsigned long size = 0, resident = 0;
+    if (FILE* file = fopen("/proc/self/statm", "r"))
+    {
+        if (fscanf(file, "%lu %lu", &size, &resident) != 2)
+            resident = 0;
+        fclose(file);
+    }
+    return size_t(resident) * size_t(sysconf(_SC_PAGESIZE));
+#else
+    return 0;
+#endif
+}
+
+static void SplitResources(char const* list, std::vector<std::string>& resources)
+{
+    std::istringstream stream(list);
+    std::string name;
+    while (stream >> name)
+        resources.push_back(name);
+}
+
+static bool SharesResource(std::vector<std::string> const& a, std::vector<std::string> const& b)
+{
+    for (std::vector<std::string>::const_iterator itr = a.begin(); itr != a.end(); ++itr)
+        if (std::find(b.begin(), b.end(), *itr) != b.end())
+            return true;
+    return false;
+}
+
+// the loaders query both databases from the worker threads
+class StartupThreadStartReq : public ACE_Method_Request
+{
+    public:
+        virtual int call()
+        {
+            WorldDatabase.ThreadStart();
+            CharacterDatabase.ThreadStart();
+            return 0;
+        }
+};
+
+class StartupThreadEndReq : public ACE_Method_Request
+{
+    public:
+        virtual int call()
+        {
+            WorldDatabase.ThreadEnd();
+            CharacterDatabase.ThreadEnd();
+            return 0;
+        }
+};
+
+class StartupTaskRequest : public ACE_Method_Request
+{
+    public:
+        StartupTaskRequest(StartupLoader& loader, size_t index) : m_loader(loader), m_index(index) {}
+
+        virtual int call()
+        {
+            m_loader.RunTask(m_index);
+            m_loader.TaskFinished(m_index);
+            return 0;
+        }
+
+    private:
+        StartupLoader& m_loader;
+        size_t m_index;
+};
+
+StartupTask::StartupTask(char const* _title, char const* _reads, char const* _writes)
+    : title(_title), waiting(0), startTime(0), endTime(0), memory(0)
+{
+    SplitResources(_reads, reads);
+    SplitResources(_writes, writes);
+}
+
+StartupLoader::StartupLoader() : m_startTime(0), m_executor(NULL), m_finished(0), m_condition(m_mutex)
+{
+}
+
+StartupLoader::~StartupLoader()
+{
+    for (std::vector<StartupTask*>::iterator itr = m_tasks.begin(); itr != m_tasks.end(); ++itr)
+        delete *itr;
+}
+
+void StartupLoader::LinkTasks()
+{
+    for (size_t i = 0; i < m_tasks.size(); ++i)
+    {
+        StartupTask* task = m_tasks[i];
+        for (size_t j = 0; j < i; ++j)
+        {
+            StartupTask* earlier = m_tasks[j];
+            if (SharesResource(earlier->writes, task->reads) || SharesResource(earlier->writes, task->writes) ||
+                SharesResource(earlier->reads, task->writes))
+            {
+                task->dependencies.push_back(j);
+                earlier->dependents.push_back(i);
+            }
+        }
+        task->waiting = task->dependencies.size();
+    }
+}
+
+void StartupLoader::Run(uint32 threads)
+{
+    LinkTasks();
+
+    m_startTime = getMSTime();
+
+    if (threads <= 1)
+    {
+        for (size_t i = 0; i < m_tasks.size(); ++i)
+            RunTask(i);
+    }
+    else
+    {
+        barGoLink::SetHidden(true);
+
+        DelayExecutor executor;
+        m_executor = &executor;
+        executor.activate(int(threads), new StartupThreadStartReq, new StartupThreadEndReq);
+
+        {
+            ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+
+            for (size_t i = 0; i < m_tasks.size(); ++i)
+                if (!m_tasks[i]->waiting)
+                    executor.execute(new StartupTaskRequest(*this, i));
+
+            while (m_finished < m_tasks.size())
+                m_condition.wait();
+        }
+
+        executor.deactivate();
+        m_executor = NULL;
+
+        barGoLink::SetHidden(false);
+    }
+
+    Report(threads);
+}
+
+void StartupLoader::RunTask(size_t index)
+{
+    StartupTask* task = m_tasks[index];
+
+    sLog.outString("%s", task->title.c_str());
+
+    size_t memory = GetProcessMemory();
+    task->startTime = getMSTimeDiff(m_startTime, getMSTime());
+
+    task->Run();
+
+    task->endTime = getMSTimeDiff(m_startTime, getMSTime());
+    task->memory = int64(GetProcessMemory()) - int64(memory);
+}
+
+void StartupLoader::TaskFinished(size_t index)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+
+    std::vector<size_t> const& dependents = m_tasks[index]->dependents;
+    for (std::vector<size_t>::const_iterator itr = dependents.begin(); itr != dependents.end(); ++itr)
+        if (--m_tasks[*itr]->waiting == 0)
+            m_executor->execute(new StartupTaskRequest(*this, *itr));
+
+    if (++m_finished == m_tasks.size())
+        m_condition.signal();
+}
+
+void StartupLoader::Report(uint32 threads) const
+{
+    if (m_tasks.empty())
+        return;
+
+    // the longest chain of dependent tasks by their own times, the loading
+    // takes at least as long whatever the number of threads
+    std::vector<uint32> chainTime(m_tasks.size());
+    std::vector<size_t> chainPrev(m_tasks.size());
+    size_t last = 0;
+    uint32 totalTime = 0;
+    for (size_t i = 0; i < m_tasks.size(); ++i)
+    {
+        StartupTask const* task = m_tasks[i];
+        uint32 before = 0;
+        chainPrev[i] = i;
+        for (std::vector<size_t>::const_iterator itr = task->dependencies.begin(); itr != task->dependencies.end(); ++itr)
+        {
+            if (chainTime[*itr] >= before)
+            {
+                before = chainTime[*itr];
+                chainPrev[i] = *itr;
+            }
+        }
+
+        chainTime[i] = before + (task->endTime - task->startTime);
+        if (chainTime[i] >= chainTime[last])
+            last = i;
+
+        totalTime = std::max(totalTime, task->endTime);
+    }
+
+    std::vector<size_t> path;
+    for (size_t i = last; ; i = chainPrev[i])
+    {
+        path.push_back(i);
+        if (chainPrev[i] == i)
+            break;
+    }
+
+    sLog.outString();
+    sLog.outString(">>> Loaded " SIZEFMTD " startup tasks in %u ms with %u threads, critical path %u ms:",
+        m_tasks.size(), totalTime, std::max(threads, uint32(1)), chainTime[last]);
+    for (std::vector<size_t>::const_reverse_iterator itr = path.rbegin(); itr != path.rend(); ++itr)
+    {
+        StartupTask const* task = m_tasks[*itr];
+        sLog.outString("    %6u ms %8.1f MB  %s", task->endTime - task->startTime, task->memory / 1048576.0, task->title.c_str());
+    }
+
+    // memory is the growth of the process, tasks running at the same time share it
+    sLog.outDetail("Startup tasks (start, time, memory):");
+    for (size_t i = 0; i < m_tasks.size(); ++i)
+    {
+        StartupTask const* task = m_tasks[i];
+        sLog.outDetail("    %6u ms %6u ms %8.1f MB  %s", task->startTime, task->endTime - task->startTime,
+            task->memory / 1048576.0, task->title.c_str());
+    }
+    sLog.outString();
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __STARTUPLOADER_H
+#define __STARTUPLOADER_H
+
+#include "Platform/Define.h"
+
+#include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+
+#include <string>
+#include <vector>
+
+class DelayExecutor;
+
+// One loader of the world startup. Reads and writes name the data it uses,
+// space separated, usually after the table ("creature_template item_template").
+class StartupTask
+{
+    public:
+        StartupTask(char const* title, char const* reads, char const* writes);
+        virtual ~StartupTask() {}
+
+        virtual void Run() = 0;
+
+        std::string title;
+        std::vector<std::string> reads;
+        std::vector<std::string> writes;
+
+        std::vector<size_t> dependencies;                   // earlier tasks sharing data with this one
+        std::vector<size_t> dependents;
+        size_t waiting;                                     // dependencies not finished yet
+
+        uint32 startTime;                                   // ms since the start of the loading
+        uint32 endTime;
+        int64 memory;                                       // growth of the process while it ran
+};
+
+template<class T, class R>
+class StartupMethodTask : public StartupTask
+{
+    public:
+        StartupMethodTask(char const* title, T& object, R (T::*method)(), char const* reads, char const* writes)
+            : StartupTask(title, reads, writes), m_object(object), m_method(method) {}
+
+        void Run() { (m_object.*m_method)(); }
+
+    private:
+        T& m_object;
+        R (T::*m_method)();
+};
+
+class StartupFunctionTask : public StartupTask
+{
+    public:
+        StartupFunctionTask(char const* title, void (*function)(), char const* reads, char const* writes)
+            : StartupTask(title, reads, writes), m_function(function) {}
+
+        void Run() { m_function(); }
+
+    private:
+        void (*m_function)();
+};
+
+// The loaders of the world startup as a graph. A task waits for the earlier
+// tasks that write data it reads or writes and for those that read data it
+// writes, so the result is the same as running them one after another in the
+// order they were added. Independent tasks run side by side, each query takes
+// a free connection of the database pool.
+class StartupLoader
+{
+    public:
+        StartupLoader();
+        ~StartupLoader();
+
+        template<class T, class R>
+        void Add(char const* title, T& object, R (T::*method)(), char const* reads = "", char const* writes = "")
+        {
+            m_tasks.push_back(new StartupMethodTask<T, R>(title, object, method, reads, writes));
+        }
+
+        void Add(char const* title, void (*function)(), char const* reads = "", char const* writes = "")
+        {
+            m_tasks.push_back(new StartupFunctionTask(title, function, reads, writes));
+        }
+
+        // runs all tasks with up to threads loaders at once, 1 runs them in order
+        // on the calling thread, and reports the times and the critical path
+        void Run(uint32 threads);
+
+        // called by the worker threads
+        void RunTask(size_t index);
+        void TaskFinished(size_t index);
+
+    private:
+        void LinkTasks();
+        void Report(uint32 threads) const;
+
+        std::vector<StartupTask*> m_tasks;
+        uint32 m_startTime;
+
+        DelayExecutor* m_executor;
+        size_t m_finished;
+        ACE_Thread_Mutex m_mutex;
+        ACE_Condition_Thread_Mutex m_condition;
+};
+#endif
@@ -116,7 +116,7 @@ bool TargetedMovementGenerator<T>::_setTargetLocation(T &owner)
         if (i_destinationHolder.HasDestination() && i_destinationHolder.GetDestinationDiff(x,y,z) < bothObjectSize)
             return;
     */
-    i_destinationHolder.SetDestination(traveller, x, y, z);
+    i_destinationHolder.SetPathDestination(traveller, x, y, z);
     owner.addUnitState(UNIT_STAT_CHASE);
     if (owner.GetTypeId() == TYPEID_UNIT && (&owner)->ToCreature()->canFly())
         owner.AddUnitMovementFlag(MOVEFLAG_FLYING2);
@@ -203,7 +203,8 @@ Unit* HostileReference::getSourceUnit()
 
 void ThreatContainer::clearReferences()
 {
-    for (std::list<HostileReference*>::iterator i = iThreatList.begin(); i != iThreatList.end(); ++i)
+    ThreatList& refs = iThreatList.refs();
+    for (ThreatList::iterator i = refs.begin(); i != refs.end(); ++i)
     {
         (*i)->unlink();
         delete (*i);
@@ -215,18 +216,7 @@ void ThreatContainer::clearReferences()
 // Return the HostileReference of NULL, if not found
 HostileReference* ThreatContainer::getReferenceByTarget(Unit* pVictim)
 {
-    HostileReference* result = NULL;
-    uint64 guid = pVictim->GetGUID();
-    for (std::list<HostileReference*>::iterator i = iThreatList.begin(); i != iThreatList.end(); ++i)
-    {
-        if ((*i)->getUnitGuid() == guid)
-        {
-            result = (*i);
-            break;
-        }
-    }
-
-    return result;
+    return iThreatList.find(pVictim->GetGUID());
 }
 
 //============================================================
@@ -248,23 +238,13 @@ void ThreatContainer::modifyThreatPercent(Unit *pVictim, int32 pPercent)
         ref->addThreatPercent(pPercent);
 }
 
-//============================================================
-
-bool HostileReferenceSortPredicate(const HostileReference* lhs, const HostileReference* rhs)
-{
-    // std::list::sort ordering predicate must be: (Pred(x,y)&&Pred(y,x)) == false
-    return lhs->getThreat() > rhs->getThreat();             // reverse sorting
-}
-
 //============================================================
 // Check if the list is dirty and sort if necessary
 
 void ThreatContainer::update()
 {
-    if (iDirty && iThreatList.size() >1)
-    {
-        iThreatList.sort(HostileReferenceSortPredicate);
-    }
+    if (iDirty && iThreatList.refs().size() > 1)
+        iThreatList.sort();
     iDirty = false;
 }
 
@@ -277,10 +257,14 @@ HostileReference* ThreatContainer::selectNextVictim(Creature* pAttacker, Hostile
     HostileReference* currentRef = NULL;
     bool found = false;
 
-    std::list<HostileReference*>::iterator lastRef = iThreatList.end();
+    ThreatList& refs = iThreatList.refs();
+    if (refs.empty())
+        return NULL;
+
+    ThreatList::iterator lastRef = refs.end();
     lastRef--;
 
-    for (std::list<HostileReference*>::iterator iter = iThreatList.begin(); iter != iThreatList.end() && !found; ++iter)
+    for (ThreatList::iterator iter = refs.begin(); iter != refs.end() && !found; ++iter)
     {
         currentRef = (*iter);
 
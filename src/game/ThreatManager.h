@@ -25,7 +25,8 @@
 #include "Utilities/LinkedReference/Reference.h"
 #include "UnitEvents.h"
 
-#include <list>
+#include <algorithm>
+#include <vector>
 
 //==============================================================
 
@@ -125,19 +126,99 @@ class HostileReference : public Reference<Unit, ThreatManager>
         bool iAccessible;
 };
 
+//==============================================================
+// References kept contiguous, sorted by threat on request and indexed by
+// the guid of the target. Moves between tables don't allocate once the
+// vectors have grown to the size of the fight. REF needs getThreat() and
+// getUnitGuid(), the table is also used by .debug threatbench.
+
+template<class REF>
+class ThreatTable
+{
+    public:
+        typedef std::vector<REF*> RefList;
+
+        RefList& refs() { return iRefs; }
+
+        void add(REF* pRef)
+        {
+            iRefs.push_back(pRef);
+            iIndex.insert(std::lower_bound(iIndex.begin(), iIndex.end(), GuidEntry(pRef->getUnitGuid(), NULL)), GuidEntry(pRef->getUnitGuid(), pRef));
+        }
+
+        void remove(REF* pRef)
+        {
+            typename RefList::iterator itr = std::find(iRefs.begin(), iRefs.end(), pRef);
+            if (itr == iRefs.end())
+                return;
+            iRefs.erase(itr);
+
+            typename GuidIndex::iterator entry = std::lower_bound(iIndex.begin(), iIndex.end(), GuidEntry(pRef->getUnitGuid(), NULL));
+            while (entry != iIndex.end() && entry->ref != pRef)
+                ++entry;
+            if (entry != iIndex.end())
+                iIndex.erase(entry);
+        }
+
+        void clear()
+        {
+            iRefs.clear();
+            iIndex.clear();
+        }
+
+        REF* find(uint64 guid) const
+        {
+            typename GuidIndex::const_iterator entry = std::lower_bound(iIndex.begin(), iIndex.end(), GuidEntry(guid, NULL));
+            return entry != iIndex.end() && entry->guid == guid ? entry->ref : NULL;
+        }
+
+        // stable like the std::list::sort it replaces, a table with a few
+        // changed threats is sorted in about one pass
+        void sort()
+        {
+            for (size_t i = 1; i < iRefs.size(); ++i)
+            {
+                REF* pRef = iRefs[i];
+                float threat = pRef->getThreat();
+                size_t j = i;
+                for (; j > 0 && iRefs[j - 1]->getThreat() < threat; --j)
+                    iRefs[j] = iRefs[j - 1];
+                iRefs[j] = pRef;
+            }
+        }
+
+    private:
+        struct GuidEntry
+        {
+            GuidEntry(uint64 pGuid, REF* pRef) : guid(pGuid), ref(pRef) {}
+            bool operator<(GuidEntry const& other) const { return guid < other.guid; }
+
+            uint64 guid;
+            REF* ref;
+        };
+        typedef std::vector<GuidEntry> GuidIndex;
+
+        RefList iRefs;
+        GuidIndex iIndex;
+};
+
+// Adding threat can add references, for the owner of a pet, and push into the
+// vector. Loops changing threat walk it by index and read the size each pass.
+typedef ThreatTable<HostileReference>::RefList ThreatList;
+
 //==============================================================
 class ThreatManager;
 
 class ThreatContainer
 {
     private:
-        std::list<HostileReference*> iThreatList;
+        ThreatTable<HostileReference> iThreatList;
         bool iDirty;
     protected:
         friend class ThreatManager;
 
         void remove(HostileReference* pRef) { iThreatList.remove(pRef); }
-        void addReference(HostileReference* pHostileReference) { iThreatList.push_back(pHostileReference); }
+        void addReference(HostileReference* pHostileReference) { iThreatList.add(pHostileReference); }
         void clearReferences();
         // Sort the list if necessary
         void update();
@@ -155,13 +236,13 @@ class ThreatContainer
 
         bool isDirty() { return iDirty; }
 
-        bool empty() { return(iThreatList.empty()); }
+        bool empty() { return(iThreatList.refs().empty()); }
 
-        HostileReference* getMostHated() { return iThreatList.empty() ? NULL : iThreatList.front(); }
+        HostileReference* getMostHated() { return iThreatList.refs().empty() ? NULL : iThreatList.refs().front(); }
 
         HostileReference* getReferenceByTarget(Unit* pVictim);
 
-        std::list<HostileReference*>& getThreatList() { return iThreatList; }
+        ThreatList& getThreatList() { return iThreatList.refs(); }
 };
 
 //=================================================
@@ -201,8 +282,8 @@ class ThreatManager
 
         // methods to access the lists from the outside to do sume dirty manipulation (scriping and such)
         // I hope they are used as little as possible.
-        inline std::list<HostileReference*>& getThreatList() { return iThreatContainer.getThreatList(); }
-        inline std::list<HostileReference*>& getOfflieThreatList() { return iThreatOfflineContainer.getThreatList(); }
+        inline ThreatList& getThreatList() { return iThreatContainer.getThreatList(); }
+        inline ThreatList& getOfflieThreatList() { return iThreatOfflineContainer.getThreatList(); }
         inline ThreatContainer& getOnlineContainer() { return iThreatContainer; }
         inline ThreatContainer& getOfflineContainer() { return iThreatOfflineContainer; }
 
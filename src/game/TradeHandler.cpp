@@ -408,7 +408,9 @@ void WorldSession::HandleAcceptTradeOpcode(WorldPacket& recvPacket)
         _player->ClearTrade();
         _player->pTrader->ClearTrade();
 
-        // desynchronized with the other saves here (SaveInventoryAndGoldToDB() not have own transaction guards)
+        // desynchronized with the other saves here (SaveInventoryAndGoldToDB() not have own transaction guards),
+        // in order with the saves of both players as the items change owner
+        SqlAsyncKeyGuard asyncKey(CharacterDatabase, SQL_ASYNC_KEY_ALL);
         CharacterDatabase.BeginTransaction();
         _player->SaveInventoryAndGoldToDB();
         _player->pTrader->SaveInventoryAndGoldToDB();
@@ -24,6 +24,7 @@
 #include "Player.h"
 #include <cassert>
 #include "CreatureGroups.h"
+#include "MoveMap.h"
 
 /** Traveller is a wrapper for units (creatures or players) that
  * travel from point A to point B using the destination holder.
@@ -54,6 +55,9 @@ struct Traveller
     float Speed(void) { assert(false); return 0.0f; }
     float GetMoveDestinationTo(float x, float y, float z);
     uint32 GetTotalTrevelTimeTo(float x, float y, float z);
+    uint32 GetTravelTime(float dist);
+    // a walkable way to the point, false if it must be travelled straight
+    bool GetPath(float /*x*/, float /*y*/, float /*z*/, Path& /*path*/) { return false; }
 
     void Relocation(float x, float y, float z, float orientation) {}
     void Relocation(float x, float y, float z) { Relocation(x, y, z, i_traveller.GetOrientation()); }
@@ -63,7 +67,12 @@ struct Traveller
 template<class T>
 inline uint32 Traveller<T>::GetTotalTrevelTimeTo(float x, float y, float z)
 {
-    float dist = GetMoveDestinationTo(x,y,z);
+    return GetTravelTime(GetMoveDestinationTo(x,y,z));
+}
+
+template<class T>
+inline uint32 Traveller<T>::GetTravelTime(float dist)
+{
     float speed = Speed();;
     if (speed <= 0.0f)
         return 0xfffffffe;  // almost infinity-unit should stop
@@ -111,6 +120,16 @@ inline void Traveller<Creature>::MoveTo(float x, float y, float z, uint32 t)
     i_traveller.AI_SendMoveToPacket(x, y, z, t, i_traveller.GetUnitMovementFlags(), 0);
 }
 
+template<>
+inline bool Traveller<Creature>::GetPath(float x, float y, float z, Path &path)
+{
+    // flying and swimming creatures are not bound to the ground
+    if (i_traveller.canFly() || i_traveller.IsInWater())
+        return false;
+
+    return sMoveMapMgr.FindPath(i_traveller.GetMapId(), GetPositionX(), GetPositionY(), GetPositionZ(), x, y, z, path) != NAV_PATH_NO_MESH;
+}
+
 // specialization for players
 template<>
 inline float Traveller<Player>::Speed()
@@ -3446,6 +3446,10 @@ bool Unit::AddAura(Aura *Aur)
         return false;
     }
 
+    // a sleeping creature has to tick the aura, see Creature::IsIdle
+    if (GetTypeId() == TYPEID_UNIT)
+        ToCreature()->WakeUp();
+
     SpellEntry const* aurSpellInfo = Aur->GetSpellProto();
 
     spellEffectPair spair = spellEffectPair(Aur->GetId(), Aur->GetEffIndex());
@@ -6740,6 +6744,9 @@ bool Unit::Attack(Unit *victim, bool meleeAttack)
             return false;
     }
 
+    if (GetTypeId() == TYPEID_UNIT)
+        ToCreature()->WakeUp();
+
     // remove SPELL_AURA_MOD_UNATTACKABLE at attack (in case non-interruptible spells stun aura applied also that not let attack)
     if (HasAuraType(SPELL_AURA_MOD_UNATTACKABLE))
         RemoveSpellsCausingAura(SPELL_AURA_MOD_UNATTACKABLE);
@@ -8592,6 +8599,9 @@ void Unit::SetInCombatState(bool PvP, Unit* enemy)
     if (isInCombat())
         return;
 
+    if (GetTypeId() == TYPEID_UNIT)
+        ToCreature()->WakeUp();
+
     SetFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_IN_COMBAT);
 
     if (GetTypeId() == TYPEID_PLAYER)
@@ -9817,6 +9827,10 @@ void Unit::SetHealth(uint32 val)
 
     SetUInt32Value(UNIT_FIELD_HEALTH, val);
 
+    // regeneration is done by the creature update
+    if (GetTypeId() == TYPEID_UNIT)
+        ToCreature()->WakeUp();
+
     // group update
     if (GetTypeId() == TYPEID_PLAYER)
     {
@@ -9840,6 +9854,9 @@ void Unit::SetMaxHealth(uint32 val)
     uint32 health = GetHealth();
     SetUInt32Value(UNIT_FIELD_MAXHEALTH, val);
 
+    if (GetTypeId() == TYPEID_UNIT)
+        ToCreature()->WakeUp();
+
     // group update
     if (GetTypeId() == TYPEID_PLAYER)
     {
@@ -9872,6 +9889,9 @@ void Unit::SetPower(Powers power, uint32 val)
 
     SetStatInt32Value(UNIT_FIELD_POWER1 + power, val);
 
+    if (GetTypeId() == TYPEID_UNIT)
+        ToCreature()->WakeUp();
+
     // group update
     if (GetTypeId() == TYPEID_PLAYER)
     {
@@ -9899,6 +9919,9 @@ void Unit::SetMaxPower(Powers power, uint32 val)
     uint32 cur_power = GetPower(power);
     SetStatInt32Value(UNIT_FIELD_MAXPOWER1 + power, val);
 
+    if (GetTypeId() == TYPEID_UNIT)
+        ToCreature()->WakeUp();
+
     // group update
     if (GetTypeId() == TYPEID_PLAYER)
     {
@@ -11055,7 +11078,7 @@ Unit* Unit::SelectNearbyTarget(float dist) const
     std::list<Unit *> targets;
     Oregon::AnyUnfriendlyUnitInObjectRangeCheck u_check(this, this, dist);
     Oregon::UnitListSearcher<Oregon::AnyUnfriendlyUnitInObjectRangeCheck> searcher(targets, u_check);
-    VisitNearbyObject(dist, searcher);
+    VisitNearbyObjectInRange(dist, TYPEMASK_UNIT, searcher);
 
     // remove current target
     if (getVictim())
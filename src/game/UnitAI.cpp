@@ -119,10 +119,10 @@ struct TargetDistanceOrder : public std::binary_function<const Unit *, const Uni
 
 Unit* UnitAI::SelectTarget(SelectAggroTarget targetType, uint32 position, float dist, bool playerOnly, int32 aura)
 {
-    const std::list<HostileReference *> &threatlist = me->getThreatManager().getThreatList();
+    const ThreatList &threatlist = me->getThreatManager().getThreatList();
     std::list<Unit*> targetList;
 
-    for (std::list<HostileReference*>::const_iterator itr = threatlist.begin(); itr != threatlist.end(); ++itr)
+    for (ThreatList::const_iterator itr = threatlist.begin(); itr != threatlist.end(); ++itr)
         if (SelectTargetHelper(me, (*itr)->getTarget(), playerOnly, dist, aura))
             targetList.push_back((*itr)->getTarget());
  
@@ -166,11 +166,11 @@ Unit* UnitAI::SelectTarget(SelectAggroTarget targetType, uint32 position, float
 
 void UnitAI::SelectTargetList(std::list<Unit*> &targetList, uint32 num, SelectAggroTarget targetType, float dist, bool playerOnly, int32 aura)
 {
-    const std::list<HostileReference*> &threatlist = me->getThreatManager().getThreatList();
+    const ThreatList &threatlist = me->getThreatManager().getThreatList();
     if (threatlist.empty())
         return;
 
-    for (std::list<HostileReference*>::const_iterator itr = threatlist.begin(); itr != threatlist.end(); ++itr)
+    for (ThreatList::const_iterator itr = threatlist.begin(); itr != threatlist.end(); ++itr)
         if (SelectTargetHelper(me, (*itr)->getTarget(), playerOnly, dist, aura))
             targetList.push_back((*itr)->getTarget());
 
@@ -26,10 +26,155 @@
 #include "World.h"
 #include "zlib.h"
 
+#include <ace/TSS_T.h>
+#include <ace/Guard_T.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/High_Res_Timer.h>
+
+volatile int UpdateData::m_compressionLevel = Z_BEST_SPEED;
+volatile uint32 UpdateData::m_compressionThreshold = 100;
+
+// One deflate stream per thread, reset between packets instead of allocating
+// and freeing the zlib state for every compressed update packet.
+class UpdateDataDeflateStream
+{
+    public:
+        UpdateDataDeflateStream() : m_level(-1)
+        {
+            memset(&m_stream, 0, sizeof(m_stream));
+
+            ACE_GUARD(ACE_Thread_Mutex, guard, m_registryLock);
+            m_registry.insert(this);
+        }
+
+        ~UpdateDataDeflateStream()
+        {
+            if (m_level >= 0)
+                deflateEnd(&m_stream);
+
+            ACE_GUARD(ACE_Thread_Mutex, guard, m_registryLock);
+            m_registry.erase(this);
+            AddStats(m_finishedStats, m_stats);
+        }
+
+        z_stream* Acquire(int level)
+        {
+            if (m_level == level)
+            {
+                if (deflateReset(&m_stream) == Z_OK)
+                    return &m_stream;
+            }
+
+            if (m_level >= 0)
+                deflateEnd(&m_stream);
+
+            memset(&m_stream, 0, sizeof(m_stream));
+            m_stream.zalloc = (alloc_func)0;
+            m_stream.zfree = (free_func)0;
+            m_stream.opaque = (voidpf)0;
+
+            int z_res = deflateInit(&m_stream, level);
+            if (z_res != Z_OK)
+            {
+                sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)",z_res,zError(z_res));
+                m_level = -1;
+                return NULL;
+            }
+
+            m_level = level;
+            return &m_stream;
+        }
+
+        // drops the stream after an error so the next packet starts clean
+        void Release()
+        {
+            if (m_level >= 0)
+                deflateEnd(&m_stream);
+            m_level = -1;
+        }
+
+        void Account(uint32 bytesIn, uint32 bytesOut, uint64 timeUs)
+        {
+            ACE_GUARD(ACE_Thread_Mutex, guard, m_statsLock);
+
+            ++m_stats.packets;
+            m_stats.bytesIn += bytesIn;
+            m_stats.bytesOut += bytesOut;
+            m_stats.timeUs += timeUs;
+        }
+
+        static UpdateDataCompressionStats GetStats()
+        {
+            ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_registryLock, UpdateDataCompressionStats());
+
+            UpdateDataCompressionStats stats = m_finishedStats;
+            for (std::set<UpdateDataDeflateStream*>::const_iterator itr = m_registry.begin(); itr != m_registry.end(); ++itr)
+            {
+                ACE_GUARD_RETURN(ACE_Thread_Mutex, statsGuard, (*itr)->m_statsLock, stats);
+                AddStats(stats, (*itr)->m_stats);
+            }
+            return stats;
+        }
+
+        static void ResetStats()
+        {
+            ACE_GUARD(ACE_Thread_Mutex, guard, m_registryLock);
+
+            m_finishedStats = UpdateDataCompressionStats();
+            for (std::set<UpdateDataDeflateStream*>::const_iterator itr = m_registry.begin(); itr != m_registry.end(); ++itr)
+            {
+                ACE_GUARD(ACE_Thread_Mutex, statsGuard, (*itr)->m_statsLock);
+                (*itr)->m_stats = UpdateDataCompressionStats();
+            }
+        }
+
+    private:
+        static void AddStats(UpdateDataCompressionStats& to, UpdateDataCompressionStats const& from)
+        {
+            to.packets += from.packets;
+            to.bytesIn += from.bytesIn;
+            to.bytesOut += from.bytesOut;
+            to.timeUs += from.timeUs;
+        }
+
+        z_stream m_stream;
+        int m_level;
+        // written by the owning thread, read and reset by others under the registry lock,
+        // always taken after m_registryLock
+        UpdateDataCompressionStats m_stats;
+        ACE_Thread_Mutex m_statsLock;
+
+        static ACE_Thread_Mutex m_registryLock;
+        static std::set<UpdateDataDeflateStream*> m_registry;
+        static UpdateDataCompressionStats m_finishedStats;
+};
+
+ACE_Thread_Mutex UpdateDataDeflateStream::m_registryLock;
+std::set<UpdateDataDeflateStream*> UpdateDataDeflateStream::m_registry;
+UpdateDataCompressionStats UpdateDataDeflateStream::m_finishedStats;
+
+static ACE_TSS<UpdateDataDeflateStream> deflateStream;
+
 UpdateData::UpdateData() : m_blockCount(0)
 {
 }
 
+void UpdateData::SetCompression(int level, uint32 threshold)
+{
+    m_compressionLevel = level;
+    m_compressionThreshold = threshold;
+}
+
+UpdateDataCompressionStats UpdateData::GetCompressionStats()
+{
+    return UpdateDataDeflateStream::GetStats();
+}
+
+void UpdateData::ResetCompressionStats()
+{
+    UpdateDataDeflateStream::ResetStats();
+}
+
 void UpdateData::AddOutOfRangeGUID(std::set<uint64>& guids)
 {
     m_outOfRangeGUIDs.insert(guids.begin(),guids.end());
@@ -48,58 +193,52 @@ void UpdateData::AddUpdateBlock(const ByteBuffer &block)
 
 void UpdateData::Compress(void* dst, uint32 *dst_size, void* src, int src_size)
 {
-    z_stream c_stream;
+    ACE_Time_Value start = ACE_High_Res_Timer::gettimeofday_hr();
 
-    c_stream.zalloc = (alloc_func)0;
-    c_stream.zfree = (free_func)0;
-    c_stream.opaque = (voidpf)0;
-
-    // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld.getConfig(CONFIG_COMPRESSION));
-    if (z_res != Z_OK)
+    UpdateDataDeflateStream* stream = deflateStream;
+    z_stream* c_stream = stream->Acquire(m_compressionLevel);
+    if (!c_stream)
     {
-        sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)",z_res,zError(z_res));
         *dst_size = 0;
         return;
     }
 
-    c_stream.next_out = (Bytef*)dst;
-    c_stream.avail_out = *dst_size;
-    c_stream.next_in = (Bytef*)src;
-    c_stream.avail_in = (uInt)src_size;
+    c_stream->next_out = (Bytef*)dst;
+    c_stream->avail_out = *dst_size;
+    c_stream->next_in = (Bytef*)src;
+    c_stream->avail_in = (uInt)src_size;
 
-    z_res = deflate(&c_stream, Z_NO_FLUSH);
+    int z_res = deflate(c_stream, Z_NO_FLUSH);
     if (z_res != Z_OK)
     {
         sLog.outError("Can't compress update packet (zlib: deflate) Error code: %i (%s)",z_res,zError(z_res));
+        stream->Release();
         *dst_size = 0;
         return;
     }
 
-    if (c_stream.avail_in != 0)
+    if (c_stream->avail_in != 0)
     {
         sLog.outError("Can't compress update packet (zlib: deflate not greedy)");
+        stream->Release();
         *dst_size = 0;
         return;
     }
 
-    z_res = deflate(&c_stream, Z_FINISH);
+    z_res = deflate(c_stream, Z_FINISH);
     if (z_res != Z_STREAM_END)
     {
         sLog.outError("Can't compress update packet (zlib: deflate should report Z_STREAM_END instead %i (%s)",z_res,zError(z_res));
+        stream->Release();
         *dst_size = 0;
         return;
     }
 
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflateEnd) Error code: %i (%s)",z_res,zError(z_res));
-        *dst_size = 0;
-        return;
-    }
+    *dst_size = c_stream->total_out;
 
-    *dst_size = c_stream.total_out;
+    ACE_UINT64 timeUs;
+    (ACE_High_Res_Timer::gettimeofday_hr() - start).to_usec(timeUs);
+    stream->Account(src_size, *dst_size, timeUs);
 }
 
 bool UpdateData::BuildPacket(WorldPacket *packet, bool hasTransport)
@@ -126,7 +265,7 @@ bool UpdateData::BuildPacket(WorldPacket *packet, bool hasTransport)
 
     size_t pSize = buf.wpos();                              // use real used data size
 
-    if (pSize > 100)                                       // compress large packets
+    if (pSize > m_compressionThreshold)                     // compress large packets
     {
         uint32 destsize = compressBound(pSize);
         packet->resize(destsize + sizeof(uint32));
@@ -45,11 +45,30 @@ enum ObjectUpdateFlags
     UPDATEFLAG_HAS_POSITION         = 0x0040,
 };
 
+struct UpdateDataCompressionStats
+{
+    UpdateDataCompressionStats() : packets(0), bytesIn(0), bytesOut(0), timeUs(0) {}
+
+    uint64 packets;
+    uint64 bytesIn;
+    uint64 bytesOut;
+    uint64 timeUs;
+};
+
 class UpdateData
 {
     public:
         UpdateData();
 
+        // zlib level and minimal size of the SMSG_COMPRESSED_UPDATE_OBJECT packets, may be changed at runtime
+        static void SetCompression(int level, uint32 threshold);
+        static int GetCompressionLevel() { return m_compressionLevel; }
+        static uint32 GetCompressionThreshold() { return m_compressionThreshold; }
+
+        // summary of all compressions done by all threads since startup or last reset
+        static UpdateDataCompressionStats GetCompressionStats();
+        static void ResetCompressionStats();
+
         void AddOutOfRangeGUID(std::set<uint64>& guids);
         void AddOutOfRangeGUID(const uint64 &guid);
         void AddUpdateBlock(const ByteBuffer &block);
@@ -65,6 +84,9 @@ class UpdateData
         ByteBuffer m_data;
 
         void Compress(void* dst, uint32 *dst_size, void* src, int src_size);
+
+        static volatile int m_compressionLevel;
+        static volatile uint32 m_compressionThreshold;
 };
 #endif
 
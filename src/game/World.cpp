@@ -25,6 +25,8 @@
 #include "Opcodes.h"
 #include "WorldSession.h"
 #include "WorldPacket.h"
+#include "SharedPacket.h"
+#include "StartupLoader.h"
 #include "Weather.h"
 #include "Player.h"
 #include "SkillExtraItems.h"
@@ -39,6 +41,7 @@
 #include "LootMgr.h"
 #include "ItemEnchantmentMgr.h"
 #include "MapManager.h"
+#include "UpdateData.h"
 #include "CreatureAIRegistry.h"
 #include "Policies/SingletonImp.h"
 #include "BattleGroundMgr.h"
@@ -47,6 +50,7 @@
 #include "AuctionHouseBot.h"
 #include "WaypointMovementGenerator.h"
 #include "VMapFactory.h"
+#include "MoveMap.h"
 #include "GameEventMgr.h"
 #include "PoolHandler.h"
 #include "Database/DatabaseImpl.h"
@@ -98,6 +102,7 @@ World::World()
     m_resultQueue = NULL;
     m_NextDailyQuestReset = 0;
     m_scheduledScripts = 0;
+    m_autosaveBudget = 0;
 
     m_defaultDbcLocale = LOCALE_enUS;
     m_availableDbcLocaleMask = 0;
@@ -542,6 +547,8 @@ void World::LoadConfigSettings(bool reload)
         sLog.outError("Compression level (%i) must be in range 1..9. Using default compression level (1).",m_configs[CONFIG_COMPRESSION]);
         m_configs[CONFIG_COMPRESSION] = 1;
     }
+    m_configs[CONFIG_COMPRESSION_THRESHOLD] = sConfig.GetIntDefault("Compression.Threshold", 100);
+    UpdateData::SetCompression(m_configs[CONFIG_COMPRESSION], m_configs[CONFIG_COMPRESSION_THRESHOLD]);
     m_configs[CONFIG_ADDON_CHANNEL] = sConfig.GetBoolDefault("AddonChannel", true);
     m_configs[CONFIG_GRID_UNLOAD] = sConfig.GetBoolDefault("GridUnload", true);
     m_configs[CONFIG_INTERVAL_SAVE] = sConfig.GetIntDefault("PlayerSaveInterval", 900000);
@@ -774,6 +781,7 @@ void World::LoadConfigSettings(bool reload)
     m_configs[CONFIG_CHANCE_OF_GM_SURVEY] = sConfig.GetFloatDefault("GM.TicketSystem.ChanceOfGMSurvey", 0.0f);
 
     m_configs[CONFIG_GROUP_VISIBILITY] = sConfig.GetIntDefault("Visibility.GroupMode", 1);
+    m_configs[CONFIG_VISIBILITY_RELOCATION_LIMIT] = sConfig.GetIntDefault("Visibility.RelocationLowerLimit", 10);
 
     m_configs[CONFIG_MAIL_DELIVERY_DELAY] = sConfig.GetIntDefault("MailDeliveryDelay", HOUR);
 
@@ -849,6 +857,7 @@ void World::LoadConfigSettings(bool reload)
     m_configs[CONFIG_CREATURE_FAMILY_ASSISTANCE_RADIUS] = sConfig.GetIntDefault("CreatureFamilyAssistanceRadius",10);
     m_configs[CONFIG_CREATURE_FAMILY_ASSISTANCE_DELAY]  = sConfig.GetIntDefault("CreatureFamilyAssistanceDelay",1500);
     m_configs[CONFIG_CREATURE_FAMILY_FLEE_DELAY]        = sConfig.GetIntDefault("CreatureFamilyFleeDelay",7000);
+    m_configs[CONFIG_CREATURE_IDLE_SLEEP]               = sConfig.GetIntDefault("CreatureIdleSleep",2000);
 
     m_configs[CONFIG_WORLD_BOSS_LEVEL_DIFF] = sConfig.GetIntDefault("WorldBossLevelDiff",3);
 
@@ -1013,9 +1022,18 @@ void World::LoadConfigSettings(bool reload)
     VMAP::VMapFactory::createOrGetVMapManager()->setEnableLineOfSightCalc(enableLOS);
     VMAP::VMapFactory::createOrGetVMapManager()->setEnableHeightCalc(enableHeight);
     VMAP::VMapFactory::preventSpellsFromBeingTestedForLoS(ignoreSpellIds.c_str());
+    VMAP::VMapFactory::createOrGetVMapManager()->setQueryCacheSize(sConfig.GetIntDefault("vmap.queryCacheSize", 65536));
     sLog.outString("WORLD: VMap support included. LineOfSight:%i, getHeight:%i, indoorCheck:%i, PetLOS:%i", enableLOS, enableHeight, enableIndoor, enablePetLOS);
     sLog.outString("WORLD: VMap data directory is: %svmaps",m_dataPath.c_str());
 
+    // the tiles are loaded with the grids, so this can't be changed at reload
+    if (!reload)
+    {
+        bool enablePathFinding = sConfig.GetBoolDefault("mmap.enablePathFinding", false);
+        sMoveMapMgr.Initialize(m_dataPath, enablePathFinding, sConfig.GetIntDefault("mmap.pathCacheSize", 4096));
+        sLog.outString("WORLD: Path finding %s, movemap data directory is: %smmaps", enablePathFinding ? "enabled" : "disabled", m_dataPath.c_str());
+    }
+
     m_configs[CONFIG_VMAP_INDOOR_CHECK] = enableIndoor;
     m_configs[CONFIG_PET_LOS] = enablePetLOS;
     m_configs[CONFIG_VMAP_TOTEM] = sConfig.GetBoolDefault("vmap.totem", false);
@@ -1036,6 +1054,16 @@ void World::LoadConfigSettings(bool reload)
     m_configs[CONFIG_INTERVAL_LOG_UPDATE] = sConfig.GetIntDefault("RecordUpdateTimeDiffInterval", 60000);
     m_configs[CONFIG_MIN_LOG_UPDATE] = sConfig.GetIntDefault("MinRecordUpdateTimeDiff", 100);
     m_configs[CONFIG_NUMTHREADS] = sConfig.GetIntDefault("MapUpdate.Threads",1);
+    m_configs[CONFIG_MAP_PACKET_PROCESSING] = sConfig.GetBoolDefault("MapUpdate.ProcessPackets", false);
+    m_configs[CONFIG_MAP_PARALLEL_CELLS] = sConfig.GetBoolDefault("MapUpdate.ParallelCells", false);
+    m_configs[CONFIG_GRID_PRELOAD_THREADS] = sConfig.GetIntDefault("GridPreload.Threads", 1);
+    m_configs[CONFIG_GRID_PRELOAD_LOOKAHEAD] = sConfig.GetIntDefault("GridPreload.LookAhead", 15);
+    m_configs[CONFIG_STARTUP_LOAD_THREADS] = sConfig.GetIntDefault("Startup.LoadThreads", 1);
+    m_configs[CONFIG_MOVEMENT_RELAY] = sConfig.GetBoolDefault("MovementRelay.Enable", true);
+    m_configs[CONFIG_MOVEMENT_RELAY_FAR_DISTANCE] = sConfig.GetIntDefault("MovementRelay.FarDistance", 0);
+    m_configs[CONFIG_MOVEMENT_RELAY_FAR_INTERVAL] = sConfig.GetIntDefault("MovementRelay.FarInterval", 500);
+    m_configs[CONFIG_WORLD_CACHE] = sConfig.GetBoolDefault("WorldCache.Enable", false);
+    m_configs[CONFIG_DBC_MAP_FILES] = sConfig.GetBoolDefault("DBC.MapFiles", false);
     m_configs[CONFIG_DUEL_MOD] = sConfig.GetBoolDefault("DuelMod.Enable", false);
     m_configs[CONFIG_DUEL_CD_RESET] = sConfig.GetBoolDefault("DuelMod.Cooldowns", false);
     m_configs[CONFIG_AUTOBROADCAST_TIMER] = sConfig.GetIntDefault("AutoBroadcast.Timer", 60000);
@@ -1076,6 +1104,27 @@ void World::LoadConfigSettings(bool reload)
 }
 
 // Initialize the World
+// startup loaders taking arguments
+static void SetDBCLocaleIndex()
+{
+    objmgr.SetDBCLocaleIndex(sWorld.GetDefaultDbcLocale());  // Get once for all the locale index of DBC language (console/broadcasts)
+}
+
+static void ReturnOrDeleteOldMails()
+{
+    objmgr.ReturnOrDeleteOldMails(false);
+}
+
+static void LoadCreatureEventAITexts()
+{
+    CreatureEAI_Mgr.LoadCreatureEventAI_Texts(false);       // false, will checked in LoadCreatureEventAI_Scripts
+}
+
+static void LoadCreatureEventAISummons()
+{
+    CreatureEAI_Mgr.LoadCreatureEventAI_Summons(false);     // false, will checked in LoadCreatureEventAI_Scripts
+}
+
 void World::SetInitialWorldSettings()
 {
     // Initialize the random number generator
@@ -1120,289 +1169,143 @@ void World::SetInitialWorldSettings()
 
     // Load the DBC files
     sLog.outString("Initialize data stores...");
-    LoadDBCStores(m_dataPath);
+    LoadDBCStores(m_dataPath, getConfig(CONFIG_DBC_MAP_FILES));
     DetectDBCLang();
 
-    sLog.outString("Loading Script Names...");
-    objmgr.LoadScriptNames();
-
-    sLog.outString("Loading Instance Template...");
-    objmgr.LoadInstanceTemplate();
-
-    sLog.outString("Loading SkillLineAbilityMultiMap Data...");
-    spellmgr.LoadSkillLineAbilityMap();
-
-    // Clean up and pack instances
-    sLog.outString("Cleaning up instances...");
-    sInstanceSaveManager.CleanupInstances();                // must be called before `creature_respawn`/`gameobject_respawn` tables
-
-    sLog.outString("Packing instances...");
-    sInstanceSaveManager.PackInstances();
-
-    sLog.outString("Loading Localization strings...");
-    objmgr.LoadCreatureLocales();
-    objmgr.LoadGameObjectLocales();
-    objmgr.LoadItemLocales();
-    objmgr.LoadQuestLocales();
-    objmgr.LoadNpcTextLocales();
-    objmgr.LoadPageTextLocales();
-    objmgr.LoadGossipMenuItemsLocales();
-    objmgr.SetDBCLocaleIndex(GetDefaultDbcLocale());        // Get once for all the locale index of DBC language (console/broadcasts)
-    sLog.outString(">>> Localization strings loaded");
-    sLog.outString();
-
-    sLog.outString("Loading Page Texts...");
-    objmgr.LoadPageTexts();
-
-    sLog.outString("Loading Game Object Templates...");     // must be after LoadPageTexts
-    objmgr.LoadGameobjectInfo();
-
-    sLog.outString("Loading Spell Chain Data...");
-    spellmgr.LoadSpellChains();
-
-    sLog.outString("Loading Spell Required Data...");
-    spellmgr.LoadSpellRequired();
-
-    sLog.outString("Loading Spell Elixir types...");
-    spellmgr.LoadSpellElixirs();
-
-    sLog.outString("Loading Spell Learn Skills...");
-    spellmgr.LoadSpellLearnSkills();                        // must be after LoadSpellChains
-
-    sLog.outString("Loading Spell Learn Spells...");
-    spellmgr.LoadSpellLearnSpells();
-
-    sLog.outString("Loading Spell Proc Event conditions...");
-    spellmgr.LoadSpellProcEvents();
-
-    sLog.outString("Loading Aggro Spells Definitions...");
-    spellmgr.LoadSpellThreats();
-
-    sLog.outString("Loading NPC Texts...");
-    objmgr.LoadGossipText();
-
-    sLog.outString("Loading Enchant Spells Proc datas...");
-    spellmgr.LoadSpellEnchantProcData();
-
-    sLog.outString("Loading Item Random Enchantments Table...");
-    LoadRandomEnchantmentsTable();
-
-    sLog.outString("Loading Items...");                     // must be after LoadRandomEnchantmentsTable and LoadPageTexts
-    objmgr.LoadItemPrototypes();
-
-    sLog.outString("Loading Item Texts...");
-    objmgr.LoadItemTexts();
-
-    sLog.outString("Loading Creature Model Based Info Data...");
-    objmgr.LoadCreatureModelInfo();
-
-    sLog.outString("Loading Equipment templates...");
-    objmgr.LoadEquipmentTemplates();
-
-    sLog.outString("Loading Creature templates...");
-    objmgr.LoadCreatureTemplates();
-
-    sLog.outString("Loading SpellsScriptTarget...");
-    spellmgr.LoadSpellScriptTarget();                       // must be after LoadCreatureTemplates and LoadGameobjectInfo
-
-    sLog.outString("Loading Creature Reputation OnKill Data...");
-    objmgr.LoadReputationOnKill();
-
-    sLog.outString("Loading Pet Create Spells...");
-    objmgr.LoadPetCreateSpells();
-
-    sLog.outString("Loading Creature Data...");
-    objmgr.LoadCreatures();
-
-    sLog.outString("Loading Creature Linked Respawn...");
-    objmgr.LoadCreatureLinkedRespawn();                     // must be after LoadCreatures()
-
-    sLog.outString();
-    sLog.outString("Loading Creature Addon Data...");
-    objmgr.LoadCreatureAddons();                            // must be after LoadCreatureTemplates() and LoadCreatures()
-    sLog.outString(">>> Creature Addon Data loaded");
-    sLog.outString();
-
-    sLog.outString("Loading Creature Respawn Data...");   // must be after PackInstances()
-    objmgr.LoadCreatureRespawnTimes();
-
-    sLog.outString("Loading Gameobject Data...");
-    objmgr.LoadGameobjects();
-
-    sLog.outString("Loading Gameobject Respawn Data...");   // must be after PackInstances()
-    objmgr.LoadGameobjectRespawnTimes();
-
-    sLog.outString("Loading Objects Pooling Data...");
-    poolhandler.LoadFromDB();
-
-    sLog.outString("Loading Game Event Data...");
-    gameeventmgr.LoadFromDB();
-
-    sLog.outString("Loading Weather Data...");
-    objmgr.LoadWeatherZoneChances();
-
-    sLog.outString("Loading Quests...");
-    objmgr.LoadQuests();                                    // must be loaded after DBCs, creature_template, item_template, gameobject tables
-
-    sLog.outString("Loading Quests Relations...");
-    objmgr.LoadQuestRelations();                            // must be after quest load
-
-    sLog.outString("Loading AreaTrigger definitions...");
-    objmgr.LoadAreaTriggerTeleports();
-
-    sLog.outString("Loading Access Requirements...");
-    objmgr.LoadAccessRequirements();                        // must be after item template load
-
-    sLog.outString("Loading Quest Area Triggers...");
-    objmgr.LoadQuestAreaTriggers();                         // must be after LoadQuests
-
-    sLog.outString("Loading Tavern Area Triggers...");
-    objmgr.LoadTavernAreaTriggers();
-
-    sLog.outString("Loading AreaTrigger script names...");
-    objmgr.LoadAreaTriggerScripts();
-
-    sLog.outString("Loading Graveyard-zone links...");
-    objmgr.LoadGraveyardZones();
-
-    sLog.outString("Loading Spell target coordinates...");
-    spellmgr.LoadSpellTargetPositions();
-
-    sLog.outString("Loading SpellAffect definitions...");
-    spellmgr.LoadSpellAffects();
-
-    sLog.outString("Loading spell pet auras...");
-    spellmgr.LoadSpellPetAuras();
-
-    sLog.outString("Loading spell extra attributes...");
-    spellmgr.LoadSpellCustomAttr();
-
-    sLog.outString("Loading linked spells...");
-    spellmgr.LoadSpellLinked();
-
-    sLog.outString("Loading Player Create Data...");
-    objmgr.LoadPlayerInfo();
-
-    sLog.outString("Loading Exploration BaseXP Data...");
-    objmgr.LoadExplorationBaseXP();
-
-    sLog.outString("Loading Pet Name Parts...");
-    objmgr.LoadPetNames();
-
-    sLog.outString("Loading the max pet number...");
-    objmgr.LoadPetNumber();
-
-    sLog.outString("Loading pet level stats...");
-    objmgr.LoadPetLevelInfo();
-
-    sLog.outString("Loading Player Corpses...");
-    objmgr.LoadCorpses();
-
-    sLog.outString("Loading Disabled Spells...");
-    objmgr.LoadSpellDisabledEntrys();
-
-    sLog.outString("Loading Loot Tables...");
-    LoadLootTables();
-
-    sLog.outString("Loading Skill Discovery Table...");
-    LoadSkillDiscoveryTable();
-
-    sLog.outString("Loading Skill Extra Item Table...");
-    LoadSkillExtraItemTable();
-
-    sLog.outString("Loading Skill Fishing base level requirements...");
-    objmgr.LoadFishingBaseSkillLevel();
+    // The static data loaders, each declares the data it reads and writes so
+    // independent ones can run side by side (Startup.LoadThreads). The DBC
+    // stores are only read from here on, except the spell store the custom
+    // attributes change. The order is the one they have when run one by one.
+    StartupLoader loader;
+
+    loader.Add("Loading Script Names...", objmgr, &ObjectMgr::LoadScriptNames, "", "script_names");
+    loader.Add("Loading Instance Template...", objmgr, &ObjectMgr::LoadInstanceTemplate, "script_names", "instance_template");
+    loader.Add("Loading SkillLineAbilityMultiMap Data...", spellmgr, &SpellMgr::LoadSkillLineAbilityMap, "", "skill_line_ability");
+
+    // must be before `creature_respawn`/`gameobject_respawn` tables
+    loader.Add("Cleaning up instances...", sInstanceSaveManager, &InstanceSaveManager::CleanupInstances, "instance_template", "instance");
+    loader.Add("Packing instances...", sInstanceSaveManager, &InstanceSaveManager::PackInstances, "", "instance");
+
+    loader.Add("Loading Creature Locales...", objmgr, &ObjectMgr::LoadCreatureLocales, "", "locale_index locales_creature");
+    loader.Add("Loading GameObject Locales...", objmgr, &ObjectMgr::LoadGameObjectLocales, "", "locale_index locales_gameobject");
+    loader.Add("Loading Item Locales...", objmgr, &ObjectMgr::LoadItemLocales, "", "locale_index locales_item");
+    loader.Add("Loading Quest Locales...", objmgr, &ObjectMgr::LoadQuestLocales, "", "locale_index locales_quest");
+    loader.Add("Loading NPC Text Locales...", objmgr, &ObjectMgr::LoadNpcTextLocales, "", "locale_index locales_npc_text");
+    loader.Add("Loading Page Text Locales...", objmgr, &ObjectMgr::LoadPageTextLocales, "", "locale_index locales_page_text");
+    loader.Add("Loading Gossip Menu Option Locales...", objmgr, &ObjectMgr::LoadGossipMenuItemsLocales, "", "locale_index locales_gossip_menu_option");
+    loader.Add("Setting DBC Locale Index...", SetDBCLocaleIndex, "locale_index", "dbc_locale_index");
+
+    loader.Add("Loading Page Texts...", objmgr, &ObjectMgr::LoadPageTexts, "", "page_text");
+    loader.Add("Loading Game Object Templates...", objmgr, &ObjectMgr::LoadGameobjectInfo, "script_names page_text spell_dbc", "gameobject_template");
+    loader.Add("Loading Spell Chain Data...", spellmgr, &SpellMgr::LoadSpellChains, "skill_line_ability spell_dbc", "spell_chain");
+    loader.Add("Loading Spell Required Data...", spellmgr, &SpellMgr::LoadSpellRequired, "", "spell_required");
+    loader.Add("Loading Spell Elixir types...", spellmgr, &SpellMgr::LoadSpellElixirs, "spell_dbc", "spell_elixir");
+    loader.Add("Loading Spell Learn Skills...", spellmgr, &SpellMgr::LoadSpellLearnSkills, "spell_dbc spell_chain", "spell_learn_skill");
+    loader.Add("Loading Spell Learn Spells...", spellmgr, &SpellMgr::LoadSpellLearnSpells, "spell_dbc spell_chain", "spell_learn_spell");
+    loader.Add("Loading Spell Proc Event conditions...", spellmgr, &SpellMgr::LoadSpellProcEvents, "spell_dbc spell_chain", "spell_proc_event");
+    loader.Add("Loading Aggro Spells Definitions...", spellmgr, &SpellMgr::LoadSpellThreats, "spell_dbc", "spell_threat");
+    loader.Add("Loading NPC Texts...", objmgr, &ObjectMgr::LoadGossipText, "", "npc_text");
+    loader.Add("Loading Enchant Spells Proc datas...", spellmgr, &SpellMgr::LoadSpellEnchantProcData, "", "spell_enchant_proc_data");
+    loader.Add("Loading Item Random Enchantments Table...", LoadRandomEnchantmentsTable, "", "item_enchantment_template");
+    loader.Add("Loading Items...", objmgr, &ObjectMgr::LoadItemPrototypes, "script_names page_text item_enchantment_template spell_dbc", "item_template");
+    loader.Add("Loading Item Texts...", objmgr, &ObjectMgr::LoadItemTexts, "", "item_text");
+    loader.Add("Loading Creature Model Based Info Data...", objmgr, &ObjectMgr::LoadCreatureModelInfo, "", "creature_model_info");
+    loader.Add("Loading Equipment templates...", objmgr, &ObjectMgr::LoadEquipmentTemplates, "", "creature_equip_template");
+    loader.Add("Loading Creature templates...", objmgr, &ObjectMgr::LoadCreatureTemplates, "script_names creature_model_info creature_equip_template", "creature_template");
+    loader.Add("Loading SpellsScriptTarget...", spellmgr, &SpellMgr::LoadSpellScriptTarget, "creature_template gameobject_template spell_dbc", "spell_script_target");
+    loader.Add("Loading Creature Reputation OnKill Data...", objmgr, &ObjectMgr::LoadReputationOnKill, "creature_template", "creature_onkill_reputation");
+    loader.Add("Loading Pet Create Spells...", objmgr, &ObjectMgr::LoadPetCreateSpells, "creature_template spell_dbc", "petcreateinfo_spell");
+
+    // the spawns are added to the cell guid lists of the maps
+    loader.Add("Loading Creature Data...", objmgr, &ObjectMgr::LoadCreatures, "creature_template creature_equip_template", "creature grid_guids");
+    loader.Add("Loading Creature Linked Respawn...", objmgr, &ObjectMgr::LoadCreatureLinkedRespawn, "creature", "creature_linked_respawn");
+    loader.Add("Loading Creature Addon Data...", objmgr, &ObjectMgr::LoadCreatureAddons, "creature creature_template spell_dbc", "creature_addon");
+    loader.Add("Loading Creature Respawn Data...", objmgr, &ObjectMgr::LoadCreatureRespawnTimes, "instance", "creature_respawn");
+    loader.Add("Loading Gameobject Data...", objmgr, &ObjectMgr::LoadGameobjects, "gameobject_template", "gameobject grid_guids");
+    loader.Add("Loading Gameobject Respawn Data...", objmgr, &ObjectMgr::LoadGameobjectRespawnTimes, "instance", "gameobject_respawn");
+    loader.Add("Loading Objects Pooling Data...", poolhandler, &PoolHandler::LoadFromDB, "creature gameobject gameobject_template", "pool");
+    loader.Add("Loading Game Event Data...", gameeventmgr, &GameEventMgr::LoadFromDB, "creature gameobject creature_template creature_equip_template item_template pool", "game_event");
+    loader.Add("Loading Weather Data...", objmgr, &ObjectMgr::LoadWeatherZoneChances, "", "game_weather");
+
+    // quest flags are also set by the area triggers and the scripts using them
+    loader.Add("Loading Quests...", objmgr, &ObjectMgr::LoadQuests, "creature_template gameobject_template item_template spell_dbc", "quest_template");
+    loader.Add("Loading Quests Relations...", objmgr, &ObjectMgr::LoadQuestRelations, "quest_template creature_template gameobject_template", "quest_relations");
+    loader.Add("Loading AreaTrigger definitions...", objmgr, &ObjectMgr::LoadAreaTriggerTeleports, "", "areatrigger_teleport");
+    loader.Add("Loading Access Requirements...", objmgr, &ObjectMgr::LoadAccessRequirements, "item_template quest_template", "access_requirement");
+    loader.Add("Loading Quest Area Triggers...", objmgr, &ObjectMgr::LoadQuestAreaTriggers, "", "quest_template areatrigger_involvedrelation");
+    loader.Add("Loading Tavern Area Triggers...", objmgr, &ObjectMgr::LoadTavernAreaTriggers, "", "areatrigger_tavern");
+    loader.Add("Loading AreaTrigger script names...", objmgr, &ObjectMgr::LoadAreaTriggerScripts, "script_names", "areatrigger_scripts");
+    loader.Add("Loading Graveyard-zone links...", objmgr, &ObjectMgr::LoadGraveyardZones, "", "game_graveyard_zone");
+    loader.Add("Loading Spell target coordinates...", spellmgr, &SpellMgr::LoadSpellTargetPositions, "spell_dbc", "spell_target_position");
+    loader.Add("Loading SpellAffect definitions...", spellmgr, &SpellMgr::LoadSpellAffects, "spell_dbc spell_chain", "spell_affect");
+    loader.Add("Loading spell pet auras...", spellmgr, &SpellMgr::LoadSpellPetAuras, "spell_dbc", "spell_pet_auras");
+
+    // changes the spell entries, runs after every earlier reader of them
+    loader.Add("Loading spell extra attributes...", spellmgr, &SpellMgr::LoadSpellCustomAttr, "spell_chain spell_affect", "spell_dbc spell_custom_attr");
+    loader.Add("Loading linked spells...", spellmgr, &SpellMgr::LoadSpellLinked, "spell_dbc", "spell_linked_spell spell_custom_attr");
+
+    loader.Add("Loading Player Create Data...", objmgr, &ObjectMgr::LoadPlayerInfo, "item_template spell_dbc", "playercreateinfo");
+    loader.Add("Loading Exploration BaseXP Data...", objmgr, &ObjectMgr::LoadExplorationBaseXP, "", "exploration_basexp");
+    loader.Add("Loading Pet Name Parts...", objmgr, &ObjectMgr::LoadPetNames, "", "pet_name_generation");
+    loader.Add("Loading the max pet number...", objmgr, &ObjectMgr::LoadPetNumber, "", "pet_number");
+    loader.Add("Loading pet level stats...", objmgr, &ObjectMgr::LoadPetLevelInfo, "creature_template", "pet_levelstats");
+    loader.Add("Loading Player Corpses...", objmgr, &ObjectMgr::LoadCorpses, "instance", "corpse grid_guids");
+    loader.Add("Loading Disabled Spells...", objmgr, &ObjectMgr::LoadSpellDisabledEntrys, "spell_dbc", "spell_disabled");
+
+    // the loot conditions share the condition list with the gossip menus, the
+    // conditions are checked against the spells, items, quests and game events
+    loader.Add("Loading Loot Tables...", LoadLootTables, "creature_template gameobject_template item_template quest_template game_event spell_dbc", "loot conditions");
+    loader.Add("Loading Skill Discovery Table...", LoadSkillDiscoveryTable, "skill_line_ability spell_dbc", "skill_discovery_template");
+    loader.Add("Loading Skill Extra Item Table...", LoadSkillExtraItemTable, "spell_dbc", "skill_extra_item_template");
+    loader.Add("Loading Skill Fishing base level requirements...", objmgr, &ObjectMgr::LoadFishingBaseSkillLevel, "", "skill_fishing_base_level");
 
     // Load dynamic data tables from the database
-    sLog.outString("Loading Item Auctions...");
-    sAuctionMgr->LoadAuctionItems();
-    sLog.outString("Loading Auctions...");
-    sAuctionMgr->LoadAuctions();
-
-    sLog.outString("Loading Guilds...");
-    objmgr.LoadGuilds();
-
-    sLog.outString("Loading ArenaTeams...");
-    objmgr.LoadArenaTeams();
-
-    sLog.outString("Loading Groups...");
-    objmgr.LoadGroups();
-
-    sLog.outString("Loading ReservedNames...");
-    objmgr.LoadReservedPlayersNames();
-
-    sLog.outString("Loading GameObjects for quests...");
-    objmgr.LoadGameObjectForQuests();
-
-    sLog.outString("Loading BattleMasters...");
-    objmgr.LoadBattleMastersEntry();
-
-    sLog.outString("Loading GameTeleports...");
-    objmgr.LoadGameTele();
-
-    sLog.outString("Loading Npc Text Id...");
-    objmgr.LoadNpcTextId();                                 // must be after load Creature and NpcText
-
-    sLog.outString( "Loading Gossip scripts...");
-    objmgr.LoadGossipScripts();                             // must be before gossip menu options
-
-    sLog.outString("Loading Gossip menu...");
-    objmgr.LoadGossipMenu();
-
-    sLog.outString("Loading Gossip menu options...");
-    objmgr.LoadGossipMenuItems();
-
-    sLog.outString("Loading Vendors...");
-    objmgr.LoadVendors();                                   // must be after load CreatureTemplate and ItemTemplate
-
-    sLog.outString("Loading Trainers...");
-    objmgr.LoadTrainerSpell();                              // must be after load CreatureTemplate
-
-    sLog.outString("Loading Waypoints...");
-    sWaypointMgr->Load();
-
-    sLog.outString("Loading Creature Formations...");
-    formation_mgr.LoadCreatureFormations();
-
-    sLog.outString("Loading Creature Groups...");
-    group_mgr.LoadCreatureGroups();
-
-    sLog.outString("Loading GM tickets...");
-    ticketmgr.LoadGMTickets();
-
-    sLog.outString("Loading GM surveys...");
-    ticketmgr.LoadGMSurveys();
-
-    // Handle outdated emails (delete/return)
-    sLog.outString("Returning old mails...");
-    objmgr.ReturnOrDeleteOldMails(false);
-
-    sLog.outString("Loading Autobroadcasts...");
-    LoadAutobroadcasts();
-
-    // Load and initialize scripts
-    sLog.outString("Loading Scripts...");
-    sLog.outString();
-    objmgr.LoadQuestStartScripts();                         // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
-    objmgr.LoadQuestEndScripts();                           // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
-    objmgr.LoadSpellScripts();                              // must be after load Creature/Gameobject(Template/Data)
-    objmgr.LoadGameObjectScripts();                         // must be after load Creature/Gameobject(Template/Data)
-    objmgr.LoadEventScripts();                              // must be after load Creature/Gameobject(Template/Data)
-    objmgr.LoadWaypointScripts();
-    sLog.outString(">>> Scripts loaded");
-    sLog.outString();
-
-    sLog.outString("Loading Scripts text locales...");      // must be after Load*Scripts calls
-    objmgr.LoadDbScriptStrings();
-
-    sLog.outString("Loading CreatureEventAI Texts...");
-    CreatureEAI_Mgr.LoadCreatureEventAI_Texts(false);       // false, will checked in LoadCreatureEventAI_Scripts
-
-    sLog.outString("Loading CreatureEventAI Summons...");
-    CreatureEAI_Mgr.LoadCreatureEventAI_Summons(false);     // false, will checked in LoadCreatureEventAI_Scripts
-
-    sLog.outString("Loading CreatureEventAI Scripts...");
-    CreatureEAI_Mgr.LoadCreatureEventAI_Scripts();
+    loader.Add("Loading Item Auctions...", *sAuctionMgr, &AuctionHouseMgr::LoadAuctionItems, "item_template", "auction_items");
+    loader.Add("Loading Auctions...", *sAuctionMgr, &AuctionHouseMgr::LoadAuctions, "auction_items creature creature_template", "auctions");
+    loader.Add("Loading Guilds...", objmgr, &ObjectMgr::LoadGuilds, "item_template", "guild");
+    loader.Add("Loading ArenaTeams...", objmgr, &ObjectMgr::LoadArenaTeams, "", "arena_team");
+    loader.Add("Loading Groups...", objmgr, &ObjectMgr::LoadGroups, "", "groups instance");
+    loader.Add("Loading ReservedNames...", objmgr, &ObjectMgr::LoadReservedPlayersNames, "", "reserved_name");
+    loader.Add("Loading GameObjects for quests...", objmgr, &ObjectMgr::LoadGameObjectForQuests, "gameobject_template loot", "gameobject_for_quests");
+    loader.Add("Loading BattleMasters...", objmgr, &ObjectMgr::LoadBattleMastersEntry, "", "battlemaster_entry");
+    loader.Add("Loading GameTeleports...", objmgr, &ObjectMgr::LoadGameTele, "", "game_tele");
+    loader.Add("Loading Npc Text Id...", objmgr, &ObjectMgr::LoadNpcTextId, "creature npc_text", "npc_gossip");
+
+    // the scripts check the spawns and the templates, the quest explored
+    // command sets a quest flag
+    char const* scriptReads = "creature creature_template gameobject gameobject_template item_template spell_dbc";
+    loader.Add("Loading Gossip scripts...", objmgr, &ObjectMgr::LoadGossipScripts, scriptReads, "gossip_scripts quest_template");
+    loader.Add("Loading Gossip menu...", objmgr, &ObjectMgr::LoadGossipMenu, "npc_text item_template quest_template game_event spell_dbc", "gossip_menu conditions");
+    loader.Add("Loading Gossip menu options...", objmgr, &ObjectMgr::LoadGossipMenuItems, "gossip_menu gossip_scripts item_template quest_template game_event spell_dbc", "gossip_menu_option conditions");
+    loader.Add("Loading Vendors...", objmgr, &ObjectMgr::LoadVendors, "creature_template item_template", "npc_vendor");
+    loader.Add("Loading Trainers...", objmgr, &ObjectMgr::LoadTrainerSpell, "creature_template spell_dbc", "npc_trainer");
+    loader.Add("Loading Waypoints...", *sWaypointMgr, &WaypointStore::Load, "", "waypoint_data");
+    loader.Add("Loading Creature Formations...", formation_mgr, &CreatureFormationManager::LoadCreatureFormations, "creature", "creature_formations");
+    loader.Add("Loading Creature Groups...", group_mgr, &CreatureGroupManager::LoadCreatureGroups, "creature", "creature_groups");
+    loader.Add("Loading GM tickets...", ticketmgr, &TicketMgr::LoadGMTickets, "", "gm_tickets");
+    loader.Add("Loading GM surveys...", ticketmgr, &TicketMgr::LoadGMSurveys, "", "gm_surveys");
+    loader.Add("Returning old mails...", ReturnOrDeleteOldMails, "item_template", "mail");
+    loader.Add("Loading Autobroadcasts...", *this, &World::LoadAutobroadcasts, "", "autobroadcast");
+
+    loader.Add("Loading Quest Start Scripts...", objmgr, &ObjectMgr::LoadQuestStartScripts, scriptReads, "quest_start_scripts quest_template");
+    loader.Add("Loading Quest End Scripts...", objmgr, &ObjectMgr::LoadQuestEndScripts, scriptReads, "quest_end_scripts quest_template");
+    loader.Add("Loading Spell Scripts...", objmgr, &ObjectMgr::LoadSpellScripts, scriptReads, "spell_scripts quest_template");
+    loader.Add("Loading GameObject Scripts...", objmgr, &ObjectMgr::LoadGameObjectScripts, scriptReads, "gameobject_scripts quest_template");
+    loader.Add("Loading Event Scripts...", objmgr, &ObjectMgr::LoadEventScripts, scriptReads, "event_scripts quest_template");
+    loader.Add("Loading Waypoint Scripts...", objmgr, &ObjectMgr::LoadWaypointScripts, scriptReads, "waypoint_scripts quest_template");
+
+    // must be after Load*Scripts calls
+    loader.Add("Loading Scripts text locales...", objmgr, &ObjectMgr::LoadDbScriptStrings,
+        "gossip_scripts quest_start_scripts quest_end_scripts spell_scripts gameobject_scripts event_scripts waypoint_scripts",
+        "oregon_strings locale_index");
+
+    // the texts and summons are checked by LoadCreatureEventAI_Scripts
+    loader.Add("Loading CreatureEventAI Texts...", LoadCreatureEventAITexts, "", "creature_ai_texts oregon_strings locale_index");
+    loader.Add("Loading CreatureEventAI Summons...", LoadCreatureEventAISummons, "", "creature_ai_summons");
+    loader.Add("Loading CreatureEventAI Scripts...", CreatureEAI_Mgr, &CreatureEventAIMgr::LoadCreatureEventAI_Scripts,
+        "creature_ai_texts creature_ai_summons creature_template item_template quest_template game_event spell_dbc", "creature_ai_scripts");
+
+    loader.Run(getConfig(CONFIG_STARTUP_LOAD_THREADS));
 
     sLog.outString("Initializing Scripts...");
     sScriptMgr.ScriptsInit();
@@ -1641,6 +1544,11 @@ void World::Update(time_t diff)
             m_timers[i].SetCurrent(0);
     }
 
+    // Twice the average autosave rate of the online players, the players over
+    // the budget retry a bit later instead of all saving in the same tick
+    if (m_configs[CONFIG_INTERVAL_SAVE])
+        m_autosaveBudget = long(2 * uint64(GetActiveSessionCount()) * uint64(diff) / m_configs[CONFIG_INTERVAL_SAVE] + 1);
+
     // Update the game time and check for shutdown time
     _UpdateGameTime();
 
@@ -1792,6 +1700,9 @@ void World::ForceGameEventUpdate()
 // Send a packet to all players (except self if mentioned)
 void World::SendGlobalMessage(WorldPacket *packet, WorldSession *self, uint32 team)
 {
+    // one copy of the payload for all sessions
+    SharedPacket* shared = SharedPacket::Create(*packet);
+
     SessionMap::iterator itr;
     for (itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
     {
@@ -1801,9 +1712,11 @@ void World::SendGlobalMessage(WorldPacket *packet, WorldSession *self, uint32 te
             itr->second != self &&
             (team == 0 || itr->second->GetPlayer()->GetTeam() == team))
         {
-            itr->second->SendPacket(packet);
+            itr->second->SendPacket(shared);
         }
     }
+
+    shared->RemoveReference();
 }
 
 // Send a packet to all GMs (except self if mentioned)
@@ -84,6 +84,7 @@ enum WorldTimers
 enum WorldConfigs
 {
     CONFIG_COMPRESSION = 0,
+    CONFIG_COMPRESSION_THRESHOLD,
     CONFIG_GRID_UNLOAD,
     CONFIG_INTERVAL_SAVE,
     CONFIG_INTERVAL_GRIDCLEAN,
@@ -142,6 +143,7 @@ enum WorldConfigs
     CONFIG_ALLOW_GM_GROUP,
     CONFIG_ALLOW_GM_FRIEND,
     CONFIG_GROUP_VISIBILITY,
+    CONFIG_VISIBILITY_RELOCATION_LIMIT,
     CONFIG_MAIL_DELIVERY_DELAY,
     CONFIG_EXTERNAL_MAIL,
     CONFIG_EXTERNAL_MAIL_INTERVAL,
@@ -170,6 +172,7 @@ enum WorldConfigs
     CONFIG_CREATURE_FAMILY_ASSISTANCE_RADIUS,
     CONFIG_CREATURE_FAMILY_ASSISTANCE_DELAY,
     CONFIG_CREATURE_FAMILY_FLEE_DELAY,
+    CONFIG_CREATURE_IDLE_SLEEP,
     CONFIG_WORLD_BOSS_LEVEL_DIFF,
     CONFIG_QUEST_LOW_LEVEL_HIDE_DIFF,
     CONFIG_QUEST_HIGH_LEVEL_HIDE_DIFF,
@@ -231,6 +234,16 @@ enum WorldConfigs
     CONFIG_PET_LOS,
     CONFIG_VMAP_TOTEM,
     CONFIG_NUMTHREADS,
+    CONFIG_MAP_PACKET_PROCESSING,
+    CONFIG_MAP_PARALLEL_CELLS,
+    CONFIG_GRID_PRELOAD_THREADS,
+    CONFIG_GRID_PRELOAD_LOOKAHEAD,
+    CONFIG_STARTUP_LOAD_THREADS,
+    CONFIG_MOVEMENT_RELAY,
+    CONFIG_MOVEMENT_RELAY_FAR_DISTANCE,
+    CONFIG_MOVEMENT_RELAY_FAR_INTERVAL,
+    CONFIG_WORLD_CACHE,
+    CONFIG_DBC_MAP_FILES,
     CONFIG_CHATLOG_CHANNEL,
     CONFIG_CHATLOG_WHISPER,
     CONFIG_CHATLOG_SYSCHAN,
@@ -565,6 +578,9 @@ class World
         uint32 DecreaseScheduledScriptCount(size_t count) { return (uint32)(m_scheduledScripts -= count); }
         bool IsScriptScheduled() const { return m_scheduledScripts > 0; }
 
+        // Player autosaves allowed in the current world tick, called from the map update threads
+        bool AcquireAutosave() { return --m_autosaveBudget >= 0; }
+
         bool IsAllowedMap(uint32 mapid) { return m_forbiddenMapIds.count(mapid) == 0 ;}
 
         // for max speed access
@@ -621,6 +637,9 @@ class World
         //atomic op counter for active scripts amount
         ACE_Atomic_Op<ACE_Thread_Mutex, long> m_scheduledScripts;
 
+        // autosaves left in the current tick, keeps them spread over the save interval
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_autosaveBudget;
+
         time_t m_startTime;
         time_t m_gameTime;
         IntervalTimer m_timers[WUPDATE_COUNT];
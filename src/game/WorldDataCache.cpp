@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "WorldDataCache.h"
+#include "Database/DatabaseEnv.h"
+#include "World.h"
+#include "Log.h"
+
+#include <ace/OS_NS_stdio.h>
+#include <ace/OS_NS_sys_stat.h>
+
+#include <string.h>
+
+struct WorldCacheHeader
+{
+    char magic[4];
+    uint32 version;
+    uint32 recordSize;
+    uint32 recordCount;
+    uint32 checksumCount;
+};
+
+static char const WorldCacheMagic[4] = { 'O', 'W', 'C', 'D' };
+
+bool WorldCacheReader::Open(std::string const& filename, uint32 recordSize, std::vector<uint64> const& checksums)
+{
+    if (m_file.map(filename.c_str(), static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_READ, ACE_MAP_SHARED) == -1)
+        return false;
+
+    m_file.close_handle();
+
+    uint8 const* data = static_cast<uint8 const*>(m_file.addr());
+    size_t size = m_file.size();
+    if (size < sizeof(WorldCacheHeader))
+        return false;
+
+    WorldCacheHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, WorldCacheMagic, sizeof(header.magic)) || header.version != WORLD_CACHE_VERSION ||
+        header.recordSize != recordSize || header.checksumCount != checksums.size())
+        return false;
+
+    size_t checksumSize = checksums.size() * sizeof(uint64);
+    size_t recordsOffset = sizeof(header) + checksumSize;
+    if (size != recordsOffset + size_t(header.recordCount) * (2 * sizeof(uint32) + recordSize))
+        return false;
+
+    if (checksumSize && memcmp(data + sizeof(header), &checksums[0], checksumSize))
+        return false;
+
+    m_data = data + recordsOffset;
+    m_recordSize = recordSize;
+    m_count = header.recordCount;
+    return true;
+}
+
+void WorldCacheReader::GetRecord(uint32 index, uint32& guid, uint32& flags, void* data) const
+{
+    uint8 const* record = m_data + size_t(index) * (2 * sizeof(uint32) + m_recordSize);
+    memcpy(&guid, record, sizeof(uint32));
+    memcpy(&flags, record + sizeof(uint32), sizeof(uint32));
+    memcpy(data, record + 2 * sizeof(uint32), m_recordSize);
+}
+
+void WorldCacheWriter::Add(uint32 guid, uint32 flags, void const* data)
+{
+    size_t offset = m_records.size();
+    m_records.resize(offset + 2 * sizeof(uint32) + m_recordSize);
+
+    uint8* record = &m_records[offset];
+    memcpy(record, &guid, sizeof(uint32));
+    memcpy(record + sizeof(uint32), &flags, sizeof(uint32));
+    memcpy(record + 2 * sizeof(uint32), data, m_recordSize);
+    ++m_count;
+}
+
+bool WorldCacheWriter::Save(std::string const& filename) const
+{
+    WorldCacheHeader header;
+    memcpy(header.magic, WorldCacheMagic, sizeof(header.magic));
+    header.version = WORLD_CACHE_VERSION;
+    header.recordSize = m_recordSize;
+    header.recordCount = m_count;
+    header.checksumCount = m_checksums.size();
+
+    std::string tempname = filename + ".tmp";
+    FILE* file = fopen(tempname.c_str(), "wb");
+    if (!file)
+    {
+        sLog.outError("WorldCache: can't create file %s", tempname.c_str());
+        return false;
+    }
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+    if (written && !m_checksums.empty())
+        written = fwrite(&m_checksums[0], sizeof(uint64), m_checksums.size(), file) == m_checksums.size();
+    if (written && !m_records.empty())
+        written = fwrite(&m_records[0], m_records.size(), 1, file) == 1;
+
+    if (fclose(file) != 0)
+        written = false;
+
+    if (!written || ACE_OS::rename(tempname.c_str(), filename.c_str()) != 0)
+    {
+        sLog.outError("WorldCache: can't write file %s", filename.c_str());
+        remove(tempname.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+std::string WorldDataCache::GetFilename(char const* name)
+{
+    std::string path = sWorld.GetDataPath() + "cache";
+    ACE_OS::mkdir(path.c_str());                            // fails when it exists already
+    return path + "/" + name + ".cache";
+}
+
+bool WorldDataCache::GetChecksums(char const* tables, std::vector<uint64>& checksums)
+{
+    checksums.clear();
+
+    QueryResult_AutoPtr result = WorldDatabase.PQuery("CHECKSUM TABLE %s", tables);
+    if (!result)
+        return false;
+
+    do
+    {
+        Field* fields = result->Fetch();
+        if (!fields[1].GetString())                         // NULL for a table that does not exist
+        {
+            sLog.outError("WorldCache: no checksum for table %s, using the database.", fields[0].GetString());
+            return false;
+        }
+
+        checksums.push_back(fields[1].GetUInt64());
+    } while (result->NextRow());
+
+    return true;
+}
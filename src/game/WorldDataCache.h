@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __WORLDDATACACHE_H
+#define __WORLDDATACACHE_H
+
+#include "Platform/Define.h"
+
+#include <ace/Mem_Map.h>
+
+#include <string>
+#include <vector>
+
+// bump when the layout of the file or of a cached record changes
+#define WORLD_CACHE_VERSION     1
+
+enum WorldCacheRecordFlags
+{
+    WORLD_CACHE_IN_GRID         = 0x01                      // spawned by the grid, not by a game event or a pool
+};
+
+// A binary copy of records loaded from the world database, written after a
+// load from SQL and mapped on the next start instead of the queries. The file
+// holds the checksums of the tables the records were built from, it is only
+// used while they are all the same. Any mismatch falls back to SQL.
+//
+// Layout: header, checksums of the tables, records of guid, flags and the data.
+class WorldCacheReader
+{
+    public:
+        WorldCacheReader() : m_data(NULL), m_recordSize(0), m_count(0) {}
+
+        bool Open(std::string const& filename, uint32 recordSize, std::vector<uint64> const& checksums);
+
+        uint32 GetCount() const { return m_count; }
+        // the data is copied out, the mapping may not be aligned for it
+        void GetRecord(uint32 index, uint32& guid, uint32& flags, void* data) const;
+
+    private:
+        ACE_Mem_Map m_file;
+        uint8 const* m_data;
+        uint32 m_recordSize;
+        uint32 m_count;
+};
+
+class WorldCacheWriter
+{
+    public:
+        WorldCacheWriter(uint32 recordSize, std::vector<uint64> const& checksums)
+            : m_recordSize(recordSize), m_checksums(checksums), m_count(0) {}
+
+        void Add(uint32 guid, uint32 flags, void const* data);
+        // written to a temporary file first, a partly written cache is never used
+        bool Save(std::string const& filename) const;
+
+    private:
+        uint32 m_recordSize;
+        std::vector<uint64> m_checksums;
+        std::vector<uint8> m_records;
+        uint32 m_count;
+};
+
+namespace WorldDataCache
+{
+    // "creature" is <DataDir>cache/creature.cache
+    std::string GetFilename(char const* name);
+    // CHECKSUM TABLE of the tables, false when one of them does not exist
+    bool GetChecksums(char const* tables, std::vector<uint64>& checksums);
+}
+#endif
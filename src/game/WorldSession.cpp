@@ -80,6 +80,8 @@ WorldSession::~WorldSession()
         delete packet;
 
     LoginDatabase.PExecute("UPDATE account SET online = 0 WHERE id = %u;", GetAccountId());
+    // all characters of the account, before a login of the next session sets one online
+    SqlAsyncKeyGuard asyncKey(CharacterDatabase, SQL_ASYNC_KEY_ALL);
     CharacterDatabase.PExecute("UPDATE characters SET online = 0 WHERE account = %u;", GetAccountId());
 }
 
@@ -141,6 +143,16 @@ void WorldSession::SendPacket(WorldPacket const* packet)
         m_Socket->CloseSocket();
 }
 
+// Send a packet shared with other sessions, the socket keeps a reference to it
+void WorldSession::SendPacket(SharedPacket* packet)
+{
+    if (!m_Socket)
+        return;
+
+    if (m_Socket->SendPacket(packet) == -1)
+        m_Socket->CloseSocket();
+}
+
 // Add an incoming packet to the queue
 void WorldSession::QueuePacket(WorldPacket* new_packet)
 {
@@ -165,25 +177,16 @@ void WorldSession::LogUnprocessedTail(WorldPacket *packet)
         packet->rpos(),packet->wpos());
 }
 
-// Update the WorldSession (triggered by World update)
-bool WorldSession::Update(uint32 diff)
+// Handle the received packets, called by the World update and by the Map updates
+void WorldSession::ProcessPackets(PacketFilter& filter)
 {
-    /// Update Timeout timer.
-    UpdateTimeOutTime(diff);
-
-    ///- Before we process anything:
-    /// If necessary, kick the player from the character select screen
-    if (IsConnectionIdle())
-        m_Socket->CloseSocket();
-
     #if COMPILER == COMPILER_GNU
     #pragma GCC diagnostic ignored "-Wuninitialized"
     #endif
 
-    // Retrieve packets from the receive queue and call the appropriate handlers
     // not proccess packets if socket already closed
     WorldPacket* packet;
-    while (m_Socket && !m_Socket->IsClosed() && _recvQueue.next(packet))
+    while (m_Socket && !m_Socket->IsClosed() && _recvQueue.next(packet, filter))
     {
         /*#if 1
         sLog.outError("MOEP: %s (0x%.4X)",
@@ -212,7 +215,7 @@ bool WorldSession::Update(uint32 diff)
                             LogUnexpectedOpcode(packet, "the player has not logged in yet");
                     }
                     else if (_player->IsInWorld())
-                        ExecuteOpcode(opHandle, packet);
+                        ExecuteOpcode(opHandle, packet, filter.DelayTeleports());
 
                     // lag can cause STATUS_LOGGEDIN opcodes to arrive after the player started a transfer
                     break;
@@ -222,7 +225,7 @@ bool WorldSession::Update(uint32 diff)
                     else if (_player->IsInWorld())
                         LogUnexpectedOpcode(packet, "the player is still in world");
                     else
-                        ExecuteOpcode(opHandle, packet);
+                        ExecuteOpcode(opHandle, packet, filter.DelayTeleports());
                     break;
                 case STATUS_AUTHED:
                     // prevent cheating with skip queue wait
@@ -234,7 +237,7 @@ bool WorldSession::Update(uint32 diff)
 
                     m_playerRecentlyLogout = false;
 
-                    ExecuteOpcode(opHandle, packet);
+                    ExecuteOpcode(opHandle, packet, filter.DelayTeleports());
                     break;
                 case STATUS_NEVER:
                     sLog.outError("SESSION: received not allowed opcode %s (0x%.4X)", LookupOpcodeName(packet->GetOpcode()), packet->GetOpcode());
@@ -259,6 +262,31 @@ bool WorldSession::Update(uint32 diff)
     #if COMPILER == COMPILER_GNU
     #	pragma GCC diagnostic warning "-Wuninitialized"
     #endif
+}
+
+// Update the WorldSession (triggered by World update)
+bool WorldSession::Update(uint32 diff)
+{
+    /// Update Timeout timer.
+    UpdateTimeOutTime(diff);
+
+    ///- Before we process anything:
+    /// If necessary, kick the player from the character select screen
+    if (IsConnectionIdle())
+        m_Socket->CloseSocket();
+
+    // Retrieve packets from the receive queue and call the appropriate handlers,
+    // the thread safe ones are left to the map of the player if enabled
+    if (sWorld.getConfig(CONFIG_MAP_PACKET_PROCESSING))
+    {
+        WorldSessionFilter filter(this);
+        ProcessPackets(filter);
+    }
+    else
+    {
+        PacketFilter filter(this);
+        ProcessPackets(filter);
+    }
 
     if (m_Socket && !m_Socket->IsClosed() && m_Warden)
         m_Warden->Update();
@@ -428,6 +456,7 @@ void WorldSession::LogoutPlayer(bool Save)
         // E.g if he got disconnected during a transfer to another map
         // Calls to GetMap in this case may cause crashes
         _player->CleanupsBeforeDelete();
+        uint32 playerGuidLow = _player->GetGUIDLow();
         Map* _map = _player->GetMap();
         _map->Remove(_player, true);
         _player = NULL; // deleted in Remove call
@@ -437,7 +466,8 @@ void WorldSession::LogoutPlayer(bool Save)
         SendPacket(&data);
 
         // Since each account can only have one online character at any given time, ensure all characters for active account are marked as offline
-        // No SQL injection as AccountId is uint32
+        // No SQL injection as AccountId is uint32, after the last save of the player
+        SqlAsyncKeyGuard asyncKey(CharacterDatabase, playerGuidLow);
         CharacterDatabase.PExecute("UPDATE characters SET online = 0 WHERE account = '%u'",
             GetAccountId());
         sLog.outDebug("SESSION: Sent SMSG_LOGOUT_COMPLETE Message");
@@ -571,7 +601,7 @@ void WorldSession::InitWarden(BigNumber* K, std::string os)
 
     m_Warden->Init(this, K);
 }
-void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket* packet)
+void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket* packet, bool delayTeleport)
 {
     // need prevent do internal far teleports in handlers because some handlers do lot steps
     // or call code that can do far teleports in some conditions unexpectedly for generic way work code
@@ -587,10 +617,36 @@ void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket* pac
 
         //we should execute delayed teleports only for alive(!) players
         //because we don't want player's ghost teleported from graveyard
-        if (_player->IsHasDelayedTeleport())
+        //the map update does them in Player::Update when it handles the packets
+        if (!delayTeleport && _player->IsHasDelayedTeleport())
             _player->TeleportTo(_player->m_teleport_dest, _player->m_teleport_options);
     }
 
     if (packet->rpos() < packet->wpos())
         LogUnprocessedTail(packet);
-}
\ No newline at end of file
+}
+
+bool MapSessionFilter::Process(WorldPacket* packet)
+{
+    if (packet->GetOpcode() >= NUM_MSG_TYPES)
+        return false;
+
+    if (opcodeTable[packet->GetOpcode()].packetProcessing != PROCESS_THREADSAFE)
+        return false;
+
+    Player* plr = m_pSession->GetPlayer();
+    return plr && plr->IsInWorld();
+}
+
+bool WorldSessionFilter::Process(WorldPacket* packet)
+{
+    if (packet->GetOpcode() >= NUM_MSG_TYPES)
+        return true;
+
+    if (opcodeTable[packet->GetOpcode()].packetProcessing != PROCESS_THREADSAFE)
+        return true;
+
+    // the map only handles the packets of players in it
+    Player* plr = m_pSession->GetPlayer();
+    return !plr || !plr->IsInWorld();
+}
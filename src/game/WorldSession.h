@@ -35,6 +35,7 @@ class Object;
 class Player;
 class Unit;
 class WorldPacket;
+class SharedPacket;
 class WorldSocket;
 class QueryResult;
 class LoginQueryHolder;
@@ -63,6 +64,42 @@ enum PartyResult
     PARTY_RESULT_INVITE_RESTRICTED    = 13
 };
 
+// Decides which packet a session update may handle next, packets are always
+// handled in the order they were received
+class PacketFilter
+{
+    public:
+        explicit PacketFilter(WorldSession* pSession) : m_pSession(pSession) {}
+        virtual ~PacketFilter() {}
+
+        virtual bool Process(WorldPacket* /*packet*/) { return true; }
+        // far teleports done by the handlers wait for the next Player::Update
+        virtual bool DelayTeleports() const { return false; }
+
+    protected:
+        WorldSession* const m_pSession;
+};
+
+// Packets handled by the map update thread of the player
+class MapSessionFilter : public PacketFilter
+{
+    public:
+        explicit MapSessionFilter(WorldSession* pSession) : PacketFilter(pSession) {}
+
+        virtual bool Process(WorldPacket* packet);
+        // the map is in the middle of its update, the player can't leave it yet
+        virtual bool DelayTeleports() const { return true; }
+};
+
+// Packets left to the world thread while the maps handle the thread safe ones
+class WorldSessionFilter : public PacketFilter
+{
+    public:
+        explicit WorldSessionFilter(WorldSession* pSession) : PacketFilter(pSession) {}
+
+        virtual bool Process(WorldPacket* packet);
+};
+
 // Player session in the World
 class WorldSession
 {
@@ -78,6 +115,7 @@ class WorldSession
         void SizeError(WorldPacket const& packet, uint32 size) const;
 
         void SendPacket(WorldPacket const* packet);
+        void SendPacket(SharedPacket* packet);
         void SendNotification(const char *format,...) ATTR_PRINTF(2,3);
         void SendNotification(int32 string_id,...);
         void SendPetNameInvalid(uint32 error, const std::string& name, DeclinedName *declinedName);
@@ -120,6 +158,9 @@ class WorldSession
         void QueuePacket(WorldPacket* new_packet);
         bool Update(uint32 diff);
 
+        // handles the received packets as long as the filter accepts them
+        void ProcessPackets(PacketFilter& filter);
+
         // Handle the authentication waiting queue (to be completed)
         void SendAuthWaitQue(uint32 position);
 
@@ -650,7 +691,7 @@ class WorldSession
         // private trade methods
         void moveItems(Item* myItems[], Item* hisItems[]);
 
-        void ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket* packet);
+        void ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket* packet, bool delayTeleport);
 
         // logging helper
         void LogUnexpectedOpcode(WorldPacket *packet, const char * reason);
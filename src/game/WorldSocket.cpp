@@ -70,6 +70,9 @@ struct ClientPktHeader
 #pragma pack(pop)
 #endif
 
+// Maximum number of buffers given to one scatter-gather write.
+#define WORLD_SOCKET_MAX_IOV 64
+
 WorldSocket::WorldSocket (void) :
 WorldHandler(),
 m_LastPingTime(ACE_Time_Value::zero),
@@ -78,8 +81,11 @@ m_Session(0),
 m_RecvWPct(0),
 m_RecvPct(),
 m_Header(sizeof (ClientPktHeader)),
-m_OutBuffer(0),
 m_OutBufferSize(65536),
+m_OutPendingOffset(0),
+m_OutQueuedBytes(0),
+m_OutQueueLimit(0),
+m_OutOverflow(false),
 m_OutActive(false),
 m_Seed(static_cast<uint32> (rand32()))
 {
@@ -90,16 +96,15 @@ WorldSocket::~WorldSocket (void)
 {
     delete m_RecvWPct;
 
-    if (m_OutBuffer)
-        m_OutBuffer->release();
-
     closing_ = true;
 
     peer().close();
 
-    WorldPacket* pct;
-    while (m_PacketQueue.dequeue_head (pct) == 0)
-        delete pct;
+    for (std::deque<WorldSocketOutPacket*>::iterator itr = m_OutPending.begin(); itr != m_OutPending.end(); ++itr)
+        DeleteOutPacket (*itr);
+
+    while (WorldSocketOutPacket* pkt = m_PacketQueue.pop())
+        DeleteOutPacket (pkt);
 }
 
 bool WorldSocket::IsClosed (void) const
@@ -133,9 +138,17 @@ const std::string& WorldSocket::GetRemoteAddress (void) const
 
 int WorldSocket::SendPacket (const WorldPacket& pct)
 {
-    ACE_GUARD_RETURN (LockType, Guard, m_OutBufferLock, -1);
+    return QueuePacket (pct.GetOpcode (), pct.empty () ? NULL : pct.contents (), pct.size (), NULL);
+}
 
-    if (closing_)
+int WorldSocket::SendPacket (SharedPacket* pct)
+{
+    return QueuePacket (pct->GetOpcode (), pct->contents (), pct->size (), pct);
+}
+
+int WorldSocket::QueuePacket (uint16 opcode, const uint8* data, size_t size, SharedPacket* shared)
+{
+    if (closing_ || m_OutOverflow)
         return -1;
 
     // Dump outgoing packet.
@@ -143,37 +156,57 @@ int WorldSocket::SendPacket (const WorldPacket& pct)
     {
         sWorldLog.outTimestampLog ("SERVER:\nSOCKET: %u\nLENGTH: %u\nOPCODE: %s (0x%.4X)\nDATA:\n",
                      (uint32) get_handle(),
-                     pct.size(),
-                     LookupOpcodeName (pct.GetOpcode()),
-                     pct.GetOpcode());
+                     (uint32) size,
+                     LookupOpcodeName (opcode),
+                     opcode);
 
         uint32 p = 0;
-        while (p < pct.size())
+        while (p < size)
         {
-            for (uint32 j = 0; j < 16 && p < pct.size(); j++)
-                sWorldLog.outLog("%.2X ", const_cast<WorldPacket&>(pct)[p++]);
+            for (uint32 j = 0; j < 16 && p < size; j++)
+                sWorldLog.outLog("%.2X ", data[p++]);
 
             sWorldLog.outLog("\n");
         }
         sWorldLog.outLog("\n");
     }
 
-    if (iSendPacket (pct) == -1)
-    {
-        WorldPacket* npct;
+    const size_t pkt_size = sizeof (ServerPktHeader) + size;
 
-        ACE_NEW_RETURN (npct, WorldPacket (pct), -1);
+    if (m_OutQueueLimit && size_t (m_OutQueuedBytes.value ()) + pkt_size > m_OutQueueLimit)
+    {
+        // the client does not read fast enough, let the network thread drop it
+        sLog.outError ("WorldSocket::SendPacket: send queue of %s exceeds " SIZEFMTD " bytes, closing connection",
+                       GetRemoteAddress ().c_str (), m_OutQueueLimit);
 
-        // NOTE maybe check of the size of the queue can be good ?
-        // to make it bounded instead of unbounded
-        if (m_PacketQueue.enqueue_tail (npct) == -1)
-        {
-            delete npct;
-            sLog.outError ("WorldSocket::SendPacket: m_PacketQueue.enqueue_tail failed");
-            return -1;
-        }
+        m_OutOverflow = true;
+        return -1;
     }
 
+    // a shared payload is not copied, the queue entry only holds the header
+    char* mem;
+    ACE_NEW_RETURN (mem, char[sizeof (WorldSocketOutPacket) + (shared ? 0 : size)], -1);
+
+    WorldSocketOutPacket* pkt = reinterpret_cast<WorldSocketOutPacket*> (mem);
+    pkt->size = size;
+    pkt->shared = shared;
+
+    ServerPktHeader& header = *((ServerPktHeader*) pkt->header);
+
+    header.cmd = opcode;
+    EndianConvert(header.cmd);
+
+    header.size = (uint16) size + 2;
+    EndianConvertReverse(header.size);
+
+    if (shared)
+        shared->AddReference ();
+    else if (size)
+        memcpy (pkt->data (), data, size);
+
+    m_OutQueuedBytes += long (pkt_size);
+    m_PacketQueue.push (pkt);
+
     return 0;
 }
 
@@ -192,7 +225,7 @@ int WorldSocket::open (void *a)
     ACE_UNUSED_ARG (a);
 
     // Prevent double call to this func.
-    if (m_OutBuffer)
+    if (!m_Address.empty())
         return -1;
 
     // This will also prevent the socket from being Updated
@@ -203,9 +236,6 @@ int WorldSocket::open (void *a)
     if (sWorldSocketMgr->OnSocketOpen(this) == -1)
         return -1;
 
-    // Allocate the buffer.
-    ACE_NEW_RETURN (m_OutBuffer, ACE_Message_Block (m_OutBufferSize), -1);
-
     // Store peer address.
     ACE_INET_Addr remote_addr;
 
@@ -288,18 +318,56 @@ int WorldSocket::handle_output (ACE_HANDLE)
 {
     ACE_GUARD_RETURN (LockType, Guard, m_OutBufferLock, -1);
 
-    if (closing_)
+    if (closing_ || m_OutOverflow)
         return -1;
 
-    const size_t send_len = m_OutBuffer->length ();
+    iFetchPacketQueue ();
 
-    if (send_len == 0)
+    if (m_OutPending.empty ())
         return cancel_wakeup_output (Guard);
 
+    // gather as many pending packets as allowed into one write
+    iovec iov[WORLD_SOCKET_MAX_IOV];
+    int iovcnt = 0;
+    size_t send_len = 0;
+    size_t skip = m_OutPendingOffset;
+
+    for (std::deque<WorldSocketOutPacket*>::const_iterator itr = m_OutPending.begin();
+        itr != m_OutPending.end() && iovcnt + 2 <= WORLD_SOCKET_MAX_IOV && send_len < m_OutBufferSize; ++itr)
+    {
+        WorldSocketOutPacket* pkt = *itr;
+
+        if (skip < sizeof (ServerPktHeader))
+        {
+            iov[iovcnt].iov_base = (char*) pkt->header + skip;
+            iov[iovcnt].iov_len = sizeof (ServerPktHeader) - skip;
+            send_len += iov[iovcnt].iov_len;
+            ++iovcnt;
+            skip = 0;
+        }
+        else
+            skip -= sizeof (ServerPktHeader);
+
+        if (pkt->size > skip)
+        {
+            iov[iovcnt].iov_base = (char*) pkt->payload () + skip;
+            iov[iovcnt].iov_len = pkt->size - skip;
+            send_len += iov[iovcnt].iov_len;
+            ++iovcnt;
+        }
+
+        skip = 0;
+    }
+
 #ifdef MSG_NOSIGNAL
-    ssize_t n = peer().send (m_OutBuffer->rd_ptr(), send_len, MSG_NOSIGNAL);
+    msghdr msg;
+    memset (&msg, 0, sizeof (msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iovcnt;
+
+    ssize_t n = ACE_OS::sendmsg (get_handle (), &msg, MSG_NOSIGNAL);
 #else
-    ssize_t n = peer().send (m_OutBuffer->rd_ptr(), send_len);
+    ssize_t n = peer().sendv (iov, iovcnt);
 #endif // MSG_NOSIGNAL
 
     if (n == 0)
@@ -311,26 +379,32 @@ int WorldSocket::handle_output (ACE_HANDLE)
 
         return -1;
     }
-    else if (size_t(n) < send_len) //now n > 0
-    {
-        m_OutBuffer->rd_ptr (static_cast<size_t> (n));
 
-        // move the data to the base of the buffer
-        m_OutBuffer->crunch();
+    m_OutQueuedBytes -= long (n);
 
-        return schedule_wakeup_output (Guard);
-    }
-    else //now n == send_len
+    // drop the packets that were written completely
+    size_t sent = static_cast<size_t> (n);
+    while (sent > 0)
     {
-        m_OutBuffer->reset();
+        WorldSocketOutPacket* pkt = m_OutPending.front ();
+        const size_t left = sizeof (ServerPktHeader) + pkt->size - m_OutPendingOffset;
 
-        if (!iFlushPacketQueue ())
-            return cancel_wakeup_output (Guard);
-        else
-            return schedule_wakeup_output (Guard);
+        if (sent < left)
+        {
+            m_OutPendingOffset += sent;
+            break;
+        }
+
+        sent -= left;
+        m_OutPendingOffset = 0;
+        m_OutPending.pop_front ();
+        DeleteOutPacket (pkt);
     }
 
-    ACE_NOTREACHED (return 0);
+    if (m_OutPending.empty () && m_OutQueuedBytes.value () == 0)
+        return cancel_wakeup_output (Guard);
+
+    return schedule_wakeup_output (Guard);
 }
 
 int WorldSocket::handle_close (ACE_HANDLE h, ACE_Reactor_Mask)
@@ -358,10 +432,10 @@ int WorldSocket::handle_close (ACE_HANDLE h, ACE_Reactor_Mask)
 
 int WorldSocket::Update (void)
 {
-    if (closing_)
+    if (closing_ || m_OutOverflow)
         return -1;
 
-    if (m_OutActive || m_OutBuffer->length () == 0)
+    if (m_OutActive || m_OutQueuedBytes.value () == 0)
         return 0;
 
     return handle_output (get_handle ());
@@ -692,24 +766,8 @@ int WorldSocket::HandleAuthSession (WorldPacket& recvPacket)
     }
 
     // Get the account information from the realmd database
-    std::string safe_account = account; // Duplicate, else will screw the SHA hash verification below
-    LoginDatabase.escape_string (safe_account);
-    // No SQL injection, username escaped.
-
-    QueryResult_AutoPtr result = LoginDatabase.PQuery ("SELECT "
-                                "id, "                      //0
-                                "sessionkey, "              //1
-                                "last_ip, "                 //2
-                                "locked, "                  //3
-                                "v, "                       //4
-                                "s, "                       //5
-                                "expansion, "               //6
-                                "mutetime, "                //7
-                                "locale, "                  //8
-                                "os "                       //9
-                                "FROM account "
-                                "WHERE username = '%s'",
-                                safe_account.c_str ());
+    // No SQL injection, the username is bound as a parameter.
+    QueryResult_AutoPtr result = LoginDatabase.Query(LOGIN_SEL_ACCOUNT_INFO_BY_NAME, SqlStmtParameters(1).addString(account));
 
     // Stop if the account is not found
     if (!result)
@@ -771,16 +829,8 @@ int WorldSocket::HandleAuthSession (WorldPacket& recvPacket)
     if (locale >= MAX_LOCALE)
         locale = LOCALE_enUS;
 
-        // Checks gmlevel per Realm
-        result =
-        LoginDatabase.PQuery ("SELECT "
-                              "RealmID, "            //0
-                              "gmlevel "             //1
-                              "FROM account_access "
-                              "WHERE id = '%d'"
-                              " AND (RealmID = '%d'"
-                              " OR RealmID = '-1')",
-                              id, realmID);
+    // Checks gmlevel per Realm
+    result = LoginDatabase.Query(LOGIN_SEL_ACCOUNT_ACCESS_GMLEVEL, SqlStmtParameters(2).addUInt32(id).addInt32(realmID));
     if (!result)
         security = 0;
     else
@@ -790,13 +840,7 @@ int WorldSocket::HandleAuthSession (WorldPacket& recvPacket)
     }
 
     // Re-check account ban (same check as in realmd)
-    QueryResult_AutoPtr banresult = LoginDatabase.PQuery ("SELECT "
-                                "bandate, "
-                                "unbandate "
-                                "FROM account_banned "
-                                "WHERE id = '%u' "
-                                "AND active = 1",
-                                id);
+    QueryResult_AutoPtr banresult = LoginDatabase.Query(LOGIN_SEL_ACCOUNT_BANNED, SqlStmtParameters(1).addUInt32(id));
 
     if (banresult) // if account banned
     {
@@ -854,14 +898,7 @@ int WorldSocket::HandleAuthSession (WorldPacket& recvPacket)
                 address.c_str());
 
     // Update the last_ip in the database
-    // No SQL injection, username escaped.
-    LoginDatabase.escape_string (address);
-
-    LoginDatabase.PExecute ("UPDATE account "
-                            "SET last_ip = '%s' "
-                            "WHERE username = '%s'",
-                            address.c_str(),
-                            safe_account.c_str());
+    LoginDatabase.Execute(LOGIN_UPD_ACCOUNT_LAST_IP, SqlStmtParameters(2).addString(address).addString(account));
 
     // NOTE ATM the socket is single-threaded, have this in mind ...
     ACE_NEW_RETURN (m_Session, WorldSession (id, this, security, expansion, mutetime, locale), -1);
@@ -949,59 +986,22 @@ int WorldSocket::HandlePing (WorldPacket& recvPacket)
     return SendPacket (packet);
 }
 
-int WorldSocket::iSendPacket (const WorldPacket& pct)
+void WorldSocket::iFetchPacketQueue ()
 {
-    if (m_OutBuffer->space () < pct.size () + sizeof (ServerPktHeader))
+    // the headers are encrypted here in one go, in the order the
+    // packets are written, not by the threads that queued them
+    while (WorldSocketOutPacket* pkt = m_PacketQueue.pop ())
     {
-        errno = ENOBUFS;
-        return -1;
+        m_Crypt.EncryptSend (pkt->header, sizeof (ServerPktHeader));
+        m_OutPending.push_back (pkt);
     }
-
-    ServerPktHeader header;
-
-    header.cmd = pct.GetOpcode ();
-    EndianConvert(header.cmd);
-
-    header.size = (uint16) pct.size () + 2;
-    EndianConvertReverse(header.size);
-
-    m_Crypt.EncryptSend ((uint8*) & header, sizeof (header));
-
-    if (m_OutBuffer->copy ((char*) & header, sizeof (header)) == -1)
-        ACE_ASSERT (false);
-
-    if (!pct.empty ())
-        if (m_OutBuffer->copy ((char*) pct.contents (), pct.size ()) == -1)
-            ACE_ASSERT (false);
-
-    return 0;
 }
 
-bool WorldSocket::iFlushPacketQueue ()
+void WorldSocket::DeleteOutPacket (WorldSocketOutPacket* pkt)
 {
-    WorldPacket *pct;
-    bool haveone = false;
-
-    while (m_PacketQueue.dequeue_head (pct) == 0)
-    {
-        if (iSendPacket (*pct) == -1)
-        {
-            if (m_PacketQueue.enqueue_head (pct) == -1)
-            {
-                delete pct;
-                sLog.outError ("WorldSocket::iFlushPacketQueue m_PacketQueue->enqueue_head");
-                return false;
-            }
-
-            break;
-        }
-        else
-        {
-            haveone = true;
-            delete pct;
-        }
-    }
+    if (pkt->shared)
+        pkt->shared->RemoveReference ();
 
-    return haveone;
+    delete[] reinterpret_cast<char*> (pkt);
 }
 
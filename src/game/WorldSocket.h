@@ -28,7 +28,7 @@
 #include <ace/Acceptor.h>
 #include <ace/Thread_Mutex.h>
 #include <ace/Guard_T.h>
-#include <ace/Unbounded_Queue.h>
+#include <ace/Atomic_Op.h>
 #include <ace/Message_Block.h>
 
 #if !defined (ACE_LACKS_PRAGMA_ONCE)
@@ -37,11 +37,34 @@
 
 #include "Common.h"
 #include "Auth/AuthCrypt.h"
+#include "MPSCQueue.h"
+#include "SharedPacket.h"
+
+#include <deque>
 
 class ACE_Message_Block;
 class WorldPacket;
 class WorldSession;
 
+// Packet waiting in the send queue of a socket, the payload follows the struct
+// in the same allocation unless it is shared with other sockets.
+struct WorldSocketOutPacket
+{
+    WorldSocketOutPacket* volatile next;
+
+    // ServerPktHeader, encrypted by the thread writing to the socket
+    uint8 header[4];
+
+    // size of the payload
+    size_t size;
+
+    // broadcast payload, one reference held by this packet
+    SharedPacket* shared;
+
+    uint8* data() { return reinterpret_cast<uint8*>(this + 1); }
+    uint8 const* payload() { return shared ? shared->contents() : data(); }
+};
+
 // Handler that can communicate over stream sockets.
 typedef ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH> WorldHandler;
 
@@ -96,8 +119,8 @@ class WorldSocket : protected WorldHandler
         typedef ACE_Thread_Mutex LockType;
         typedef ACE_Guard<LockType> GuardType;
 
-        // Queue for storing packets for which there is no space.
-        typedef ACE_Unbounded_Queue< WorldPacket* > PacketQueueT;
+        // Queue the packets are appended to by any thread and written from by the network thread.
+        typedef ACE_Based::MPSCQueue< WorldSocketOutPacket > PacketQueueT;
 
         // Check if socket is closed.
         bool IsClosed (void) const;
@@ -108,11 +131,14 @@ class WorldSocket : protected WorldHandler
         // Get address of connected peer.
         const std::string& GetRemoteAddress (void) const;
 
-        // Send A packet on the socket, this function is reentrant.
+        // Send A packet on the socket, this function is reentrant and never blocks.
         // pct packet to send
-        // return -1 of failure
+        // return -1 of failure or if the send queue of the client is full
         int SendPacket (const WorldPacket& pct);
 
+        // Send a broadcast packet, the socket keeps a reference to the payload instead of a copy.
+        int SendPacket (SharedPacket* pct);
+
         // Add reference to this object.
         long AddReference (void);
 
@@ -164,15 +190,14 @@ class WorldSocket : protected WorldHandler
         // Called by ProcessIncoming() on CMSG_PING.
         int HandlePing (WorldPacket& recvPacket);
 
-        // Try to write WorldPacket to m_OutBuffer ,return -1 if no space
+        // Move the packets of m_PacketQueue to m_OutPending and encrypt their headers.
         // Need to be called with m_OutBufferLock lock held
-        int iSendPacket (const WorldPacket& pct);
+        void iFetchPacketQueue ();
 
-        // Flush m_PacketQueue if there are packets in it
-        // Need to be called with m_OutBufferLock lock held
-        // return true if it wrote to the buffer (AKA you need
-        // to mark the socket for output).
-        bool iFlushPacketQueue ();
+        // Append a packet to the send queue, shared is NULL to copy the payload.
+        int QueuePacket (uint16 opcode, const uint8* data, size_t size, SharedPacket* shared);
+
+        static void DeleteOutPacket (WorldSocketOutPacket* pkt);
 
     private:
         // Time in which the last ping was received
@@ -204,19 +229,30 @@ class WorldSocket : protected WorldHandler
         // Fragment of the received header.
         ACE_Message_Block m_Header;
 
-        // Mutex for protecting output related data.
+        // Mutex for protecting output related data, not taken by SendPacket.
         LockType m_OutBufferLock;
 
-        // Buffer used for writing output.
-        ACE_Message_Block *m_OutBuffer;
-
-        // Size of the m_OutBuffer.
+        // Maximum amount of bytes handed to the kernel in one write.
         size_t m_OutBufferSize;
 
-        // Here are stored packets for which there was no space on m_OutBuffer,
-        // this allows not-to kick player if its buffer is overflowed.
+        // Packets appended by SendPacket, not yet seen by the network thread.
         PacketQueueT m_PacketQueue;
 
+        // Packets with encrypted headers, in the order they go on the wire.
+        std::deque<WorldSocketOutPacket*> m_OutPending;
+
+        // Bytes of the first packet of m_OutPending already written.
+        size_t m_OutPendingOffset;
+
+        // Bytes in m_PacketQueue and m_OutPending not yet written.
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_OutQueuedBytes;
+
+        // Limit of m_OutQueuedBytes, a client that can't keep up with it is disconnected.
+        size_t m_OutQueueLimit;
+
+        // Set by SendPacket when the limit was hit, the network thread closes the socket.
+        volatile bool m_OutOverflow;
+
         // True if the socket is registered with the reactor for output
         bool m_OutActive;
 
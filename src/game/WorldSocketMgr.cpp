@@ -206,6 +206,7 @@ WorldSocketMgr::WorldSocketMgr() :
     m_NetThreadsCount(0),
     m_SockOutKBuff(-1),
     m_SockOutUBuff(65536),
+    m_SockOutQueueLimit(4194304),
     m_UseNoDelay(true),
     m_Acceptor (0)
 {
@@ -247,6 +248,15 @@ WorldSocketMgr::StartReactiveIO (ACE_UINT16 port, const char* address)
         return -1;
     }
 
+    // 0 means unlimited
+    m_SockOutQueueLimit = sConfig.GetIntDefault ("Network.OutQueueLimit", 4194304);
+
+    if (m_SockOutQueueLimit < 0)
+    {
+        sLog.outError ("Network.OutQueueLimit is wrong in your config file");
+        return -1;
+    }
+
     WorldSocket::Acceptor *acc = new WorldSocket::Acceptor;
     m_Acceptor = acc;
 
@@ -338,6 +348,7 @@ WorldSocketMgr::OnSocketOpen (WorldSocket* sock)
     }
 
     sock->m_OutBufferSize = static_cast<size_t> (m_SockOutUBuff);
+    sock->m_OutQueueLimit = static_cast<size_t> (m_SockOutQueueLimit);
 
     // we skip the Acceptor Thread
     size_t min = 1;
@@ -61,6 +61,7 @@ private:
 
   int m_SockOutKBuff;
   int m_SockOutUBuff;
+  int m_SockOutQueueLimit;
   bool m_UseNoDelay;
 
   ACE_Event_Handler* m_Acceptor;
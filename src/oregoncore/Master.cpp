@@ -316,7 +316,8 @@ bool Master::StartDatabase()
     }
 
     // Initialise the world database
-    if (!WorldDatabase.Initialize(dbstring.c_str()))
+    if (!WorldDatabase.Initialize(dbstring.c_str(), sConfig.GetIntDefault("WorldDatabase.Connections", 1),
+        sConfig.GetIntDefault("WorldDatabase.AsyncThreads", 1)))
     {
         sLog.outError("Cannot connect to world database %s",dbstring.c_str());
         return false;
@@ -331,12 +332,19 @@ bool Master::StartDatabase()
     }
 
     // Initialise the Character database
-    if (!CharacterDatabase.Initialize(dbstring.c_str()))
+    if (!CharacterDatabase.Initialize(dbstring.c_str(), sConfig.GetIntDefault("CharacterDatabase.Connections", 1),
+        sConfig.GetIntDefault("CharacterDatabase.AsyncThreads", 1)))
     {
         sLog.outError("Cannot connect to Character database %s",dbstring.c_str());
         return false;
     }
 
+    if (!PrepareCharacterDatabaseStatements())
+    {
+        sLog.outError("Cannot prepare the statements of the Character database");
+        return false;
+    }
+
     // Get login database info from configuration file
     dbstring = sConfig.GetStringDefault("LoginDatabaseInfo", "");
     if (dbstring.empty())
@@ -346,12 +354,19 @@ bool Master::StartDatabase()
     }
 
     // Initialise the login database
-    if (!LoginDatabase.Initialize(dbstring.c_str()))
+    if (!LoginDatabase.Initialize(dbstring.c_str(), sConfig.GetIntDefault("LoginDatabase.Connections", 1),
+        sConfig.GetIntDefault("LoginDatabase.AsyncThreads", 1)))
     {
         sLog.outError("Cannot connect to login database %s",dbstring.c_str());
         return false;
     }
 
+    if (!PrepareLoginDatabaseStatements())
+    {
+        sLog.outError("Cannot prepare the statements of the login database");
+        return false;
+    }
+
     // Get the realm Id from the configuration file
     realmID = sConfig.GetIntDefault("RealmID", 0);
     if (!realmID)
@@ -232,8 +232,8 @@ struct boss_chromaggusAI : public ScriptedAI
         //Affliction_Timer
         if (Affliction_Timer <= diff)
         {
-            std::list<HostileReference*> threatlist = me->getThreatManager().getThreatList();
-            for (std::list<HostileReference*>::const_iterator i = threatlist.begin(); i != threatlist.end(); ++i)
+            ThreatList threatlist = me->getThreatManager().getThreatList();
+            for (ThreatList::const_iterator i = threatlist.begin(); i != threatlist.end(); ++i)
             {
                 Unit* pUnit;
                 if ((*i) && (*i)->getSource())
@@ -244,9 +244,9 @@ struct boss_attumenAI : public ScriptedAI
             if (ChargeTimer <= diff)
             {
                 Unit *pTarget = NULL;
-                std::list<HostileReference *> t_list = me->getThreatManager().getThreatList();
+                ThreatList t_list = me->getThreatManager().getThreatList();
                 std::vector<Unit *> target_list;
-                for (std::list<HostileReference *>::const_iterator itr = t_list.begin(); itr!= t_list.end(); ++itr)
+                for (ThreatList::const_iterator itr = t_list.begin(); itr!= t_list.end(); ++itr)
                 {
                     pTarget = Unit::GetUnit(*me, (*itr)->getUnitGuid());
                     if (pTarget && !pTarget->IsWithinDist(me, ATTACK_DISTANCE, false) && pTarget->GetTypeId() == TYPEID_PLAYER)
@@ -293,14 +293,14 @@ struct boss_malchezaarAI : public ScriptedAI
         if (!info)
             return;
 
-        std::list<HostileReference *> t_list = me->getThreatManager().getThreatList();
+        ThreatList t_list = me->getThreatManager().getThreatList();
         std::vector<Unit *> targets;
 
         if (!t_list.size())
             return;
 
         //begin + 1, so we don't target the one with the highest threat
-        std::list<HostileReference *>::const_iterator itr = t_list.begin();
+        ThreatList::const_iterator itr = t_list.begin();
         std::advance(itr, 1);
         for (; itr != t_list.end(); ++itr) //store the threat list in a different container
             if (Unit *pTarget = Unit::GetUnit(*me, (*itr)->getUnitGuid()))
@@ -178,13 +178,13 @@ struct boss_aranAI : public ScriptedAI
     void FlameWreathEffect()
     {
         std::vector<Unit*> targets;
-        std::list<HostileReference *> t_list = me->getThreatManager().getThreatList();
+        ThreatList t_list = me->getThreatManager().getThreatList();
 
         if (!t_list.size())
             return;
 
         //store the threat list in a different container
-        for (std::list<HostileReference *>::const_iterator itr = t_list.begin(); itr!= t_list.end(); ++itr)
+        for (ThreatList::const_iterator itr = t_list.begin(); itr!= t_list.end(); ++itr)
         {
             Unit *pTarget = Unit::GetUnit(*me, (*itr)->getUnitGuid());
             //only on alive players
@@ -182,8 +182,8 @@ struct boss_felblood_kaelthasAI : public ScriptedAI
         if (!SummonedUnit)
             return;
 
-        std::list<HostileReference*>& m_threatlist = me->getThreatManager().getThreatList();
-        std::list<HostileReference*>::const_iterator i = m_threatlist.begin();
+        ThreatList& m_threatlist = me->getThreatManager().getThreatList();
+        ThreatList::const_iterator i = m_threatlist.begin();
         for (i = m_threatlist.begin(); i != m_threatlist.end(); ++i)
         {
             Unit* pUnit = Unit::GetUnit((*me), (*i)->getUnitGuid());
@@ -200,7 +200,7 @@ struct boss_felblood_kaelthasAI : public ScriptedAI
         float x = KaelLocations[0][0];
         float y = KaelLocations[0][1];
         me->GetMap()->CreatureRelocation(me, x, y, LOCATION_Z, 0.0f);
-        std::list<HostileReference*>::const_iterator i = me->getThreatManager().getThreatList().begin();
+        ThreatList::const_iterator i = me->getThreatManager().getThreatList().begin();
         for (i = me->getThreatManager().getThreatList().begin(); i!= me->getThreatManager().getThreatList().end(); ++i)
         {
             Unit* pUnit = Unit::GetUnit((*me), (*i)->getUnitGuid());
@@ -212,7 +212,7 @@ struct boss_felblood_kaelthasAI : public ScriptedAI
 
     void CastGravityLapseKnockUp()
     {
-        std::list<HostileReference*>::const_iterator i = me->getThreatManager().getThreatList().begin();
+        ThreatList::const_iterator i = me->getThreatManager().getThreatList().begin();
         for (i = me->getThreatManager().getThreatList().begin(); i!= me->getThreatManager().getThreatList().end(); ++i)
         {
             Unit* pUnit = Unit::GetUnit((*me), (*i)->getUnitGuid());
@@ -224,7 +224,7 @@ struct boss_felblood_kaelthasAI : public ScriptedAI
 
     void CastGravityLapseFly()                              // Use Fly Packet hack for now as players can't cast "fly" spells unless in map 530. Has to be done a while after they get knocked into the air...
     {
-        std::list<HostileReference*>::const_iterator i = me->getThreatManager().getThreatList().begin();
+        ThreatList::const_iterator i = me->getThreatManager().getThreatList().begin();
         for (i = me->getThreatManager().getThreatList().begin(); i!= me->getThreatManager().getThreatList().end(); ++i)
         {
             Unit* pUnit = Unit::GetUnit((*me), (*i)->getUnitGuid());
@@ -245,7 +245,7 @@ struct boss_felblood_kaelthasAI : public ScriptedAI
 
     void RemoveGravityLapse()
     {
-        std::list<HostileReference*>::const_iterator i = me->getThreatManager().getThreatList().begin();
+        ThreatList::const_iterator i = me->getThreatManager().getThreatList().begin();
         for (i = me->getThreatManager().getThreatList().begin(); i!= me->getThreatManager().getThreatList().end(); ++i)
         {
             Unit* pUnit = Unit::GetUnit((*me), (*i)->getUnitGuid());
@@ -796,8 +796,8 @@ struct boss_yazzaiAI : public boss_priestess_lackey_commonAI
         if (Blink_Timer <= diff)
         {
             bool InMeleeRange = false;
-            std::list<HostileReference*>& t_list = me->getThreatManager().getThreatList();
-            for (std::list<HostileReference*>::const_iterator itr = t_list.begin(); itr!= t_list.end(); ++itr)
+            ThreatList& t_list = me->getThreatManager().getThreatList();
+            for (ThreatList::const_iterator itr = t_list.begin(); itr!= t_list.end(); ++itr)
             {
                 if (Unit *pTarget = Unit::GetUnit(*me, (*itr)->getUnitGuid()))
                 {
@@ -876,8 +876,8 @@ struct boss_warlord_salarisAI : public boss_priestess_lackey_commonAI
         if (Intercept_Stun_Timer <= diff)
         {
             bool InMeleeRange = false;
-            std::list<HostileReference*>& t_list = me->getThreatManager().getThreatList();
-            for (std::list<HostileReference*>::const_iterator itr = t_list.begin(); itr!= t_list.end(); ++itr)
+            ThreatList& t_list = me->getThreatManager().getThreatList();
+            for (ThreatList::const_iterator itr = t_list.begin(); itr!= t_list.end(); ++itr)
             {
                 if (Unit *pTarget = Unit::GetUnit(*me, (*itr)->getUnitGuid()))
                 {
@@ -124,7 +124,7 @@ struct boss_maexxnaAI : public ScriptedAI
 
     void DoCastWebWrap()
     {
-        std::list<HostileReference *> t_list = me->getThreatManager().getThreatList();
+        ThreatList t_list = me->getThreatManager().getThreatList();
         std::vector<Unit *> targets;
 
         //This spell doesn't work if we only have 1 player on threat list
@@ -132,7 +132,7 @@ struct boss_maexxnaAI : public ScriptedAI
             return;
 
         //begin + 1 , so we don't target the one with the highest threat
-        std::list<HostileReference *>::iterator itr = t_list.begin();
+        ThreatList::iterator itr = t_list.begin();
         std::advance(itr, 1);
         for (; itr != t_list.end(); ++itr)                   //store the threat list in a different container
         {
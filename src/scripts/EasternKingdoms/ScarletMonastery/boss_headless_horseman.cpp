@@ -557,7 +557,7 @@ struct boss_headless_horsemanAI : public ScriptedAI
             caster->GetMotionMaster()->Clear(false);
             caster->GetMotionMaster()->MoveFollow(me,6,urand(0,5));
             //DoResetThreat();//not sure if need
-            std::list<HostileReference*>::const_iterator itr;
+            ThreatList::const_iterator itr;
             for (itr = caster->getThreatManager().getThreatList().begin(); itr != caster->getThreatManager().getThreatList().end(); ++itr)
             {
                 Unit* pUnit = Unit::GetUnit((*me), (*itr)->getUnitGuid());
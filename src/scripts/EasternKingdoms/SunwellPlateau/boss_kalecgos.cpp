@@ -295,9 +295,9 @@ struct boss_kalecgosAI : public ScriptedAI
 
             if (SpectralBlastTimer <= diff)
             {
-                std::list<HostileReference*> &m_threatlist = me->getThreatManager().getThreatList();
+                ThreatList &m_threatlist = me->getThreatManager().getThreatList();
                 std::list<Unit*> targetList;
-                for (std::list<HostileReference*>::const_iterator itr = m_threatlist.begin(); itr!= m_threatlist.end(); ++itr)
+                for (ThreatList::const_iterator itr = m_threatlist.begin(); itr!= m_threatlist.end(); ++itr)
                     if ((*itr)->getTarget() && (*itr)->getTarget()->GetTypeId() == TYPEID_PLAYER && (*itr)->getTarget()->GetGUID() != me->getVictim()->GetGUID() && !(*itr)->getTarget()->HasAura(AURA_SPECTRAL_EXHAUSTION, 0) && (*itr)->getTarget()->GetPositionZ() > me->GetPositionZ()-5)
                         targetList.push_back((*itr)->getTarget());
                 if (targetList.empty())
@@ -609,9 +609,10 @@ struct boss_sathrovarrAI : public ScriptedAI
 
         if (ResetThreat <= diff)
         {
-            for (std::list<HostileReference*>::const_iterator itr = me->getThreatManager().getThreatList().begin(); itr != me->getThreatManager().getThreatList().end(); ++itr)
+            ThreatList const& threatlist = me->getThreatManager().getThreatList();
+            for (size_t i = 0; i < threatlist.size(); ++i)
             {
-                if (Unit* pUnit = Unit::GetUnit(*me, (*itr)->getUnitGuid()))
+                if (Unit* pUnit = Unit::GetUnit(*me, threatlist[i]->getUnitGuid()))
                 {
                     if (pUnit->GetPositionZ() > me->GetPositionZ()+5)
                     {
@@ -952,7 +952,7 @@ struct mob_hand_of_the_deceiverAI : public ScriptedAI
         {
             if (Creature* pPortal = DoSpawnCreature(CREATURE_FELFIRE_PORTAL, 0, 0,0, 0, TEMPSUMMON_TIMED_DESPAWN, 20000))
             {
-                std::list<HostileReference*>::iterator itr;
+                ThreatList::iterator itr;
                 for (itr = me->getThreatManager().getThreatList().begin(); itr != me->getThreatManager().getThreatList().end(); ++itr)
                 {
                     Unit* pUnit = Unit::GetUnit(*me, (*itr)->getUnitGuid());
@@ -239,7 +239,7 @@ struct boss_mandokirAI : public ScriptedAI
                 {
                     TargetInRange = 0;
 
-                    std::list<HostileReference*>::const_iterator i = me->getThreatManager().getThreatList().begin();
+                    ThreatList::const_iterator i = me->getThreatManager().getThreatList().begin();
                     for (; i != me->getThreatManager().getThreatList().end(); ++i)
                     {
                         Unit* pUnit = Unit::GetUnit(*me, (*i)->getUnitGuid());
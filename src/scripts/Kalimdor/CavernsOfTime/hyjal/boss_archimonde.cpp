@@ -426,12 +426,12 @@ struct boss_archimondeAI : public hyjal_trashAI
         if (victim && me->IsWithinDistInMap(victim, me->GetAttackDistance(victim)))
             return false;
 
-        std::list<HostileReference*>& m_threatlist = me->getThreatManager().getThreatList();
+        ThreatList& m_threatlist = me->getThreatManager().getThreatList();
         if (m_threatlist.empty())
             return false;
 
         std::list<Unit*> targets;
-        std::list<HostileReference*>::iterator itr = m_threatlist.begin();
+        ThreatList::iterator itr = m_threatlist.begin();
         for (; itr != m_threatlist.end(); ++itr)
         {
             Unit* pUnit = Unit::GetUnit((*me), (*itr)->getUnitGuid());
@@ -463,7 +463,7 @@ struct boss_archimondeAI : public hyjal_trashAI
             ((mob_doomfire_targettingAI*)Doomfire->AI())->ArchimondeGUID = me->GetGUID();
             Doomfire->SetFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_NOT_SELECTABLE);
             // Give Doomfire a taste of everyone in the threatlist = more targets to chase.
-            std::list<HostileReference*>::iterator itr;
+            ThreatList::iterator itr;
             for (itr = me->getThreatManager().getThreatList().begin(); itr != me->getThreatManager().getThreatList().end(); ++itr)
                 Doomfire->AddThreat(Unit::GetUnit(*me, (*itr)->getUnitGuid()), 1.0f);
             Doomfire->setFaction(me->getFaction());
@@ -170,8 +170,8 @@ struct boss_kazrogalAI : public hyjal_trashAI
             //cast dummy, useful for bos addons
             me->CastCustomSpell(me, SPELL_MARK, NULL, NULL, NULL, false, NULL, NULL, me->GetGUID());
 
-            std::list<HostileReference *> t_list = me->getThreatManager().getThreatList();
-            for (std::list<HostileReference *>::iterator itr = t_list.begin(); itr != t_list.end(); ++itr)
+            ThreatList t_list = me->getThreatManager().getThreatList();
+            for (ThreatList::iterator itr = t_list.begin(); itr != t_list.end(); ++itr)
             {
                 Unit *pTarget = Unit::GetUnit(*me, (*itr)->getUnitGuid());
                 if (pTarget && pTarget->GetTypeId() == TYPEID_PLAYER && pTarget->getPowerType() == POWER_MANA)
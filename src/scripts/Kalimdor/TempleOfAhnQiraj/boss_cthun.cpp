@@ -619,7 +619,7 @@ struct cthunAI : public Scripted_NoMovementAI
                     //Place all units in threat list on outside of stomach
                     Stomach_Map.clear();
 
-                    std::list<HostileReference*>::iterator i = me->getThreatManager().getThreatList().begin();
+                    ThreatList::iterator i = me->getThreatManager().getThreatList().begin();
                     for (; i != me->getThreatManager().getThreatList().end(); ++i)
                     {
                         //Outside stomach
@@ -276,7 +276,7 @@ struct aqsentinelAI : public ScriptedAI
 
     Unit *GetHatedManaUser()
     {
-        std::list<HostileReference*>::iterator i;
+        ThreatList::iterator i;
         for (i = me->getThreatManager().getThreatList().begin();i != me->getThreatManager().getThreatList().end(); ++i)
         {
             Unit* pUnit = Unit::GetUnit((*me), (*i)->getUnitGuid());
@@ -74,8 +74,8 @@ struct boss_azuregosAI : public ScriptedAI
         if (Teleport_Timer <= diff)
         {
             DoScriptText(SAY_TELEPORT, me);
-            std::list<HostileReference*>& m_threatlist = me->getThreatManager().getThreatList();
-            std::list<HostileReference*>::iterator i = m_threatlist.begin();
+            ThreatList& m_threatlist = me->getThreatManager().getThreatList();
+            ThreatList::iterator i = m_threatlist.begin();
             for (i = m_threatlist.begin(); i != m_threatlist.end();++i)
             {
                 Unit* pUnit = Unit::GetUnit((*me), (*i)->getUnitGuid());
@@ -132,8 +132,8 @@ struct boss_blackheart_the_inciterAI : public ScriptedAI
         {
             DoCast(me, SPELL_INCITE_CHAOS);
 
-            std::list<HostileReference *> t_list = me->getThreatManager().getThreatList();
-            for (std::list<HostileReference *>::iterator itr = t_list.begin(); itr != t_list.end(); ++itr)
+            ThreatList t_list = me->getThreatManager().getThreatList();
+            for (ThreatList::iterator itr = t_list.begin(); itr != t_list.end(); ++itr)
             {
                 Unit *pTarget = Unit::GetUnit(*me, (*itr)->getUnitGuid());
                 if (pTarget && pTarget->GetTypeId() == TYPEID_PLAYER)
@@ -133,8 +133,8 @@ struct boss_murmurAI : public Scripted_NoMovementAI
             // Thundering Storm
             if (ThunderingStorm_Timer <= diff)
             {
-                std::list<HostileReference*>& m_threatlist = me->getThreatManager().getThreatList();
-                for (std::list<HostileReference*>::iterator i = m_threatlist.begin(); i != m_threatlist.end(); ++i)
+                ThreatList& m_threatlist = me->getThreatManager().getThreatList();
+                for (ThreatList::iterator i = m_threatlist.begin(); i != m_threatlist.end(); ++i)
                     if (Unit *pTarget = Unit::GetUnit((*me),(*i)->getUnitGuid()))
                         if (pTarget->isAlive() && me->GetDistance2d(pTarget) > 35)
                             DoCast(pTarget, SPELL_THUNDERING_STORM, true);
@@ -156,8 +156,8 @@ struct boss_murmurAI : public Scripted_NoMovementAI
             return;
         if (!me->IsWithinMeleeRange(me->getVictim()))
         {
-            std::list<HostileReference*>& m_threatlist = me->getThreatManager().getThreatList();
-            for (std::list<HostileReference*>::iterator i = m_threatlist.begin(); i != m_threatlist.end(); ++i)
+            ThreatList& m_threatlist = me->getThreatManager().getThreatList();
+            for (ThreatList::iterator i = m_threatlist.begin(); i != m_threatlist.end(); ++i)
                 if (Unit *pTarget = Unit::GetUnit((*me),(*i)->getUnitGuid()))
                     if (pTarget->isAlive() && me->IsWithinMeleeRange(pTarget))
                     {
@@ -501,7 +501,7 @@ struct boss_illidan_stormrageAI : public ScriptedAI
 
     void DeleteFromThreatList(uint64 TargetGUID)
     {
-        for (std::list<HostileReference*>::const_iterator itr = me->getThreatManager().getThreatList().begin(); itr != me->getThreatManager().getThreatList().end(); ++itr)
+        for (ThreatList::const_iterator itr = me->getThreatManager().getThreatList().begin(); itr != me->getThreatManager().getThreatList().end(); ++itr)
         {
             if ((*itr)->getUnitGuid() == TargetGUID)
             {
@@ -1076,9 +1076,9 @@ struct npc_akama_illidanAI : public ScriptedAI
 
     void KillAllElites()
     {
-        std::list<HostileReference*>& threatList = me->getThreatManager().getThreatList();
+        ThreatList& threatList = me->getThreatManager().getThreatList();
         std::vector<Unit*> eliteList;
-        for (std::list<HostileReference*>::iterator itr = threatList.begin(); itr != threatList.end(); ++itr)
+        for (ThreatList::iterator itr = threatList.begin(); itr != threatList.end(); ++itr)
         {
             Unit* pUnit = Unit::GetUnit((*me), (*itr)->getUnitGuid());
             if (pUnit && pUnit->GetEntry() == ILLIDARI_ELITE)
@@ -356,11 +356,11 @@ struct boss_essence_of_sufferingAI : public ScriptedAI
 
     void CastFixate()
     {
-        std::list<HostileReference*>& m_threatlist = me->getThreatManager().getThreatList();
+        ThreatList& m_threatlist = me->getThreatManager().getThreatList();
         if (m_threatlist.empty())
             return; // No point continuing if empty threatlist.
         std::list<Unit*> targets;
-        std::list<HostileReference*>::const_iterator itr = m_threatlist.begin();
+        ThreatList::const_iterator itr = m_threatlist.begin();
         for (; itr != m_threatlist.end(); ++itr)
         {
             Unit* pUnit = Unit::GetUnit((*me), (*itr)->getUnitGuid());
@@ -132,8 +132,8 @@ struct boss_supremusAI : public ScriptedAI
         uint32 health = 0;
         Unit *pTarget = NULL;
 
-        std::list<HostileReference*>& m_threatlist = me->getThreatManager().getThreatList();
-        std::list<HostileReference*>::iterator i = m_threatlist.begin();
+        ThreatList& m_threatlist = me->getThreatManager().getThreatList();
+        ThreatList::iterator i = m_threatlist.begin();
         for (i = m_threatlist.begin(); i != m_threatlist.end();++i)
         {
             Unit* pUnit = Unit::GetUnit((*me), (*i)->getUnitGuid());
@@ -145,10 +145,10 @@ struct mob_shadowy_constructAI : public ScriptedAI
 
     void CheckPlayers()
     {
-        std::list<HostileReference*>& m_threatlist = me->getThreatManager().getThreatList();
+        ThreatList& m_threatlist = me->getThreatManager().getThreatList();
         if (m_threatlist.empty())
             return;                                         // No threat list. Don't continue.
-        std::list<HostileReference*>::iterator itr = m_threatlist.begin();
+        ThreatList::iterator itr = m_threatlist.begin();
         std::list<Unit*> targets;
         for (; itr != m_threatlist.end(); ++itr)
         {
@@ -293,8 +293,8 @@ struct boss_teron_gorefiendAI : public ScriptedAI
     {
         if (!Blossom) return;
 
-        std::list<HostileReference*>& m_threatlist = me->getThreatManager().getThreatList();
-        std::list<HostileReference*>::iterator i = m_threatlist.begin();
+        ThreatList& m_threatlist = me->getThreatManager().getThreatList();
+        ThreatList::iterator i = m_threatlist.begin();
         for (i = m_threatlist.begin(); i != m_threatlist.end(); ++i)
         {
             Unit* pUnit = Unit::GetUnit((*me), (*i)->getUnitGuid());
@@ -457,8 +457,8 @@ struct boss_lady_vashjAI : public ScriptedAI
             {
                 bool InMeleeRange = false;
                 Unit *pTarget;
-                std::list<HostileReference *> t_list = me->getThreatManager().getThreatList();
-                for (std::list<HostileReference *>::const_iterator itr = t_list.begin(); itr!= t_list.end(); ++itr)
+                ThreatList t_list = me->getThreatManager().getThreatList();
+                for (ThreatList::const_iterator itr = t_list.begin(); itr!= t_list.end(); ++itr)
                 {
                     pTarget = Unit::GetUnit(*me, (*itr)->getUnitGuid());
                                                             //if in melee range
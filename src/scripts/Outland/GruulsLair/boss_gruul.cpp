@@ -134,12 +134,12 @@ struct boss_gruulAI : public ScriptedAI
                     case 0:
                     {
                         //Begin the whole ordeal
-                        std::list<HostileReference*>& m_threatlist = me->getThreatManager().getThreatList();
+                        ThreatList& m_threatlist = me->getThreatManager().getThreatList();
 
                         std::vector<Unit*> knockback_targets;
 
                         //First limit the list to only players
-                        for (std::list<HostileReference*>::iterator itr = m_threatlist.begin(); itr != m_threatlist.end(); ++itr)
+                        for (ThreatList::iterator itr = m_threatlist.begin(); itr != m_threatlist.end(); ++itr)
                         {
                             Unit *pTarget = Unit::GetUnit(*me, (*itr)->getUnitGuid());
 
@@ -170,9 +170,9 @@ struct boss_gruulAI : public ScriptedAI
                     case 1:
                     {
                         //Players are going to get stoned
-                        std::list<HostileReference*>& m_threatlist = me->getThreatManager().getThreatList();
+                        ThreatList& m_threatlist = me->getThreatManager().getThreatList();
 
-                        for (std::list<HostileReference*>::iterator itr = m_threatlist.begin(); itr != m_threatlist.end(); ++itr)
+                        for (ThreatList::iterator itr = m_threatlist.begin(); itr != m_threatlist.end(); ++itr)
                         {
                             Unit *pTarget = Unit::GetUnit(*me, (*itr)->getUnitGuid());
 
@@ -199,8 +199,8 @@ struct boss_gruulAI : public ScriptedAI
                     {
                         //Shatter takes effect
                         // Not Needet Anymore Handled in Spell SPELL_SHATTER
-                        //std::list<HostileReference*>& m_threatlist = me->getThreatManager().getThreatList();
-                        //for (std::list<HostileReference*>::iterator itr = m_threatlist.begin(); itr != m_threatlist.end(); ++itr)
+                        //ThreatList& m_threatlist = me->getThreatManager().getThreatList();
+                        //for (ThreatList::iterator itr = m_threatlist.begin(); itr != m_threatlist.end(); ++itr)
                         //{
                         //    Unit *target = Unit::GetUnit(*me, (*itr)->getUnitGuid());
                         //    if (target)
@@ -695,9 +695,9 @@ struct boss_krosh_firehandAI : public ScriptedAI
         if (BlastWave_Timer <= diff)
         {
                        Unit *pTarget;
-            std::list<HostileReference *> t_list = me->getThreatManager().getThreatList();
+            ThreatList t_list = me->getThreatManager().getThreatList();
             std::vector<Unit *> target_list;
-            for (std::list<HostileReference *>::iterator itr = t_list.begin(); itr != t_list.end(); ++itr)
+            for (ThreatList::iterator itr = t_list.begin(); itr != t_list.end(); ++itr)
             {
                 pTarget = Unit::GetUnit(*me, (*itr)->getUnitGuid());
                                                             //15 yard radius minimum
@@ -912,7 +912,7 @@ struct boss_kaelthasAI : public ScriptedAI
                     //GravityLapse_Timer
                     if (GravityLapse_Timer <= diff)
                     {
-                        std::list<HostileReference*>::iterator i = me->getThreatManager().getThreatList().begin();
+                        ThreatList::iterator i = me->getThreatManager().getThreatList().begin();
                         switch(GravityLapse_Phase)
                         {
                             case 0:
@@ -1264,8 +1264,8 @@ struct boss_grand_astromancer_capernianAI : public advisorbase_ai
         {
             bool InMeleeRange = false;
             Unit *pTarget = NULL;
-            std::list<HostileReference*>& m_threatlist = me->getThreatManager().getThreatList();
-            for (std::list<HostileReference*>::iterator i = m_threatlist.begin(); i != m_threatlist.end();++i)
+            ThreatList& m_threatlist = me->getThreatManager().getThreatList();
+            for (ThreatList::iterator i = m_threatlist.begin(); i != m_threatlist.end();++i)
             {
                 Unit* pUnit = Unit::GetUnit((*me), (*i)->getUnitGuid());
                                                             //if in melee range
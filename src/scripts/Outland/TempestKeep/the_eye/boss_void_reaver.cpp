@@ -122,9 +122,9 @@ struct boss_void_reaverAI : public ScriptedAI
                 return;
             }
             Unit *pTarget = NULL;
-            std::list<HostileReference *> t_list = me->getThreatManager().getThreatList();
+            ThreatList t_list = me->getThreatManager().getThreatList();
             std::vector<Unit *> target_list;
-            for (std::list<HostileReference *>::iterator itr = t_list.begin(); itr != t_list.end(); ++itr)
+            for (ThreatList::iterator itr = t_list.begin(); itr != t_list.end(); ++itr)
             {
                 pTarget = Unit::GetUnit(*me, (*itr)->getUnitGuid());
                                                             //18 yard radius minimum
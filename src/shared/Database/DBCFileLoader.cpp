@@ -23,22 +23,79 @@
 
 #include "DBCFileLoader.h"
 
+#include <ace/Mem_Map.h>
+
+#define DBC_HEADER_SIZE 20
+
 DBCFileLoader::DBCFileLoader()
 {
     data = NULL;
     fieldsOffset = NULL;
+    mapped = false;
+}
+
+static void SetFieldOffsets(uint32* fieldsOffset, uint32 fieldCount, const char* fmt)
+{
+    fieldsOffset[0] = 0;
+    for (uint32 i = 1; i < fieldCount; i++)
+    {
+        fieldsOffset[i] = fieldsOffset[i - 1];
+        if (fmt[i - 1] == 'b' || fmt[i - 1] == 'X')         // byte fields
+            fieldsOffset[i] += 1;
+        else                                                // 4 byte fields (int32/float/strings)
+            fieldsOffset[i] += 4;
+    }
 }
 
-bool DBCFileLoader::Load(const char *filename, const char *fmt)
+bool DBCFileLoader::Load(const char *filename, const char *fmt, ACE_Mem_Map *mapping)
 {
 
     uint32 header;
     if (data)
     {
-        delete [] data;
+        if (!mapped)
+            delete [] data;
         data=NULL;
     }
 
+    if (mapping)
+    {
+        if (mapping->map(filename, static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_READ | PROT_WRITE, ACE_MAP_PRIVATE) == -1)
+            return false;
+
+        mapping->close_handle();
+
+        unsigned char *file = static_cast<unsigned char*>(mapping->addr());
+        size_t size = mapping->size();
+        if (size < DBC_HEADER_SIZE)
+            return false;
+
+        memcpy(&header, file, 4);
+        memcpy(&recordCount, file + 4, 4);
+        memcpy(&fieldCount, file + 8, 4);
+        memcpy(&recordSize, file + 12, 4);
+        memcpy(&stringSize, file + 16, 4);
+        EndianConvert(header);
+        EndianConvert(recordCount);
+        EndianConvert(fieldCount);
+        EndianConvert(recordSize);
+        EndianConvert(stringSize);
+
+        if (header != 0x43424457 || !fieldCount)            //'WDBC'
+            return false;
+
+        if (size < DBC_HEADER_SIZE + size_t(recordSize) * recordCount + stringSize)
+            return false;
+
+        fieldsOffset = new uint32[fieldCount];
+        SetFieldOffsets(fieldsOffset, fieldCount, fmt);
+
+        data = file + DBC_HEADER_SIZE;
+        stringTable = data + recordSize*recordCount;
+        mapped = true;
+        return true;
+    }
+
     FILE * f=fopen(filename,"rb");
     if (!f)return false;
 
@@ -70,15 +127,7 @@ bool DBCFileLoader::Load(const char *filename, const char *fmt)
     EndianConvert(stringSize);
 
     fieldsOffset = new uint32[fieldCount];
-    fieldsOffset[0] = 0;
-    for (uint32 i = 1; i < fieldCount; i++)
-    {
-        fieldsOffset[i] = fieldsOffset[i - 1];
-        if (fmt[i - 1] == 'b' || fmt[i - 1] == 'X')         // byte fields
-            fieldsOffset[i] += 1;
-        else                                                // 4 byte fields (int32/float/strings)
-            fieldsOffset[i] += 4;
-    }
+    SetFieldOffsets(fieldsOffset, fieldCount, fmt);
 
     data = new unsigned char[recordSize*recordCount+stringSize];
     stringTable = data + recordSize*recordCount;
@@ -92,7 +141,7 @@ bool DBCFileLoader::Load(const char *filename, const char *fmt)
 
 DBCFileLoader::~DBCFileLoader()
 {
-    if (data)
+    if (data && !mapped)
         delete [] data;
     if (fieldsOffset)
         delete [] fieldsOffset;
@@ -136,34 +185,18 @@ uint32 DBCFileLoader::GetFormatRecordSize(const char * format,int32* index_pos)
     return recordsize;
 }
 
-char* DBCFileLoader::AutoProduceData(const char* format, uint32& records, char**& indexTable)
+char** DBCFileLoader::AllocIndexTable(int32 indexPos, uint32& records)
 {
-    /*
-    format STRING, NA, FLOAT,NA,INT <=>
-    struct{
-    char* field0,
-    float field1,
-    int field2
-    }entry;
-
-    this func will generate  entry[rows] data;
-    */
-
     typedef char * ptr;
-    if (strlen(format)!=fieldCount)
-        return NULL;
-
-    // get struct size and index pos
-    int32 i;
-    uint32 recordsize=GetFormatRecordSize(format,&i);
+    ptr* indexTable;
 
-    if (i>=0)
+    if (indexPos>=0)
     {
         uint32 maxi=0;
         // find max index
         for (uint32 y=0; y<recordCount; y++)
         {
-            uint32 ind=getRecord(y).getUInt (i);
+            uint32 ind=getRecord(y).getUInt (indexPos);
             if (ind>maxi)maxi=ind;
         }
 
@@ -178,6 +211,77 @@ char* DBCFileLoader::AutoProduceData(const char* format, uint32& records, char**
         indexTable = new ptr[recordCount];
     }
 
+    return indexTable;
+}
+
+bool DBCFileLoader::IsInPlaceFormat(const char* format) const
+{
+#if OREGON_ENDIAN == OREGON_BIGENDIAN
+    return false;
+#else
+    if (strlen(format) != fieldCount || recordSize % 4)
+        return false;
+
+    uint32 x = 0;
+    while (format[x] == FT_IND || format[x] == FT_INT || format[x] == FT_FLOAT)
+        ++x;
+
+    if (!x || recordSize < x * 4)
+        return false;
+
+    for (uint32 y = x; format[y]; ++y)
+        if (format[y] != FT_NA && format[y] != FT_NA_BYTE && format[y] != FT_LOGIC)
+            return false;
+
+    return true;
+#endif
+}
+
+char* DBCFileLoader::AutoProduceIndex(const char* format, uint32& records, char**& indexTable)
+{
+    if (strlen(format)!=fieldCount)
+        return NULL;
+
+    int32 i;
+    GetFormatRecordSize(format,&i);
+
+    indexTable = AllocIndexTable(i, records);
+
+    for (uint32 y = 0; y < recordCount; ++y)
+    {
+        char* record = reinterpret_cast<char*>(data + y*recordSize);
+        if (i>=0)
+            indexTable[getRecord(y).getUInt(i)] = record;
+        else
+            indexTable[y] = record;
+    }
+
+    return reinterpret_cast<char*>(data);
+}
+
+char* DBCFileLoader::AutoProduceData(const char* format, uint32& records, char**& indexTable)
+{
+    /*
+    format STRING, NA, FLOAT,NA,INT <=>
+    struct{
+    char* field0,
+    float field1,
+    int field2
+    }entry;
+
+    this func will generate  entry[rows] data;
+    */
+
+    typedef char * ptr;
+    if (strlen(format)!=fieldCount)
+        return NULL;
+
+    // get struct size and index pos
+    int32 i;
+    uint32 recordsize=GetFormatRecordSize(format,&i);
+
+    indexTable = AllocIndexTable(i, records);
+
     char* dataTable= new char[recordCount*recordsize];
 
     uint32 offset=0;
@@ -227,6 +331,21 @@ char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
     char* stringPool= new char[stringSize];
     memcpy(stringPool,stringTable,stringSize);
 
+    FillStrings(format, dataTable, stringPool);
+    return stringPool;
+}
+
+uint32 DBCFileLoader::AutoProduceStringsInPlace(const char* format, char* dataTable)
+{
+    if (strlen(format)!=fieldCount)
+        return 0;
+
+    return FillStrings(format, dataTable, reinterpret_cast<char*>(stringTable));
+}
+
+uint32 DBCFileLoader::FillStrings(const char* format, char* dataTable, char* stringPool)
+{
+    uint32 filled=0;
     uint32 offset=0;
 
     for (uint32 y =0; y<recordCount; y++)
@@ -249,12 +368,13 @@ char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
                 {
                     const char * st = getRecord(y).getString(x);
                     *slot=stringPool+(st-(const char*)stringTable);
+                    ++filled;
                 }
                 offset+=sizeof(char*);
                 break;
         }
     }
 
-    return stringPool;
+    return filled;
 }
 
@@ -23,6 +23,8 @@
 #include "Utilities/ByteConverter.h"
 #include <cassert>
 
+class ACE_Mem_Map;
+
 enum
 {
     FT_NA='x',                                              //not used or unknown, 4 byte size
@@ -42,7 +44,9 @@ class DBCFileLoader
         DBCFileLoader();
         ~DBCFileLoader();
 
-        bool Load(const char *filename, const char *fmt);
+        // with a mapping the file is mapped copy on write instead of read, the
+        // caller keeps the mapping for as long as the records or strings are used
+        bool Load(const char *filename, const char *fmt, ACE_Mem_Map *mapping = NULL);
 
         class Record
         {
@@ -94,8 +98,18 @@ class DBCFileLoader
         bool IsLoaded() { return data != NULL; }
         char* AutoProduceData(const char* fmt, uint32& count, char**& indexTable);
         char* AutoProduceStrings(const char* fmt, char* dataTable);
+        // records laid out in the file like the structure of the format: 4 byte
+        // fields only, the not used ones at the end, so they are used in place
+        bool IsInPlaceFormat(const char* fmt) const;
+        // index to the records of the file, no copy of them
+        char* AutoProduceIndex(const char* fmt, uint32& count, char**& indexTable);
+        // strings pointing into the string table of the file, returns how many were set
+        uint32 AutoProduceStringsInPlace(const char* fmt, char* dataTable);
         static uint32 GetFormatRecordSize(const char * format, int32 * index_pos = NULL);
     private:
+        char** AllocIndexTable(int32 indexPos, uint32& records);
+        uint32 FillStrings(const char* format, char* dataTable, char* stringPool);
+
 
         uint32 recordSize;
         uint32 recordCount;
@@ -104,6 +118,7 @@ class DBCFileLoader
         uint32 *fieldsOffset;
         unsigned char *data;
         unsigned char *stringTable;
+        bool mapped;                                        // data is in the mapping of the caller
 };
 #endif
 
@@ -22,10 +22,13 @@
 
 #include "DBCFileLoader.h"
 
+#include <ace/Mem_Map.h>
+
 template<class T>
 class DBCStorage
 {
     typedef std::list<char*> StringPoolList;
+    typedef std::list<ACE_Mem_Map*> MappedFileList;
     public:
         explicit DBCStorage(const char *f) : fmt(f), nCount(0), fieldCount(0), indexTable(NULL), m_dataTable(NULL) { }
         ~DBCStorage() { Clear(); }
@@ -35,34 +38,82 @@ class DBCStorage
         char const* GetFormat() const { return fmt; }
         uint32 GetFieldCount() const { return fieldCount; }
 
-        bool Load(char const* fn)
+        // records used in place of the file mapping, nothing copied
+        bool IsInPlace() const { return indexTable && !m_dataTable; }
+
+        // mapped: the file stays mapped copy on write, records are used in place
+        // when the format allows it, strings always. Pages are shared with the
+        // other processes mapping the file until an entry gets changed.
+        bool Load(char const* fn, bool mapped = false)
         {
             DBCFileLoader dbc;
+            ACE_Mem_Map* file = mapped ? new ACE_Mem_Map() : NULL;
             // Check if load was sucessful, only then continue
-            if (!dbc.Load(fn, fmt))
+            if (!dbc.Load(fn, fmt, file))
+            {
+                delete file;
                 return false;
+            }
 
             fieldCount = dbc.GetCols();
-            m_dataTable = (T*)dbc.AutoProduceData(fmt,nCount,(char**&)indexTable);
 
-            m_stringPoolList.push_back(dbc.AutoProduceStrings(fmt,(char*)m_dataTable));
+            if (file)
+            {
+                if (dbc.IsInPlaceFormat(fmt))
+                {
+                    dbc.AutoProduceIndex(fmt,nCount,(char**&)indexTable);
+                    m_mappedFileList.push_back(file);
+                }
+                else
+                {
+                    m_dataTable = (T*)dbc.AutoProduceData(fmt,nCount,(char**&)indexTable);
+                    // kept only when a string of it is used
+                    if (m_dataTable && dbc.AutoProduceStringsInPlace(fmt,(char*)m_dataTable))
+                        m_mappedFileList.push_back(file);
+                    else
+                        delete file;
+                }
+            }
+            else
+            {
+                m_dataTable = (T*)dbc.AutoProduceData(fmt,nCount,(char**&)indexTable);
+
+                m_stringPoolList.push_back(dbc.AutoProduceStrings(fmt,(char*)m_dataTable));
+            }
 
             // error in dbc file at loading if NULL
             return indexTable!=NULL;
         }
 
-        bool LoadStringsFrom(char const* fn)
+        bool LoadStringsFrom(char const* fn, bool mapped = false)
         {
             // DBC must be already loaded using Load
             if (!indexTable)
                 return false;
 
+            // in place formats have no strings
+            if (!m_dataTable)
+                return true;
+
             DBCFileLoader dbc;
+            ACE_Mem_Map* file = mapped ? new ACE_Mem_Map() : NULL;
             // Check if load was successful, only then continue
-            if (!dbc.Load(fn, fmt))
+            if (!dbc.Load(fn, fmt, file))
+            {
+                delete file;
                 return false;
+            }
 
-            m_stringPoolList.push_back(dbc.AutoProduceStrings(fmt,(char*)m_dataTable));
+            if (file)
+            {
+                // kept only when a string of it is used
+                if (dbc.AutoProduceStringsInPlace(fmt,(char*)m_dataTable))
+                    m_mappedFileList.push_back(file);
+                else
+                    delete file;
+            }
+            else
+                m_stringPoolList.push_back(dbc.AutoProduceStrings(fmt,(char*)m_dataTable));
 
             return true;
         }
@@ -82,6 +133,12 @@ class DBCStorage
                 delete[] m_stringPoolList.front();
                 m_stringPoolList.pop_front();
             }
+
+            while(!m_mappedFileList.empty())
+            {
+                delete m_mappedFileList.front();
+                m_mappedFileList.pop_front();
+            }
             nCount = 0;
         }
 
@@ -92,6 +149,7 @@ class DBCStorage
         T** indexTable;
         T* m_dataTable;
         StringPoolList m_stringPoolList;
+        MappedFileList m_mappedFileList;
 };
 
 #endif
@@ -29,6 +29,8 @@
 #include "Threading.h"
 #include "Database/SqlDelayThread.h"
 #include "Database/SqlOperations.h"
+#include "Database/SqlConnection.h"
+#include "Database/SqlStmtParameters.h"
 #include "Timer.h"
 
 
@@ -38,7 +40,7 @@
 
 size_t Database::db_count = 0;
 
-Database::Database() : mMysql(NULL)
+Database::Database() : tranThread(NULL), m_tranConnection(NULL), m_nextConnection(0), m_syncQueries(0), m_syncWaits(0), m_halting(false)
 {
     // before first connection
     if (db_count++ == 0)
@@ -56,18 +58,17 @@ Database::Database() : mMysql(NULL)
 
 Database::~Database()
 {
-    if (m_delayThread)
-        HaltDelayThread();
+    HaltDelayThread();
 
-    if (mMysql)
-        mysql_close(mMysql);
+    for (SqlConnections::iterator itr = m_connections.begin(); itr != m_connections.end(); ++itr)
+        delete *itr;
 
     // Free Mysql library pointers for last ~DB
     if (--db_count == 0)
         mysql_library_end();
 }
 
-bool Database::Initialize(const char *infoString)
+bool Database::Initialize(const char *infoString, uint32 connections, uint32 asyncThreads)
 {
     // Enable logging of SQL commands (usally only GM commands)
     // (See method: PExecuteLog)
@@ -79,104 +80,34 @@ bool Database::Initialize(const char *infoString)
             m_logsDir.append("/");
     }
 
-    tranThread = NULL;
-    MYSQL *mysqlInit;
-    mysqlInit = mysql_init(NULL);
-    if (!mysqlInit)
-    {
-        sLog.outError("Could not initialize Mysql connection");
-        return false;
-    }
-
-    InitDelayThread();
-
-    Tokens tokens = StrSplit(infoString, ";");
-
-    Tokens::iterator iter;
-
-    std::string host, port_or_socket, user, password, database;
-    int port;
-    char const* unix_socket;
-
-    iter = tokens.begin();
+    m_infoString = infoString;
 
-    if (iter != tokens.end())
-        host = *iter++;
-    if (iter != tokens.end())
-        port_or_socket = *iter++;
-    if (iter != tokens.end())
-        user = *iter++;
-    if (iter != tokens.end())
-        password = *iter++;
-    if (iter != tokens.end())
-        database = *iter++;
+    if (connections < 1)
+        connections = 1;
+    else if (connections > MAX_SQL_CONNECTIONS)
+        connections = MAX_SQL_CONNECTIONS;
 
-    mysql_options(mysqlInit, MYSQL_SET_CHARSET_NAME, "utf8");
-    #ifdef _WIN32
-    if (host==".")                                           // named pipe use option (Windows)
+    for (uint32 i = 0; i < connections; ++i)
     {
-        unsigned int opt = MYSQL_PROTOCOL_PIPE;
-        mysql_options(mysqlInit, MYSQL_OPT_PROTOCOL, (char const*)&opt);
-        port = 0;
-        unix_socket = 0;
-    }
-    else                                                    // generic case
-    {
-        port = atoi(port_or_socket.c_str());
-        unix_socket = 0;
-    }
-    #else
-    if (host==".")                                           // socket use option (Unix/Linux)
-    {
-        unsigned int opt = MYSQL_PROTOCOL_SOCKET;
-        mysql_options(mysqlInit, MYSQL_OPT_PROTOCOL, (char const*)&opt);
-        host = "localhost";
-        port = 0;
-        unix_socket = port_or_socket.c_str();
-    }
-    else                                                    // generic case
-    {
-        port = atoi(port_or_socket.c_str());
-        unix_socket = 0;
-    }
-    #endif
-
-    mMysql = mysql_real_connect(mysqlInit, host.c_str(), user.c_str(),
-        password.c_str(), database.c_str(), port, unix_socket, 0);
+        SqlConnection* conn = new SqlConnection(*this);
+        if (!conn->Open(infoString))
+        {
+            delete conn;
+            return false;
+        }
 
-    if (mMysql)
-    {
-        sLog.outDetail("Connected to MySQL database at %s", host.c_str());
-        sLog.outString("MySQL client library: %s", mysql_get_client_info());
-        sLog.outString("MySQL server ver: %s ", mysql_get_server_info( mMysql));
+        if (m_connections.empty())
+        {
+            sLog.outString("MySQL client library: %s", mysql_get_client_info());
+            sLog.outString("MySQL server ver: %s ", mysql_get_server_info(conn->GetMysql()));
+        }
 
-        if (!mysql_autocommit(mMysql, 1))
-            sLog.outDetail("AUTOCOMMIT SUCCESSFULLY SET TO 1");
-        else
-            sLog.outDetail("AUTOCOMMIT NOT SET TO 1");
+        m_connections.push_back(conn);
+    }
 
-        // set connection properties to UTF8 to properly handle locales for different
-        // server configs - core sends data in UTF8, so MySQL must expect UTF8 too
-        PExecute("SET NAMES `utf8`");
-        PExecute("SET CHARACTER SET `utf8`");
+    InitDelayThread(asyncThreads);
 
-    #if MYSQL_VERSION_ID >= 50003
-        my_bool my_true = (my_bool)1;
-        if (mysql_options(mMysql, MYSQL_OPT_RECONNECT, &my_true))
-            sLog.outDetail("Failed to turn on MYSQL_OPT_RECONNECT.");
-        else
-           sLog.outDetail("Successfully turned on MYSQL_OPT_RECONNECT.");
-    #else
-        #warning "Your mySQL client lib version does not support reconnecting after a timeout.\nIf this causes you any trouble we advice you to upgrade your mySQL client libs to at least mySQL 5.0.13 to resolve this problem."
-    #endif
-        return true;
-    }
-    else
-    {
-        sLog.outError("Could not connect to MySQL database at %s: %s\n", host.c_str(),mysql_error(mysqlInit));
-        mysql_close(mysqlInit);
-        return false;
-    }
+    return !m_threadBodies.empty();
 }
 
 void Database::ThreadStart()
@@ -202,10 +133,11 @@ void Database::escape_string(std::string& str)
 
 unsigned long Database::escape_string(char *to, const char *from, unsigned long length)
 {
-    if (!mMysql || !to || !from || !length)
+    if (m_connections.empty() || !to || !from || !length)
         return 0;
 
-    return(mysql_real_escape_string(mMysql, to, from, length));
+    // only depends on the character set of the connection, no need to lock it
+    return(mysql_real_escape_string(m_connections[0]->GetMysql(), to, from, length));
 }
 
 
@@ -258,63 +190,49 @@ void Database::SetResultQueue(SqlResultQueue * queue)
     m_queryQueues[ACE_Based::Thread::current()] = queue;
 }
 
-bool Database::_Query(const char *sql, MYSQL_RES **pResult, MYSQL_FIELD **pFields, uint64* pRowCount, uint32* pFieldCount)
+SqlConnection* Database::AcquireConnection()
 {
-    if (!mMysql)
-        return 0;
+    // the thread running a synchronous transaction keeps its connection locked
+    if (m_tranConnection && tranThread == ACE_Based::Thread::current())
+        return m_tranConnection;
 
-    {
-        // guarded block for thread-safe mySQL request
-        ACE_Guard<ACE_Thread_Mutex> query_connection_guard(mMutex);
-        #ifdef TRINITY_DEBUG
-        uint32 _s = getMSTime();
-        #endif
-        if (mysql_query(mMysql, sql))
-        {
-            sLog.outErrorDb("SQL: %s", sql);
-            sLog.outErrorDb("query ERROR: %s", mysql_error(mMysql));
-            return false;
-        }
-        else
-        {
-            #ifdef TRINITY_DEBUG
-            sLog.outDebug("[%u ms] SQL: %s", getMSTimeDiff(_s,getMSTime()), sql );
-            #endif
-        }
+    ++m_syncQueries;
 
-        *pResult = mysql_store_result(mMysql);
-        *pRowCount = mysql_affected_rows(mMysql);
-        *pFieldCount = mysql_field_count(mMysql);
+    // take the first free connection, starting from a different one each time
+    uint32 count = m_connections.size();
+    uint32 start = (m_nextConnection++) % count;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        SqlConnection* conn = m_connections[(start + i) % count];
+        if (conn->TryLock())
+            return conn;
     }
 
-    if (!*pResult )
-        return false;
+    // all busy, wait for ours
+    ++m_syncWaits;
+    SqlConnection* conn = m_connections[start];
+    conn->Lock();
+    return conn;
+}
 
-    if (!*pRowCount)
-    {
-        mysql_free_result(*pResult);
-        return false;
-    }
+void Database::ReleaseConnection(SqlConnection* conn)
+{
+    if (conn == m_tranConnection && tranThread == ACE_Based::Thread::current())
+        return;
 
-    *pFields = mysql_fetch_fields(*pResult);
-    return true;
+    conn->Unlock();
 }
 
 QueryResult_AutoPtr Database::Query(const char *sql)
 {
-    MYSQL_RES *result = NULL;
-    MYSQL_FIELD *fields = NULL;
-    uint64 rowCount = 0;
-    uint32 fieldCount = 0;
-
-    if (!_Query(sql, &result, &fields, &rowCount, &fieldCount))
+    if (m_connections.empty())
         return QueryResult_AutoPtr(NULL);
 
-    QueryResult *queryResult = new QueryResult(result, fields, rowCount, fieldCount);
+    SqlConnection* conn = AcquireConnection();
+    QueryResult_AutoPtr result = conn->Query(sql);
+    ReleaseConnection(conn);
 
-    queryResult->NextRow();
-
-    return QueryResult_AutoPtr(queryResult);
+    return result;
 }
 
 QueryResult_AutoPtr Database::PQuery(const char *format,...)
@@ -339,23 +257,14 @@ QueryResult_AutoPtr Database::PQuery(const char *format,...)
 
 QueryNamedResult* Database::QueryNamed(const char *sql)
 {
-    MYSQL_RES *result = NULL;
-    MYSQL_FIELD *fields = NULL;
-    uint64 rowCount = 0;
-    uint32 fieldCount = 0;
-
-    if (!_Query(sql, &result, &fields, &rowCount, &fieldCount))
+    if (m_connections.empty())
         return NULL;
 
-    QueryFieldNames names(fieldCount);
-    for (uint32 i = 0; i < fieldCount; i++)
-         names[i] = fields[i].name;
-
-    QueryResult *queryResult = new QueryResult(result, fields, rowCount, fieldCount);
-
-    queryResult->NextRow();
+    SqlConnection* conn = AcquireConnection();
+    QueryNamedResult* result = conn->QueryNamed(sql);
+    ReleaseConnection(conn);
 
-    return new QueryNamedResult(queryResult, names);
+    return result;
 }
 
 QueryNamedResult* Database::PQueryNamed(const char *format,...)
@@ -380,11 +289,12 @@ QueryNamedResult* Database::PQueryNamed(const char *format,...)
 
 bool Database::Execute(const char *sql)
 {
-    if (!mMysql)
+    if (m_connections.empty())
         return false;
 
     // don't use queued execution if it has not been initialized
-    if (!m_threadBody)
+    SqlDelayThread* delayThread = GetDelayThread();
+    if (!delayThread)
         return DirectExecute(sql);
 
     nMutex.acquire();
@@ -393,7 +303,7 @@ bool Database::Execute(const char *sql)
     if (i != m_tranQueues.end() && i->second != NULL)
         i->second->DelayExecute(sql);                       // Statement for transaction
     else
-        m_threadBody->Delay(new SqlStatement(sql));         // Simple sql statement
+        delayThread->Delay(new SqlStatement(sql));          // Simple sql statement
 
     nMutex.release();
     return true;
@@ -421,31 +331,14 @@ bool Database::PExecute(const char * format,...)
 
 bool Database::DirectExecute(const char* sql)
 {
-    if (!mMysql)
+    if (m_connections.empty())
         return false;
 
-    {
-        // guarded block for thread-safe mySQL request
-        ACE_Guard<ACE_Thread_Mutex> query_connection_guard(mMutex);
+    SqlConnection* conn = AcquireConnection();
+    bool res = conn->Execute(sql);
+    ReleaseConnection(conn);
 
-        #ifdef OREGON_DEBUG
-        uint32 _s = getMSTime();
-        #endif
-        if (mysql_query(mMysql, sql))
-        {
-            sLog.outErrorDb("SQL: %s", sql);
-            sLog.outErrorDb("SQL ERROR: %s", mysql_error(mMysql));
-            return false;
-        }
-        else
-        {
-            #ifdef OREGON_DEBUG
-            sLog.outDebug("[%u ms] SQL: %s", getMSTimeDiff(_s,getMSTime()), sql);
-            #endif
-        }
-    }
-
-    return true;
+    return res;
 }
 
 bool Database::DirectPExecute(const char * format,...)
@@ -468,37 +361,102 @@ bool Database::DirectPExecute(const char * format,...)
     return DirectExecute(szQuery);
 }
 
-bool Database::_TransactionCmd(const char *sql)
+bool Database::PrepareStatement(uint32 index, const char *sql)
 {
-    if (mysql_query(mMysql, sql))
+    if (index >= m_statements.size())
+        m_statements.resize(index + 1);
+
+    m_statements[index] = sql;
+
+    // check it right now on the first connection, the others prepare it at first use
+    if (!m_connections.empty())
     {
-        sLog.outError("SQL: %s", sql);
-        sLog.outError("SQL ERROR: %s", mysql_error(mMysql));
-        return false;
+        SqlConnection* conn = m_connections[0];
+        conn->Lock();
+        bool res = conn->Prepare(index);
+        conn->Unlock();
+        return res;
     }
+
+    return true;
+}
+
+const char* Database::GetStatementSql(uint32 index) const
+{
+    if (index >= m_statements.size() || m_statements[index].empty())
+        return NULL;
+
+    return m_statements[index].c_str();
+}
+
+QueryResult_AutoPtr Database::Query(uint32 index, SqlStmtParameters const& params)
+{
+    if (m_connections.empty())
+        return QueryResult_AutoPtr(NULL);
+
+    SqlConnection* conn = AcquireConnection();
+    QueryResult_AutoPtr result = conn->Query(index, params);
+    ReleaseConnection(conn);
+
+    return result;
+}
+
+bool Database::Execute(uint32 index, SqlStmtParameters const& params)
+{
+    if (m_connections.empty())
+        return false;
+
+    // don't use queued execution if it has not been initialized
+    SqlDelayThread* delayThread = GetDelayThread();
+    if (!delayThread)
+        return DirectExecute(index, params);
+
+    nMutex.acquire();
+    tranThread = ACE_Based::Thread::current();              // owner of this transaction
+    TransactionQueues::iterator i = m_tranQueues.find(tranThread);
+    if (i != m_tranQueues.end() && i->second != NULL)
+        i->second->DelayExecute(new SqlPreparedStatement(index, params));  // Statement for transaction
     else
-        DEBUG_LOG("SQL: %s", sql);
+        delayThread->Delay(new SqlPreparedStatement(index, params));       // Simple prepared statement
 
+    nMutex.release();
     return true;
 }
 
+bool Database::DirectExecute(uint32 index, SqlStmtParameters const& params)
+{
+    if (m_connections.empty())
+        return false;
+
+    SqlConnection* conn = AcquireConnection();
+    bool res = conn->Execute(index, params);
+    ReleaseConnection(conn);
+
+    return res;
+}
+
 bool Database::BeginTransaction()
 {
-    if (!mMysql)
+    if (m_connections.empty())
         return false;
 
     // don't use queued execution if it has not been initialized
-    if (!m_threadBody)
+    if (m_threadBodies.empty())
     {
-        if (tranThread == ACE_Based::Thread::current())
+        if (m_tranConnection && tranThread == ACE_Based::Thread::current())
             return false;                                   // huh? this thread already started transaction
 
-        mMutex.acquire();
-        if (!_TransactionCmd("START TRANSACTION"))
+        // synchronous transactions are serialized on the first connection
+        SqlConnection* conn = m_connections[0];
+        conn->Lock();
+        if (!conn->Execute("START TRANSACTION"))
         {
-            mMutex.release();                               // can't start transaction
+            conn->Unlock();                                 // can't start transaction
             return false;
         }
+
+        tranThread = ACE_Based::Thread::current();
+        m_tranConnection = conn;
         return true;                                        // transaction started
     }
 
@@ -517,20 +475,23 @@ bool Database::BeginTransaction()
 
 bool Database::CommitTransaction()
 {
-    if (!mMysql)
+    if (m_connections.empty())
         return false;
 
     bool _res = false;
 
     // don't use queued execution if it has not been initialized
-    if (!m_threadBody)
+    SqlDelayThread* delayThread = GetDelayThread();
+    if (!delayThread)
     {
-        if (tranThread != ACE_Based::Thread::current())
+        if (!m_tranConnection || tranThread != ACE_Based::Thread::current())
             return false;
 
-        _res = _TransactionCmd("COMMIT");
+        SqlConnection* conn = m_tranConnection;
+        _res = conn->Execute("COMMIT");
         tranThread = NULL;
-        mMutex.release();
+        m_tranConnection = NULL;
+        conn->Unlock();
         return _res;
     }
 
@@ -539,7 +500,7 @@ bool Database::CommitTransaction()
     TransactionQueues::iterator i = m_tranQueues.find(tranThread);
     if (i != m_tranQueues.end() && i->second != NULL)
     {
-        m_threadBody->Delay(i->second);
+        delayThread->Delay(i->second);
         m_tranQueues.erase(i);
         _res = true;
     }
@@ -549,18 +510,20 @@ bool Database::CommitTransaction()
 
 bool Database::RollbackTransaction()
 {
-    if (!mMysql)
+    if (m_connections.empty())
         return false;
 
     // don't use queued execution if it has not been initialized
-    if (!m_threadBody)
+    if (m_threadBodies.empty())
     {
-        if (tranThread != ACE_Based::Thread::current())
+        if (!m_tranConnection || tranThread != ACE_Based::Thread::current())
             return false;
 
-        bool _res = _TransactionCmd("ROLLBACK");
+        SqlConnection* conn = m_tranConnection;
+        bool _res = conn->Execute("ROLLBACK");
         tranThread = NULL;
-        mMutex.release();
+        m_tranConnection = NULL;
+        conn->Unlock();
         return _res;
     }
 
@@ -577,24 +540,91 @@ bool Database::RollbackTransaction()
     return true;
 }
 
-void Database::InitDelayThread()
+void Database::InitDelayThread(uint32 asyncThreads)
 {
-    assert(!m_delayThread);
+    assert(m_delayThreads.empty());
+
+    if (asyncThreads < 1)
+        asyncThreads = 1;
+    else if (asyncThreads > MAX_SQL_CONNECTIONS)
+        asyncThreads = MAX_SQL_CONNECTIONS;
+
+    // New delay threads for delay execute, each with its own connection
+    for (uint32 i = 0; i < asyncThreads; ++i)
+    {
+        SqlConnection* conn = new SqlConnection(*this);
+        if (!conn->Open(m_infoString.c_str()))
+        {
+            delete conn;
+            break;
+        }
 
-    //New delay thread for delay execute
-    m_threadBody = new SqlDelayThread(this);              // will deleted at m_delayThread delete
-    m_delayThread = new ACE_Based::Thread(m_threadBody);
+        SqlDelayThread* threadBody = new SqlDelayThread(this, conn);    // will deleted at delay thread delete
+        m_threadBodies.push_back(threadBody);
+        m_delayThreads.push_back(new ACE_Based::Thread(threadBody));
+    }
 }
 
 void Database::HaltDelayThread()
 {
-    if (!m_threadBody || !m_delayThread)
+    if (m_threadBodies.empty())
         return;
 
-    m_threadBody->Stop();                                   //Stop event
-    m_delayThread->wait();                                  //Wait for flush to DB
-    delete m_delayThread;                                   //This also deletes m_threadBody
-    m_delayThread = NULL;
-    m_threadBody = NULL;
+    m_halting = true;
+
+    // wait for all of them before going back to direct execution
+    for (SqlDelayThreads::iterator itr = m_threadBodies.begin(); itr != m_threadBodies.end(); ++itr)
+        (*itr)->Stop();                                     //Stop event
+
+    for (SqlExecutorThreads::iterator itr = m_delayThreads.begin(); itr != m_delayThreads.end(); ++itr)
+    {
+        (*itr)->wait();                                     //Wait for flush to DB
+        delete *itr;                                        //This also deletes the thread body
+    }
+
+    m_delayThreads.clear();
+    m_threadBodies.clear();
+    m_halting = false;
 }
 
+SqlDelayThread* Database::GetDelayThread()
+{
+    if (m_threadBodies.empty())
+        return NULL;
+
+    // the default key keeps the first executer for itself, it also runs the barriers
+    uint32 key = GetAsyncKey();
+    if (!key || key == SQL_ASYNC_KEY_ALL || m_threadBodies.size() == 1)
+        return m_threadBodies[0];
+
+    return m_threadBodies[1 + key % (m_threadBodies.size() - 1)];
+}
+
+bool Database::DelayBarrier(SqlOperation* op)
+{
+    if (m_threadBodies.size() == 1)
+        return m_threadBodies[0]->Enqueue(op);
+
+    // two barriers with their fences in a different order would wait for each other
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_barrierLock, false);
+
+    SqlBarrier* barrier = new SqlBarrier(this, m_threadBodies.size() - 1);
+    for (size_t i = 1; i < m_threadBodies.size(); ++i)
+        m_threadBodies[i]->Enqueue(new SqlBarrierFence(barrier));
+
+    return m_threadBodies[0]->Enqueue(new SqlBarrierOperation(barrier, op));
+}
+
+void Database::GetStats(DatabaseStats& stats)
+{
+    stats.syncQueries = m_syncQueries.value();
+    stats.syncWaits = m_syncWaits.value();
+
+    stats.queueSizes.clear();
+    stats.executors.clear();
+    for (SqlDelayThreads::const_iterator itr = m_threadBodies.begin(); itr != m_threadBodies.end(); ++itr)
+    {
+        stats.queueSizes.push_back((*itr)->GetQueueSize());
+        stats.executors.push_back((*itr)->GetStats());
+    }
+}
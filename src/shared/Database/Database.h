@@ -26,6 +26,10 @@
 #include "Policies/Singleton.h"
 #include "ace/Thread_Mutex.h"
 #include "ace/Guard_T.h"
+#include "ace/TSS_T.h"
+#include "ace/Atomic_Op.h"
+
+#include <vector>
 
 #ifdef WIN32
   #define FD_SETSIZE 1024
@@ -33,32 +37,53 @@
 #endif
 #include <mysql.h>
 
+class SqlConnection;
+class SqlStmtParameters;
 class SqlTransaction;
 class SqlResultQueue;
 class SqlQueryHolder;
 
 typedef UNORDERED_MAP<ACE_Based::Thread* , SqlTransaction*> TransactionQueues;
 typedef UNORDERED_MAP<ACE_Based::Thread* , SqlResultQueue*> QueryQueues;
+typedef std::vector<SqlConnection*> SqlConnections;
+typedef std::vector<SqlDelayThread*> SqlDelayThreads;
+typedef std::vector<ACE_Based::Thread*> SqlExecutorThreads;
 
 #define MAX_QUERY_LEN   1024
+#define MAX_SQL_CONNECTIONS 32
+
+// Async key of the operations in order with the ones of every key, see SqlBarrier
+#define SQL_ASYNC_KEY_ALL 0xFFFFFFFF
+
+// Counters of a database pool, see Database::GetStats
+struct DatabaseStats
+{
+    uint64 syncQueries;                                     // Statements run on the synchronous pool
+    uint64 syncWaits;                                       // Of them, had to wait for a busy connection
+    std::vector<long> queueSizes;                           // Async operations queued per executor
+    std::vector<SqlDelayStats> executors;
+};
 
 class Database
 {
     protected:
         TransactionQueues m_tranQueues;                     // Transaction queues from diff. threads
         QueryQueues m_queryQueues;                          // Query queues from diff threads
-        SqlDelayThread* m_threadBody;                       // Pointer to delay sql executer (owned by m_delayThread)
-        ACE_Based::Thread* m_delayThread;                   // Pointer to executer thread
+        SqlDelayThreads m_threadBodies;                     // Delay sql executers (owned by m_delayThreads)
+        SqlExecutorThreads m_delayThreads;                  // Executer threads
 
     public:
 
         Database();
         ~Database();
 
-        /*! infoString should be formated like hostname;username;password;database. */
-        bool Initialize(const char *infoString);
+        /*! infoString should be formated like hostname;username;password;database.
+            connections is the size of the pool used by the synchronous queries and
+            asyncThreads the number of executers of the delayed ones, each with its
+            own connection. */
+        bool Initialize(const char *infoString, uint32 connections = 1, uint32 asyncThreads = 1);
 
-        void InitDelayThread();
+        void InitDelayThread(uint32 asyncThreads = 1);
         void HaltDelayThread();
 
         QueryResult_AutoPtr Query(const char *sql);
@@ -111,6 +136,14 @@ class Database
         bool DirectExecute(const char* sql);
         bool DirectPExecute(const char *format,...) ATTR_PRINTF(2,3);
 
+        // Prepared statements, registered by index at startup before any use
+        bool PrepareStatement(uint32 index, const char *sql);
+        const char* GetStatementSql(uint32 index) const;
+
+        QueryResult_AutoPtr Query(uint32 index, SqlStmtParameters const& params);
+        bool Execute(uint32 index, SqlStmtParameters const& params);
+        bool DirectExecute(uint32 index, SqlStmtParameters const& params);
+
         // Writes SQL commands to a LOG file (see Oregond.conf "LogSQL")
         bool PExecuteLog(const char *format,...) ATTR_PRINTF(2,3);
 
@@ -118,7 +151,7 @@ class Database
         bool CommitTransaction();
         bool RollbackTransaction();
 
-        operator bool () const { return mMysql != NULL; }
+        operator bool () const { return !m_connections.empty(); }
         unsigned long escape_string(char *to, const char *from, unsigned long length);
         void escape_string(std::string& str);
 
@@ -128,20 +161,99 @@ class Database
         // sets the result queue of the current thread, be careful what thread you call this from
         void SetResultQueue(SqlResultQueue * queue);
 
+        // Async operations are only executed in order with the ones of the same key,
+        // see SqlAsyncKeyGuard. Operations of the default key 0 share one executer.
+        uint32 GetAsyncKey() { return *m_asyncKey; }
+        void SetAsyncKey(uint32 key) { *m_asyncKey = key; }
+
+        // queues op of the key SQL_ASYNC_KEY_ALL, called by SqlDelayThread::Delay
+        bool DelayBarrier(SqlOperation* op);
+        bool IsHalting() const { return m_halting; }
+
+        void GetStats(DatabaseStats& stats);
+
     private:
         bool m_logSQL;
         std::string m_logsDir;
-        ACE_Thread_Mutex mMutex;        // For thread safe operations between core and mySQL server
+        std::string m_infoString;
         ACE_Thread_Mutex nMutex;        // For thread safe operations on m_transQueues
 
         ACE_Based::Thread * tranThread;
+        SqlConnection* m_tranConnection;                    // Locked by tranThread during a synchronous transaction
+
+        std::vector<std::string> m_statements;              // Prepared statements by index
 
-        MYSQL *mMysql;
+        SqlConnections m_connections;                       // Synchronous pool
+        ACE_Atomic_Op<ACE_Thread_Mutex, uint32> m_nextConnection;
+        ACE_Atomic_Op<ACE_Thread_Mutex, uint64> m_syncQueries;
+        ACE_Atomic_Op<ACE_Thread_Mutex, uint64> m_syncWaits;
+
+        ACE_TSS<ACE_TSS_Type_Adapter<uint32> > m_asyncKey;
+        ACE_Thread_Mutex m_barrierLock;                     // keeps the fences of all the barriers in one order
+        volatile bool m_halting;
 
         static size_t db_count;
 
-        bool _TransactionCmd(const char *sql);
-        bool _Query(const char *sql, MYSQL_RES **pResult, MYSQL_FIELD **pFields, uint64* pRowCount, uint32* pFieldCount);
+        SqlConnection* AcquireConnection();
+        void ReleaseConnection(SqlConnection* conn);
+        SqlDelayThread* GetDelayThread();
+};
+
+// Sets the async key of the current thread for its scope, in the scope of
+// SQL_ASYNC_KEY_ALL everything stays in order with all the keys
+class SqlAsyncKeyGuard
+{
+    public:
+        SqlAsyncKeyGuard(Database& db, uint32 key) : m_db(db), m_prevKey(db.GetAsyncKey())
+        {
+            if (m_prevKey != SQL_ASYNC_KEY_ALL)
+                m_db.SetAsyncKey(key);
+        }
+        ~SqlAsyncKeyGuard() { m_db.SetAsyncKey(m_prevKey); }
+
+    private:
+        Database& m_db;
+        uint32 m_prevKey;
+};
+
+// Builds one multi-row INSERT out of many rows:
+//   SqlBatchInsert batch("INSERT INTO character_spell (guid,spell) VALUES ", " ON DUPLICATE KEY UPDATE spell = spell");
+//   batch.NextRow() << guid << ", " << spell;
+//   batch.Execute(CharacterDatabase);
+// The values are written as is, strings must be quoted and escaped by the user.
+class SqlBatchInsert
+{
+    public:
+        SqlBatchInsert(const char *head, const char *tail = "") : m_head(head), m_tail(tail), m_rows(0) {}
+
+        std::ostringstream& NextRow()
+        {
+            if (m_rows++)
+                m_ss << "), (";
+            else
+                m_ss << m_head << "(";
+            return m_ss;
+        }
+
+        uint32 GetRowCount() const { return m_rows; }
+
+        // Executes the statement if it has rows, async and in the transaction of the thread if any
+        void Execute(Database& db)
+        {
+            if (!m_rows)
+                return;
+
+            m_ss << ")" << m_tail;
+            db.Execute(m_ss.str().c_str());
+            m_ss.str("");
+            m_rows = 0;
+        }
+
+    private:
+        const char *m_head;
+        const char *m_tail;
+        uint32 m_rows;
+        std::ostringstream m_ss;
 };
 #endif
 
@@ -28,6 +28,8 @@
 #include "Database/QueryResult.h"
 
 #include "Database/Database.h"
+#include "Database/SqlStmtParameters.h"
+#include "Database/PreparedStatements.h"
 typedef Database DatabaseType;
 #define _LIKE_           "LIKE"
 #define _TABLE_SIM_      "`"
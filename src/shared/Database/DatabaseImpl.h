@@ -19,12 +19,16 @@
 
 #include "Database/Database.h"
 #include "Database/SqlOperations.h"
+#include "Database/SqlDelayThread.h"
 
 // Function body definitions for the template function members of the Database class
 
-#define ASYNC_QUERY_BODY(sql, queue_itr) \
+#define ASYNC_QUERY_BODY(sql, queue_itr, delay_thread) \
     if (!sql) return false; \
     \
+    SqlDelayThread* delay_thread = GetDelayThread(); \
+    if (!delay_thread) return false; \
+    \
     QueryQueues::iterator queue_itr; \
     \
     { \
@@ -52,9 +56,12 @@
         } \
     }
 
-#define ASYNC_DELAYHOLDER_BODY(holder, queue_itr) \
+#define ASYNC_DELAYHOLDER_BODY(holder, queue_itr, delay_thread) \
     if (!holder) return false; \
     \
+    SqlDelayThread* delay_thread = GetDelayThread(); \
+    if (!delay_thread) return false; \
+    \
     QueryQueues::iterator queue_itr; \
     \
     { \
@@ -69,32 +76,32 @@ template<class Class>
 bool
 Database::AsyncQuery(Class *object, void (Class::*method)(QueryResult_AutoPtr), const char *sql)
 {
-    ASYNC_QUERY_BODY(sql, itr)
-    return m_threadBody->Delay(new SqlQuery(sql, new Oregon::QueryCallback<Class>(object, method), itr->second));
+    ASYNC_QUERY_BODY(sql, itr, thread)
+    return thread->Delay(new SqlQuery(sql, new Oregon::QueryCallback<Class>(object, method), itr->second));
 }
 
 template<class Class, typename ParamType1>
 bool
 Database::AsyncQuery(Class *object, void (Class::*method)(QueryResult_AutoPtr, ParamType1), ParamType1 param1, const char *sql)
 {
-    ASYNC_QUERY_BODY(sql, itr)
-    return m_threadBody->Delay(new SqlQuery(sql, new Oregon::QueryCallback<Class, ParamType1>(object, method, QueryResult_AutoPtr(NULL), param1), itr->second));
+    ASYNC_QUERY_BODY(sql, itr, thread)
+    return thread->Delay(new SqlQuery(sql, new Oregon::QueryCallback<Class, ParamType1>(object, method, QueryResult_AutoPtr(NULL), param1), itr->second));
 }
 
 template<class Class, typename ParamType1, typename ParamType2>
 bool
 Database::AsyncQuery(Class *object, void (Class::*method)(QueryResult_AutoPtr, ParamType1, ParamType2), ParamType1 param1, ParamType2 param2, const char *sql)
 {
-    ASYNC_QUERY_BODY(sql, itr)
-    return m_threadBody->Delay(new SqlQuery(sql, new Oregon::QueryCallback<Class, ParamType1, ParamType2>(object, method, QueryResult_AutoPtr(NULL), param1, param2), itr->second));
+    ASYNC_QUERY_BODY(sql, itr, thread)
+    return thread->Delay(new SqlQuery(sql, new Oregon::QueryCallback<Class, ParamType1, ParamType2>(object, method, QueryResult_AutoPtr(NULL), param1, param2), itr->second));
 }
 
 template<class Class, typename ParamType1, typename ParamType2, typename ParamType3>
 bool
 Database::AsyncQuery(Class *object, void (Class::*method)(QueryResult_AutoPtr, ParamType1, ParamType2, ParamType3), ParamType1 param1, ParamType2 param2, ParamType3 param3, const char *sql)
 {
-    ASYNC_QUERY_BODY(sql, itr)
-    return m_threadBody->Delay(new SqlQuery(sql, new Oregon::QueryCallback<Class, ParamType1, ParamType2, ParamType3>(object, method, QueryResult_AutoPtr(NULL), param1, param2, param3), itr->second));
+    ASYNC_QUERY_BODY(sql, itr, thread)
+    return thread->Delay(new SqlQuery(sql, new Oregon::QueryCallback<Class, ParamType1, ParamType2, ParamType3>(object, method, QueryResult_AutoPtr(NULL), param1, param2, param3), itr->second));
 }
 
 // Query / static
@@ -103,24 +110,24 @@ template<typename ParamType1>
 bool
 Database::AsyncQuery(void (*method)(QueryResult_AutoPtr, ParamType1), ParamType1 param1, const char *sql)
 {
-    ASYNC_QUERY_BODY(sql, itr)
-    return m_threadBody->Delay(new SqlQuery(sql, new Oregon::SQueryCallback<ParamType1>(method, QueryResult_AutoPtr(NULL), param1), itr->second));
+    ASYNC_QUERY_BODY(sql, itr, thread)
+    return thread->Delay(new SqlQuery(sql, new Oregon::SQueryCallback<ParamType1>(method, QueryResult_AutoPtr(NULL), param1), itr->second));
 }
 
 template<typename ParamType1, typename ParamType2>
 bool
 Database::AsyncQuery(void (*method)(QueryResult_AutoPtr, ParamType1, ParamType2), ParamType1 param1, ParamType2 param2, const char *sql)
 {
-    ASYNC_QUERY_BODY(sql, itr)
-    return m_threadBody->Delay(new SqlQuery(sql, new Oregon::SQueryCallback<ParamType1, ParamType2>(method, QueryResult_AutoPtr(NULL), param1, param2), itr->second));
+    ASYNC_QUERY_BODY(sql, itr, thread)
+    return thread->Delay(new SqlQuery(sql, new Oregon::SQueryCallback<ParamType1, ParamType2>(method, QueryResult_AutoPtr(NULL), param1, param2), itr->second));
 }
 
 template<typename ParamType1, typename ParamType2, typename ParamType3>
 bool
 Database::AsyncQuery(void (*method)(QueryResult_AutoPtr, ParamType1, ParamType2, ParamType3), ParamType1 param1, ParamType2 param2, ParamType3 param3, const char *sql)
 {
-    ASYNC_QUERY_BODY(sql, itr)
-    return m_threadBody->Delay(new SqlQuery(sql, new Oregon::SQueryCallback<ParamType1, ParamType2, ParamType3>(method, QueryResult_AutoPtr(NULL), param1, param2, param3), itr->second));
+    ASYNC_QUERY_BODY(sql, itr, thread)
+    return thread->Delay(new SqlQuery(sql, new Oregon::SQueryCallback<ParamType1, ParamType2, ParamType3>(method, QueryResult_AutoPtr(NULL), param1, param2, param3), itr->second));
 }
 
 // PQuery / member
@@ -189,16 +196,16 @@ template<class Class>
 bool
 Database::DelayQueryHolder(Class *object, void (Class::*method)(QueryResult_AutoPtr, SqlQueryHolder*), SqlQueryHolder *holder)
 {
-    ASYNC_DELAYHOLDER_BODY(holder, itr)
-    return holder->Execute(new Oregon::QueryCallback<Class, SqlQueryHolder*>(object, method, QueryResult_AutoPtr(NULL), holder), m_threadBody, itr->second);
+    ASYNC_DELAYHOLDER_BODY(holder, itr, thread)
+    return holder->Execute(new Oregon::QueryCallback<Class, SqlQueryHolder*>(object, method, QueryResult_AutoPtr(NULL), holder), thread, itr->second);
 }
 
 template<class Class, typename ParamType1>
 bool
 Database::DelayQueryHolder(Class *object, void (Class::*method)(QueryResult_AutoPtr, SqlQueryHolder*, ParamType1), SqlQueryHolder *holder, ParamType1 param1)
 {
-    ASYNC_DELAYHOLDER_BODY(holder, itr)
-    return holder->Execute(new Oregon::QueryCallback<Class, SqlQueryHolder*, ParamType1>(object, method, QueryResult_AutoPtr(NULL), holder, param1), m_threadBody, itr->second);
+    ASYNC_DELAYHOLDER_BODY(holder, itr, thread)
+    return holder->Execute(new Oregon::QueryCallback<Class, SqlQueryHolder*, ParamType1>(object, method, QueryResult_AutoPtr(NULL), holder, param1), thread, itr->second);
 }
 
 #undef ASYNC_QUERY_BODY
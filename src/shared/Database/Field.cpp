@@ -19,51 +19,14 @@
 
 #include "DatabaseEnv.h"
 
-Field::Field() :
-mValue(NULL), mType(DB_TYPE_UNKNOWN)
+const char *Field::GetNativeString() const
 {
-}
-
-Field::Field(Field &f)
-{
-    const char *value;
-
-    value = f.GetString();
-
-    if (value && (mValue = new char[strlen(value) + 1]))
-        strcpy(mValue, value);
-    else
-        mValue = NULL;
-
-    mType = f.GetType();
-}
-
-Field::Field(const char *value, enum Field::DataTypes type) :
-mType(type)
-{
-    if (value && (mValue = new char[strlen(value) + 1]))
-        strcpy(mValue, value);
+    if (mType == DB_TYPE_FLOAT)
+        snprintf(mBuffer, sizeof(mBuffer), "%g", mData.d);
+    else if (mUnsigned)
+        snprintf(mBuffer, sizeof(mBuffer), UI64FMTD, static_cast<uint64>(mData.i));
     else
-        mValue = NULL;
-}
+        snprintf(mBuffer, sizeof(mBuffer), SI64FMTD, mData.i);
 
-Field::~Field()
-{
-    if (mValue)
-        delete [] mValue;
+    return mBuffer;
 }
-
-void Field::SetValue(const char *value)
-{
-    if (mValue)
-        delete [] mValue;
-
-    if (value)
-    {
-        mValue = new char[strlen(value) + 1];
-        strcpy(mValue, value);
-    }
-    else
-        mValue = NULL;
-}
-
@@ -33,36 +33,55 @@ class Field
             DB_TYPE_BOOL    = 0x04
         };
 
-        Field();
-        Field(Field &f);
-        Field(const char *value, enum DataTypes type);
-
-        ~Field();
+        Field() : mValue(NULL), mType(DB_TYPE_UNKNOWN), mNative(false), mUnsigned(false) {}
 
         enum DataTypes GetType() const { return mType; }
 
-        const char *GetString() const { return mValue; }
+        const char *GetString() const { return mNative ? GetNativeString() : mValue; }
         std::string GetCppString() const
         {
-            return mValue ? mValue : "";                    // std::string s = 0 have undefine result in C++
+            char const* value = GetString();
+            return value ? value : "";                      // std::string s = 0 have undefine result in C++
         }
-        float GetFloat() const { return mValue ? static_cast<float>(atof(mValue)) : 0.0f; }
-        bool GetBool() const { return mValue ? atoi(mValue) > 0 : false; }
-        int32 GetInt32() const { return mValue ? static_cast<int32>(atol(mValue)) : int32(0); }
-        uint8 GetUInt8() const { return mValue ? static_cast<uint8>(atol(mValue)) : uint8(0); }
-        uint16 GetUInt16() const { return mValue ? static_cast<uint16>(atol(mValue)) : uint16(0); }
-        int16 GetInt16() const { return mValue ? static_cast<int16>(atol(mValue)) : int16(0); }
-        uint32 GetUInt32() const { return mValue ? static_cast<uint32>(atol(mValue)) : uint32(0); }
-        uint64 GetUInt64() const { return mValue ? strtoull(mValue, NULL, 10) : uint64(0); }
-        int64 GetInt64() const { return mValue ? strtoll(mValue, NULL, 10) : int64(0); }
+        float GetFloat() const { return mNative ? static_cast<float>(GetNativeDouble()) : mValue ? static_cast<float>(atof(mValue)) : 0.0f; }
+        bool GetBool() const { return mNative ? GetNativeInt() > 0 : mValue ? atoi(mValue) > 0 : false; }
+        int32 GetInt32() const { return mNative ? static_cast<int32>(GetNativeInt()) : mValue ? static_cast<int32>(atol(mValue)) : int32(0); }
+        uint8 GetUInt8() const { return mNative ? static_cast<uint8>(GetNativeInt()) : mValue ? static_cast<uint8>(atol(mValue)) : uint8(0); }
+        uint16 GetUInt16() const { return mNative ? static_cast<uint16>(GetNativeInt()) : mValue ? static_cast<uint16>(atol(mValue)) : uint16(0); }
+        int16 GetInt16() const { return mNative ? static_cast<int16>(GetNativeInt()) : mValue ? static_cast<int16>(atol(mValue)) : int16(0); }
+        uint32 GetUInt32() const { return mNative ? static_cast<uint32>(GetNativeInt()) : mValue ? static_cast<uint32>(atol(mValue)) : uint32(0); }
+        uint64 GetUInt64() const { return mNative ? static_cast<uint64>(GetNativeInt()) : mValue ? strtoull(mValue, NULL, 10) : uint64(0); }
+        int64 GetInt64() const { return mNative ? GetNativeInt() : mValue ? strtoll(mValue, NULL, 10) : int64(0); }
 
         void SetType(enum DataTypes type) { mType = type; }
 
-        void SetValue(const char *value);
+        // Text protocol value, not copied: it must stay valid as long as the field is used
+        void SetValue(const char *value) { mValue = value; mNative = false; }
+
+        // Binary protocol values of DB_TYPE_INTEGER and DB_TYPE_FLOAT fields
+        void SetNativeInt(int64 value, bool isUnsigned) { mData.i = value; mNative = true; mUnsigned = isUnsigned; }
+        void SetNativeDouble(double value) { mData.d = value; mNative = true; mUnsigned = false; }
 
     private:
-        char *mValue;
+        int64 GetNativeInt() const { return mType == DB_TYPE_FLOAT ? static_cast<int64>(mData.d) : mData.i; }
+        double GetNativeDouble() const
+        {
+            if (mType == DB_TYPE_FLOAT)
+                return mData.d;
+            return mUnsigned ? static_cast<double>(static_cast<uint64>(mData.i)) : static_cast<double>(mData.i);
+        }
+        const char *GetNativeString() const;
+
+        const char *mValue;
+        union
+        {
+            int64 i;
+            double d;
+        } mData;
         enum DataTypes mType;
+        bool mNative;
+        bool mUnsigned;
+
+        mutable char mBuffer[32];                           // GetString() of native values
 };
 #endif
-
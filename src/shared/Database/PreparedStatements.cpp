@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DatabaseEnv.h"
+#include "Database/PreparedStatements.h"
+
+bool PrepareCharacterDatabaseStatements()
+{
+    bool res = true;
+
+    // NOTE: all fields in `characters` must be read to prevent lost character data at next save in case wrong DB structure.
+    // !!! NOTE: including unused `zone`,`online`
+    res &= CharacterDatabase.PrepareStatement(CHAR_SEL_CHARACTER,
+        "SELECT guid, account, data, name, race, class, gender, level, xp, "
+        "money, playerBytes, playerBytes2, playerFlags, position_x, "
+        "position_y, position_z, map, orientation, taximask, cinematic, "
+        "totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, "
+        "resettalents_cost, resettalents_time, trans_x, trans_y, trans_z, "
+        "trans_o, transguid, extra_flags, stable_slots, at_login, zone, "
+        "online, death_expire_time, taxi_path, dungeon_difficulty, "
+        "arenaPoints, totalHonorPoints, todayHonorPoints, "
+        "yesterdayHonorPoints, totalKills, todayKills, yesterdayKills, "
+        "chosenTitle, watchedFaction, drunk, health, "
+        "powerMana, powerRage, powerFocus, powerEnergy, powerHappiness, instance_id "
+        "FROM characters WHERE guid = ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_SEL_GROUP_MEMBER,                "SELECT leaderGuid FROM group_member WHERE memberGuid = ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_SEL_CHARACTER_INSTANCE,          "SELECT id, permanent, map, difficulty, resettime FROM character_instance LEFT JOIN instance ON instance = id WHERE guid = ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_SEL_CHARACTER_AURAS,             "SELECT caster_guid,spell,effect_index,stackcount,amount,maxduration,remaintime,remaincharges FROM character_aura WHERE guid = ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_SEL_CHARACTER_SPELLS,            "SELECT spell,active,disabled FROM character_spell WHERE guid = ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_SEL_CHARACTER_QUESTSTATUS,       "SELECT quest,status,rewarded,explored,timer,mobcount1,mobcount2,mobcount3,mobcount4,itemcount1,itemcount2,itemcount3,itemcount4 FROM character_queststatus WHERE guid = ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_SEL_CHARACTER_QUESTSTATUS_DAILY, "SELECT quest,time FROM character_queststatus_daily WHERE guid = ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_SEL_CHARACTER_TUTORIALS,         "SELECT tut0,tut1,tut2,tut3,tut4,tut5,tut6,tut7 FROM character_tutorial WHERE account = ? AND realmid = ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_SEL_CHARACTER_REPUTATION,        "SELECT faction,standing,flags FROM character_reputation WHERE guid = ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_SEL_CHARACTER_INVENTORY,         "SELECT data,bag,slot,item,item_template FROM character_inventory JOIN item_instance ON character_inventory.item = item_instance.guid WHERE character_inventory.guid = ? ORDER BY bag,slot");
+    res &= CharacterDatabase.PrepareStatement(CHAR_SEL_CHARACTER_ACTIONS,           "SELECT button,action,type,misc FROM character_action WHERE guid = ? ORDER BY button");
+    res &= CharacterDatabase.PrepareStatement(CHAR_SEL_MAIL_COUNT,                  "SELECT COUNT(id) FROM mail WHERE receiver = ? AND (checked & 1)=0 AND deliver_time <= ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_SEL_MAIL_DATE,                   "SELECT MIN(deliver_time) FROM mail WHERE receiver = ? AND (checked & 1)=0");
+    res &= CharacterDatabase.PrepareStatement(CHAR_SEL_CHARACTER_SOCIAL,            "SELECT friend,flags,note FROM character_social WHERE guid = ? LIMIT 255");
+    res &= CharacterDatabase.PrepareStatement(CHAR_SEL_CHARACTER_HOMEBIND,          "SELECT map,zone,position_x,position_y,position_z FROM character_homebind WHERE guid = ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_SEL_CHARACTER_SPELL_COOLDOWNS,   "SELECT spell,item,time FROM character_spell_cooldown WHERE guid = ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_SEL_CHARACTER_DECLINEDNAMES,     "SELECT genitive, dative, accusative, instrumental, prepositional FROM character_declinedname WHERE guid = ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_SEL_GUILD_MEMBER,                "SELECT guildid,rank FROM guild_member WHERE guid = ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_SEL_ARENA_TEAM_MEMBER,           "SELECT arenateamid, played_week, played_season, personal_rating FROM arena_team_member WHERE guid = ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_SEL_CHARACTER_BGDATA,            "SELECT instance_id, team, join_x, join_y, join_z, join_o, join_map, taxi_start, taxi_end, mount_spell FROM character_battleground_data WHERE guid = ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_SEL_CHARACTER_SKILLS,            "SELECT skill, value, max FROM character_skills WHERE guid = ?");
+
+    res &= CharacterDatabase.PrepareStatement(CHAR_REP_CHARACTER,
+        "REPLACE INTO characters (guid,account,name,race,class,gender,level,xp,money,playerBytes,playerBytes2,playerFlags,"
+        "map, instance_id, dungeon_difficulty, position_x, position_y, position_z, orientation, data, "
+        "taximask, online, cinematic, "
+        "totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, resettalents_cost, resettalents_time, "
+        "trans_x, trans_y, trans_z, trans_o, transguid, extra_flags, stable_slots, at_login, zone, "
+        "death_expire_time, taxi_path, arenaPoints, totalHonorPoints, todayHonorPoints, yesterdayHonorPoints, "
+        "totalKills, todayKills, yesterdayKills, chosenTitle, watchedFaction, drunk, health, "
+        "powerMana, powerRage, powerFocus, powerEnergy, powerHappiness, latency) VALUES ("
+        "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
+        "?, ?, ?, ?, ?, ?, ?, ?, "
+        "?, ?, ?, "
+        "?, ?, ?, ?, ?, ?, ?, "
+        "?, ?, ?, ?, ?, ?, ?, ?, ?, "
+        "?, ?, ?, ?, ?, ?, "
+        "?, ?, ?, ?, ?, ?, ?, "
+        "?, ?, ?, ?, ?, ?)");
+    res &= CharacterDatabase.PrepareStatement(CHAR_UPD_CHARACTER_MONEY,             "UPDATE characters SET money = ? WHERE guid = ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_DEL_CHARACTER_ACTION,            "DELETE FROM character_action WHERE guid = ? AND button = ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_DEL_CHARACTER_AURAS,             "DELETE FROM character_aura WHERE guid = ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_DEL_CHARACTER_INVENTORY_BY_ITEM, "DELETE FROM character_inventory WHERE item = ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_DEL_CHARACTER_INVENTORY_BY_SLOT, "DELETE FROM character_inventory WHERE bag = ? AND slot = ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_DEL_CHARACTER_QUESTSTATUS_DAILY, "DELETE FROM character_queststatus_daily WHERE guid = ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_DEL_CHARACTER_SKILL,             "DELETE FROM character_skills WHERE guid = ? AND skill = ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_DEL_CHARACTER_SPELL,             "DELETE FROM character_spell WHERE guid = ? AND spell = ?");
+
+    res &= CharacterDatabase.PrepareStatement(CHAR_REP_ITEM_INSTANCE,               "REPLACE INTO item_instance (guid, owner_guid, data) VALUES (?, ?, ?)");
+    res &= CharacterDatabase.PrepareStatement(CHAR_UPD_ITEM_INSTANCE,               "UPDATE item_instance SET data = ?, owner_guid = ? WHERE guid = ?");
+    res &= CharacterDatabase.PrepareStatement(CHAR_DEL_ITEM_INSTANCE,               "DELETE FROM item_instance WHERE guid = ?");
+
+    return res;
+}
+
+bool PrepareLoginDatabaseStatements()
+{
+    bool res = true;
+
+    res &= LoginDatabase.PrepareStatement(LOGIN_SEL_ACCOUNT_INFO_BY_NAME,   "SELECT id, sessionkey, last_ip, locked, v, s, expansion, mutetime, locale, os FROM account WHERE username = ?");
+    res &= LoginDatabase.PrepareStatement(LOGIN_SEL_ACCOUNT_ACCESS_GMLEVEL, "SELECT RealmID, gmlevel FROM account_access WHERE id = ? AND (RealmID = ? OR RealmID = '-1')");
+    res &= LoginDatabase.PrepareStatement(LOGIN_SEL_ACCOUNT_BANNED,         "SELECT bandate, unbandate FROM account_banned WHERE id = ? AND active = 1");
+    res &= LoginDatabase.PrepareStatement(LOGIN_UPD_ACCOUNT_LAST_IP,        "UPDATE account SET last_ip = ? WHERE username = ?");
+
+    return res;
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PREPAREDSTATEMENTS_H
+#define __PREPAREDSTATEMENTS_H
+
+// Naming: <DB>_<SEL|INS|UPD|DEL|REP>_<what>, the parameters are given in the
+// order of the placeholders of the statement.
+enum CharacterDatabaseStatements
+{
+    // player login
+    CHAR_SEL_CHARACTER,
+    CHAR_SEL_GROUP_MEMBER,
+    CHAR_SEL_CHARACTER_INSTANCE,
+    CHAR_SEL_CHARACTER_AURAS,
+    CHAR_SEL_CHARACTER_SPELLS,
+    CHAR_SEL_CHARACTER_QUESTSTATUS,
+    CHAR_SEL_CHARACTER_QUESTSTATUS_DAILY,
+    CHAR_SEL_CHARACTER_TUTORIALS,
+    CHAR_SEL_CHARACTER_REPUTATION,
+    CHAR_SEL_CHARACTER_INVENTORY,
+    CHAR_SEL_CHARACTER_ACTIONS,
+    CHAR_SEL_MAIL_COUNT,
+    CHAR_SEL_MAIL_DATE,
+    CHAR_SEL_CHARACTER_SOCIAL,
+    CHAR_SEL_CHARACTER_HOMEBIND,
+    CHAR_SEL_CHARACTER_SPELL_COOLDOWNS,
+    CHAR_SEL_CHARACTER_DECLINEDNAMES,
+    CHAR_SEL_GUILD_MEMBER,
+    CHAR_SEL_ARENA_TEAM_MEMBER,
+    CHAR_SEL_CHARACTER_BGDATA,
+    CHAR_SEL_CHARACTER_SKILLS,
+
+    // player save
+    CHAR_REP_CHARACTER,
+    CHAR_UPD_CHARACTER_MONEY,
+    CHAR_DEL_CHARACTER_ACTION,
+    CHAR_DEL_CHARACTER_AURAS,
+    CHAR_DEL_CHARACTER_INVENTORY_BY_ITEM,
+    CHAR_DEL_CHARACTER_INVENTORY_BY_SLOT,
+    CHAR_DEL_CHARACTER_QUESTSTATUS_DAILY,
+    CHAR_DEL_CHARACTER_SKILL,
+    CHAR_DEL_CHARACTER_SPELL,
+
+    // items
+    CHAR_REP_ITEM_INSTANCE,
+    CHAR_UPD_ITEM_INSTANCE,
+    CHAR_DEL_ITEM_INSTANCE,
+
+    MAX_CHARACTERDATABASE_STATEMENTS
+};
+
+enum LoginDatabaseStatements
+{
+    LOGIN_SEL_ACCOUNT_INFO_BY_NAME,
+    LOGIN_SEL_ACCOUNT_ACCESS_GMLEVEL,
+    LOGIN_SEL_ACCOUNT_BANNED,
+    LOGIN_UPD_ACCOUNT_LAST_IP,
+
+    MAX_LOGINDATABASE_STATEMENTS
+};
+
+// Registers the statements, the connections must be open
+bool PrepareCharacterDatabaseStatements();
+bool PrepareLoginDatabaseStatements();
+#endif                                                      //__PREPAREDSTATEMENTS_H
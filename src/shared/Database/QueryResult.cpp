@@ -31,6 +31,14 @@ QueryResult::QueryResult(MYSQL_RES *result, MYSQL_FIELD *fields, uint64 rowCount
          mCurrentRow[i].SetType(ConvertNativeType(fields[i].type));
 }
 
+QueryResult::QueryResult(uint64 rowCount, uint32 fieldCount)
+: mCurrentRow(NULL)
+, mFieldCount(fieldCount)
+, mRowCount(rowCount)
+, mResult(NULL)
+{
+}
+
 QueryResult::~QueryResult()
 {
     EndQuery();
@@ -103,3 +111,122 @@ enum Field::DataTypes QueryResult::ConvertNativeType(enum_field_types mysqlType)
     }
 }
 
+PreparedQueryResult::PreparedQueryResult(MYSQL_STMT *stmt, MYSQL_RES *metadata, uint64 rowCount, uint32 fieldCount)
+: QueryResult(rowCount, fieldCount)
+, mRows(size_t(rowCount) * fieldCount)
+, mNextRow(0)
+{
+    MYSQL_FIELD *fields = mysql_fetch_fields(metadata);
+
+    std::vector<MYSQL_BIND> binds(mFieldCount);
+    std::vector<int64> ints(mFieldCount);
+    std::vector<double> doubles(mFieldCount);
+    std::vector<my_bool> isNull(mFieldCount);
+    std::vector<unsigned long> lengths(mFieldCount);
+    std::vector<size_t> offsets(mRows.size(), size_t(-1));
+
+    // strings are fetched in a buffer sized for the longest value of each column
+    std::vector<size_t> bufferOffsets(mFieldCount);
+    size_t bufferSize = 0;
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        Field::DataTypes type = ConvertNativeType(fields[i].type);
+        if (type != Field::DB_TYPE_INTEGER && type != Field::DB_TYPE_FLOAT)
+        {
+            bufferOffsets[i] = bufferSize;
+            bufferSize += fields[i].max_length + 1;
+        }
+    }
+    std::vector<char> buffer(bufferSize + 1);
+
+    memset(&binds[0], 0, sizeof(MYSQL_BIND) * mFieldCount);
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        Field::DataTypes type = ConvertNativeType(fields[i].type);
+        for (uint64 row = 0; row < mRowCount; ++row)
+            mRows[size_t(row) * mFieldCount + i].SetType(type);
+
+        binds[i].is_null = &isNull[i];
+        binds[i].length = &lengths[i];
+        binds[i].is_unsigned = (fields[i].flags & UNSIGNED_FLAG) != 0;
+
+        switch (type)
+        {
+            case Field::DB_TYPE_INTEGER:
+                binds[i].buffer_type = MYSQL_TYPE_LONGLONG;
+                binds[i].buffer = &ints[i];
+                break;
+            case Field::DB_TYPE_FLOAT:
+                binds[i].buffer_type = MYSQL_TYPE_DOUBLE;
+                binds[i].buffer = &doubles[i];
+                break;
+            default:
+                binds[i].buffer_type = MYSQL_TYPE_STRING;
+                binds[i].buffer = &buffer[bufferOffsets[i]];
+                binds[i].buffer_length = fields[i].max_length + 1;
+                break;
+        }
+    }
+
+    if (mysql_stmt_bind_result(stmt, &binds[0]))
+    {
+        sLog.outErrorDb("SQL ERROR: %s", mysql_stmt_error(stmt));
+        mRowCount = 0;
+        return;
+    }
+
+    uint64 row = 0;
+    for (; row < mRowCount; ++row)
+    {
+        int res = mysql_stmt_fetch(stmt);
+        if (res != 0 && res != MYSQL_DATA_TRUNCATED)
+            break;
+
+        Field *fieldRow = &mRows[size_t(row) * mFieldCount];
+        for (uint32 i = 0; i < mFieldCount; ++i)
+        {
+            if (isNull[i])
+                continue;
+
+            switch (binds[i].buffer_type)
+            {
+                case MYSQL_TYPE_LONGLONG:
+                    fieldRow[i].SetNativeInt(ints[i], binds[i].is_unsigned != 0);
+                    break;
+                case MYSQL_TYPE_DOUBLE:
+                    fieldRow[i].SetNativeDouble(doubles[i]);
+                    break;
+                default:
+                    offsets[size_t(row) * mFieldCount + i] = mStrings.size();
+                    mStrings.insert(mStrings.end(), (char*)binds[i].buffer, (char*)binds[i].buffer + lengths[i]);
+                    mStrings.push_back('\0');
+                    break;
+            }
+        }
+    }
+    mRowCount = row;
+
+    // the string buffer doesn't move anymore
+    for (size_t i = 0; i < offsets.size(); ++i)
+        if (offsets[i] != size_t(-1))
+            mRows[i].SetValue(&mStrings[offsets[i]]);
+}
+
+PreparedQueryResult::~PreparedQueryResult()
+{
+    // the rows are not owned by QueryResult
+    mCurrentRow = NULL;
+}
+
+bool PreparedQueryResult::NextRow()
+{
+    if (mNextRow >= mRowCount)
+    {
+        mCurrentRow = NULL;
+        return false;
+    }
+
+    mCurrentRow = &mRows[size_t(mNextRow) * mFieldCount];
+    ++mNextRow;
+    return true;
+}
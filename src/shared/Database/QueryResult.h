@@ -25,6 +25,8 @@
 
 #include "Field.h"
 
+#include <vector>
+
 #ifdef WIN32
   #define FD_SETSIZE 1024
   #include <winsock2.h>
@@ -35,9 +37,9 @@ class QueryResult
 {
     public:
         QueryResult(MYSQL_RES *result, MYSQL_FIELD *fields, uint64 rowCount, uint32 fieldCount);
-        ~QueryResult();
+        virtual ~QueryResult();
 
-        bool NextRow();
+        virtual bool NextRow();
 
         Field *Fetch() const { return mCurrentRow; }
 
@@ -47,17 +49,37 @@ class QueryResult
         uint64 GetRowCount() const { return mRowCount; }
 
     protected:
+        QueryResult(uint64 rowCount, uint32 fieldCount);
+
+        enum Field::DataTypes ConvertNativeType(enum_field_types mysqlType) const;
+
         Field *mCurrentRow;
         uint32 mFieldCount;
         uint64 mRowCount;
 
     private:
-        enum Field::DataTypes ConvertNativeType(enum_field_types mysqlType) const;
         void EndQuery();
         MYSQL_RES *mResult;
 
 };
 
+// Result of a prepared statement, all rows are fetched from the binary protocol
+// at once: integer and float columns are stored as native values, strings in
+// one buffer.
+class PreparedQueryResult : public QueryResult
+{
+    public:
+        PreparedQueryResult(MYSQL_STMT *stmt, MYSQL_RES *metadata, uint64 rowCount, uint32 fieldCount);
+        ~PreparedQueryResult();
+
+        bool NextRow();
+
+    private:
+        std::vector<Field> mRows;
+        std::vector<char> mStrings;
+        uint64 mNextRow;
+};
+
 typedef ACE_Refcounted_Auto_Ptr<QueryResult, ACE_Null_Mutex> QueryResult_AutoPtr;
 
 typedef std::vector<std::string> QueryFieldNames;
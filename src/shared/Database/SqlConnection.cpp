@@ -0,0 +1,359 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Database/SqlConnection.h"
+#include "Database/SqlStmtParameters.h"
+#include "DatabaseEnv.h"
+#include "Util.h"
+#include "Timer.h"
+
+#include <errmsg.h>
+#include <mysqld_error.h>
+
+SqlConnection::~SqlConnection()
+{
+    for (size_t i = 0; i < mStmts.size(); ++i)
+        if (mStmts[i])
+            mysql_stmt_close(mStmts[i]);
+
+    if (mMysql)
+        mysql_close(mMysql);
+}
+
+bool SqlConnection::Open(const char *infoString)
+{
+    MYSQL *mysqlInit;
+    mysqlInit = mysql_init(NULL);
+    if (!mysqlInit)
+    {
+        sLog.outError("Could not initialize Mysql connection");
+        return false;
+    }
+
+    Tokens tokens = StrSplit(infoString, ";");
+
+    Tokens::iterator iter;
+
+    std::string host, port_or_socket, user, password, database;
+    int port;
+    char const* unix_socket;
+
+    iter = tokens.begin();
+
+    if (iter != tokens.end())
+        host = *iter++;
+    if (iter != tokens.end())
+        port_or_socket = *iter++;
+    if (iter != tokens.end())
+        user = *iter++;
+    if (iter != tokens.end())
+        password = *iter++;
+    if (iter != tokens.end())
+        database = *iter++;
+
+    mysql_options(mysqlInit, MYSQL_SET_CHARSET_NAME, "utf8");
+    #ifdef _WIN32
+    if (host==".")                                           // named pipe use option (Windows)
+    {
+        unsigned int opt = MYSQL_PROTOCOL_PIPE;
+        mysql_options(mysqlInit, MYSQL_OPT_PROTOCOL, (char const*)&opt);
+        port = 0;
+        unix_socket = 0;
+    }
+    else                                                    // generic case
+    {
+        port = atoi(port_or_socket.c_str());
+        unix_socket = 0;
+    }
+    #else
+    if (host==".")                                           // socket use option (Unix/Linux)
+    {
+        unsigned int opt = MYSQL_PROTOCOL_SOCKET;
+        mysql_options(mysqlInit, MYSQL_OPT_PROTOCOL, (char const*)&opt);
+        host = "localhost";
+        port = 0;
+        unix_socket = port_or_socket.c_str();
+    }
+    else                                                    // generic case
+    {
+        port = atoi(port_or_socket.c_str());
+        unix_socket = 0;
+    }
+    #endif
+
+    mMysql = mysql_real_connect(mysqlInit, host.c_str(), user.c_str(),
+        password.c_str(), database.c_str(), port, unix_socket, 0);
+
+    if (!mMysql)
+    {
+        sLog.outError("Could not connect to MySQL database at %s: %s\n", host.c_str(),mysql_error(mysqlInit));
+        mysql_close(mysqlInit);
+        return false;
+    }
+
+    sLog.outDetail("Connected to MySQL database at %s", host.c_str());
+
+    if (!mysql_autocommit(mMysql, 1))
+        sLog.outDetail("AUTOCOMMIT SUCCESSFULLY SET TO 1");
+    else
+        sLog.outDetail("AUTOCOMMIT NOT SET TO 1");
+
+    // set connection properties to UTF8 to properly handle locales for different
+    // server configs - core sends data in UTF8, so MySQL must expect UTF8 too
+    Execute("SET NAMES `utf8`");
+    Execute("SET CHARACTER SET `utf8`");
+
+#if MYSQL_VERSION_ID >= 50003
+    my_bool my_true = (my_bool)1;
+    if (mysql_options(mMysql, MYSQL_OPT_RECONNECT, &my_true))
+        sLog.outDetail("Failed to turn on MYSQL_OPT_RECONNECT.");
+    else
+       sLog.outDetail("Successfully turned on MYSQL_OPT_RECONNECT.");
+#else
+    #warning "Your mySQL client lib version does not support reconnecting after a timeout.\nIf this causes you any trouble we advice you to upgrade your mySQL client libs to at least mySQL 5.0.13 to resolve this problem."
+#endif
+    return true;
+}
+
+bool SqlConnection::_Query(const char *sql, MYSQL_RES **pResult, MYSQL_FIELD **pFields, uint64* pRowCount, uint32* pFieldCount)
+{
+    if (!mMysql)
+        return false;
+
+    #ifdef OREGON_DEBUG
+    uint32 _s = getMSTime();
+    #endif
+    if (mysql_query(mMysql, sql))
+    {
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("query ERROR: %s", mysql_error(mMysql));
+        return false;
+    }
+    else
+    {
+        #ifdef OREGON_DEBUG
+        sLog.outDebug("[%u ms] SQL: %s", getMSTimeDiff(_s,getMSTime()), sql );
+        #endif
+    }
+
+    *pResult = mysql_store_result(mMysql);
+    *pRowCount = mysql_affected_rows(mMysql);
+    *pFieldCount = mysql_field_count(mMysql);
+
+    if (!*pResult )
+        return false;
+
+    if (!*pRowCount)
+    {
+        mysql_free_result(*pResult);
+        return false;
+    }
+
+    *pFields = mysql_fetch_fields(*pResult);
+    return true;
+}
+
+QueryResult_AutoPtr SqlConnection::Query(const char *sql)
+{
+    MYSQL_RES *result = NULL;
+    MYSQL_FIELD *fields = NULL;
+    uint64 rowCount = 0;
+    uint32 fieldCount = 0;
+
+    if (!_Query(sql, &result, &fields, &rowCount, &fieldCount))
+        return QueryResult_AutoPtr(NULL);
+
+    QueryResult *queryResult = new QueryResult(result, fields, rowCount, fieldCount);
+
+    queryResult->NextRow();
+
+    return QueryResult_AutoPtr(queryResult);
+}
+
+QueryNamedResult* SqlConnection::QueryNamed(const char *sql)
+{
+    MYSQL_RES *result = NULL;
+    MYSQL_FIELD *fields = NULL;
+    uint64 rowCount = 0;
+    uint32 fieldCount = 0;
+
+    if (!_Query(sql, &result, &fields, &rowCount, &fieldCount))
+        return NULL;
+
+    QueryFieldNames names(fieldCount);
+    for (uint32 i = 0; i < fieldCount; i++)
+         names[i] = fields[i].name;
+
+    QueryResult *queryResult = new QueryResult(result, fields, rowCount, fieldCount);
+
+    queryResult->NextRow();
+
+    return new QueryNamedResult(queryResult, names);
+}
+
+bool SqlConnection::Execute(const char *sql)
+{
+    if (!mMysql)
+        return false;
+
+    #ifdef OREGON_DEBUG
+    uint32 _s = getMSTime();
+    #endif
+    if (mysql_query(mMysql, sql))
+    {
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("SQL ERROR: %s", mysql_error(mMysql));
+        return false;
+    }
+    else
+    {
+        #ifdef OREGON_DEBUG
+        sLog.outDebug("[%u ms] SQL: %s", getMSTimeDiff(_s,getMSTime()), sql);
+        #endif
+    }
+
+    return true;
+}
+
+MYSQL_STMT* SqlConnection::_GetStmt(uint32 index)
+{
+    if (index < mStmts.size() && mStmts[index])
+        return mStmts[index];
+
+    const char *sql = m_db.GetStatementSql(index);
+    if (!sql)
+    {
+        sLog.outErrorDb("SQL: unknown prepared statement %u", index);
+        return NULL;
+    }
+
+    MYSQL_STMT *stmt = mysql_stmt_init(mMysql);
+    if (!stmt)
+    {
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("SQL ERROR: %s", mysql_error(mMysql));
+        return NULL;
+    }
+
+    if (mysql_stmt_prepare(stmt, sql, strlen(sql)))
+    {
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("SQL ERROR: %s", mysql_stmt_error(stmt));
+        mysql_stmt_close(stmt);
+        return NULL;
+    }
+
+    // needed to size the string buffers of the results
+    my_bool updateMaxLength = 1;
+    mysql_stmt_attr_set(stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &updateMaxLength);
+
+    if (index >= mStmts.size())
+        mStmts.resize(index + 1, NULL);
+    mStmts[index] = stmt;
+    return stmt;
+}
+
+MYSQL_STMT* SqlConnection::_ExecuteStmt(uint32 index, SqlStmtParameters const& params)
+{
+    if (!mMysql)
+        return NULL;
+
+    std::vector<MYSQL_BIND> binds;
+    params.Bind(binds);
+
+    // a statement is lost when the connection is reestablished, prepare it again once
+    for (int attempt = 0; attempt < 2; ++attempt)
+    {
+        MYSQL_STMT *stmt = _GetStmt(index);
+        if (!stmt)
+            return NULL;
+
+        if (mysql_stmt_param_count(stmt) != binds.size())
+        {
+            sLog.outErrorDb("SQL: %s", m_db.GetStatementSql(index));
+            sLog.outErrorDb("SQL ERROR: %u parameters given, %lu expected", uint32(binds.size()), mysql_stmt_param_count(stmt));
+            return NULL;
+        }
+
+        #ifdef OREGON_DEBUG
+        uint32 _s = getMSTime();
+        #endif
+        if ((binds.empty() || !mysql_stmt_bind_param(stmt, &binds[0])) && !mysql_stmt_execute(stmt))
+        {
+            #ifdef OREGON_DEBUG
+            sLog.outDebug("[%u ms] SQL: %s", getMSTimeDiff(_s,getMSTime()), m_db.GetStatementSql(index));
+            #endif
+            return stmt;
+        }
+
+        unsigned int error = mysql_stmt_errno(stmt);
+        if (attempt == 0 && (error == CR_SERVER_GONE_ERROR || error == CR_SERVER_LOST || error == ER_UNKNOWN_STMT_HANDLER))
+        {
+            mysql_stmt_close(stmt);
+            mStmts[index] = NULL;
+            mysql_ping(mMysql);                             // reconnects
+            continue;
+        }
+
+        sLog.outErrorDb("SQL: %s", m_db.GetStatementSql(index));
+        sLog.outErrorDb("SQL ERROR: %s", mysql_stmt_error(stmt));
+        return NULL;
+    }
+
+    return NULL;
+}
+
+QueryResult_AutoPtr SqlConnection::Query(uint32 index, SqlStmtParameters const& params)
+{
+    MYSQL_STMT *stmt = _ExecuteStmt(index, params);
+    if (!stmt)
+        return QueryResult_AutoPtr(NULL);
+
+    if (mysql_stmt_store_result(stmt))
+    {
+        sLog.outErrorDb("SQL: %s", m_db.GetStatementSql(index));
+        sLog.outErrorDb("query ERROR: %s", mysql_stmt_error(stmt));
+        return QueryResult_AutoPtr(NULL);
+    }
+
+    // the metadata holds the max lengths once the result is stored
+    MYSQL_RES *metadata = mysql_stmt_result_metadata(stmt);
+    uint64 rowCount = mysql_stmt_num_rows(stmt);
+    uint32 fieldCount = mysql_stmt_field_count(stmt);
+
+    QueryResult *queryResult = NULL;
+    if (metadata && rowCount)
+    {
+        queryResult = new PreparedQueryResult(stmt, metadata, rowCount, fieldCount);
+        if (!queryResult->NextRow())
+        {
+            delete queryResult;
+            queryResult = NULL;
+        }
+    }
+
+    if (metadata)
+        mysql_free_result(metadata);
+    mysql_stmt_free_result(stmt);
+
+    return QueryResult_AutoPtr(queryResult);
+}
+
+bool SqlConnection::Execute(uint32 index, SqlStmtParameters const& params)
+{
+    return _ExecuteStmt(index, params) != NULL;
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SQLCONNECTION_H
+#define __SQLCONNECTION_H
+
+#include "Common.h"
+#include "Database/QueryResult.h"
+#include "ace/Thread_Mutex.h"
+
+#include <vector>
+
+#ifdef WIN32
+  #define FD_SETSIZE 1024
+  #include <winsock2.h>
+#endif
+#include <mysql.h>
+
+class Database;
+class SqlStmtParameters;
+
+// One connection to the mySQL server. The connections of the synchronous pool
+// are shared and must be locked by the user, the ones of the async executors
+// are only used by their own thread.
+class SqlConnection
+{
+    public:
+        explicit SqlConnection(Database& db) : m_db(db), mMysql(NULL) {}
+        ~SqlConnection();
+
+        /*! infoString should be formated like hostname;username;password;database. */
+        bool Open(const char *infoString);
+
+        QueryResult_AutoPtr Query(const char *sql);
+        QueryNamedResult* QueryNamed(const char *sql);
+        bool Execute(const char *sql);
+
+        // Prepared statements of the database, prepared on this connection at first use
+        QueryResult_AutoPtr Query(uint32 index, SqlStmtParameters const& params);
+        bool Execute(uint32 index, SqlStmtParameters const& params);
+        bool Prepare(uint32 index) { return _GetStmt(index) != NULL; }
+
+        bool TryLock() { return mMutex.tryacquire() != -1; }
+        void Lock() { mMutex.acquire(); }
+        void Unlock() { mMutex.release(); }
+
+        MYSQL* GetMysql() { return mMysql; }
+
+    private:
+        bool _Query(const char *sql, MYSQL_RES **pResult, MYSQL_FIELD **pFields, uint64* pRowCount, uint32* pFieldCount);
+        MYSQL_STMT* _GetStmt(uint32 index);
+        MYSQL_STMT* _ExecuteStmt(uint32 index, SqlStmtParameters const& params);
+
+        Database& m_db;
+        ACE_Thread_Mutex mMutex;
+        MYSQL *mMysql;
+        std::vector<MYSQL_STMT*> mStmts;
+
+        SqlConnection(SqlConnection const&);
+        SqlConnection& operator=(SqlConnection const&);
+};
+#endif                                                      //__SQLCONNECTION_H
@@ -19,12 +19,19 @@
 
 #include "Database/SqlDelayThread.h"
 #include "Database/SqlOperations.h"
+#include "Database/SqlConnection.h"
 #include "DatabaseEnv.h"
+#include "Timer.h"
 
-SqlDelayThread::SqlDelayThread(Database* db) : m_dbEngine(db), m_running(true)
+SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn) : m_dbEngine(db), m_dbConnection(conn), m_running(true), m_queueSize(0)
 {
 }
 
+SqlDelayThread::~SqlDelayThread()
+{
+    delete m_dbConnection;
+}
+
 void SqlDelayThread::run()
 {
     mysql_thread_init();
@@ -39,8 +46,18 @@ void SqlDelayThread::run()
         s = dynamic_cast<SqlAsyncTask*> (m_sqlQueue.dequeue());
         if (s)
         {
+            uint32 startTime = getMSTime();
+            uint32 waitTime = getMSTimeDiff(s->GetQueueTime(), startTime);
+
             s->call();
             delete s;
+            --m_queueSize;
+
+            ++m_stats.operations;
+            m_stats.waitTime += waitTime;
+            m_stats.execTime += getMSTimeDiff(startTime, getMSTime());
+            if (waitTime > m_stats.maxWaitTime)
+                m_stats.maxWaitTime = waitTime;
         }
     }
 
@@ -55,7 +72,18 @@ void SqlDelayThread::Stop()
 
 bool SqlDelayThread::Delay(SqlOperation* sql)
 {
-    int res = m_sqlQueue.enqueue(new SqlAsyncTask(m_dbEngine, sql));
+    if (m_dbEngine->GetAsyncKey() == SQL_ASYNC_KEY_ALL)
+        return m_dbEngine->DelayBarrier(sql);
+
+    return Enqueue(sql);
+}
+
+bool SqlDelayThread::Enqueue(SqlOperation* sql)
+{
+    ++m_queueSize;
+    int res = m_sqlQueue.enqueue(new SqlAsyncTask(m_dbConnection, sql));
+    if (res == -1)
+        --m_queueSize;
     return (res != -1);
 }
 
@@ -22,11 +22,25 @@
 
 #include "ace/Thread_Mutex.h"
 #include "ace/Activation_Queue.h"
+#include "ace/Atomic_Op.h"
 #include "Threading.h"
+#include "Platform/Define.h"
 
 class Database;
+class SqlConnection;
 class SqlOperation;
 
+// Counters of an async executor, in milliseconds
+struct SqlDelayStats
+{
+    SqlDelayStats() : operations(0), waitTime(0), execTime(0), maxWaitTime(0) {}
+
+    uint64 operations;                                      // Executed operations
+    uint64 waitTime;                                        // Time spent in the queue
+    uint64 execTime;                                        // Time spent executing
+    uint32 maxWaitTime;
+};
+
 class SqlDelayThread : public ACE_Based::Runnable
 {
     typedef ACE_Activation_Queue SqlQueue;
@@ -34,17 +48,27 @@ class SqlDelayThread : public ACE_Based::Runnable
     private:
         SqlQueue m_sqlQueue;                                // Queue of SQL statements
         Database* m_dbEngine;                               // Pointer to used Database engine
+        SqlConnection* m_dbConnection;                      // Connection used by this thread only
         volatile bool m_running;
 
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_queueSize;  // Statements delayed and not executed yet
+        SqlDelayStats m_stats;                              // Only written by this thread
+
         SqlDelayThread();
     public:
-        SqlDelayThread(Database* db);
+        SqlDelayThread(Database* db, SqlConnection* conn);
+        ~SqlDelayThread();
 
-        // Put sql statement to delay queue
+        // Put sql statement to delay queue, as a barrier for the key SQL_ASYNC_KEY_ALL
         bool Delay(SqlOperation* sql);
+        // Put it to the queue of this executer only
+        bool Enqueue(SqlOperation* sql);
 
         void Stop();                                // Stop event
         virtual void run();                                 // Main Thread loop
+
+        long GetQueueSize() const { return m_queueSize.value(); }
+        SqlDelayStats const& GetStats() const { return m_stats; }
 };
 #endif                                                      //__SQLDELAYTHREAD_H
 
@@ -19,66 +19,122 @@
 
 #include "SqlOperations.h"
 #include "SqlDelayThread.h"
+#include "SqlConnection.h"
 #include "DatabaseEnv.h"
 #include "DatabaseImpl.h"
 
 // ASYNC STATEMENTS / TRANSACTIONS
 
-void SqlStatement::Execute(Database *db)
+bool SqlStatement::Execute(SqlConnection *conn)
 {
     // just do it
-    db->DirectExecute(m_sql);
+    return conn->Execute(m_sql);
 }
 
-void SqlTransaction::Execute(Database *db)
+bool SqlPreparedStatement::Execute(SqlConnection *conn)
 {
-    const char* sql;
+    return conn->Execute(m_index, m_params);
+}
 
+SqlTransaction::~SqlTransaction()
+{
+    // not executed (rollback)
+    while (!m_queue.empty())
+    {
+        delete m_queue.front();
+        m_queue.pop();
+    }
+}
+
+bool SqlTransaction::Execute(SqlConnection *conn)
+{
     m_Mutex.acquire();
     if (m_queue.empty())
     {
         m_Mutex.release();
-        return;
+        return true;
     }
 
-    db->DirectExecute("START TRANSACTION");
+    conn->Execute("START TRANSACTION");
     while (!m_queue.empty())
     {
-        sql = m_queue.front();
+        SqlOperation *op = m_queue.front();
+        m_queue.pop();
 
-        if (!db->DirectExecute(sql))
+        bool res = op->Execute(conn);
+        delete op;
+
+        if (!res)
         {
-            free((void*)const_cast<char*>(sql));
-            m_queue.pop();
-            db->DirectExecute("ROLLBACK");
+            conn->Execute("ROLLBACK");
             while (!m_queue.empty())
             {
-                free((void*)const_cast<char*>(m_queue.front()));
+                delete m_queue.front();
                 m_queue.pop();
             }
             m_Mutex.release();
-            return;
+            return false;
         }
-
-        free((void*)const_cast<char*>(sql));
-        m_queue.pop();
     }
 
-    db->DirectExecute("COMMIT");
+    conn->Execute("COMMIT");
     m_Mutex.release();
+    return true;
+}
+
+// BARRIERS
+
+void SqlBarrier::Arrive()
+{
+    m_arrived.release();
+    Wait(m_done);
+    Release();
+}
+
+void SqlBarrier::Run(SqlOperation* op, SqlConnection* conn)
+{
+    for (uint32 i = 0; i < m_fences; ++i)
+        if (!Wait(m_arrived))
+            break;
+
+    op->Execute(conn);
+
+    m_done.release(m_fences);
+    Release();
+}
+
+bool SqlBarrier::Wait(ACE_Thread_Semaphore& sem)
+{
+    // a fence may never run once the executers are stopped
+    for (;;)
+    {
+        ACE_Time_Value timeout = ACE_OS::gettimeofday() + ACE_Time_Value(1);
+        if (sem.acquire(timeout) == 0)
+            return true;
+
+        if (m_db->IsHalting())
+            return false;
+    }
+}
+
+void SqlBarrier::Release()
+{
+    if (--m_refs == 0)
+        delete this;
 }
 
 // ASYNC QUERIES
 
-void SqlQuery::Execute(Database *db)
+bool SqlQuery::Execute(SqlConnection *conn)
 {
     if (!m_callback || !m_queue)
-        return;
+        return false;
 
     // execute the query and store the result in the callback
-    m_callback->SetResult(db->Query(m_sql));
+    m_callback->SetResult(conn->Query(m_sql));
     // add the callback to the sql result queue of the thread it originated from
     m_queue->add(m_callback);
+    return true;
 }
 
 void SqlResultQueue::Update()
@@ -112,15 +168,34 @@ bool SqlQueryHolder::SetQuery(size_t index, const char *sql)
         return false;
     }
 
-    if (m_queries[index].first != NULL)
+    if (m_queries[index].sql != NULL || m_queries[index].params != NULL)
     {
         sLog.outError("Attempt assign query to holder index (%u) where other query stored (Old: [%s] New: [%s])",
-            index,m_queries[index].first,sql);
+            index,m_queries[index].sql ? m_queries[index].sql : "prepared statement",sql);
         return false;
     }
 
     // not executed yet, just stored (it's not called a holder for nothing)
-    m_queries[index] = SqlResultPair(strdup(sql), QueryResult_AutoPtr(NULL));
+    m_queries[index].sql = strdup(sql);
+    return true;
+}
+
+bool SqlQueryHolder::SetPreparedQuery(size_t index, uint32 stmt, SqlStmtParameters const& params)
+{
+    if (m_queries.size() <= index)
+    {
+        sLog.outError("Query index (%u) out of range (size: %u) for prepared statement %u",index,(uint32)m_queries.size(),stmt);
+        return false;
+    }
+
+    if (m_queries[index].sql != NULL || m_queries[index].params != NULL)
+    {
+        sLog.outError("Attempt assign prepared statement %u to holder index (%u) where other query stored",stmt,index);
+        return false;
+    }
+
+    m_queries[index].stmt = stmt;
+    m_queries[index].params = new SqlStmtParameters(params);
     return true;
 }
 
@@ -152,13 +227,18 @@ QueryResult_AutoPtr SqlQueryHolder::GetResult(size_t index)
     if (index < m_queries.size())
     {
         // the query strings are freed on the first GetResult or in the destructor
-        if (m_queries[index].first != NULL)
+        if (m_queries[index].sql != NULL)
+        {
+            free((void*)(const_cast<char*>(m_queries[index].sql)));
+            m_queries[index].sql = NULL;
+        }
+        if (m_queries[index].params != NULL)
         {
-            free((void*)(const_cast<char*>(m_queries[index].first)));
-            m_queries[index].first = NULL;
+            delete m_queries[index].params;
+            m_queries[index].params = NULL;
         }
         // when you get a result aways remember to delete it!
-        return m_queries[index].second;
+        return m_queries[index].result;
     }
     else
         return QueryResult_AutoPtr(NULL);
@@ -168,7 +248,7 @@ void SqlQueryHolder::SetResult(size_t index, QueryResult_AutoPtr result)
 {
     // store the result in the holder
     if (index < m_queries.size())
-        m_queries[index].second = result;
+        m_queries[index].result = result;
 }
 
 SqlQueryHolder::~SqlQueryHolder()
@@ -177,8 +257,9 @@ SqlQueryHolder::~SqlQueryHolder()
     {
         // if the result was never used, free the resources
         // results used already (getresult called) are expected to be deleted
-        if (m_queries[i].first != NULL)
-            free((void*)(const_cast<char*>(m_queries[i].first)));
+        if (m_queries[i].sql != NULL)
+            free((void*)(const_cast<char*>(m_queries[i].sql)));
+        delete m_queries[i].params;
     }
 }
 
@@ -188,22 +269,25 @@ void SqlQueryHolder::SetSize(size_t size)
     m_queries.resize(size);
 }
 
-void SqlQueryHolderEx::Execute(Database *db)
+bool SqlQueryHolderEx::Execute(SqlConnection *conn)
 {
     if (!m_holder || !m_callback || !m_queue)
-        return;
+        return false;
 
     // we can do this, we are friends
-    std::vector<SqlQueryHolder::SqlResultPair> &queries = m_holder->m_queries;
+    std::vector<SqlQueryHolder::SqlHolderQuery> &queries = m_holder->m_queries;
 
     for (size_t i = 0; i < queries.size(); i++)
     {
         // execute all queries in the holder and pass the results
-        char const *sql = queries[i].first;
-        if (sql) m_holder->SetResult(i, db->Query(sql));
+        if (char const *sql = queries[i].sql)
+            m_holder->SetResult(i, conn->Query(sql));
+        else if (queries[i].params)
+            m_holder->SetResult(i, conn->Query(queries[i].stmt, *queries[i].params));
     }
 
     // sync with the caller thread
     m_queue->add(m_callback);
+    return true;
 }
 
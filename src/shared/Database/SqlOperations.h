@@ -23,22 +23,27 @@
 #include "Common.h"
 
 #include "ace/Thread_Mutex.h"
+#include "ace/Thread_Semaphore.h"
+#include "ace/Atomic_Op.h"
 #include "ace/Method_Request.h"
 #include "LockedQueue.h"
 #include <queue>
 #include "Utilities/Callback.h"
 #include "QueryResult.h"
+#include "SqlStmtParameters.h"
+#include "Timer.h"
 
 // BASE
 
 class Database;
+class SqlConnection;
 class SqlDelayThread;
 
 class SqlOperation
 {
     public:
         virtual void OnRemove() { delete this; }
-        virtual void Execute(Database *db) = 0;
+        virtual bool Execute(SqlConnection *conn) = 0;
         virtual ~SqlOperation() {}
 };
 
@@ -51,25 +56,79 @@ class SqlStatement : public SqlOperation
     public:
         SqlStatement(const char *sql) : m_sql(strdup(sql)){}
         ~SqlStatement() { void* tofree = const_cast<char*>(m_sql); free(tofree); }
-        void Execute(Database *db);
+        bool Execute(SqlConnection *conn);
+};
+
+class SqlPreparedStatement : public SqlOperation
+{
+    private:
+        uint32 m_index;
+        SqlStmtParameters m_params;
+    public:
+        SqlPreparedStatement(uint32 index, SqlStmtParameters const& params) : m_index(index), m_params(params) {}
+        bool Execute(SqlConnection *conn);
 };
 
 class SqlTransaction : public SqlOperation
 {
     private:
-        std::queue<const char*> m_queue;
+        std::queue<SqlOperation*> m_queue;
         ACE_Thread_Mutex m_Mutex;
     public:
         SqlTransaction() {}
-        void DelayExecute(const char *sql)
+        ~SqlTransaction();
+        void DelayExecute(const char *sql) { DelayExecute(new SqlStatement(sql)); }
+        void DelayExecute(SqlOperation *op)
         {
             m_Mutex.acquire();
-            char* _sql = strdup(sql);
-            if (_sql)
-                m_queue.push(_sql);
+            m_queue.push(op);
             m_Mutex.release();
         }
-        void Execute(Database *db);
+        bool Execute(SqlConnection *conn);
+};
+
+// BARRIERS
+
+// An operation of the key SQL_ASYNC_KEY_ALL. It runs on the first executer
+// once all the others got to their fence, which hold them until it is done,
+// so it is in order with the operations of every key.
+class SqlBarrier
+{
+    public:
+        SqlBarrier(Database* db, uint32 fences) : m_db(db), m_fences(fences), m_refs(fences + 1), m_arrived(0), m_done(0) {}
+
+        void Arrive();                                      // by the fences
+        void Run(SqlOperation* op, SqlConnection* conn);    // by the first executer
+
+    private:
+        bool Wait(ACE_Thread_Semaphore& sem);
+        void Release();
+
+        Database* m_db;
+        uint32 m_fences;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_refs;       // the parts still to run
+        ACE_Thread_Semaphore m_arrived;
+        ACE_Thread_Semaphore m_done;
+};
+
+class SqlBarrierFence : public SqlOperation
+{
+    private:
+        SqlBarrier* m_barrier;
+    public:
+        explicit SqlBarrierFence(SqlBarrier* barrier) : m_barrier(barrier) {}
+        bool Execute(SqlConnection* /*conn*/) { m_barrier->Arrive(); return true; }
+};
+
+class SqlBarrierOperation : public SqlOperation
+{
+    private:
+        SqlBarrier* m_barrier;
+        SqlOperation* m_op;
+    public:
+        SqlBarrierOperation(SqlBarrier* barrier, SqlOperation* op) : m_barrier(barrier), m_op(op) {}
+        ~SqlBarrierOperation() { delete m_op; }
+        bool Execute(SqlConnection* conn) { m_barrier->Run(m_op, conn); return true; }
 };
 
 // ASYNC QUERIES
@@ -97,20 +156,30 @@ class SqlQuery : public SqlOperation
         SqlQuery(const char *sql, Oregon::IQueryCallback * callback, SqlResultQueue * queue)
             : m_sql(strdup(sql)), m_callback(callback), m_queue(queue) {}
         ~SqlQuery() { void* tofree = const_cast<char*>(m_sql); free(tofree); }
-        void Execute(Database *db);
+        bool Execute(SqlConnection *conn);
 };
 
 class SqlQueryHolder
 {
     friend class SqlQueryHolderEx;
     private:
-        typedef std::pair<const char*, QueryResult_AutoPtr> SqlResultPair;
-        std::vector<SqlResultPair> m_queries;
+        // the query string, or the index and parameters of a prepared statement
+        struct SqlHolderQuery
+        {
+            SqlHolderQuery() : sql(NULL), stmt(0), params(NULL), result(NULL) {}
+
+            const char* sql;
+            uint32 stmt;
+            SqlStmtParameters* params;
+            QueryResult_AutoPtr result;
+        };
+        std::vector<SqlHolderQuery> m_queries;
     public:
         SqlQueryHolder() {}
         ~SqlQueryHolder();
         bool SetQuery(size_t index, const char *sql);
         bool SetPQuery(size_t index, const char *format, ...) ATTR_PRINTF(3,4);
+        bool SetPreparedQuery(size_t index, uint32 stmt, SqlStmtParameters const& params);
         void SetSize(size_t size);
         QueryResult_AutoPtr GetResult(size_t index);
         void SetResult(size_t index, QueryResult_AutoPtr result);
@@ -126,13 +195,13 @@ class SqlQueryHolderEx : public SqlOperation
     public:
         SqlQueryHolderEx(SqlQueryHolder *holder, Oregon::IQueryCallback * callback, SqlResultQueue * queue)
             : m_holder(holder), m_callback(callback), m_queue(queue) {}
-        void Execute(Database *db);
+        bool Execute(SqlConnection *conn);
 };
 
 class SqlAsyncTask : public ACE_Method_Request
 {
 public:
-    SqlAsyncTask(Database * db, SqlOperation * op) : m_db(db), m_op(op){}
+    SqlAsyncTask(SqlConnection * conn, SqlOperation * op) : m_conn(conn), m_op(op), m_queueTime(getMSTime()) {}
     ~SqlAsyncTask()
     {
         if (!m_op)
@@ -144,12 +213,12 @@ public:
 
     int call()
     {
-        if (m_db == NULL || m_op == NULL)
+        if (m_conn == NULL || m_op == NULL)
         return -1;
 
         try
         {
-            m_op->Execute(m_db);
+            m_op->Execute(m_conn);
         }
         catch(...)
         {
@@ -159,9 +228,12 @@ public:
         return 0;
     }
 
+    uint32 GetQueueTime() const { return m_queueTime; }
+
 private:
-    Database * m_db;
+    SqlConnection * m_conn;
     SqlOperation * m_op;
+    uint32 m_queueTime;                                     // getMSTime() when delayed
 };
 #endif                                                      //__SQLOPERATIONS_H
 
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Database/SqlStmtParameters.h"
+
+void SqlStmtParameters::Bind(std::vector<MYSQL_BIND>& binds) const
+{
+    binds.resize(m_params.size());
+    if (binds.empty())
+        return;
+
+    memset(&binds[0], 0, sizeof(MYSQL_BIND) * binds.size());
+
+    for (size_t i = 0; i < m_params.size(); ++i)
+    {
+        SqlStmtFieldData const& param = m_params[i];
+        MYSQL_BIND& bind = binds[i];
+
+        // the server only reads the buffers
+        bind.buffer = const_cast<void*>(static_cast<void const*>(&param.data));
+
+        switch (param.type)
+        {
+            case FIELD_BOOL:
+            case FIELD_UI8:
+                bind.buffer_type = MYSQL_TYPE_TINY;
+                bind.is_unsigned = true;
+                break;
+            case FIELD_I8:
+                bind.buffer_type = MYSQL_TYPE_TINY;
+                break;
+            case FIELD_UI16:
+                bind.buffer_type = MYSQL_TYPE_SHORT;
+                bind.is_unsigned = true;
+                break;
+            case FIELD_I16:
+                bind.buffer_type = MYSQL_TYPE_SHORT;
+                break;
+            case FIELD_UI32:
+                bind.buffer_type = MYSQL_TYPE_LONG;
+                bind.is_unsigned = true;
+                break;
+            case FIELD_I32:
+                bind.buffer_type = MYSQL_TYPE_LONG;
+                break;
+            case FIELD_UI64:
+                bind.buffer_type = MYSQL_TYPE_LONGLONG;
+                bind.is_unsigned = true;
+                break;
+            case FIELD_I64:
+                bind.buffer_type = MYSQL_TYPE_LONGLONG;
+                break;
+            case FIELD_FLOAT:
+                bind.buffer_type = MYSQL_TYPE_FLOAT;
+                break;
+            case FIELD_DOUBLE:
+                bind.buffer_type = MYSQL_TYPE_DOUBLE;
+                break;
+            case FIELD_STRING:
+                bind.buffer_type = MYSQL_TYPE_STRING;
+                bind.buffer = const_cast<char*>(param.str.c_str());
+                bind.buffer_length = param.str.size();
+                break;
+        }
+    }
+}
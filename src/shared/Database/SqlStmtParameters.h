@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SQLSTMTPARAMETERS_H
+#define __SQLSTMTPARAMETERS_H
+
+#include "Common.h"
+
+#ifdef WIN32
+  #define FD_SETSIZE 1024
+  #include <winsock2.h>
+#endif
+#include <mysql.h>
+
+#include <vector>
+
+enum SqlStmtFieldType
+{
+    FIELD_BOOL,
+    FIELD_UI8,
+    FIELD_UI16,
+    FIELD_UI32,
+    FIELD_UI64,
+    FIELD_I8,
+    FIELD_I16,
+    FIELD_I32,
+    FIELD_I64,
+    FIELD_FLOAT,
+    FIELD_DOUBLE,
+    FIELD_STRING
+};
+
+// One typed parameter of a prepared statement
+struct SqlStmtFieldData
+{
+    SqlStmtFieldType type;
+    union
+    {
+        bool boolean;
+        uint8 ui8;
+        int8 i8;
+        uint16 ui16;
+        int16 i16;
+        uint32 ui32;
+        int32 i32;
+        uint64 ui64;
+        int64 i64;
+        float f;
+        double d;
+    } data;
+    std::string str;
+};
+
+// Parameters of a prepared statement, in the order of the placeholders:
+//   CharacterDatabase.Execute(CHAR_DEL_AURAS, SqlStmtParameters(1).addUInt32(guid));
+class SqlStmtParameters
+{
+    public:
+        explicit SqlStmtParameters(uint32 reserve = 0) { m_params.reserve(reserve); }
+
+        SqlStmtParameters& addBool(bool value) { push(FIELD_BOOL).data.boolean = value; return *this; }
+        SqlStmtParameters& addUInt8(uint8 value) { push(FIELD_UI8).data.ui8 = value; return *this; }
+        SqlStmtParameters& addUInt16(uint16 value) { push(FIELD_UI16).data.ui16 = value; return *this; }
+        SqlStmtParameters& addUInt32(uint32 value) { push(FIELD_UI32).data.ui32 = value; return *this; }
+        SqlStmtParameters& addUInt64(uint64 value) { push(FIELD_UI64).data.ui64 = value; return *this; }
+        SqlStmtParameters& addInt8(int8 value) { push(FIELD_I8).data.i8 = value; return *this; }
+        SqlStmtParameters& addInt16(int16 value) { push(FIELD_I16).data.i16 = value; return *this; }
+        SqlStmtParameters& addInt32(int32 value) { push(FIELD_I32).data.i32 = value; return *this; }
+        SqlStmtParameters& addInt64(int64 value) { push(FIELD_I64).data.i64 = value; return *this; }
+        SqlStmtParameters& addFloat(float value) { push(FIELD_FLOAT).data.f = value; return *this; }
+        SqlStmtParameters& addDouble(double value) { push(FIELD_DOUBLE).data.d = value; return *this; }
+        SqlStmtParameters& addString(std::string const& value) { push(FIELD_STRING).str = value; return *this; }
+        SqlStmtParameters& addString(const char *value) { push(FIELD_STRING).str = value ? value : ""; return *this; }
+
+        size_t size() const { return m_params.size(); }
+
+        // Fills the MYSQL_BIND of each parameter, they point in this object
+        void Bind(std::vector<MYSQL_BIND>& binds) const;
+
+    private:
+        SqlStmtFieldData& push(SqlStmtFieldType type)
+        {
+            m_params.resize(m_params.size() + 1);
+            m_params.back().type = type;
+            return m_params.back();
+        }
+
+        std::vector<SqlStmtFieldData> m_params;
+};
+#endif                                                      //__SQLSTMTPARAMETERS_H
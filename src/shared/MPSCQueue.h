@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include "Platform/CompilerDefs.h"
+
+#if COMPILER == COMPILER_MICROSOFT
+#  include <windows.h>
+#endif
+
+namespace ACE_Based
+{
+    // Intrusive multi producer / single consumer queue (Dmitry Vyukov's algorithm).
+    // T must be default constructible and have a "T* volatile next" member.
+    // push() never blocks and may be called from any thread, pop() may only be
+    // called from one thread at a time.
+    template <class T>
+        class MPSCQueue
+    {
+        public:
+
+            MPSCQueue() : _head(&_stub), _tail(&_stub)
+            {
+                _stub.next = NULL;
+            }
+
+            // Adds a node to the queue.
+            void push(T* node)
+            {
+                node->next = NULL;
+                T* prev = exchange(&_head, node);
+                store(&prev->next, node);
+            }
+
+            // Takes the oldest node of the queue, NULL if the queue is empty
+            // or the next node is still being published by a producer.
+            T* pop()
+            {
+                T* tail = _tail;
+                T* next = load(&tail->next);
+
+                if (tail == &_stub)
+                {
+                    if (!next)
+                        return NULL;
+
+                    _tail = next;
+                    tail = next;
+                    next = load(&next->next);
+                }
+
+                if (next)
+                {
+                    _tail = next;
+                    return tail;
+                }
+
+                if (tail != load(&_head))
+                    return NULL;
+
+                push(&_stub);
+
+                next = load(&tail->next);
+                if (next)
+                {
+                    _tail = next;
+                    return tail;
+                }
+
+                return NULL;
+            }
+
+        private:
+
+            static T* exchange(T* volatile* ptr, T* value)
+            {
+#if COMPILER == COMPILER_MICROSOFT
+                return static_cast<T*>(InterlockedExchangePointer((PVOID volatile*)ptr, value));
+#else
+                return __atomic_exchange_n(ptr, value, __ATOMIC_ACQ_REL);
+#endif
+            }
+
+            static T* load(T* volatile* ptr)
+            {
+#if COMPILER == COMPILER_MICROSOFT
+                return *ptr;                                // volatile reads have acquire semantics
+#else
+                return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#endif
+            }
+
+            static void store(T* volatile* ptr, T* value)
+            {
+#if COMPILER == COMPILER_MICROSOFT
+                *ptr = value;                               // volatile writes have release semantics
+#else
+                __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#endif
+            }
+
+            // written by the producers
+            T* volatile _head;
+
+            // only touched by the consumer
+            T* _tail;
+
+            T _stub;
+
+            MPSCQueue(MPSCQueue const&);
+            MPSCQueue& operator=(MPSCQueue const&);
+    };
+}
+#endif
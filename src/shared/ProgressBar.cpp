@@ -26,8 +26,11 @@ char const* const barGoLink::full  = "\x3D";
 char const* const barGoLink::full  = "*";
 #endif
 
+bool barGoLink::hidden = false;
+
 barGoLink::~barGoLink()
 {
+    if ( hidden ) return;
     printf( "\n" );
     fflush(stdout);
 }
@@ -38,6 +41,7 @@ barGoLink::barGoLink( int row_count )
     rec_pos   = 0;
     indic_len = 50;
     num_rec   = row_count;
+    if ( hidden ) return;
     #ifdef _WIN32
     printf( "\x3D" );
     #else
@@ -56,7 +60,7 @@ void barGoLink::step( void )
 {
     int i, n;
 
-    if ( num_rec == 0 ) return;
+    if ( num_rec == 0 || hidden ) return;
     ++rec_no;
     n = rec_no * indic_len / num_rec;
     if ( n != rec_pos )
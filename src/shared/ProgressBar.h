@@ -28,6 +28,8 @@ class barGoLink
     static char const * const empty;
     static char const * const full;
 
+    static bool hidden;
+
     int rec_no;
     int rec_pos;
     int num_rec;
@@ -38,6 +40,9 @@ class barGoLink
         void step( void );
         barGoLink( int );
         ~barGoLink();
+
+        // bars of loaders running side by side would write over each other
+        static void SetHidden( bool on ) { hidden = on; }
 };
 #endif
 
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OREGONCORE_SHAREDPACKET_H
+#define OREGONCORE_SHAREDPACKET_H
+
+#include "WorldPacket.h"
+
+#include <ace/Atomic_Op.h>
+#include <ace/Thread_Mutex.h>
+
+#include <new>
+
+// Immutable copy of a packet sent to many sessions at once. The send queues of
+// the sockets hold references to it instead of a copy of the payload each, only
+// the header is built and encrypted per receiver. The payload follows the object
+// in the same allocation.
+class SharedPacket
+{
+    public:
+        // the caller owns the first reference
+        static SharedPacket* Create(WorldPacket const& packet)
+        {
+            char* mem = new char[sizeof(SharedPacket) + packet.size()];
+            SharedPacket* shared = new (mem) SharedPacket(packet.GetOpcode(), packet.size());
+            if (!packet.empty())
+                memcpy(mem + sizeof(SharedPacket), packet.contents(), packet.size());
+            return shared;
+        }
+
+        // may be called from any thread
+        void AddReference() { ++m_refs; }
+        void RemoveReference()
+        {
+            if (--m_refs == 0)
+            {
+                this->~SharedPacket();
+                delete[] reinterpret_cast<char*>(this);
+            }
+        }
+
+        uint16 GetOpcode() const { return m_opcode; }
+        size_t size() const { return m_size; }
+        uint8 const* contents() const { return reinterpret_cast<uint8 const*>(this + 1); }
+
+    private:
+        SharedPacket(uint16 opcode, size_t size) : m_refs(1), m_opcode(opcode), m_size(size) {}
+        ~SharedPacket() {}
+
+        SharedPacket(SharedPacket const&);
+        SharedPacket& operator=(SharedPacket const&);
+
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_refs;
+        uint16 m_opcode;
+        size_t m_size;
+};
+#endif
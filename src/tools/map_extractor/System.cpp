@@ -755,7 +755,8 @@ bool ConvertADT(char *filename, char *filename2, int cell_y, int cell_x)
                     liquid_height[y][x] = CONF_use_minHeight;
             }
         }
-        map.liquidMapOffset = map.heightMapOffset + map.heightMapSize;
+        // the core maps the files, keep the liquid heights 4 byte aligned
+        map.liquidMapOffset = (map.heightMapOffset + map.heightMapSize + 3) & ~3;
         map.liquidMapSize = sizeof(map_liquidHeader);
         liquidHeader.fourcc = MAP_LIQUID_MAGIC;
         liquidHeader.flags = 0;
@@ -822,6 +823,8 @@ bool ConvertADT(char *filename, char *filename2, int cell_y, int cell_x)
     // Store liquid data if need
     if (map.liquidMapOffset)
     {
+        static uint8 const padding[4] = { 0, 0, 0, 0 };
+        fwrite(padding, 1, map.liquidMapOffset - (map.heightMapOffset + map.heightMapSize), output);
         fwrite(&liquidHeader, sizeof(liquidHeader), 1, output);
         if (!(liquidHeader.flags&MAP_LIQUID_NO_TYPE))
             fwrite(liquid_type, sizeof(liquid_type), 1, output);
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <iostream>
+#include <cstdlib>
+
+#include "TileBuilder.h"
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3 && argc != 5)
+    {
+        std::cout << "usage: " << argv[0] << " <data dir> <map id> [<tile x> <tile y>]" << std::endl;
+        std::cout << "reads <data dir>/maps and <data dir>/vmaps, the tiles are written to <data dir>/mmaps" << std::endl;
+        return 1;
+    }
+
+    std::string dataPath = argv[1];
+    if (!dataPath.empty() && dataPath[dataPath.length() - 1] != '/' && dataPath[dataPath.length() - 1] != '\\')
+        dataPath.append("/");
+
+    uint32 mapId = atoi(argv[2]);
+
+    MMAP::TileBuilder* builder = new MMAP::TileBuilder(dataPath);
+
+    bool result;
+    if (argc == 5)
+    {
+        uint32 tileX = atoi(argv[3]);
+        uint32 tileY = atoi(argv[4]);
+        if (tileX >= 64 || tileY >= 64)
+        {
+            std::cout << "tile coordinates are 0 to 63" << std::endl;
+            delete builder;
+            return 1;
+        }
+        result = builder->BuildTile(mapId, tileX, tileY);
+    }
+    else
+        result = builder->BuildMap(mapId);
+
+    delete builder;
+
+    if (!result)
+    {
+        std::cout << "exit with errors" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Ok, all done" << std::endl;
+    return 0;
+}
@@ -0,0 +1,465 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TileBuilder.h"
+#include "VMapManager2.h"
+#include "MapTree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+
+// .map file format, see Map.h
+#define MAP_MAGIC             0x5350414D // SPAM
+#define MAP_VERSION_MAGIC     0x352E3077 // 5.0w
+#define MAP_HEIGHT_MAGIC      0x5447484D // TGHM
+
+#define MAP_RESOLUTION        128
+
+struct map_fileheader
+{
+    uint32 mapMagic;
+    uint32 versionMagic;
+    uint32 areaMapOffset;
+    uint32 areaMapSize;
+    uint32 heightMapOffset;
+    uint32 heightMapSize;
+    uint32 liquidMapOffset;
+    uint32 liquidMapSize;
+};
+
+#define MAP_HEIGHT_NO_HEIGHT  0x0001
+#define MAP_HEIGHT_AS_INT16   0x0002
+#define MAP_HEIGHT_AS_INT8    0x0004
+
+struct map_heightHeader
+{
+    uint32 fourcc;
+    uint32 flags;
+    float  gridHeight;
+    float  gridMaxHeight;
+};
+
+// vmap surfaces are searched downwards from here
+#define NAV_SEARCH_TOP          5000.0f
+#define NAV_SEARCH_BOTTOM       -5000.0f
+#define NAV_MAX_SURFACES        32
+// step below a hit before searching for the next surface
+#define NAV_SURFACE_STEP        0.05f
+// a tile without .map and .vmtile file is probed with PROBE * PROBE rays
+#define NAV_TILE_PROBE          16
+
+// cells of a tile with the ring of neighbour cells around it
+#define NAV_BORDER_CELLS        (NAV_TILE_CELLS + 2)
+
+namespace MMAP
+{
+    template<class T>
+    static bool ReadHeights(FILE* file, float mult, float base, std::vector<float>& V9, std::vector<float>& V8)
+    {
+        std::vector<T> raw(129 * 129 + 128 * 128);
+        if (fread(&raw[0], sizeof(T), raw.size(), file) != raw.size())
+            return false;
+
+        V9.resize(129 * 129);
+        V8.resize(128 * 128);
+        for (size_t i = 0; i < V9.size(); ++i)
+            V9[i] = raw[i] * mult + base;
+        for (size_t i = 0; i < V8.size(); ++i)
+            V8[i] = raw[V9.size() + i] * mult + base;
+        return true;
+    }
+
+    bool TerrainTile::Load(const char* filename)
+    {
+        FILE* file = fopen(filename, "rb");
+        if (!file)
+            return false;
+
+        map_fileheader header;
+        map_heightHeader heightHeader;
+        bool result = fread(&header, sizeof(header), 1, file) == 1 &&
+            header.mapMagic == MAP_MAGIC && header.versionMagic == MAP_VERSION_MAGIC &&
+            fseek(file, header.heightMapOffset, SEEK_SET) == 0 &&
+            fread(&heightHeader, sizeof(heightHeader), 1, file) == 1 && heightHeader.fourcc == MAP_HEIGHT_MAGIC;
+
+        if (result)
+        {
+            // tiles without heights are flat at gridHeight, like in the core
+            m_gridHeight = heightHeader.gridHeight;
+            if (!(heightHeader.flags & MAP_HEIGHT_NO_HEIGHT))
+            {
+                if (heightHeader.flags & MAP_HEIGHT_AS_INT16)
+                    result = ReadHeights<uint16>(file, (heightHeader.gridMaxHeight - heightHeader.gridHeight) / 65535, heightHeader.gridHeight, m_V9, m_V8);
+                else if (heightHeader.flags & MAP_HEIGHT_AS_INT8)
+                    result = ReadHeights<uint8>(file, (heightHeader.gridMaxHeight - heightHeader.gridHeight) / 255, heightHeader.gridHeight, m_V9, m_V8);
+                else
+                    result = ReadHeights<float>(file, 1.0f, 0.0f, m_V9, m_V8);
+            }
+        }
+
+        fclose(file);
+        return result;
+    }
+
+    // GridMap::getHeightFromFloat
+    float TerrainTile::GetHeight(float x, float y) const
+    {
+        if (m_V9.empty())
+            return m_gridHeight;
+
+        x = MAP_RESOLUTION * (32 - x / NAV_GRID_SIZE);
+        y = MAP_RESOLUTION * (32 - y / NAV_GRID_SIZE);
+
+        int x_int = (int)x;
+        int y_int = (int)y;
+        x -= x_int;
+        y -= y_int;
+        x_int &= (MAP_RESOLUTION - 1);
+        y_int &= (MAP_RESOLUTION - 1);
+
+        float a, b, c;
+        float h5 = 2 * m_V8[x_int * 128 + y_int];
+        if (x + y < 1)
+        {
+            if (x > y)
+            {
+                float h1 = m_V9[x_int * 129 + y_int];
+                float h2 = m_V9[(x_int + 1) * 129 + y_int];
+                a = h2 - h1;
+                b = h5 - h1 - h2;
+                c = h1;
+            }
+            else
+            {
+                float h1 = m_V9[x_int * 129 + y_int];
+                float h3 = m_V9[x_int * 129 + y_int + 1];
+                a = h5 - h1 - h3;
+                b = h3 - h1;
+                c = h1;
+            }
+        }
+        else
+        {
+            if (x > y)
+            {
+                float h2 = m_V9[(x_int + 1) * 129 + y_int];
+                float h4 = m_V9[(x_int + 1) * 129 + y_int + 1];
+                a = h2 + h4 - h5;
+                b = h4 - h2;
+                c = h5 - h4;
+            }
+            else
+            {
+                float h3 = m_V9[x_int * 129 + y_int + 1];
+                float h4 = m_V9[(x_int + 1) * 129 + y_int + 1];
+                a = h4 - h3;
+                b = h3 + h4 - h5;
+                c = h5 - h4;
+            }
+        }
+
+        return a * x + b * y + c;
+    }
+
+    TileBuilder::TileBuilder(std::string const& dataPath) : m_dataPath(dataPath), m_mapId(0)
+    {
+        m_vmapManager = new VMAP::VMapManager2();
+        m_vmapManager->setEnableHeightCalc(true);
+        m_vmapManager->setEnableLineOfSightCalc(true);
+        // every query is asked once
+        m_vmapManager->setQueryCacheSize(0);
+
+        for (uint32 i = 0; i < 64; ++i)
+        {
+            for (uint32 j = 0; j < 64; ++j)
+            {
+                m_terrain[i][j] = NULL;
+                m_loaded[i][j] = false;
+                m_vmapLoaded[i][j] = false;
+            }
+        }
+    }
+
+    TileBuilder::~TileBuilder()
+    {
+        SetWindow(m_mapId, -2, -2);
+        delete m_vmapManager;
+    }
+
+    bool TileBuilder::BuildMap(uint32 mapId)
+    {
+        uint32 built = 0;
+        for (uint32 tileX = 0; tileX < 64; ++tileX)
+        {
+            for (uint32 tileY = 0; tileY < 64; ++tileY)
+            {
+                if (!HasTileData(mapId, tileX, tileY))
+                    continue;
+
+                if (!BuildTile(mapId, tileX, tileY))
+                    return false;
+                ++built;
+            }
+        }
+
+        printf("map %03u: %u tiles\n", mapId, built);
+        return true;
+    }
+
+    bool TileBuilder::HasTileData(uint32 mapId, uint32 tileX, uint32 tileY)
+    {
+        char filename[32];
+        snprintf(filename, sizeof(filename), "maps/%03u%02u%02u.map", mapId, tileX, tileY);
+        if (FILE* file = fopen((m_dataPath + filename).c_str(), "rb"))
+        {
+            fclose(file);
+            return true;
+        }
+
+        std::string tileFile = m_dataPath + "vmaps/" + VMAP::StaticMapTree::getTileFileName(mapId, tileX, tileY);
+        if (FILE* file = fopen(tileFile.c_str(), "rb"))
+        {
+            fclose(file);
+            return true;
+        }
+
+        // the models of maps without terrain are not split into tiles
+        SetWindow(mapId, tileX, tileY);
+        for (uint32 i = 0; i < NAV_TILE_PROBE; ++i)
+        {
+            for (uint32 j = 0; j < NAV_TILE_PROBE; ++j)
+            {
+                int32 cx = tileX * NAV_TILE_CELLS + (i * NAV_TILE_CELLS + NAV_TILE_CELLS / 2) / NAV_TILE_PROBE;
+                int32 cy = tileY * NAV_TILE_CELLS + (j * NAV_TILE_CELLS + NAV_TILE_CELLS / 2) / NAV_TILE_PROBE;
+                float z = m_vmapManager->getHeight(mapId, NavCoordFromCell(cx), NavCoordFromCell(cy), NAV_SEARCH_TOP, NAV_SEARCH_TOP - NAV_SEARCH_BOTTOM);
+                if (z > VMAP_INVALID_HEIGHT)
+                    return true;
+            }
+        }
+
+        return false;
+    }
+
+    // keeps the terrain and the vmaps of the tile and its 8 neighbours loaded,
+    // a window outside of the map unloads everything
+    void TileBuilder::SetWindow(uint32 mapId, int32 tileX, int32 tileY)
+    {
+        if (mapId != m_mapId)
+        {
+            SetWindow(m_mapId, -2, -2);
+            m_mapId = mapId;
+        }
+
+        std::string vmapPath = m_dataPath + "vmaps";
+        for (int32 i = 0; i < 64; ++i)
+        {
+            for (int32 j = 0; j < 64; ++j)
+            {
+                bool inside = std::abs(i - tileX) <= 1 && std::abs(j - tileY) <= 1;
+                if (inside == m_loaded[i][j])
+                    continue;
+
+                if (inside)
+                {
+                    char filename[32];
+                    snprintf(filename, sizeof(filename), "maps/%03u%02u%02u.map", mapId, i, j);
+                    TerrainTile* terrain = new TerrainTile();
+                    if (terrain->Load((m_dataPath + filename).c_str()))
+                        m_terrain[i][j] = terrain;
+                    else
+                        delete terrain;
+
+                    m_vmapLoaded[i][j] = m_vmapManager->loadMap(vmapPath.c_str(), mapId, i, j) == VMAP::VMAP_LOAD_RESULT_OK;
+                }
+                else
+                {
+                    delete m_terrain[i][j];
+                    m_terrain[i][j] = NULL;
+                    if (m_vmapLoaded[i][j])
+                        m_vmapManager->unloadMap(mapId, i, j);
+                    m_vmapLoaded[i][j] = false;
+                }
+
+                m_loaded[i][j] = inside;
+            }
+        }
+    }
+
+    // the heights a creature can stand at in the cell, highest first
+    void TileBuilder::GatherLayers(uint32 mapId, int32 cx, int32 cy, CellLayers& layers)
+    {
+        layers.clear();
+        if (cx < 0 || cy < 0 || cx >= NAV_MAP_CELLS || cy >= NAV_MAP_CELLS)
+            return;
+
+        float x = NavCoordFromCell(cx);
+        float y = NavCoordFromCell(cy);
+
+        std::vector<float> surfaces;
+        if (TerrainTile const* terrain = m_terrain[cx / NAV_TILE_CELLS][cy / NAV_TILE_CELLS])
+            surfaces.push_back(terrain->GetHeight(x, y));
+
+        // every surface under the start, the floors and the undersides of the models
+        float z = NAV_SEARCH_TOP;
+        for (uint32 i = 0; i < NAV_MAX_SURFACES; ++i)
+        {
+            float hit = m_vmapManager->getHeight(mapId, x, y, z, z - NAV_SEARCH_BOTTOM);
+            if (hit <= VMAP_INVALID_HEIGHT)
+                break;
+
+            surfaces.push_back(hit);
+            z = hit - NAV_SURFACE_STEP;
+        }
+
+        std::sort(surfaces.begin(), surfaces.end(), std::greater<float>());
+
+        // a surface is walkable if there is room for the creature above it
+        for (size_t i = 0; i < surfaces.size() && layers.size() < NAV_MAX_LAYERS; ++i)
+        {
+            if (i > 0 && surfaces[i - 1] - surfaces[i] < NAV_AGENT_HEIGHT)
+                continue;
+
+            layers.push_back(surfaces[i]);
+        }
+    }
+
+    uint32 TileBuilder::LinkLayer(uint32 mapId, int32 cx, int32 cy, float z, CellLayers const* neighbours[MAX_NAV_DIRECTIONS])
+    {
+        float x = NavCoordFromCell(cx);
+        float y = NavCoordFromCell(cy);
+
+        NavLayer layer;
+        layer.z = z;
+        layer.links = 0;
+
+        // straight directions first, a diagonal step needs both of its sides to
+        // be open so paths do not cut the corners of walls
+        for (uint32 pass = 0; pass < 2; ++pass)
+        {
+            for (uint32 dir = pass; dir < MAX_NAV_DIRECTIONS; dir += 2)
+            {
+                if (pass && (!layer.IsLinked(dir - 1) || !layer.IsLinked((dir + 1) % MAX_NAV_DIRECTIONS)))
+                    continue;
+
+                CellLayers const& other = *neighbours[dir];
+                float dist = pass ? NAV_CELL_SIZE * 1.41421356f : NAV_CELL_SIZE;
+                float maxClimb = NAV_AGENT_CLIMB + NAV_AGENT_SLOPE * dist;
+
+                uint32 best = NAV_MAX_LAYERS;
+                for (uint32 i = 0; i < other.size(); ++i)
+                    if (std::fabs(other[i] - z) <= maxClimb && (best == NAV_MAX_LAYERS || std::fabs(other[i] - z) < std::fabs(other[best] - z)))
+                        best = i;
+
+                if (best == NAV_MAX_LAYERS)
+                    continue;
+
+                float nx = NavCoordFromCell(cx + NavDirectionX[dir]);
+                float ny = NavCoordFromCell(cy + NavDirectionY[dir]);
+                if (!m_vmapManager->isInLineOfSight(mapId, x, y, z + NAV_AGENT_EYE_HEIGHT, nx, ny, other[best] + NAV_AGENT_EYE_HEIGHT))
+                    continue;
+
+                layer.Link(dir, best);
+            }
+        }
+
+        return layer.links;
+    }
+
+    bool TileBuilder::BuildTile(uint32 mapId, uint32 tileX, uint32 tileY)
+    {
+        SetWindow(mapId, tileX, tileY);
+
+        // the layers of the ring around the tile are needed for the links
+        // leaving it, they are computed again by the neighbour tiles
+        std::vector<CellLayers> cells(NAV_BORDER_CELLS * NAV_BORDER_CELLS);
+        int32 baseX = tileX * NAV_TILE_CELLS - 1;
+        int32 baseY = tileY * NAV_TILE_CELLS - 1;
+        for (int32 j = 0; j < NAV_BORDER_CELLS; ++j)
+            for (int32 i = 0; i < NAV_BORDER_CELLS; ++i)
+                GatherLayers(mapId, baseX + i, baseY + j, cells[i + j * NAV_BORDER_CELLS]);
+
+        std::vector<uint32> firstLayer(NAV_TILE_CELLS * NAV_TILE_CELLS + 1);
+        std::vector<NavLayer> layers;
+        for (int32 j = 1; j <= NAV_TILE_CELLS; ++j)
+        {
+            for (int32 i = 1; i <= NAV_TILE_CELLS; ++i)
+            {
+                CellLayers const* neighbours[MAX_NAV_DIRECTIONS];
+                for (uint32 dir = 0; dir < MAX_NAV_DIRECTIONS; ++dir)
+                    neighbours[dir] = &cells[(i + NavDirectionX[dir]) + (j + NavDirectionY[dir]) * NAV_BORDER_CELLS];
+
+                firstLayer[(i - 1) + (j - 1) * NAV_TILE_CELLS] = layers.size();
+
+                CellLayers const& own = cells[i + j * NAV_BORDER_CELLS];
+                for (size_t l = 0; l < own.size(); ++l)
+                {
+                    NavLayer layer;
+                    layer.z = own[l];
+                    layer.links = LinkLayer(mapId, baseX + i, baseY + j, own[l], neighbours);
+                    layers.push_back(layer);
+                }
+            }
+        }
+        firstLayer[NAV_TILE_CELLS * NAV_TILE_CELLS] = layers.size();
+
+        if (layers.empty())
+        {
+            printf("map %03u tile [%02u,%02u]: nothing to walk on\n", mapId, tileX, tileY);
+            return true;
+        }
+
+        if (!WriteTile(mapId, tileX, tileY, firstLayer, layers))
+            return false;
+
+        printf("map %03u tile [%02u,%02u]: %u layers\n", mapId, tileX, tileY, uint32(layers.size()));
+        return true;
+    }
+
+    bool TileBuilder::WriteTile(uint32 mapId, uint32 tileX, uint32 tileY, std::vector<uint32> const& firstLayer, std::vector<NavLayer> const& layers) const
+    {
+        char filename[32];
+        snprintf(filename, sizeof(filename), "mmaps/%03u%02u%02u.mmtile", mapId, tileX, tileY);
+
+        FILE* file = fopen((m_dataPath + filename).c_str(), "wb");
+        if (!file)
+        {
+            printf("ERROR: can not create %s%s\n", m_dataPath.c_str(), filename);
+            return false;
+        }
+
+        NavTileHeader header;
+        header.magic = NAV_TILE_MAGIC;
+        header.version = NAV_TILE_VERSION;
+        header.mapId = mapId;
+        header.tileX = tileX;
+        header.tileY = tileY;
+        header.layerCount = layers.size();
+
+        bool result = fwrite(&header, sizeof(header), 1, file) == 1 &&
+            fwrite(&firstLayer[0], sizeof(uint32), firstLayer.size(), file) == firstLayer.size() &&
+            fwrite(&layers[0], sizeof(NavLayer), layers.size(), file) == layers.size();
+
+        if (fclose(file) != 0)
+            result = false;
+
+        if (!result)
+            printf("ERROR: can not write %s%s\n", m_dataPath.c_str(), filename);
+        return result;
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2010-2012 OregonCore <http://www.oregoncore.com/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TILEBUILDER_H
+#define _TILEBUILDER_H
+
+#include "MoveMapSharedDefines.h"
+
+#include <string>
+#include <vector>
+
+namespace VMAP
+{
+    class VMapManager2;
+}
+
+namespace MMAP
+{
+    // heights of one .map file, the int8 and int16 encodings are expanded to float
+    class TerrainTile
+    {
+        public:
+            TerrainTile() : m_gridHeight(0.0f) {}
+
+            bool Load(const char* filename);
+            float GetHeight(float x, float y) const;
+
+        private:
+            float m_gridHeight;
+            std::vector<float> m_V9;
+            std::vector<float> m_V8;
+    };
+
+    class TileBuilder
+    {
+        public:
+            TileBuilder(std::string const& dataPath);
+            ~TileBuilder();
+
+            // every tile with terrain or models, the data path holds maps/, vmaps/ and mmaps/
+            bool BuildMap(uint32 mapId);
+            bool BuildTile(uint32 mapId, uint32 tileX, uint32 tileY);
+
+        private:
+            typedef std::vector<float> CellLayers;
+
+            bool HasTileData(uint32 mapId, uint32 tileX, uint32 tileY);
+            void SetWindow(uint32 mapId, int32 tileX, int32 tileY);
+
+            void GatherLayers(uint32 mapId, int32 cx, int32 cy, CellLayers& layers);
+            uint32 LinkLayer(uint32 mapId, int32 cx, int32 cy, float z, CellLayers const* neighbours[MAX_NAV_DIRECTIONS]);
+            bool WriteTile(uint32 mapId, uint32 tileX, uint32 tileY, std::vector<uint32> const& firstLayer, std::vector<NavLayer> const& layers) const;
+
+            std::string m_dataPath;
+            VMAP::VMapManager2* m_vmapManager;
+            uint32 m_mapId;
+            TerrainTile* m_terrain[64][64];
+            bool m_loaded[64][64];
+            bool m_vmapLoaded[64][64];
+    };
+}
+#endif